@@ -8,7 +8,40 @@
 
 #include "basic_btb.h"
 
+#include <algorithm>
+#include <iterator>
+#include <fmt/core.h>
+
 #include "instruction.h"
+#include "ooo_cpu.h"
+
+namespace
+{
+std::vector<direct_predictor::level_type> levels_of(const O3_CPU* cpu)
+{
+  if (std::empty(cpu->BTB_LEVELS))
+    return direct_predictor::default_levels;
+
+  std::vector<direct_predictor::level_type> levels{};
+  std::transform(std::begin(cpu->BTB_LEVELS), std::end(cpu->BTB_LEVELS), std::back_inserter(levels), [](const auto& level) {
+    return direct_predictor::level_type{level.sets, level.ways, level.latency};
+  });
+  return levels;
+}
+} // namespace
+
+basic_btb::basic_btb(O3_CPU* cpu)
+    : btb(cpu), direct(levels_of(cpu)),
+      prefetch_from_l1i(cpu->BTB_PREFETCH_FROM_L1I)
+{
+  stats.level_hits.resize(std::size(direct.BTB));
+}
+
+basic_btb::basic_btb(const std::vector<direct_predictor::level_type>& levels, bool prefetch_from_l1i_)
+    : btb(nullptr), direct(levels), prefetch_from_l1i(prefetch_from_l1i_)
+{
+  stats.level_hits.resize(std::size(direct.BTB));
+}
 
 std::pair<champsim::address, bool> basic_btb::btb_prediction(champsim::address ip)
 {
@@ -19,13 +52,22 @@ std::pair<champsim::address, bool> basic_btb::btb_prediction(champsim::address i
   if (!btb_entry.has_value())
     return {champsim::address{}, false};
 
-  if (btb_entry->type == direct_predictor::branch_info::RETURN)
+  ++stats.level_hits.at(btb_entry->level);
+
+  // Hits in the slower levels delay the redirect
+  if (btb_entry->latency > 0) {
+    stats.bubble_cycles += static_cast<uint64_t>(btb_entry->latency);
+    if (intern_ != nullptr)
+      insert_fetch_bubble(btb_entry->latency);
+  }
+
+  if (btb_entry->entry.type == direct_predictor::branch_info::RETURN)
     return ras.prediction();
 
-  if (btb_entry->type == direct_predictor::branch_info::INDIRECT)
+  if (btb_entry->entry.type == direct_predictor::branch_info::INDIRECT)
     return indirect.prediction(ip);
 
-  return {btb_entry->target, btb_entry->type != direct_predictor::branch_info::CONDITIONAL};
+  return {btb_entry->entry.target, btb_entry->entry.type != direct_predictor::branch_info::CONDITIONAL};
 }
 
 void basic_btb::update_btb(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type)
@@ -46,3 +88,18 @@ void basic_btb::update_btb(champsim::address ip, champsim::address branch_target
 
   direct.update(ip, branch_target, branch_type);
 }
+
+void basic_btb::prefetch_btb(champsim::address block_address)
+{
+  if (prefetch_from_l1i)
+    stats.prefetched += direct.prefetch(champsim::block_number{block_address});
+}
+
+void basic_btb::btb_final_stats()
+{
+  for (std::size_t level = 0; level < std::size(stats.level_hits); ++level)
+    fmt::print("BTB level {} hits: {}\n", level, stats.level_hits[level]);
+  fmt::print("BTB bubble cycles: {}\n", stats.bubble_cycles);
+  if (prefetch_from_l1i)
+    fmt::print("BTB entries prefetched from L1I: {}\n", stats.prefetched);
+}
@@ -1,6 +1,9 @@
 #ifndef BTB_BASIC_BTB_H
 #define BTB_BASIC_BTB_H
 
+#include <cstdint>
+#include <vector>
+
 #include "address.h"
 #include "direct_predictor.h"
 #include "indirect_predictor.h"
@@ -13,13 +16,25 @@ class basic_btb : champsim::modules::btb
   indirect_predictor indirect{};
   direct_predictor direct{};
 
+  // If set, the entries for the branches in each block fetched by the L1I are placed in the first level of the BTB
+  bool prefetch_from_l1i = false;
+
 public:
-  using btb::btb;
-  basic_btb() : btb(nullptr) {}
+  struct {
+    std::vector<uint64_t> level_hits{};
+    uint64_t bubble_cycles = 0;
+    uint64_t prefetched = 0;
+  } stats;
+
+  explicit basic_btb(O3_CPU* cpu);
+  basic_btb() : basic_btb(direct_predictor::default_levels) {}
+  explicit basic_btb(const std::vector<direct_predictor::level_type>& levels, bool prefetch_from_l1i_ = false);
 
   // void initialize_btb();
   std::pair<champsim::address, bool> btb_prediction(champsim::address ip);
   void update_btb(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void prefetch_btb(champsim::address block_address);
+  void btb_final_stats();
 };
 
 #endif
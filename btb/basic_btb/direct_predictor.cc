@@ -1,10 +1,29 @@
 #include "direct_predictor.h"
 
+#include <algorithm>
+
 #include "instruction.h"
 
-auto direct_predictor::check_hit(champsim::address ip) -> std::optional<btb_entry_t>
+direct_predictor::direct_predictor(const std::vector<level_type>& levels)
+{
+  for (auto level : levels) {
+    BTB.emplace_back(level.sets, level.ways);
+    latency.push_back(level.latency);
+  }
+}
+
+auto direct_predictor::check_hit(champsim::address ip) -> std::optional<lookup_result>
 {
-  return BTB.check_hit({ip, champsim::address{}, branch_info::ALWAYS_TAKEN});
+  btb_entry_t probe{ip, champsim::address{}, branch_info::ALWAYS_TAKEN};
+  for (std::size_t level = 0; level < std::size(BTB); ++level) {
+    if (auto found = BTB[level].check_hit(probe); found.has_value()) {
+      // Promote the entry into the faster levels
+      for (std::size_t upper = 0; upper < level; ++upper)
+        BTB[upper].fill(*found);
+      return lookup_result{*found, level, latency[level]};
+    }
+  }
+  return std::nullopt;
 }
 
 void direct_predictor::update(champsim::address ip, champsim::address branch_target, uint8_t branch_type)
@@ -18,14 +37,46 @@ void direct_predictor::update(champsim::address ip, champsim::address branch_tar
   else if (branch_type == BRANCH_CONDITIONAL)
     type = branch_info::CONDITIONAL;
 
-  auto opt_entry = BTB.check_hit({ip, branch_target, type});
-  if (opt_entry.has_value()) {
-    opt_entry->type = type;
-    if (branch_target != champsim::address{})
-      opt_entry->target = branch_target;
+  std::optional<btb_entry_t> last_filled{};
+  for (auto& level : BTB) {
+    auto opt_entry = level.check_hit({ip, branch_target, type});
+    if (opt_entry.has_value()) {
+      opt_entry->type = type;
+      if (branch_target != champsim::address{})
+        opt_entry->target = branch_target;
+    }
+
+    if (branch_target != champsim::address{}) {
+      last_filled = opt_entry.value_or(btb_entry_t{ip, branch_target, type});
+      level.fill(*last_filled);
+    }
   }
 
-  if (branch_target != champsim::address{}) {
-    BTB.fill(opt_entry.value_or(btb_entry_t{ip, branch_target, type}));
+  // Remember this branch as part of its block's footprint
+  if (last_filled.has_value()) {
+    champsim::block_number block{ip};
+    auto footprint = footprints.check_hit({block}).value_or(block_footprint{block});
+    auto end = std::next(std::begin(footprint.branches), static_cast<long>(footprint.count));
+    auto found = std::find_if(std::begin(footprint.branches), end, [ip](const auto& x) { return x.ip_tag == ip; });
+    if (found != end)
+      *found = *last_filled;
+    else if (footprint.count < footprint_branches)
+      footprint.branches[footprint.count++] = *last_filled;
+    footprints.fill(footprint);
   }
 }
+
+std::size_t direct_predictor::prefetch(champsim::block_number block)
+{
+  auto footprint = footprints.check_hit({block});
+  if (!footprint.has_value() || std::empty(BTB))
+    return 0;
+
+  auto end = std::next(std::cbegin(footprint->branches), static_cast<long>(footprint->count));
+  return static_cast<std::size_t>(std::count_if(std::cbegin(footprint->branches), end, [this](const auto& branch) {
+    if (BTB.front().check_hit(branch).has_value())
+      return false;
+    BTB.front().fill(branch);
+    return true;
+  }));
+}
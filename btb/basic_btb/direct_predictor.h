@@ -1,8 +1,10 @@
 #ifndef BTB_BASIC_BTB_DIRECT_PREDICTOR_H
 #define BTB_BASIC_BTB_DIRECT_PREDICTOR_H
 
+#include <array>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "address.h"
 #include "champsim.h"
@@ -19,6 +21,27 @@ struct direct_predictor {
   static constexpr std::size_t sets = 1024;
   static constexpr std::size_t ways = 8;
 
+  /*
+   * The BTB may be organized as a hierarchy. The first level is searched on every prediction. Later levels are searched on a miss,
+   * and a hit there costs the level's latency in fetch bubbles and copies the entry into the levels above. Updates are written to every level.
+   *
+   * For example, {{256, 4, 0}, {2048, 8, 2}, {8192, 8, 4}} describes a three-level BTB with 2- and 4-cycle second and third levels.
+   */
+  struct level_type {
+    std::size_t sets;
+    std::size_t ways;
+    long latency;
+  };
+  static inline const std::vector<level_type> default_levels{{sets, ways, 0}};
+
+  /*
+   * Predecoding a fetched block reveals the branches it contains, so that their entries can be placed in the first level before they are
+   * needed. The branches seen in each block are remembered here to stand in for the instruction bytes.
+   */
+  static constexpr std::size_t footprint_sets = 256;
+  static constexpr std::size_t footprint_ways = 8;
+  static constexpr std::size_t footprint_branches = 8;
+
   struct btb_entry_t {
     champsim::address ip_tag{};
     champsim::address target{};
@@ -36,9 +59,31 @@ struct direct_predictor {
     }
   };
 
-  champsim::msl::lru_table<btb_entry_t> BTB{sets, ways};
-  std::optional<btb_entry_t> check_hit(champsim::address ip);
+  struct lookup_result {
+    btb_entry_t entry;
+    std::size_t level;
+    long latency;
+  };
+
+  struct block_footprint {
+    champsim::block_number block{};
+    std::array<btb_entry_t, footprint_branches> branches{};
+    std::size_t count = 0;
+  };
+  struct footprint_indexer {
+    auto operator()(const block_footprint& entry) const { return entry.block; }
+  };
+
+  std::vector<champsim::msl::lru_table<btb_entry_t>> BTB{};
+  std::vector<long> latency{};
+  champsim::msl::lru_table<block_footprint, footprint_indexer, footprint_indexer> footprints{footprint_sets, footprint_ways};
+
+  direct_predictor() : direct_predictor(default_levels) {}
+  explicit direct_predictor(const std::vector<level_type>& levels);
+
+  std::optional<lookup_result> check_hit(champsim::address ip);
   void update(champsim::address ip, champsim::address branch_target, uint8_t branch_type);
+  std::size_t prefetch(champsim::block_number block);
 };
 
 #endif
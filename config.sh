@@ -52,6 +52,8 @@ if __name__ == '__main__':
             help='A directory to search for branch target predictors')
     search_group.add_argument('--prefetcher-dir', action='append', default=[], metavar='DIR',
             help='A directory to search for prefetchers')
+    search_group.add_argument('--dram-prefetcher-dir', action='append', default=[], metavar='DIR',
+            help='A directory to search for memory-side prefetchers')
     search_group.add_argument('--replacement-dir', action='append', default=[], metavar='DIR',
             help='A directory to search for replacement policies')
 
@@ -89,6 +91,7 @@ if __name__ == '__main__':
         'branch_dir': args.branch_dir,
         'btb_dir': args.btb_dir,
         'pref_dir': args.prefetcher_dir,
+        'dram_pref_dir': args.dram_prefetcher_dir,
         'repl_dir': args.replacement_dir,
         'compile_all_modules': args.compile_all_modules,
         'verbose': args.verbose
@@ -23,6 +23,7 @@ import pathlib
 from .makefile import get_makefile_lines
 from .instantiation_file import get_instantiation_lines
 from .instantiation_file import get_instantiation_header
+from .instantiation_file import get_constants_header
 from . import util
 
 warning_text = (
@@ -100,6 +101,13 @@ class Fragment:
         it = iter(iterable)
         key, first_value = next(it)
 
+        # The constants are compiled into the shared objects, so every configuration must agree on them
+        if os.path.basename(key) == 'champsim_constants.h':
+            first_value = tuple(first_value)
+            if any(tuple(v[1]) != first_value for v in it):
+                raise ValueError('All configurations that share an object directory must have the same block and page sizes')
+            return key, first_value
+
         header_len = 0
         if os.path.splitext(key)[1] in ('.cc', '.h', '.inc'):
             header_len = len(cxx_generated_warning())
@@ -166,6 +174,7 @@ class Fragment:
             # Instantiation file
             (os.path.join(objdir_name, 'core_inst.inc'), cxx_file(get_instantiation_header(len(elements['cores']), config_file, build_id=build_id))),
             (os.path.join(objdir_name, 'core_inst.cc.inc'), cxx_file(get_instantiation_lines(build_id=build_id, **elements))),
+            (os.path.join(objdir_name, 'champsim_constants.h'), tuple(cxx_file(get_constants_header(config_file)))),
 
             # Makefile generation
             (os.path.join(makedir_name, '_configuration.mk'), (
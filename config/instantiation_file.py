@@ -22,8 +22,9 @@ import multiprocessing as mp
 from . import util
 from . import cxx
 
-pmem_fmtstr = 'champsim::chrono::picoseconds{{{clock_period_dbus}}}, champsim::chrono::picoseconds{{{clock_period_mc}}}, std::size_t{{{_tRP}}}, std::size_t{{{_tRCD}}}, std::size_t{{{_tCAS}}}, std::size_t{{{_tRAS}}}, champsim::chrono::microseconds{{{_refresh_period}}}, {{{_ulptr}}}, {rq_size}, {wq_size}, {channels}, champsim::data::bytes{{{channel_width}}}, {_bank_rows}, {_bank_columns}, {ranks}, {bankgroups}, {banks}, {_refreshes_per_period}'
-vmem_fmtstr = 'champsim::data::bytes{{{pte_page_size}}}, {num_levels}, champsim::chrono::picoseconds{{{clock_period}*{minor_fault_penalty}}}, {dram_name}, {_randomization}'
+pmem_fmtstr = 'champsim::dram_prefetcher_type_holder<{_prefetcher_classes}>{{}}, champsim::chrono::picoseconds{{{clock_period_dbus}}}, champsim::chrono::picoseconds{{{clock_period_mc}}}, std::size_t{{{_tRP}}}, std::size_t{{{_tRCD}}}, std::size_t{{{_tCAS}}}, std::size_t{{{_tRAS}}}, champsim::chrono::microseconds{{{_refresh_period}}}, {{{_ulptr}}}, {rq_size}, {wq_size}, {channels}, champsim::data::bytes{{{channel_width}}}, {_bank_rows}, {_bank_columns}, {ranks}, {bankgroups}, {banks}, {_refreshes_per_period}, {_prefetch_params}, {_rowhammer_params}, {_profile_params}'
+dram_cache_fmtstr = 'std::in_place, champsim::chrono::picoseconds{{{clock_period_dbus}}}, champsim::chrono::picoseconds{{{clock_period_mc}}}, std::size_t{{{_tRP}}}, std::size_t{{{_tRCD}}}, std::size_t{{{_tCAS}}}, std::size_t{{{_tRAS}}}, champsim::chrono::microseconds{{{_refresh_period}}}, std::vector<champsim::channel*>{{{_ulptr}}}, &{_llptr}, {rq_size}, {wq_size}, {channels}, champsim::data::bytes{{{channel_width}}}, {bank_columns}, {ranks}, {bankgroups}, {banks}, {refreshes_per_period}, {_params}'
+vmem_fmtstr = 'champsim::data::bytes{{{pte_page_size}}}, {num_levels}, champsim::chrono::picoseconds{{{clock_period}*{minor_fault_penalty}}}, {dram_name}, {_randomization}, {_allocation}, {_profile_params}'
 
 queue_fmtstr = '{rq_size}, {pq_size}, {wq_size}, champsim::data::bits{{{_offset_bits}}}, {_queue_check_full_addr:b}'
 
@@ -48,6 +49,7 @@ core_builder_parts = {
     'dispatch_latency': '.dispatch_latency({dispatch_latency})',
     'schedule_latency': '.schedule_latency({schedule_latency})',
     'execute_latency': '.execute_latency({execute_latency})',
+    'class_execute_latency': '.class_execute_latency({{{^class_execute_latency_string}}})',
     'dib_set': '  .dib_set({dib_set})',
     'dib_way': '  .dib_way({dib_way})',
     'dib_window': '  .dib_window({dib_window})',
@@ -56,13 +58,29 @@ core_builder_parts = {
     '_branch_predictor_data': '.branch_predictor<{^branch_predictor_string}>()',
     '_btb_data': '.btb<{^btb_string}>()',
     '_index': '.index({_index})',
-    'frequency': '.clock_period(champsim::chrono::picoseconds{{{^clock_period}}})'
+    'frequency': '.clock_period(champsim::chrono::picoseconds{{{^clock_period}}})',
+    'model': '.model(champsim::core_model::{model})',
+    'ip_attribution': '.ip_attribution({ip_attribution})',
+    'btb_levels': '.btb_levels({{{^btb_levels_string}}})'
+}
+
+local_core_builder_parts = {
+    ('btb_prefetch_from_l1i', True): '.set_btb_prefetch_from_l1i()',
+    ('btb_prefetch_from_l1i', False): '.reset_btb_prefetch_from_l1i()'
 }
 
 dib_builder_parts = {
     'sets': '  .dib_set({DIB[sets]})',
     'ways': '  .dib_way({DIB[ways]})',
-    'window_size': '  .dib_window({DIB[window_size]})'
+    'window_size': '  .dib_window({DIB[window_size]})',
+    'uops_per_line': '  .dib_uops_per_line({DIB[uops_per_line]})',
+    'ways_per_window': '  .dib_ways_per_window({DIB[ways_per_window]})',
+    'switch_penalty': '  .dib_switch_penalty({DIB[switch_penalty]})'
+}
+
+local_dib_builder_parts = {
+    ('inclusive', True): '  .set_dib_inclusive()',
+    ('inclusive', False): '  .reset_dib_inclusive()'
 }
 
 cache_builder_parts = {
@@ -74,12 +92,19 @@ cache_builder_parts = {
     'log2_ways': '.log2_ways({log2_ways})',
     'pq_size': '.pq_size({pq_size})',
     'mshr_size': '.mshr_size({mshr_size})',
+    'mshr_demand_reserve': '.mshr_demand_reserve({mshr_demand_reserve})',
+    'mshr_prefetch_limit': '.mshr_prefetch_limit({mshr_prefetch_limit})',
     'latency': '.latency({latency})',
     'hit_latency': '.hit_latency({hit_latency})',
     'fill_latency': '.fill_latency({fill_latency})',
     'max_tag_check': '.tag_bandwidth(champsim::bandwidth::maximum_type{{{max_tag_check}}})',
     'max_fill': '.fill_bandwidth(champsim::bandwidth::maximum_type{{{max_fill}}})',
     '_offset_bits': '.offset_bits(champsim::data::bits{{{_offset_bits}}})',
+    'sectors': '.sectors({sectors})',
+    'victim_cache': '.victim_cache({victim_cache})',
+    'prefetch_buffer': '.prefetch_buffer({prefetch_buffer})',
+    'write_buffer': '.write_buffer_size({write_buffer})',
+    'ip_attribution': '.ip_attribution({ip_attribution})',
     'prefetch_activate': '.prefetch_activate({^prefetch_activate_string})',
     '_replacement_data': '.replacement<{^replacement_string}>()',
     '_prefetcher_data': '.prefetcher<{^prefetcher_string}>()',
@@ -105,6 +130,22 @@ def vector_string(iterable):
         return hoisted[0]
     return '{'+', '.join(hoisted)+'}'
 
+def get_energy_builder_parts(elem, structures):
+    '''
+    Generate the builder calls that set the access energy of the structures of an element.
+    Each structure in the element's "energy" dict gives its read and write energy and its leakage.
+    Structures and fields that are not given are estimated from the structure's size.
+
+    :param elem: The element to generate for.
+    :param structures: A mapping from the names of the structures to the builder functions that set them.
+    '''
+    energy = elem.get('energy', {})
+    for name, func in structures.items():
+        if name in energy:
+            fields = (energy[name].get(k) for k in ('read', 'write', 'leakage'))
+            values = ', '.join('std::nullopt' if v is None else str(float(v)) for v in fields)
+            yield f'.{func}(champsim::partial_access_energy{{{{{values}}}}})'
+
 def get_cpu_builder(cpu, caches, ul_pairs):
     '''
     Generate a champsim::core_builder
@@ -121,7 +162,9 @@ def get_cpu_builder(cpu, caches, ul_pairs):
         '^fetch_queues': f'channels.at({ul_pairs.index((cpu.get("L1I"), cpu.get("name")))})',
         '^data_queues': f'channels.at({ul_pairs.index((cpu.get("L1D"), cpu.get("name")))})',
         '^l1i_ptr': f'(*std::next(std::begin(caches), {cache_index(cpu.get("L1I"))}))',
-        '^l1d_ptr': f'(*std::next(std::begin(caches), {cache_index(cpu.get("L1D"))}))'
+        '^l1d_ptr': f'(*std::next(std::begin(caches), {cache_index(cpu.get("L1D"))}))',
+        '^class_execute_latency_string': ', '.join(str(x) for x in cpu.get('class_execute_latency',[])),
+        '^btb_levels_string': ', '.join(f'{{{l["sets"]}, {l["ways"]}, {l.get("latency", 0)}}}' for l in cpu.get('btb_levels',[]))
     }
     if 'frequency' in cpu:
         local_params['^clock_period'] = int(1000000/cpu['frequency'])
@@ -130,7 +173,10 @@ def get_cpu_builder(cpu, caches, ul_pairs):
         ('champsim::core_builder{{ champsim::defaults::default_core }}',),
         required_parts,
         *(util.wrap_list(v) for k,v in core_builder_parts.items() if k in cpu),
-        (v for k,v in dib_builder_parts.items() if k in cpu.get('DIB',{}))
+        (v for k,v in local_core_builder_parts.items() if k[0] in cpu and k[1] == cpu[k[0]]),
+        (v for k,v in dib_builder_parts.items() if k in cpu.get('DIB',{})),
+        (v for k,v in local_dib_builder_parts.items() if k[0] in cpu.get('DIB',{}) and k[1] == cpu['DIB'][k[0]]),
+        get_energy_builder_parts(cpu, {'rob': 'rob_energy', 'lq': 'lq_energy', 'sq': 'sq_energy', 'branch_predictor': 'branch_predictor_energy'})
     ), indent=1, line_end=''))
     yield from (part.format(**cpu, **local_params) for part in builder_parts)
 
@@ -141,6 +187,7 @@ def get_cache_builder(elem, ul_pairs):
     required_parts = [
         '.name("{name}")',
         '.upper_levels({{{^upper_levels_string}}})',
+        '.memory_controller(&DRAM)',
     ]
 
     local_cache_builder_parts = {
@@ -149,7 +196,19 @@ def get_cache_builder(elem, ul_pairs):
         ('wq_check_full_addr', True): '.set_wq_checks_full_addr()',
         ('wq_check_full_addr', False): '.reset_wq_checks_full_addr()',
         ('virtual_prefetch', True): '.set_virtual_prefetch()',
-        ('virtual_prefetch', False): '.reset_virtual_prefetch()'
+        ('virtual_prefetch', False): '.reset_virtual_prefetch()',
+        ('prefetch_filter', True): '.set_prefetch_filter()',
+        ('prefetch_filter', False): '.reset_prefetch_filter()',
+        ('demand_priority', True): '.set_demand_priority()',
+        ('demand_priority', False): '.reset_demand_priority()',
+        ('fixed_priority', True): '.set_fixed_priority()',
+        ('fixed_priority', False): '.reset_fixed_priority()',
+        ('write_through', True): '.set_write_through()',
+        ('write_through', False): '.reset_write_through()',
+        ('write_allocate', True): '.set_write_allocate()',
+        ('write_allocate', False): '.reset_write_allocate()',
+        ('eager_writeback', True): '.set_eager_writeback()',
+        ('eager_writeback', False): '.reset_eager_writeback()'
     }
 
     uppers = (v for v in ul_pairs if v[0] == elem.get('name'))
@@ -172,7 +231,8 @@ def get_cache_builder(elem, ul_pairs):
         ('champsim::cache_builder{{ {^defaults} }}',),
         required_parts,
         (v for k,v in cache_builder_parts.items() if k in elem),
-        (v for k,v in local_cache_builder_parts.items() if k[0] in elem and k[1] == elem[k[0]])
+        (v for k,v in local_cache_builder_parts.items() if k[0] in elem and k[1] == elem[k[0]]),
+        get_energy_builder_parts(elem, {'tag': 'tag_energy', 'data': 'data_energy'})
     ), indent=1, line_end=''))
     yield from (part.format(**elem, **local_params) for part in builder_parts)
 
@@ -205,7 +265,8 @@ def get_ptw_builder(ptw, ul_pairs):
         ('champsim::ptw_builder{{ champsim::defaults::default_ptw }}',),
         required_parts,
         (v for k,v in ptw_builder_parts.items() if k in ptw),
-        (v for keys,v in local_ptw_builder_parts.items() if any(k in ptw for k in keys))
+        (v for keys,v in local_ptw_builder_parts.items() if any(k in ptw for k in keys)),
+        get_energy_builder_parts(ptw, {'pscl': 'pscl_energy'})
     ), indent=1, line_end=''))
     yield from (part.format(**ptw, **local_params) for part in builder_parts)
 
@@ -251,7 +312,7 @@ def cache_queue_defaults(cache):
         'rq_size': cache.get('rq_size', cache['_queue_factor']),
         'wq_size': cache.get('wq_size', cache['_queue_factor']),
         'pq_size': cache.get('pq_size', cache['_queue_factor']),
-        '_offset_bits': cache['_offset_bits'],
+        '_offset_bits': cache.get('_queue_offset_bits', cache['_offset_bits']),
         '_queue_check_full_addr': cache['_queue_check_full_addr']
     }
 
@@ -264,12 +325,13 @@ def ptw_queue_defaults(ptw):
         '_queue_check_full_addr': False
     }
 
-def get_upper_levels(cores, caches, ptws):
+def get_upper_levels(cores, caches, ptws, dram_caches=tuple()):
     ''' Get a sequence of (lower_name, upper_name) for the given elements. '''
     def named_selector(elem, key):
         return elem.get(key), elem.get('name')
 
     return list(filter(lambda x: x[0] is not None, itertools.chain(
+        map(functools.partial(named_selector, key='lower_level'), dram_caches),
         map(functools.partial(named_selector, key='lower_level'), ptws),
         map(functools.partial(named_selector, key='lower_level'), caches),
         map(functools.partial(named_selector, key='lower_translate'), caches),
@@ -295,43 +357,108 @@ def module_include_files(datas):
 
     yield from (f'#include "{f}"' for _,f in candidates)
 
-def decorate_queues(caches, ptws, pmem):
+def decorate_queues(caches, ptws, pmem, dram_caches=tuple()):
+    memory_queue_defaults = {
+        'rq_size':'std::numeric_limits<std::size_t>::max()',
+        'wq_size':'std::numeric_limits<std::size_t>::max()',
+        'pq_size':'std::numeric_limits<std::size_t>::max()',
+        '_offset_bits':'champsim::lg2(BLOCK_SIZE)',
+        '_queue_check_full_addr':False
+    }
     return util.chain(
             *({c['name']: cache_queue_defaults(c)} for c in caches),
             *({p['name']: ptw_queue_defaults(p)} for p in ptws),
-            {pmem['name']: {
-                    'rq_size':'std::numeric_limits<std::size_t>::max()',
-                    'wq_size':'std::numeric_limits<std::size_t>::max()',
-                    'pq_size':'std::numeric_limits<std::size_t>::max()',
-                    '_offset_bits':'champsim::lg2(BLOCK_SIZE)',
-                    '_queue_check_full_addr':False
-                }
-            }
+            *({d['name']: memory_queue_defaults} for d in dram_caches),
+            {pmem['name']: memory_queue_defaults}
     )
 
 def get_queue_info(ul_pairs, decoration):
     return [decoration.get(ll) for ll,_ in ul_pairs]
 
-def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
+def get_link_params(upper):
+    ''' Format the timing of the link between an element and its lower level for the channel constructor, or None if the link is not timed '''
+    link = upper.get('link')
+    if link is None:
+        return None
+    clock_period = int(1000000/link.get('frequency', upper['frequency']))
+    flit_size = f'champsim::data::bytes{{{int(link["flit_size"])}}}' if 'flit_size' in link else 'champsim::data::bytes{BLOCK_SIZE}'
+    return (f'champsim::link_parameters{{champsim::chrono::picoseconds{{{clock_period}}}, {int(link.get("request_latency", 0))}, '
+            f'{int(link.get("response_latency", 0))}, {int(link.get("flits_per_cycle", 0))}, {flit_size}}}')
+
+def get_channel_instantiation(ul_pairs, queues, uppers):
+    ''' Generate the constructor arguments of each channel, with the timing of the link given by its upper level '''
+    for (lower, upper), queue in zip(ul_pairs, queues):
+        elem = uppers.get(upper, {})
+        link = get_link_params(elem) if elem.get('lower_level') == lower else None
+        if link is None:
+            yield queue_fmtstr.format(**queue)
+        else:
+            yield f'{queue_fmtstr.format(**queue)}, "{upper}->{lower}", {link}'
+
+def get_dram_prefetch_params(pmem):
+    ''' Format the memory-side prefetcher parameters for the memory controller constructor '''
+    modes = { 'buffer': 'buffer', 'open_row': 'open_row' }
+    mode = modes[pmem.get('prefetch_mode', 'buffer')]
+    return (f'dram_prefetch_parameters{{dram_prefetch_parameters::mode_type::{mode}, '
+            f'{int(pmem.get("prefetch_buffer_size", 16))}, {int(pmem.get("prefetch_degree", 2))}}}')
+
+def get_dram_rowhammer_params(pmem):
+    ''' Format the RowHammer mitigation parameters for the memory controller constructor '''
+    mitigations = { 'no': 'none', 'none': 'none', 'para': 'para', 'graphene': 'graphene', 'rfm': 'rfm' }
+    mitigation = mitigations[pmem.get('rowhammer_mitigation', 'none')]
+    return (f'dram_rowhammer_parameters{{dram_rowhammer_parameters::mitigation_type::{mitigation}, {float(pmem.get("para_probability", 0.001))}, '
+            f'{int(pmem.get("rowhammer_threshold", 1024))}, {int(pmem.get("rowhammer_table_size", 64))}, {int(pmem.get("rowhammer_blast_radius", 1))}, '
+            f'{int(pmem.get("rowhammer_seed", 0))}}}')
+
+def get_dram_cache_params(dram_cache):
+    ''' Format the organization of a DRAM cache for its constructor '''
+    predictors = { 'no': 'none', 'none': 'none', 'map_i': 'map_i' }
+    organization = dram_cache['organization']
+    predictor = predictors[dram_cache['miss_predictor']]
+    return (f'dram_cache_parameters{{dram_cache_parameters::organization_type::{organization}, dram_cache_parameters::predictor_type::{predictor}, '
+            f'champsim::data::bytes{{{int(dram_cache["size"])}}}, champsim::data::bytes{{{int(dram_cache["page_size"])}}}, {int(dram_cache["ways"])}, '
+            f'{int(dram_cache["mshr_size"])}, {int(dram_cache["predictor_size"])}, {int(dram_cache["footprint_table_size"])}}}')
+
+def get_page_allocation_params(vmem, llc_sets):
+    ''' Format the physical page allocation policy for the virtual memory constructor '''
+    policies = ('random', 'sequential', 'coloring', 'buddy', 'numa')
+    colors = ('llc', 'bank')
+    policy = vmem.get('page_allocation', 'random')
+    color = vmem.get('page_color', 'llc')
+    if policy not in policies:
+        raise ValueError(f'Unknown page allocation policy "{policy}"')
+    if color not in colors:
+        raise ValueError(f'Unknown page color "{color}"')
+    return (f'page_allocation_parameters{{page_allocation_parameters::policy_type::{policy}, page_allocation_parameters::color_type::{color}, '
+            f'{int(llc_sets)}, {float(vmem.get("fragmentation", 0.5))}, {int(vmem.get("max_order", 10))}, {int(vmem.get("numa_nodes", 1))}}}')
+
+def get_page_profile_params(elem):
+    ''' Format the page hotness profile parameters for the memory controller or virtual memory constructor '''
+    return f'page_profile_parameters{{"{elem.get("page_profile", "")}", {int(elem.get("page_profile_epoch", 0))}}}'
+
+def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id, dram_cache=None):
     '''
     Generate the lines for a C++ file that instantiates a configuration.
     '''
     classname = f'champsim::configured::generated_environment<0x{build_id}>'
-    ul_pairs = get_upper_levels(cores, caches, ptws)
-    queues = get_queue_info(ul_pairs, decorate_queues(caches, ptws, pmem))
+    dram_caches = (dram_cache,) if dram_cache is not None else tuple()
+    ul_pairs = get_upper_levels(cores, caches, ptws, dram_caches)
+    queues = get_queue_info(ul_pairs, decorate_queues(caches, ptws, pmem, dram_caches))
 
     datas = itertools.filterfalse(operator.methodcaller('get', 'legacy', False), itertools.chain(
         *(c['_branch_predictor_data'] for c in cores),
         *(c['_btb_data'] for c in cores),
         *(c['_prefetcher_data'] for c in caches),
-        *(c['_replacement_data'] for c in caches)
+        *(c['_replacement_data'] for c in caches),
+        pmem.get('_dram_prefetcher_data', [])
     ))
     yield from module_include_files(datas)
 
     # Get fastest clock period in picoseconds
-    global_clock_period = int(1000000/max(x['frequency'] for x in itertools.chain(cores, caches, ptws, (pmem,))))
+    global_clock_period = int(1000000/max(x['frequency'] for x in itertools.chain(cores, caches, ptws, (pmem,), dram_caches)))
 
-    channels_head, channels_tail = util.cut((f'champsim::channel{{{queue_fmtstr.format(**v)}}}' for v in queues), n=-1)
+    uppers = {elem['name']: elem for elem in itertools.chain(caches, ptws, dram_caches)}
+    channels_head, channels_tail = util.cut((f'champsim::channel{{{v}}}' for v in get_channel_instantiation(ul_pairs, queues, uppers)), n=-1)
     channel_instantiation_body = ('channels{', *(v+',' for v in channels_head), *channels_tail, '},')
 
     pmem_instantiation_body = (
@@ -347,17 +474,42 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
             _bank_columns=int(pmem['columns']*8 if 'columns' in pmem else pmem['bank_columns']),
             _refresh_period=int(1000*pmem['refresh_period']),
             _refreshes_per_period=int(pmem['refreshes_per_period']),
+            _prefetcher_classes=', '.join(f'class {k["class"]}' for k in pmem.get('_dram_prefetcher_data', [])),
+            _prefetch_params=get_dram_prefetch_params(pmem),
+            _rowhammer_params=get_dram_rowhammer_params(pmem),
+            _profile_params=get_page_profile_params(pmem),
             _ulptr=vector_string(f'&channels.at({ul_pairs.index(v)})' for v in ul_pairs if v[0] == pmem['name']),
             **pmem),
         '},'
     )
 
+    dram_cache_instantiation_body = tuple(itertools.chain(*((
+        'dram_cache{',
+        dram_cache_fmtstr.format(
+            clock_period_dbus=int(1000000/d['data_rate']),
+            clock_period_mc=int(1000000/d['frequency']),
+            _tRP=int(d['tRP']),
+            _tRCD=int(d['tRCD']),
+            _tCAS=int(d['tCAS']),
+            _tRAS=int(d['tRAS']),
+            _refresh_period=int(1000*d['refresh_period']),
+            _params=get_dram_cache_params(d),
+            _ulptr=', '.join(f'&channels.at({ul_pairs.index(v)})' for v in ul_pairs if v[0] == d['name']),
+            _llptr=f'channels.at({ul_pairs.index((d["lower_level"], d["name"]))})',
+            **d),
+        '},'
+    ) for d in dram_caches)))
+
+    # Pages are colored by the sets of the caches next to memory
+    memory_names = (pmem['name'], *(d['name'] for d in dram_caches))
     vmem_instantiation_body = (
         'vmem{',
         vmem_fmtstr.format(
             dram_name=pmem['name'], 
             clock_period=global_clock_period,
             _randomization= '{}' if (isinstance(vmem['randomization'],bool) and vmem['randomization'] == False) else int(vmem['randomization']),
+            _allocation=get_page_allocation_params(vmem, max((c.get('sets', 1) for c in caches if c.get('lower_level') in memory_names), default=1)),
+            _profile_params=get_page_profile_params(vmem),
             **vmem),
         '},',
     )
@@ -386,6 +538,7 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
     )
     yield from channel_instantiation_body
     yield from pmem_instantiation_body
+    yield from dram_cache_instantiation_body
     yield from vmem_instantiation_body
     yield from ptw_instantiation_body
     yield from cache_instantiation_body
@@ -409,23 +562,61 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
         'std::transform(std::begin(cores), std::end(cores), std::back_inserter(retval), make_ref);',
         'std::transform(std::begin(caches), std::end(caches), std::back_inserter(retval), make_ref);',
         'std::transform(std::begin(ptws), std::end(ptws), std::back_inserter(retval), make_ref);',
+        'if (dram_cache.has_value()) {',
+        '  retval.push_back(std::ref<champsim::operable>(*dram_cache));',
+        '}',
         'retval.push_back(std::ref<champsim::operable>(DRAM));',
+        'for (auto& link : link_view()) {',
+        '  retval.push_back(std::ref<champsim::operable>(link.get()));',
+        '}',
         'return retval;'
     ), rtype='std::vector<std::reference_wrapper<champsim::operable>>')
     yield ''
 
+    yield from cxx.function(f'{classname}::link_view', (
+        'std::vector<std::reference_wrapper<champsim::channel>> retval{};',
+        'std::copy_if(std::begin(channels), std::end(channels), std::back_inserter(retval), [](const auto& x) { return x.timed(); });',
+        'return retval;'
+    ), rtype='std::vector<std::reference_wrapper<champsim::channel>>')
+    yield ''
+
     yield from cxx.function(f'{classname}::dram_view', [f'return {pmem["name"]};'], rtype='MEMORY_CONTROLLER&')
     yield ''
 
+    yield from cxx.function(f'{classname}::dram_cache_view', (
+        'std::vector<std::reference_wrapper<DRAM_CACHE>> retval{};',
+        'if (dram_cache.has_value()) {',
+        '  retval.push_back(std::ref(*dram_cache));',
+        '}',
+        'return retval;'
+    ), rtype='std::vector<std::reference_wrapper<DRAM_CACHE>>')
+    yield ''
+
+def get_constants_header(env):
+    ''' Produce the compile-time block and page geometry shared by every translation unit. '''
+    for name in ('block_size', 'page_size'):
+        if env[name] <= 0 or (env[name] & (env[name] - 1)) != 0:
+            raise ValueError(f'The {name} must be a power of two')
+
+    yield '#ifndef CHAMPSIM_CONSTANTS_H'
+    yield '#define CHAMPSIM_CONSTANTS_H'
+    yield f'constexpr unsigned BLOCK_SIZE = {env["block_size"]};'
+    yield f'constexpr unsigned PAGE_SIZE = {env["page_size"]};'
+    yield f'constexpr unsigned LOG2_BLOCK_SIZE = {env["block_size"].bit_length() - 1};'
+    yield f'constexpr unsigned LOG2_PAGE_SIZE = {env["page_size"].bit_length() - 1};'
+    yield '#endif'
+
 def get_instantiation_header(num_cpus, env, build_id):
     yield '#include "environment.h"'
     yield '#include "vmem.h"'
     yield '#include <forward_list>'
+    yield '#include <optional>'
     yield 'template <>'
     struct_body = (
         'private:',
         'std::vector<champsim::channel> channels;',
         'MEMORY_CONTROLLER DRAM;',
+        'std::optional<DRAM_CACHE> dram_cache;',
         'VirtualMemory vmem;',
         'std::forward_list<PageTableWalker> ptws;',
         'std::forward_list<CACHE> caches;',
@@ -441,6 +632,8 @@ def get_instantiation_header(num_cpus, env, build_id):
         'std::vector<std::reference_wrapper<CACHE>> cache_view() final;',
         'std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final;',
         'MEMORY_CONTROLLER& dram_view() final;',
+        'std::vector<std::reference_wrapper<DRAM_CACHE>> dram_cache_view() final;',
+        'std::vector<std::reference_wrapper<champsim::channel>> link_view() final;',
         'std::vector<std::reference_wrapper<operable>> operable_view() final;'
     )
     struct_name = f'champsim::configured::generated_environment<0x{build_id}> final'
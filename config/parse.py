@@ -99,6 +99,44 @@ def split_string_or_list(val, delim=','):
         return [v for v in retval if v]
     return val
 
+def cache_block_size(cache, root_config):
+    ''' The block size of a data cache, which defaults to the block size of the system '''
+    return int_or_prefixed_size(cache.get('block_size', root_config['block_size']))
+
+def dram_cache_defaults(dram_cache, pmem, root_config):
+    '''
+    Apply the defaults for a DRAM cache, whose timing is that of an HBM-like device.
+    The alloy organization is direct-mapped with one block per frame, while the unison organization allocates pages into a set-associative array.
+    '''
+    organization = dram_cache.get('organization', 'alloy')
+    if organization not in ('alloy', 'unison'):
+        raise ValueError(f'Unknown DRAM cache organization {organization}')
+
+    if organization == 'unison':
+        geometry = { 'page_size': 1024, 'ways': 4 }
+    else:
+        geometry = { 'page_size': root_config['block_size'], 'ways': 1 }
+
+    retval = util.chain(
+        { k: int_or_prefixed_size(v) for k,v in util.subdict(dram_cache, ('size', 'page_size')).items() },
+        dram_cache,
+        geometry,
+        {
+            'name': 'DRAM_CACHE', 'lower_level': pmem['name'], 'organization': organization, 'size': int_or_prefixed_size('256MiB'),
+            'miss_predictor': 'map_i', 'mshr_size': 64, 'predictor_size': 256, 'footprint_table_size': 1024,
+            'data_rate': 2000, 'frequency': 1000, 'channels': 8, 'ranks': 1, 'bankgroups': 4, 'banks': 4, 'bank_columns': 128,
+            'channel_width': 16, 'wq_size': 64, 'rq_size': 64, 'tRP': 14, 'tRCD': 14, 'tCAS': 14, 'tRAS': 33,
+            'refresh_period': 32, 'refreshes_per_period': 8192
+        }
+    )
+
+    # Each page is tracked with one bit per block
+    blocks_per_page = retval['page_size'] // root_config['block_size']
+    if retval['page_size'] % root_config['block_size'] != 0 or blocks_per_page & (blocks_per_page - 1) != 0 or not 1 <= blocks_per_page <= 64:
+        raise ValueError('The DRAM cache page size must be a power-of-two multiple of the block size, of at most 64 blocks')
+
+    return retval
+
 def int_or_prefixed_size(val):
     '''
     Convert a string value to an integer. The following sizes are recognized:
@@ -234,7 +272,7 @@ class NormalizedConfiguration:
                 'frequency', 'ifetch_buffer_size', 'decode_buffer_size', 'dispatch_buffer_size', 'register_file_size', 'rob_size', 'lq_size',
                 'sq_size', 'fetch_width', 'decode_width', 'dispatch_width', 'execute_width', 'lq_width', 'sq_width',
                 'retire_width', 'mispredict_penalty', 'scheduler_size', 'decode_latency', 'dispatch_latency',
-                'schedule_latency', 'execute_latency', 'branch_predictor', 'btb', 'DIB'
+                'schedule_latency', 'execute_latency', 'class_execute_latency', 'branch_predictor', 'btb', 'DIB', 'model'
             )
         )
         self.cores = [util.chain(cpu, core_from_config, {'name': f'cpu{i}'}) for i,cpu in enumerate(self.cores)]
@@ -287,6 +325,18 @@ class NormalizedConfiguration:
         if verbose:
             print('P: pmem', list(self.pmem.keys()))
 
+        # A DRAM cache is only present if it is configured
+        self.dram_cache = config_file.get('dram_cache')
+        if self.dram_cache is not None:
+            if 'frequency' in self.dram_cache.keys():
+                self.dram_cache['data_rate'] = self.dram_cache['frequency']
+                self.dram_cache['frequency'] = self.dram_cache['frequency']/2
+            elif 'data_rate' in self.dram_cache.keys():
+                self.dram_cache['frequency'] = self.dram_cache['data_rate']/2
+
+            if verbose:
+                print('P: dram_cache', list(self.dram_cache.keys()))
+
         self.vmem = config_file.get('virtual_memory', {})
 
         if verbose:
@@ -302,10 +352,12 @@ class NormalizedConfiguration:
         self.caches = util.chain(self.caches, rhs.caches)
         self.ptws = util.chain(self.ptws, rhs.ptws)
         self.pmem = util.chain(self.pmem, rhs.pmem)
+        if self.dram_cache is not None or rhs.dram_cache is not None:
+            self.dram_cache = util.chain(self.dram_cache or {}, rhs.dram_cache or {})
         self.vmem = util.chain(self.vmem, rhs.vmem)
         self.root = util.chain(self.root, rhs.root)
 
-    def apply_defaults_in(self, branch_context, btb_context, prefetcher_context, replacement_context, verbose=False):
+    def apply_defaults_in(self, branch_context, btb_context, prefetcher_context, replacement_context, dram_prefetcher_context=None, verbose=False): # pylint: disable=line-too-long,
         ''' Apply defaults and produce a result suitible for writing the generated files. '''
         if verbose:
             print('D: keys in root', list(self.root.keys()))
@@ -331,9 +383,19 @@ class NormalizedConfiguration:
         pmem = util.chain(self.pmem, {
             'name': 'DRAM', 'data_rate': 3200, 'frequency': 1600, 'channels': 1, 'ranks': 1, 'bankgroups': 8, 'banks': 4, 'bank_rows': 65536, 'bank_columns': 1024,
             'channel_width': 8, 'wq_size': 64, 'rq_size': 64, 'tRP': 24, 'tRCD': 24, 'tCAS': 24, 'tRAS' : 52,
-            'refresh_period': 32, 'refreshes_per_period': 8192
+            'refresh_period': 32, 'refreshes_per_period': 8192,
+            'prefetcher': 'no', 'prefetch_mode': 'buffer', 'prefetch_buffer_size': 16, 'prefetch_degree': 2
         })
         pmem = util.chain(pmem,(do_deprecation(pmem, pmem_deprecation_keys,pmem_deprecation_warnings)))
+
+        # Memory-side prefetchers are modules. Unlike the caches, the physical memory has no "no" module.
+        if dram_prefetcher_context is None:
+            dram_prefetcher_context = modules.ModuleSearchContext([])
+        pmem['_dram_prefetcher_data'] = [module_parse(m, dram_prefetcher_context) for m in util.wrap_list(pmem['prefetcher']) if m not in ('no', 'none')]
+
+        dram_cache = None
+        if self.dram_cache is not None:
+            dram_cache = dram_cache_defaults(self.dram_cache, pmem, root_config)
         
         #convert vmem boolean to string
         vmem = util.chain(
@@ -366,6 +428,11 @@ class NormalizedConfiguration:
                 **module_parse(mod_name, prefetcher_context)
             }
 
+        # The cores find their returned requests by the system block size
+        for name in itertools.chain(*path_root_names[:2]):
+            if name in caches and cache_block_size(caches[name], root_config) // caches[name].get('sectors', 1) != root_config['block_size']:
+                raise ValueError(f'The first-level cache {name} must fill blocks of the system block size')
+
         tlb_path = itertools.chain(*(util.iter_system(caches, name) for name in itertools.chain(*path_root_names[2:])))
         data_path = itertools.chain(*(util.iter_system(caches, name) for name in itertools.chain(*path_root_names[:2])))
         caches = util.combine_named(
@@ -374,9 +441,13 @@ class NormalizedConfiguration:
                'prefetch_activate': split_string_or_list(cache['prefetch_activate'])
             } for k,cache in caches.items() if 'prefetch_activate' in cache),
 
-            # TLBs use page offsets, Caches use block offsets
+            # TLBs use page offsets, Caches use block offsets. Requests into a sectored cache are merged by sector.
             ({'name': c['name'], '_offset_bits': f'champsim::lg2({root_config["page_size"]})'} for c in tlb_path),
-            ({'name': c['name'], '_offset_bits': f'champsim::lg2({root_config["block_size"]})'} for c in data_path),
+            ({
+                'name': c['name'],
+                '_offset_bits': f'champsim::lg2({cache_block_size(c, root_config)})',
+                '_queue_offset_bits': f'champsim::lg2({cache_block_size(c, root_config) // c.get("sectors", 1)})'
+            } for c in data_path),
 
             # Unfold suffixed strings
             ({'name': c['name'], **transform_for_keys(c, ('size',), int_or_prefixed_size)} for c in caches.values()),
@@ -408,6 +479,13 @@ class NormalizedConfiguration:
             } for k,cache in caches.items())
         )
 
+        # The DRAM cache is inserted above the physical memory
+        if dram_cache is not None:
+            caches = util.combine_named(
+                ({'name': k, 'lower_level': dram_cache['name']} for k,cache in caches.items() if cache.get('lower_level') == pmem['name']),
+                caches.values()
+            )
+
         ptws = util.combine_named(
             ptws.values(),
 
@@ -434,13 +512,15 @@ class NormalizedConfiguration:
             'caches': tuple(caches.values()),
             'ptws': tuple(ptws.values()),
             'pmem': pmem,
-            'vmem': vmem
+            'vmem': vmem,
+            'dram_cache': dram_cache
         }
         module_info = {
             'repl': util.combine_named(*(c['_replacement_data'] for c in caches.values()), replacement_context.find_all()),
             'pref': util.combine_named(*(c['_prefetcher_data'] for c in caches.values()), prefetcher_context.find_all()),
             'branch': util.combine_named(*(c['_branch_predictor_data'] for c in cores), branch_context.find_all()),
-            'btb': util.combine_named(*(c['_btb_data'] for c in cores), btb_context.find_all())
+            'btb': util.combine_named(*(c['_btb_data'] for c in cores), btb_context.find_all()),
+            'dram_pref': util.combine_named(pmem['_dram_prefetcher_data'], dram_prefetcher_context.find_all())
         }
 
         config_extern = {
@@ -450,7 +530,7 @@ class NormalizedConfiguration:
 
         return elements, module_info, config_extern
 
-def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_dir=None, repl_dir=None, compile_all_modules=False, verbose=False): # pylint: disable=line-too-long,
+def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_dir=None, repl_dir=None, dram_pref_dir=None, compile_all_modules=False, verbose=False): # pylint: disable=line-too-long,
     '''
     This is the main parsing dispatch function. Programmatic use of the configuration system should use this as an entry point.
 
@@ -460,6 +540,7 @@ def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_
     :param btb_dir: A directory to search for branch target predictors
     :param pref_dir: A directory to search for prefetchers
     :param repl_dir: A directory to search for replacement policies
+    :param dram_pref_dir: A directory to search for memory-side prefetchers
     :param compile_all_modules: If true, all modules in the given directories will be compiled. If false, only the module in the configuration will be compiled.
     :param verbose: Print extra verbose output
     '''
@@ -479,7 +560,8 @@ def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_
         branch_context = modules.ModuleSearchContext(list_dirs('branch', branch_dir or []), verbose=verbose),
         btb_context = modules.ModuleSearchContext(list_dirs('btb', btb_dir or []), verbose=verbose),
         replacement_context = modules.ModuleSearchContext(list_dirs('replacement', repl_dir or []), verbose=verbose),
-        prefetcher_context = modules.ModuleSearchContext(list_dirs('prefetcher', pref_dir or []), verbose=verbose)
+        prefetcher_context = modules.ModuleSearchContext(list_dirs('prefetcher', pref_dir or []), verbose=verbose),
+        dram_prefetcher_context = modules.ModuleSearchContext(list_dirs('dram_prefetcher', dram_pref_dir or []), verbose=verbose)
     )
     if verbose:
         for k,v in contexts.items():
@@ -493,7 +575,8 @@ def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_
             *(c['_replacement_data'] for c in elements['caches']),
             *(c['_prefetcher_data'] for c in elements['caches']),
             *(c['_branch_predictor_data'] for c in elements['cores']),
-            *(c['_btb_data'] for c in elements['cores'])
+            *(c['_btb_data'] for c in elements['cores']),
+            elements['pmem']['_dram_prefetcher_data']
         ))]
 
     return executable_name(*configs), elements, modules_to_compile, module_info, config_file
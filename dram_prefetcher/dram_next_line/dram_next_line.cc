@@ -0,0 +1,14 @@
+#include "dram_next_line.h"
+
+#include "dram_controller.h"
+
+void dram_next_line::dram_prefetcher_operate(champsim::address addr, bool buffer_hit)
+{
+  champsim::block_number block{addr};
+  for (std::size_t i = 1; i <= intern_->prefetch_degree(); ++i) {
+    auto pf_block = block + static_cast<champsim::block_number::difference_type>(i);
+    if (champsim::page_number{pf_block} != champsim::page_number{block})
+      break;
+    prefetch_line(champsim::address{pf_block});
+  }
+}
@@ -0,0 +1,15 @@
+#ifndef DRAM_PREFETCHER_NEXT_LINE_H
+#define DRAM_PREFETCHER_NEXT_LINE_H
+
+#include "address.h"
+#include "modules.h"
+
+struct dram_next_line : public champsim::modules::dram_prefetcher {
+  using dram_prefetcher::dram_prefetcher;
+  void dram_prefetcher_operate(champsim::address addr, bool buffer_hit);
+
+  // void dram_prefetcher_initialize() {}
+  // void dram_prefetcher_final_stats() {}
+};
+
+#endif
@@ -0,0 +1,30 @@
+#include "dram_stream.h"
+
+#include "dram_controller.h"
+
+void dram_stream::dram_prefetcher_operate(champsim::address addr, bool buffer_hit)
+{
+  champsim::block_number block{addr};
+  champsim::page_number page{addr};
+
+  // Wait for two steps in the same direction within a page before prefetching
+  auto found = stream_table.check_hit({page});
+  auto entry = found.value_or(stream_entry{page, block, 0, false});
+  if (found.has_value() && block != found->last_block) {
+    champsim::block_number::difference_type step_direction = (block > found->last_block) ? 1 : -1;
+    entry.confirmed = (step_direction == entry.direction);
+    entry.direction = step_direction;
+    entry.last_block = block;
+  }
+  stream_table.fill(entry);
+
+  if (!entry.confirmed)
+    return;
+
+  for (std::size_t i = 1; i <= intern_->prefetch_degree(); ++i) {
+    auto pf_block = block + entry.direction * static_cast<champsim::block_number::difference_type>(i);
+    if (champsim::page_number{pf_block} != page)
+      break;
+    prefetch_line(champsim::address{pf_block});
+  }
+}
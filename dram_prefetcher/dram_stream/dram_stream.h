@@ -0,0 +1,27 @@
+#ifndef DRAM_PREFETCHER_STREAM_H
+#define DRAM_PREFETCHER_STREAM_H
+
+#include "address.h"
+#include "modules.h"
+#include "msl/lru_table.h"
+
+struct dram_stream : public champsim::modules::dram_prefetcher {
+  struct stream_entry {
+    champsim::page_number page{};
+    champsim::block_number last_block{};
+    champsim::block_number::difference_type direction = 0;
+    bool confirmed = false;
+  };
+  struct stream_indexer {
+    auto operator()(const stream_entry& entry) const { return entry.page; }
+  };
+
+  constexpr static std::size_t TRACKERS = 16;
+
+  champsim::msl::lru_table<stream_entry, stream_indexer, stream_indexer> stream_table{1, TRACKERS};
+
+  using dram_prefetcher::dram_prefetcher;
+  void dram_prefetcher_operate(champsim::address addr, bool buffer_hit);
+};
+
+#endif
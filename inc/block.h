@@ -18,6 +18,7 @@
 #define BLOCK_H
 
 #include "champsim.h"
+#include "chrono.h"
 
 namespace champsim
 {
@@ -26,11 +27,17 @@ struct cache_block {
   bool prefetch = false;
   bool dirty = false;
 
+  // The sectors of the block that are present and that have been written. A block that is not sectored has a single sector.
+  uint64_t valid_sectors = 0;
+  uint64_t dirty_sectors = 0;
+
   champsim::address address{};
   champsim::address v_address{};
   champsim::address data{};
 
   uint32_t pf_metadata = 0;
+
+  champsim::chrono::clock::time_point fill_time{};
 };
 } // namespace champsim
 
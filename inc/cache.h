@@ -22,6 +22,7 @@
 #undef CHAMPSIM_MODULE
 #endif
 
+#include <algorithm>
 #include <array>
 #include <cstddef> // for size_t
 #include <cstdint> // for uint64_t, uint32_t, uint8_t
@@ -29,6 +30,7 @@
 #include <iterator> // for size
 #include <limits>   // for numeric_limits
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -42,11 +44,16 @@
 #include "champsim.h"
 #include "channel.h"
 #include "chrono.h"
+#include "energy.h"
 #include "modules.h"
+#include "msl/lru_table.h"
 #include "operable.h"
+#include "prefetch_filter.h"
 #include "util/to_underlying.h" // for to_underlying
 #include "waitable.h"
 
+class MEMORY_CONTROLLER;
+
 class CACHE : public champsim::operable
 {
   enum [[deprecated(
@@ -105,6 +112,9 @@ public:
 
     champsim::chrono::clock::time_point time_enqueued;
 
+    // The pieces of the fill that the lower level has yet to return, if the lower level has smaller blocks than this cache
+    uint64_t parts_pending = 1;
+
     std::vector<uint64_t> instr_depend_on_me{};
     std::vector<std::deque<response_type>*> to_return{};
 
@@ -116,7 +126,12 @@ private:
   bool try_hit(const tag_lookup_type& handle_pkt);
   bool handle_fill(const mshr_type& fill_mshr);
   bool handle_miss(const tag_lookup_type& handle_pkt);
+  [[nodiscard]] bool mshr_available(access_type type) const;
   bool handle_write(const tag_lookup_type& handle_pkt);
+  bool handle_write_around(const tag_lookup_type& handle_pkt);
+  void buffer_write(champsim::address address, champsim::address v_address, uint32_t triggering_cpu, uint64_t instr_id);
+  long drain_write_buffer();
+  long issue_eager_writeback();
   void finish_packet(const response_type& packet);
   void finish_translation(const response_type& packet);
 
@@ -126,8 +141,17 @@ public:
   using BLOCK = champsim::cache_block;
 
 private:
-  static BLOCK fill_block(mshr_type mshr, uint32_t metadata);
+  BLOCK fill_block(mshr_type mshr, uint32_t metadata) const;
   using set_type = std::vector<BLOCK>;
+  using side_type = std::deque<BLOCK>;
+
+  bool write_back(const BLOCK& victim, uint32_t triggering_cpu, uint64_t instr_id);
+  bool make_room(side_type& side, std::size_t capacity, uint32_t triggering_cpu, uint64_t instr_id);
+  void absorb_side_copies(BLOCK& fill);
+  void record_prefetch_eviction(const BLOCK& victim, bool by_prefetch);
+  void record_miss(const tag_lookup_type& handle_pkt);
+  std::pair<set_type::iterator, BLOCK*> check_side_structures(const tag_lookup_type& handle_pkt);
+  set_type::iterator promote(side_type& side, side_type::iterator found, const tag_lookup_type& handle_pkt);
 
   std::pair<set_type::iterator, set_type::iterator> get_set_span(champsim::address address);
   [[nodiscard]] std::pair<set_type::const_iterator, set_type::const_iterator> get_set_span(champsim::address address) const;
@@ -143,30 +167,81 @@ private:
   champsim::address module_address(const T& element) const;
 
   auto matches_address(champsim::address address) const;
+  auto matches_sector(champsim::address address) const;
+  [[nodiscard]] uint64_t sector_mask(champsim::address address) const;
+  [[nodiscard]] champsim::address sector_address(champsim::address address, std::size_t sector) const;
+  [[nodiscard]] champsim::data::bits lower_offset_bits() const;
+  [[nodiscard]] std::vector<champsim::address> lower_level_parts(champsim::address address) const;
+  [[nodiscard]] uint64_t part_mask(champsim::address address) const;
+  [[nodiscard]] uint64_t filter_key(champsim::address address) const;
   std::pair<mshr_type, request_type> mshr_and_forward_packet(const tag_lookup_type& handle_pkt);
 
   std::deque<tag_lookup_type> internal_PQ{};
   std::deque<tag_lookup_type> inflight_tag_check{};
   std::deque<tag_lookup_type> translation_stash{};
 
+  // Writes of a write-through cache, or writes that did not allocate, waiting to be sent to the lower level
+  std::deque<request_type> write_buffer{};
+
+  // The next set to be examined for an eager writeback
+  long eager_writeback_set = 0;
+
 public:
   std::vector<channel_type*> upper_levels;
   channel_type* lower_level;
   channel_type* lower_translate;
+  const MEMORY_CONTROLLER* memory_controller; // read-only, for bandwidth telemetry. May be null.
 
   uint32_t cpu = 0;
   std::string NAME;
   uint32_t NUM_SET, NUM_WAY, MSHR_SIZE;
+  uint32_t MSHR_DEMAND_RESERVE, MSHR_PREFETCH_LIMIT;
   std::size_t PQ_SIZE;
   champsim::chrono::clock::duration HIT_LATENCY;
   champsim::chrono::clock::duration FILL_LATENCY;
   champsim::data::bits OFFSET_BITS;
+  champsim::data::bits SECTOR_OFFSET_BITS;
   set_type block{static_cast<typename set_type::size_type>(NUM_SET * NUM_WAY)};
+
+  // Small fully associative structures beside the main array, each ordered from the most to the least recently used
+  std::size_t VICTIM_CACHE_SIZE, PREFETCH_BUFFER_SIZE;
+  side_type victim_cache{};
+  side_type prefetch_buffer{};
+
   champsim::bandwidth::maximum_type MAX_TAG, MAX_FILL;
   bool prefetch_as_load;
   bool match_offset_bits;
   bool virtual_prefetch;
+  bool demand_priority;
+  bool fixed_priority;
+  bool write_through;
+  bool write_allocate;
+  bool eager_writeback;
+  std::size_t WRITE_BUFFER_SIZE;
+  std::size_t IP_ATTRIBUTION_SIZE;
   std::vector<access_type> pref_activate_mask;
+  std::optional<champsim::prefetch_filter> pf_filter;
+
+  // The energy of each access to the tag and data arrays
+  champsim::access_energy tag_energy, data_energy;
+
+  // Blocks recently evicted without use after being prefetched, or evicted to make room for a prefetch.
+  // A demand miss to one of these blocks means that the prefetch came too early, or polluted the cache.
+  // The window has a fixed size, rather than one that grows with the cache, since only the recent evictions are likely to be demanded again.
+  constexpr static std::size_t PREFETCH_EVICTION_SETS = 64;
+  constexpr static std::size_t PREFETCH_EVICTION_WAYS = 8;
+  struct prefetch_eviction {
+    uint64_t block;
+    bool by_prefetch;
+  };
+  struct prefetch_eviction_indexer {
+    auto operator()(const prefetch_eviction& entry) const { return entry.block; }
+  };
+  champsim::msl::lru_table<prefetch_eviction, prefetch_eviction_indexer, prefetch_eviction_indexer> prefetch_evictions{
+      PREFETCH_EVICTION_SETS, PREFETCH_EVICTION_WAYS};
+
+  // The virtual address of each block that leaves the cache, by eviction or invalidation, is appended to these queues.
+  std::vector<std::deque<champsim::address>*> eviction_listeners{};
 
   using stats_type = cache_stats;
 
@@ -244,6 +319,7 @@ public:
     virtual void impl_initialize_replacement() = 0;
     virtual long impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const BLOCK* current_set, champsim::address ip,
                                   champsim::address full_addr, access_type type) = 0;
+    [[nodiscard]] virtual std::optional<long> impl_peek_victim(long set, const BLOCK* current_set) const = 0;
     virtual void impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                                champsim::address victim_addr, access_type type, bool hit) = 0;
     virtual void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
@@ -285,6 +361,7 @@ public:
     void impl_initialize_replacement() final;
     [[nodiscard]] long impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const BLOCK* current_set, champsim::address ip,
                                         champsim::address full_addr, access_type type) final;
+    [[nodiscard]] std::optional<long> impl_peek_victim(long set, const BLOCK* current_set) const final;
     void impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                        champsim::address victim_addr, access_type type, bool hit) final;
     void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
@@ -308,6 +385,7 @@ public:
   void impl_initialize_replacement() const;
   [[nodiscard]] long impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const BLOCK* current_set, champsim::address ip,
                                       champsim::address full_addr, access_type type) const;
+  [[nodiscard]] std::optional<long> impl_peek_victim(long set, const BLOCK* current_set) const;
   void impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                      champsim::address victim_addr, access_type type, bool hit) const;
   void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
@@ -317,11 +395,18 @@ public:
 
   template <typename... Ps, typename... Rs>
   explicit CACHE(champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, champsim::cache_builder_module_type_holder<Rs...>> b)
-      : champsim::operable(b.m_clock_period), upper_levels(b.m_uls), lower_level(b.m_ll), lower_translate(b.m_lt), NAME(b.m_name), NUM_SET(b.get_num_sets()),
-        NUM_WAY(b.get_num_ways()), MSHR_SIZE(b.get_num_mshrs()), PQ_SIZE(b.m_pq_size), HIT_LATENCY(b.get_hit_latency() * b.m_clock_period),
-        FILL_LATENCY(b.get_fill_latency() * b.m_clock_period), OFFSET_BITS(b.m_offset_bits), MAX_TAG(b.get_tag_bandwidth()), MAX_FILL(b.get_fill_bandwidth()),
-        prefetch_as_load(b.m_pref_load), match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), pref_activate_mask(b.m_pref_act_mask),
-        pref_module_pimpl(std::make_unique<prefetcher_module_model<Ps...>>(this)), repl_module_pimpl(std::make_unique<replacement_module_model<Rs...>>(this))
+      : champsim::operable(b.m_clock_period), upper_levels(b.m_uls), lower_level(b.m_ll), lower_translate(b.m_lt), memory_controller(b.m_mc), NAME(b.m_name),
+        NUM_SET(b.get_num_sets()), NUM_WAY(b.get_num_ways()), MSHR_SIZE(b.get_num_mshrs()), MSHR_DEMAND_RESERVE(b.get_mshr_demand_reserve()),
+        MSHR_PREFETCH_LIMIT(b.get_mshr_prefetch_limit()), PQ_SIZE(b.m_pq_size), HIT_LATENCY(b.get_hit_latency() * b.m_clock_period),
+        FILL_LATENCY(b.get_fill_latency() * b.m_clock_period), OFFSET_BITS(b.m_offset_bits),
+        SECTOR_OFFSET_BITS{champsim::to_underlying(b.m_offset_bits) - champsim::lg2(b.get_num_sectors())}, VICTIM_CACHE_SIZE(b.m_victim_entries),
+        PREFETCH_BUFFER_SIZE(b.m_pf_buffer_entries), MAX_TAG(b.get_tag_bandwidth()), MAX_FILL(b.get_fill_bandwidth()), prefetch_as_load(b.m_pref_load),
+        match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), demand_priority(b.m_demand_priority), fixed_priority(b.m_fixed_priority),
+        write_through(b.m_write_through), write_allocate(b.m_write_allocate), eager_writeback(b.m_eager_writeback), WRITE_BUFFER_SIZE(b.m_write_buffer_size),
+        IP_ATTRIBUTION_SIZE(b.m_ip_attribution), pref_activate_mask(b.m_pref_act_mask),
+        pf_filter(b.m_pref_filter ? std::optional<champsim::prefetch_filter>{std::in_place, NUM_SET * NUM_WAY + MSHR_SIZE} : std::nullopt),
+        tag_energy(b.get_tag_energy()), data_energy(b.get_data_energy()), pref_module_pimpl(std::make_unique<prefetcher_module_model<Ps...>>(this)),
+        repl_module_pimpl(std::make_unique<replacement_module_model<Rs...>>(this))
   {
   }
 
@@ -465,6 +550,20 @@ long CACHE::replacement_module_model<Rs...>::impl_find_victim(uint32_t triggerin
   return return_type{};
 }
 
+template <typename... Rs>
+std::optional<long> CACHE::replacement_module_model<Rs...>::impl_peek_victim(long set, const BLOCK* current_set) const
+{
+  std::optional<long> retval{};
+  [[maybe_unused]] auto process_one = [&](const auto& r) {
+    using namespace champsim::modules;
+    if constexpr (replacement::has_peek_victim<decltype(r), long, const BLOCK*>)
+      retval = r.peek_victim(set, current_set);
+  };
+
+  std::apply([&](const auto&... r) { (..., process_one(r)); }, intern_);
+  return retval;
+}
+
 template <typename... Rs>
 void CACHE::replacement_module_model<Rs...>::impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr,
                                                                            champsim::address ip, champsim::address victim_addr, access_type type, bool hit)
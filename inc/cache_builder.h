@@ -26,10 +26,12 @@
 #include "champsim.h"
 #include "channel.h"
 #include "chrono.h"
+#include "energy.h"
 #include "util/bits.h"
 #include "util/to_underlying.h"
 
 class CACHE;
+class MEMORY_CONTROLLER;
 namespace champsim
 {
 class channel;
@@ -48,20 +50,36 @@ struct cache_builder_base {
   std::optional<uint32_t> m_ways{};
   std::size_t m_pq_size{std::numeric_limits<std::size_t>::max()};
   std::optional<uint32_t> m_mshr_size{};
+  uint32_t m_mshr_demand_reserve{};
+  std::optional<uint32_t> m_mshr_prefetch_limit{};
   std::optional<uint64_t> m_hit_lat{};
   std::optional<uint64_t> m_fill_lat{};
   std::optional<uint64_t> m_latency{};
   std::optional<champsim::bandwidth::maximum_type> m_max_tag{};
   std::optional<champsim::bandwidth::maximum_type> m_max_fill{};
+  champsim::partial_access_energy m_tag_energy{};
+  champsim::partial_access_energy m_data_energy{};
   champsim::data::bits m_offset_bits{LOG2_BLOCK_SIZE};
+  uint32_t m_sectors{1};
   bool m_pref_load{};
   bool m_wq_full_addr{};
   bool m_va_pref{};
+  bool m_pref_filter{};
+  bool m_demand_priority{};
+  bool m_fixed_priority{};
+  bool m_write_through{};
+  bool m_write_allocate{true};
+  bool m_eager_writeback{};
+  std::size_t m_write_buffer_size{8};
+  std::size_t m_ip_attribution{0};
+  std::size_t m_victim_entries{};
+  std::size_t m_pf_buffer_entries{};
 
   std::vector<access_type> m_pref_act_mask{access_type::LOAD, access_type::PREFETCH};
   std::vector<champsim::channel*> m_uls{};
   champsim::channel* m_ll{};
   champsim::channel* m_lt{nullptr};
+  const MEMORY_CONTROLLER* m_mc{nullptr};
 };
 } // namespace detail
 
@@ -82,11 +100,16 @@ class cache_builder : public detail::cache_builder_base
   uint32_t get_num_sets() const;
   uint32_t get_num_ways() const;
   uint32_t get_num_mshrs() const;
+  uint32_t get_mshr_demand_reserve() const;
+  uint32_t get_mshr_prefetch_limit() const;
+  uint32_t get_num_sectors() const;
   champsim::bandwidth::maximum_type get_tag_bandwidth() const;
   champsim::bandwidth::maximum_type get_fill_bandwidth() const;
   uint64_t get_hit_latency() const;
   uint64_t get_fill_latency() const;
   uint64_t get_total_latency() const;
+  champsim::access_energy get_tag_energy() const;
+  champsim::access_energy get_data_energy() const;
 
 public:
   cache_builder() = default;
@@ -146,6 +169,18 @@ public:
    */
   self_type& mshr_size(uint32_t mshr_size_);
 
+  /**
+   * Specify the number of MSHRs that are held back for demand misses.
+   * A prefetch may not allocate an MSHR if it would leave fewer than this many free.
+   */
+  self_type& mshr_demand_reserve(uint32_t reserve_);
+
+  /**
+   * Specify the largest number of MSHRs that prefetches may occupy at once.
+   * If this is not specified, prefetches may occupy every MSHR that is not reserved for demand misses.
+   */
+  self_type& mshr_prefetch_limit(uint32_t limit_);
+
   /**
    * Specify the latency of the cache, in cycles.
    * If the hit latency and fill latency are not specified, this will be distributed evenly between them.
@@ -167,6 +202,18 @@ public:
    */
   self_type& tag_bandwidth(champsim::bandwidth::maximum_type max_read_);
 
+  /**
+   * Specify the energy of a lookup (read) and an update (write) of the tag array, and its leakage.
+   * If this is not specified, it is estimated from the number of sets and ways.
+   */
+  self_type& tag_energy(champsim::partial_access_energy energy_);
+
+  /**
+   * Specify the energy of a read and a write of a block in the data array, and its leakage.
+   * If this is not specified, it is estimated from the size and associativity of the cache.
+   */
+  self_type& data_energy(champsim::partial_access_energy energy_);
+
   /**
    * Specify the bandwidth of the cache fill.
    */
@@ -182,6 +229,13 @@ public:
    */
   self_type& log2_offset_bits(unsigned log2_offset_bits_);
 
+  /**
+   * Specify the number of sectors in each block.
+   * Each sector is valid and dirty independently, and a miss fetches only the sector that was requested.
+   * This is rounded up to a power of two, and may not exceed 64 or the number of bytes in the block.
+   */
+  self_type& sectors(uint32_t sectors_);
+
   /**
    * Specify that prefetches should be issued with the same priority as loads.
    */
@@ -212,6 +266,95 @@ public:
    */
   self_type& reset_virtual_prefetch();
 
+  /**
+   * Specify that prefetch candidates should be filtered before they enter the internal prefetch queue,
+   * dropping those that were recently issued or whose block may already be resident or in flight.
+   */
+  self_type& set_prefetch_filter();
+
+  /**
+   * Specify that all prefetch candidates should enter the internal prefetch queue.
+   */
+  self_type& reset_prefetch_filter();
+
+  /**
+   * Specify that demand requests from every upper level should begin their tag checks ahead of prefetches.
+   */
+  self_type& set_demand_priority();
+
+  /**
+   * Specify that each upper level's queues should begin their tag checks in turn, regardless of the type of request.
+   */
+  self_type& reset_demand_priority();
+
+  /**
+   * Specify that the upper levels should be served in a fixed order, each taking as much of the tag check bandwidth as it can before the next.
+   */
+  self_type& set_fixed_priority();
+
+  /**
+   * Specify that the upper levels should take turns being served first, with the tag check bandwidth shared equally among them.
+   */
+  self_type& reset_fixed_priority();
+
+  /**
+   * Specify that writes should be sent on to the lower level as they are made, through a write buffer that merges writes to the same block.
+   * Blocks in the cache are never dirty.
+   */
+  self_type& set_write_through();
+
+  /**
+   * Specify that writes should only mark the block dirty, to be written back when it is evicted.
+   */
+  self_type& reset_write_through();
+
+  /**
+   * Specify the number of blocks in the write buffer of a write-through cache.
+   * When the buffer is full, no more writes begin their tag checks.
+   */
+  self_type& write_buffer_size(std::size_t write_buffer_size_);
+
+  /**
+   * Specify the number of instruction addresses to report, by their demand misses.
+   * The misses are attributed with a bounded-memory sketch. Zero disables the attribution.
+   */
+  self_type& ip_attribution(std::size_t ip_attribution_);
+
+  /**
+   * Specify that a write that misses should allocate its block in the cache.
+   */
+  self_type& set_write_allocate();
+
+  /**
+   * Specify that a write that misses should be sent on to the lower level without allocating its block.
+   */
+  self_type& reset_write_allocate();
+
+  /**
+   * Specify that dirty blocks that are about to be evicted should be written back early, while the memory controller has no writes waiting.
+   * This is intended for the last-level cache, and requires a replacement policy that defines peek_victim().
+   */
+  self_type& set_eager_writeback();
+
+  /**
+   * Specify that dirty blocks should be written back only when they are evicted.
+   */
+  self_type& reset_eager_writeback();
+
+  /**
+   * Specify the number of blocks in a fully associative victim cache beside the main array.
+   * Blocks evicted from the main array are kept there, and are moved back into the main array when they are accessed again.
+   * A size of zero, the default, disables the victim cache.
+   */
+  self_type& victim_cache(std::size_t entries_);
+
+  /**
+   * Specify the number of blocks in a fully associative buffer for the prefetches issued by this cache.
+   * Prefetched blocks wait there until their first demand access, when they are moved into the main array.
+   * A size of zero, the default, fills prefetches directly into the main array.
+   */
+  self_type& prefetch_buffer(std::size_t entries_);
+
   /**
    * Specify the ``access_type`` values that should activate the prefetcher.
    */
@@ -233,6 +376,11 @@ public:
    */
   self_type& lower_translate(champsim::channel* lt_);
 
+  /**
+   * Specify the memory controller whose bandwidth telemetry is visible to this cache's modules.
+   */
+  self_type& memory_controller(const MEMORY_CONTROLLER* mc_);
+
   /**
    * Specify the cache prefetcher.
    */
@@ -278,6 +426,25 @@ auto champsim::cache_builder<P, R>::get_num_mshrs() const -> uint32_t
   return std::max(m_mshr_size.value_or(default_count), 1u);
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_mshr_demand_reserve() const -> uint32_t
+{
+  return std::min(m_mshr_demand_reserve, get_num_mshrs());
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_mshr_prefetch_limit() const -> uint32_t
+{
+  return std::min(m_mshr_prefetch_limit.value_or(get_num_mshrs()), get_num_mshrs());
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_num_sectors() const -> uint32_t
+{
+  const auto max_sectors = std::min<uint64_t>(64, uint64_t{1} << champsim::to_underlying(m_offset_bits));
+  return static_cast<uint32_t>(std::clamp<uint64_t>(champsim::next_pow2(m_sectors), 1, max_sectors));
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::get_tag_bandwidth() const -> champsim::bandwidth::maximum_type
 {
@@ -318,6 +485,21 @@ auto champsim::cache_builder<P, R>::get_total_latency() const -> uint64_t
   return std::max(latency, uint64_t{2});
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_tag_energy() const -> champsim::access_energy
+{
+  // Each tag, with its state bits, is taken to be 4 bytes
+  constexpr long long tag_entry_bytes = 4;
+  return m_tag_energy.value_or(champsim::estimate_energy(champsim::data::bytes{tag_entry_bytes * get_num_sets() * get_num_ways()}, get_num_ways()));
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_data_energy() const -> champsim::access_energy
+{
+  const auto capacity = champsim::data::bytes{(1ll << champsim::to_underlying(m_offset_bits)) * get_num_sets() * get_num_ways()};
+  return m_data_energy.value_or(champsim::estimate_energy(capacity, get_num_ways()));
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::name(std::string name_) -> self_type&
 {
@@ -395,6 +577,20 @@ auto champsim::cache_builder<P, R>::mshr_size(uint32_t mshr_size_) -> self_type&
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::mshr_demand_reserve(uint32_t reserve_) -> self_type&
+{
+  m_mshr_demand_reserve = reserve_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::mshr_prefetch_limit(uint32_t limit_) -> self_type&
+{
+  m_mshr_prefetch_limit = limit_;
+  return *this;
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::latency(uint64_t lat_) -> self_type&
 {
@@ -423,6 +619,20 @@ auto champsim::cache_builder<P, R>::tag_bandwidth(champsim::bandwidth::maximum_t
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::tag_energy(champsim::partial_access_energy energy_) -> self_type&
+{
+  m_tag_energy = energy_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::data_energy(champsim::partial_access_energy energy_) -> self_type&
+{
+  m_data_energy = energy_;
+  return *this;
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::fill_bandwidth(champsim::bandwidth::maximum_type max_write_) -> self_type&
 {
@@ -443,6 +653,13 @@ auto champsim::cache_builder<P, R>::log2_offset_bits(unsigned log2_offset_bits_)
   return offset_bits(champsim::data::bits{1ull << log2_offset_bits_});
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::sectors(uint32_t sectors_) -> self_type&
+{
+  m_sectors = sectors_;
+  return *this;
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::set_prefetch_as_load() -> self_type&
 {
@@ -485,6 +702,118 @@ auto champsim::cache_builder<P, R>::reset_virtual_prefetch() -> self_type&
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_prefetch_filter() -> self_type&
+{
+  m_pref_filter = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_prefetch_filter() -> self_type&
+{
+  m_pref_filter = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_write_through() -> self_type&
+{
+  m_write_through = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_write_through() -> self_type&
+{
+  m_write_through = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::write_buffer_size(std::size_t write_buffer_size_) -> self_type&
+{
+  m_write_buffer_size = write_buffer_size_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::ip_attribution(std::size_t ip_attribution_) -> self_type&
+{
+  m_ip_attribution = ip_attribution_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_write_allocate() -> self_type&
+{
+  m_write_allocate = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_write_allocate() -> self_type&
+{
+  m_write_allocate = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_eager_writeback() -> self_type&
+{
+  m_eager_writeback = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_eager_writeback() -> self_type&
+{
+  m_eager_writeback = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_demand_priority() -> self_type&
+{
+  m_demand_priority = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_demand_priority() -> self_type&
+{
+  m_demand_priority = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_fixed_priority() -> self_type&
+{
+  m_fixed_priority = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_fixed_priority() -> self_type&
+{
+  m_fixed_priority = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::victim_cache(std::size_t entries_) -> self_type&
+{
+  m_victim_entries = entries_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::prefetch_buffer(std::size_t entries_) -> self_type&
+{
+  m_pf_buffer_entries = entries_;
+  return *this;
+}
+
 template <typename P, typename R>
 template <typename... Elems>
 auto champsim::cache_builder<P, R>::prefetch_activate(Elems... pref_act_elems) -> self_type&
@@ -514,6 +843,13 @@ auto champsim::cache_builder<P, R>::lower_translate(champsim::channel* lt_) -> s
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::memory_controller(const MEMORY_CONTROLLER* mc_) -> self_type&
+{
+  m_mc = mc_;
+  return *this;
+}
+
 template <typename P, typename R>
 template <typename... Ps>
 auto champsim::cache_builder<P, R>::prefetcher() -> champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, R>
@@ -7,7 +7,10 @@
 #include <utility>
 
 #include "channel.h"
+#include "energy.h"
 #include "event_counter.h"
+#include "histogram.h"
+#include "space_saving.h"
 
 struct cache_stats {
   std::string name;
@@ -17,13 +20,43 @@ struct cache_stats {
   uint64_t pf_useful = 0;
   uint64_t pf_useless = 0;
   uint64_t pf_fill = 0;
+  uint64_t pf_filtered = 0;
+
+  // Timeliness of the prefetches issued by this cache
+  uint64_t pf_late = 0;      // a demand arrived while the prefetch was still in flight
+  uint64_t pf_early = 0;     // a demand missed on a prefetched block that was evicted before it was used
+  uint64_t pf_polluting = 0; // a demand missed on a block that a prefetch evicted
+  champsim::stats::log2_histogram pf_use_distance{};  // cycles from the fill of a prefetch to its first use
+  champsim::stats::log2_histogram pf_late_distance{}; // cycles from the issue of a late prefetch to the demand that caught it
+
+  uint64_t sector_misses = 0;
+
+  // victim cache and prefetch buffer stats
+  uint64_t victim_hits = 0;
+  uint64_t victim_promotions = 0;
+  uint64_t pf_buffer_hits = 0;
+  uint64_t pf_buffer_promotions = 0;
+
+  // writes sent to the lower level, by their cause
+  uint64_t wb_eviction = 0;
+  uint64_t wb_eager = 0;
+  uint64_t wb_write_through = 0;
+  uint64_t wb_write_around = 0;
+  uint64_t write_buffer_merges = 0;
 
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> hits = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> misses = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_merge = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_return = {};
+  // Each cycle that a miss waits for an MSHR is counted once
+  champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_full = {};
 
   long total_miss_latency_cycles{};
+
+  // Demand misses by instruction address, weighted by their latency
+  champsim::stats::space_saving<champsim::address> ip_misses{};
+
+  champsim::energy_stats energy{};
 };
 
 cache_stats operator-(cache_stats lhs, cache_stats rhs);
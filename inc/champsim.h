@@ -22,15 +22,12 @@
 #include <exception>
 #include <limits>
 
+#include "champsim_constants.h"
 #include "extent.h"
 #include "util/bit_enum.h"
 #include "util/ratio.h"
 
 extern const std::size_t NUM_CPUS;
-extern const unsigned BLOCK_SIZE;
-extern const unsigned PAGE_SIZE;
-extern const unsigned LOG2_BLOCK_SIZE;
-extern const unsigned LOG2_PAGE_SIZE;
 
 namespace champsim
 {
@@ -69,6 +66,15 @@ using tebibytes = size<long long, tebi>;
  * Convenience definitions for commmon address slices
  */
 using address = address_slice<static_extent<champsim::data::bits{std::numeric_limits<uint64_t>::digits}, champsim::data::bits{}>>;
+
+/**
+ * The extents of block and page slices. These are fixed by the configuration, so that the slices need no runtime bounds.
+ */
+using page_number_extent = static_extent<champsim::data::bits{std::numeric_limits<uint64_t>::digits}, champsim::data::bits{LOG2_PAGE_SIZE}>;
+using page_offset_extent = static_extent<champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{}>;
+using block_number_extent = static_extent<champsim::data::bits{std::numeric_limits<uint64_t>::digits}, champsim::data::bits{LOG2_BLOCK_SIZE}>;
+using block_offset_extent = static_extent<champsim::data::bits{LOG2_BLOCK_SIZE}, champsim::data::bits{}>;
+
 using block_number = address_slice<block_number_extent>;
 using block_offset = address_slice<block_offset_extent>;
 using page_number = address_slice<page_number_extent>;
@@ -21,12 +21,15 @@
 #include <cstdint>
 #include <deque>
 #include <limits>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "access_type.h"
 #include "address.h"
 #include "champsim.h"
+#include "chrono.h"
+#include "operable.h"
 
 namespace champsim
 {
@@ -47,7 +50,34 @@ struct cache_queue_stats {
   uint64_t WQ_FORWARD = 0;
 };
 
-class channel
+/**
+ * The timing of the link that a channel models between two levels.
+ * A link with no clock period passes packets between the levels immediately, with no limit on bandwidth.
+ */
+struct link_parameters {
+  champsim::chrono::picoseconds clock_period{};
+
+  // The number of link cycles a packet spends on the wire in each direction
+  long request_latency = 0;
+  long response_latency = 0;
+
+  // The number of flits that may be sent in each direction per link cycle, or 0 for unlimited bandwidth.
+  // Writes and responses carry a block of data, and take BLOCK_SIZE / flit_size flits; other requests take one flit.
+  long flits_per_cycle = 0;
+  champsim::data::bytes flit_size{BLOCK_SIZE};
+};
+
+struct link_stats {
+  std::string name{};
+  uint64_t cycles = 0;
+
+  uint64_t request_packets = 0, request_flits = 0, request_busy_cycles = 0, request_queue_delay = 0;
+  uint64_t response_packets = 0, response_flits = 0, response_busy_cycles = 0, response_queue_delay = 0;
+};
+
+link_stats operator-(link_stats lhs, link_stats rhs);
+
+class channel : public champsim::operable
 {
   struct request {
     bool forward_checked = false;
@@ -83,8 +113,24 @@ class channel
     explicit response(request req) : response(req.address, req.v_address, req.data, req.pf_metadata, req.instr_depend_on_me) {}
   };
 
-  template <typename R>
-  bool do_add_queue(R& queue, std::size_t queue_size, const typename R::value_type& packet);
+  template <typename T>
+  struct transfer {
+    T packet;
+    champsim::chrono::clock::time_point event_time{};
+    long flits = 1;
+    long flits_sent = 0;
+  };
+
+  struct request_transfer : transfer<request> {
+    std::deque<request> channel::*destination;
+  };
+
+  bool do_add_queue(std::deque<request> channel::*queue, std::size_t queue_size, const request& packet);
+  [[nodiscard]] std::size_t occupancy(std::deque<request> channel::*queue) const;
+  [[nodiscard]] long data_flits() const;
+
+  template <typename Q>
+  long transmit(Q& waiting, Q& wire, long latency, uint64_t& packets, uint64_t& flits, uint64_t& busy_cycles, uint64_t& queue_delay);
 
   std::size_t RQ_SIZE = std::numeric_limits<std::size_t>::max();
   std::size_t PQ_SIZE = std::numeric_limits<std::size_t>::max();
@@ -92,18 +138,31 @@ class channel
   champsim::data::bits OFFSET_BITS{};
   bool match_offset_bits = false;
 
+  link_parameters link{};
+
+  // Packets that have been sent, but have not yet crossed the link
+  std::deque<request_transfer> request_waiting{}, request_wire{};
+  std::deque<transfer<response>> response_waiting{}, response_wire{};
+  std::deque<response> returning{};
+
 public:
   using response_type = response;
   using request_type = request;
   using stats_type = cache_queue_stats;
+  using link_stats_type = link_stats;
+
+  std::string NAME{};
 
   std::deque<request_type> RQ{}, PQ{}, WQ{};
   std::deque<response_type> returned{};
 
   stats_type sim_stats{}, roi_stats{};
+  link_stats_type sim_link_stats{}, roi_link_stats{};
 
   channel() = default;
   channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset);
+  channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset, std::string_view name,
+          link_parameters link_params);
 
   bool add_rq(const request_type& packet);
   bool add_wq(const request_type& packet);
@@ -117,7 +176,23 @@ public:
   [[nodiscard]] std::size_t wq_size() const;
   [[nodiscard]] std::size_t pq_size() const;
 
+  [[nodiscard]] champsim::data::bits offset_bits() const;
+
+  /**
+   * Whether packets take time to cross this channel. A timed channel must be operated for its packets to arrive.
+   */
+  [[nodiscard]] bool timed() const;
+
+  /**
+   * The queue into which the lower level should place responses. They appear in ``returned`` once they have crossed the link.
+   */
+  [[nodiscard]] std::deque<response_type>* response_target();
+
   void check_collision();
+
+  long operate() final;
+  void begin_phase() final;
+  void end_phase(unsigned cpu) final;
 };
 } // namespace champsim
 
@@ -17,16 +17,40 @@
 #ifndef CORE_BUILDER_H
 #define CORE_BUILDER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <optional>
+#include <vector>
 
+#include "bandwidth.h"
 #include "chrono.h"
+#include "energy.h"
 
 class CACHE;
 class O3_CPU;
 namespace champsim
 {
 class channel;
+
+/**
+ * The timing model used for a core.
+ *
+ * The out-of-order model simulates each pipeline stage in every cycle. The interval model dispatches instructions into a window the size of the ROB
+ * and charges the front end, branch mispredictions, and long-latency loads as stall intervals, overlapping the loads that fit in the window.
+ * The in-order model issues instructions in program order and stalls when an instruction uses a register whose value is not yet ready.
+ */
+enum class core_model { out_of_order, interval, in_order };
+
+/**
+ * One level of a multi-level branch target buffer, with the fetch bubbles that a hit in it costs.
+ */
+struct btb_level {
+  std::size_t sets;
+  std::size_t ways;
+  long latency;
+};
+
 template <typename...>
 class core_builder_module_type_holder
 {
@@ -36,9 +60,13 @@ namespace detail
 struct core_builder_base {
   uint32_t m_cpu{};
   champsim::chrono::picoseconds m_clock_period{250};
+  core_model m_model{core_model::out_of_order};
   std::size_t m_dib_set{1};
   std::size_t m_dib_way{1};
   std::size_t m_dib_window{1};
+  std::size_t m_dib_uops_per_line{0};
+  std::size_t m_dib_ways_per_window{0};
+  bool m_dib_inclusive{false};
   std::size_t m_ifetch_buffer_size{1};
   std::size_t m_decode_buffer_size{1};
   std::size_t m_dispatch_buffer_size{1};
@@ -61,18 +89,30 @@ struct core_builder_base {
   champsim::bandwidth::maximum_type m_dib_inorder_width{1};
 
   unsigned m_dib_hit_latency{};
+  unsigned m_dib_switch_penalty{};
 
   unsigned m_mispredict_penalty{};
   unsigned m_decode_latency{};
   unsigned m_dispatch_latency{};
   unsigned m_schedule_latency{};
   unsigned m_execute_latency{};
+  std::vector<unsigned> m_class_execute_latency{};
 
   CACHE* m_l1i{};
   champsim::bandwidth::maximum_type m_l1i_bw{1};
   champsim::bandwidth::maximum_type m_l1d_bw{1};
   champsim::channel* m_fetch_queues{};
   champsim::channel* m_data_queues{};
+
+  champsim::partial_access_energy m_rob_energy{};
+  champsim::partial_access_energy m_lq_energy{};
+  champsim::partial_access_energy m_sq_energy{};
+  champsim::partial_access_energy m_bp_energy{};
+
+  std::size_t m_ip_attribution{0};
+
+  std::vector<btb_level> m_btb_levels{};
+  bool m_btb_prefetch_from_l1i{false};
 };
 } // namespace detail
 
@@ -88,6 +128,11 @@ class core_builder : public detail::core_builder_base
 
   explicit core_builder(const detail::core_builder_base& other) : detail::core_builder_base(other) {}
 
+  champsim::access_energy get_rob_energy() const;
+  champsim::access_energy get_lq_energy() const;
+  champsim::access_energy get_sq_energy() const;
+  champsim::access_energy get_bp_energy() const;
+
 public:
   core_builder() = default;
 
@@ -98,6 +143,11 @@ public:
    */
   self_type& clock_period(champsim::chrono::picoseconds clock_period_);
 
+  /**
+   * Specify the timing model of the core.
+   */
+  self_type& model(core_model model_);
+
   /**
    * Specify the number of sets in the Decoded Instruction Buffer.
    */
@@ -113,6 +163,31 @@ public:
    */
   self_type& dib_window(std::size_t dib_window_);
 
+  /**
+   * Specify the number of micro-ops each line of the Decoded Instruction Buffer can hold. Zero means no limit.
+   */
+  self_type& dib_uops_per_line(std::size_t dib_uops_per_line_);
+
+  /**
+   * Specify the number of ways of the Decoded Instruction Buffer that a single window may occupy. Zero means the whole set.
+   */
+  self_type& dib_ways_per_window(std::size_t dib_ways_per_window_);
+
+  /**
+   * Specify the number of cycles lost when delivery switches between the decoders and the Decoded Instruction Buffer.
+   */
+  self_type& dib_switch_penalty(unsigned dib_switch_penalty_);
+
+  /**
+   * Remove windows from the Decoded Instruction Buffer when their block leaves the L1I.
+   */
+  self_type& set_dib_inclusive();
+
+  /**
+   * Do not remove windows from the Decoded Instruction Buffer when their block leaves the L1I.
+   */
+  self_type& reset_dib_inclusive();
+
   /**
    * Specify the maximum size of the instruction fetch buffer.
    */
@@ -225,6 +300,12 @@ public:
    */
   self_type& execute_latency(unsigned execute_latency_);
 
+  /**
+   * Specify the latency of execution for each instruction class, indexed by the class recorded in the trace.
+   * Instructions whose class is not in the list use the latency given to execute_latency().
+   */
+  self_type& class_execute_latency(std::vector<unsigned> class_execute_latency_);
+
   /**
    * Specify the latency of execution.
    */
@@ -255,6 +336,52 @@ public:
    */
   self_type& data_queues(champsim::channel* data_queues_);
 
+  /**
+   * Specify the energy of each access to the reorder buffer.
+   * If this is not specified, it is estimated from the size of the reorder buffer.
+   */
+  self_type& rob_energy(champsim::partial_access_energy rob_energy_);
+
+  /**
+   * Specify the energy of each access to the load queue.
+   * If this is not specified, it is estimated from the size of the load queue, which is searched associatively.
+   */
+  self_type& lq_energy(champsim::partial_access_energy lq_energy_);
+
+  /**
+   * Specify the energy of each access to the store queue.
+   * If this is not specified, it is estimated from the size of the store queue, which is searched associatively.
+   */
+  self_type& sq_energy(champsim::partial_access_energy sq_energy_);
+
+  /**
+   * Specify the energy of each prediction and update of the branch predictor.
+   * If this is not specified, the branch predictor is estimated as an 8 KiB table.
+   */
+  self_type& branch_predictor_energy(champsim::partial_access_energy bp_energy_);
+
+  /**
+   * Specify the number of instruction addresses to report, by their branch mispredictions and by the cycles they stall retirement.
+   * These are attributed with bounded-memory sketches. Zero disables the attribution.
+   */
+  self_type& ip_attribution(std::size_t ip_attribution_);
+
+  /**
+   * Specify the levels of the branch target buffer, from the first level searched to the last.
+   * If this is not specified, the BTB module chooses its own organization.
+   */
+  self_type& btb_levels(std::vector<btb_level> btb_levels_);
+
+  /**
+   * Specify that the BTB should place the branches of each block the L1I fetches in its first level.
+   */
+  self_type& set_btb_prefetch_from_l1i();
+
+  /**
+   * Specify that the BTB should be filled only by the branches it predicts.
+   */
+  self_type& reset_btb_prefetch_from_l1i();
+
   /**
    * Specify the branch direction predictor.
    */
@@ -283,6 +410,13 @@ auto champsim::core_builder<B, T>::clock_period(champsim::chrono::picoseconds cl
   return *this;
 }
 
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::model(core_model model_) -> self_type&
+{
+  m_model = model_;
+  return *this;
+}
+
 template <typename B, typename T>
 auto champsim::core_builder<B, T>::dib_set(std::size_t dib_set_) -> self_type&
 {
@@ -304,6 +438,41 @@ auto champsim::core_builder<B, T>::dib_window(std::size_t dib_window_) -> self_t
   return *this;
 }
 
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::dib_uops_per_line(std::size_t dib_uops_per_line_) -> self_type&
+{
+  m_dib_uops_per_line = dib_uops_per_line_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::dib_ways_per_window(std::size_t dib_ways_per_window_) -> self_type&
+{
+  m_dib_ways_per_window = dib_ways_per_window_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::dib_switch_penalty(unsigned dib_switch_penalty_) -> self_type&
+{
+  m_dib_switch_penalty = dib_switch_penalty_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::set_dib_inclusive() -> self_type&
+{
+  m_dib_inclusive = true;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::reset_dib_inclusive() -> self_type&
+{
+  m_dib_inclusive = false;
+  return *this;
+}
+
 template <typename B, typename T>
 auto champsim::core_builder<B, T>::ifetch_buffer_size(std::size_t ifetch_buffer_size_) -> self_type&
 {
@@ -465,6 +634,13 @@ auto champsim::core_builder<B, T>::execute_latency(unsigned execute_latency_) ->
   return *this;
 }
 
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::class_execute_latency(std::vector<unsigned> class_execute_latency_) -> self_type&
+{
+  m_class_execute_latency = class_execute_latency_;
+  return *this;
+}
+
 template <typename B, typename T>
 auto champsim::core_builder<B, T>::l1i(CACHE* l1i_) -> self_type&
 {
@@ -500,6 +676,96 @@ auto champsim::core_builder<B, T>::data_queues(champsim::channel* data_queues_)
   return *this;
 }
 
+namespace champsim::detail
+{
+// Each entry of the reorder buffer and the load and store queues, with its address and status, is taken to be 16 bytes
+constexpr long long core_queue_entry_bytes = 16;
+} // namespace champsim::detail
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::get_rob_energy() const -> champsim::access_energy
+{
+  return m_rob_energy.value_or(champsim::estimate_energy(champsim::data::bytes{detail::core_queue_entry_bytes * static_cast<long long>(m_rob_size)}, 1));
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::get_lq_energy() const -> champsim::access_energy
+{
+  // The load queue is searched associatively, so every entry is read
+  const champsim::data::bytes capacity{detail::core_queue_entry_bytes * static_cast<long long>(m_lq_size)};
+  return m_lq_energy.value_or(champsim::estimate_energy(capacity, static_cast<long>(m_lq_size)));
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::get_sq_energy() const -> champsim::access_energy
+{
+  // The store queue is searched associatively, so every entry is read
+  const champsim::data::bytes capacity{detail::core_queue_entry_bytes * static_cast<long long>(m_sq_size)};
+  return m_sq_energy.value_or(champsim::estimate_energy(capacity, static_cast<long>(m_sq_size)));
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::get_bp_energy() const -> champsim::access_energy
+{
+  return m_bp_energy.value_or(champsim::estimate_energy(champsim::data::kibibytes{8}, 1));
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::rob_energy(champsim::partial_access_energy rob_energy_) -> self_type&
+{
+  m_rob_energy = rob_energy_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::lq_energy(champsim::partial_access_energy lq_energy_) -> self_type&
+{
+  m_lq_energy = lq_energy_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::sq_energy(champsim::partial_access_energy sq_energy_) -> self_type&
+{
+  m_sq_energy = sq_energy_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::branch_predictor_energy(champsim::partial_access_energy bp_energy_) -> self_type&
+{
+  m_bp_energy = bp_energy_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::ip_attribution(std::size_t ip_attribution_) -> self_type&
+{
+  m_ip_attribution = ip_attribution_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::btb_levels(std::vector<btb_level> btb_levels_) -> self_type&
+{
+  m_btb_levels = btb_levels_;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::set_btb_prefetch_from_l1i() -> self_type&
+{
+  m_btb_prefetch_from_l1i = true;
+  return *this;
+}
+
+template <typename B, typename T>
+auto champsim::core_builder<B, T>::reset_btb_prefetch_from_l1i() -> self_type&
+{
+  m_btb_prefetch_from_l1i = false;
+  return *this;
+}
+
 template <typename B, typename T>
 template <typename... Bs>
 auto champsim::core_builder<B, T>::branch_predictor() -> champsim::core_builder<core_builder_module_type_holder<Bs...>, T>
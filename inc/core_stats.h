@@ -4,8 +4,10 @@
 #include <cstdint>
 #include <string>
 
+#include "energy.h"
 #include "event_counter.h"
 #include "instruction.h"
+#include "space_saving.h"
 
 struct cpu_stats {
   std::string name;
@@ -15,9 +17,40 @@ struct cpu_stats {
   long long end_cycles = 0;
   uint64_t total_rob_occupancy_at_branch_mispredict = 0;
 
+  uint64_t dib_lookups = 0;
+  uint64_t dib_hits = 0;
+  uint64_t dib_uops_delivered = 0;
+  uint64_t decoder_uops_delivered = 0;
+  uint64_t dib_delivery_cycles = 0;
+  uint64_t decoder_delivery_cycles = 0;
+  uint64_t dib_switches = 0;
+  uint64_t dib_overflows = 0;
+  uint64_t dib_inclusion_invalidations = 0;
+
+  uint64_t decode_cache_hits = 0;
+  uint64_t decode_cache_misses = 0;
+
+  uint64_t interval_dispatch_cycles = 0;
+  uint64_t interval_frontend_stall_cycles = 0;
+  uint64_t interval_branch_stall_cycles = 0;
+  uint64_t interval_memory_stall_cycles = 0;
+  uint64_t interval_window_stall_cycles = 0;
+
+  uint64_t in_order_issue_cycles = 0;
+  uint64_t in_order_use_stall_cycles = 0;
+  uint64_t in_order_frontend_stall_cycles = 0;
+  uint64_t in_order_branch_stall_cycles = 0;
+  uint64_t in_order_window_stall_cycles = 0;
+
   champsim::stats::event_counter<branch_type> total_branch_types = {};
   champsim::stats::event_counter<branch_type> branch_type_misses = {};
 
+  champsim::energy_stats energy{};
+
+  // Branch mispredictions and the cycles in which the head of the ROB could not retire, by instruction address
+  champsim::stats::space_saving<champsim::address> ip_mispredicts{};
+  champsim::stats::space_saving<champsim::address> ip_rob_stalls{};
+
   [[nodiscard]] auto instrs() const { return end_instrs - begin_instrs; }
   [[nodiscard]] auto cycles() const { return end_cycles - begin_cycles; }
 };
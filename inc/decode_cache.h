@@ -0,0 +1,92 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DECODE_CACHE_H
+#define DECODE_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "instruction.h"
+
+namespace champsim
+{
+/**
+ * A direct-mapped cache of decoded static instructions, for use while reading a trace.
+ *
+ * Entries are found by the IP and checked against the register operands of the trace instruction, so that an IP whose operands change
+ * (for instance, in self-modifying code) is decoded again. Dynamic instructions then only need their memory addresses and branch direction copied.
+ *
+ * \tparam T The trace instruction format
+ */
+template <typename T>
+class decode_cache
+{
+  struct entry_type {
+    bool valid = false;
+    T key{};
+    static_instr_info decoded{};
+  };
+
+  std::vector<entry_type> entries;
+
+  static bool same_signature(const T& lhs, const T& rhs)
+  {
+    return lhs.ip == rhs.ip && std::equal(std::begin(lhs.destination_registers), std::end(lhs.destination_registers), std::begin(rhs.destination_registers))
+           && std::equal(std::begin(lhs.source_registers), std::end(lhs.source_registers), std::begin(rhs.source_registers));
+  }
+
+public:
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  /**
+   * Construct a cache with the given number of entries.
+   */
+  explicit decode_cache(std::size_t size) : entries(std::max<std::size_t>(size, 1)) {}
+
+  /**
+   * Find the decoded form of the instruction, decoding it if it is not present.
+   */
+  const static_instr_info& lookup(const T& instr)
+  {
+    auto& entry = entries.at((instr.ip ^ (instr.ip >> 16)) % std::size(entries));
+    if (entry.valid && same_signature(entry.key, instr)) {
+      ++hits;
+    } else {
+      ++misses;
+      entry = {true, instr, ooo_model_instr::decode(instr)};
+    }
+    return entry.decoded;
+  }
+
+  /**
+   * Construct the model instruction for a trace instruction.
+   */
+  ooo_model_instr operator()(uint8_t cpu, const T& instr)
+  {
+    const auto misses_before = misses;
+    ooo_model_instr retval{cpu, instr, lookup(instr)};
+    retval.decode_cache_hit = (misses == misses_before);
+    return retval;
+  }
+};
+} // namespace champsim
+
+#endif
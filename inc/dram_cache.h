@@ -0,0 +1,182 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DRAM_CACHE_H
+#define DRAM_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "address.h"
+#include "channel.h"
+#include "chrono.h"
+#include "dram_controller.h"
+#include "dram_stats.h"
+#include "msl/lru_table.h"
+#include "operable.h"
+#include "util/units.h"
+
+/**
+ * Parameters for the organization of a DRAM cache.
+ *
+ * The alloy organization is direct-mapped, with the tag stored beside each block in the DRAM row, so that a single access returns both.
+ * The unison organization allocates pages of several blocks into a set-associative array. When a page is allocated, the blocks that were
+ * used the last time the page was resident after a miss by the same instruction and offset are fetched with it.
+ */
+struct dram_cache_parameters {
+  enum class organization_type { alloy, unison };
+  enum class predictor_type { none, map_i };
+
+  organization_type organization = organization_type::alloy;
+  predictor_type miss_predictor = predictor_type::map_i;
+  champsim::data::bytes size{1 << 28};
+  champsim::data::bytes page_size{BLOCK_SIZE};
+  std::size_t ways = 1;
+  std::size_t mshr_size = 64;
+  std::size_t predictor_size = 256;
+  std::size_t footprint_table_size = 1024;
+};
+
+/**
+ * A cache of main memory, built in stacked or on-package DRAM, that sits between the last-level cache and the memory controller.
+ *
+ * Tags are kept in the DRAM rows beside the data, so every lookup is a read of the cache's own DRAM channels, timed in the same way as main memory.
+ * Misses are discovered when that read returns, unless the miss predictor started the read of main memory at the same time.
+ * Blocks fetched from main memory are written into the cache after they are returned.
+ */
+class DRAM_CACHE : public champsim::operable
+{
+  using channel_type = champsim::channel;
+  using request_type = typename channel_type::request_type;
+  using response_type = typename channel_type::response_type;
+
+  std::vector<channel_type*> upper_levels;
+  channel_type* lower_level;
+
+  const dram_cache_parameters params;
+  const DRAM_ADDRESS_MAPPING address_mapping;
+  const champsim::data::bits PAGE_OFFSET_BITS;
+  const std::size_t NUM_SET;
+
+  struct frame_type {
+    bool valid = false;
+    champsim::address page{};
+    uint64_t valid_blocks = 0;
+    uint64_t dirty_blocks = 0;
+    uint64_t used_blocks = 0;
+    uint64_t footprint_key = 0;
+    uint64_t last_used = 0;
+  };
+  // The frames of each set are created when the set is first used, so that a large cache costs no more memory than the sets it touches
+  std::unordered_map<std::size_t, std::vector<frame_type>> frames;
+  uint64_t access_count = 0;
+
+  struct miss_entry {
+    bool footprint_fetch = false;
+    bool tag_checked = false;
+    bool memory_wanted = false;
+    bool memory_issued = false;
+    bool memory_returned = false;
+    bool finished = false;
+
+    access_type type{access_type::LOAD};
+    uint32_t cpu = 0;
+    uint32_t pf_metadata = 0;
+
+    champsim::address address{};
+    champsim::address v_address{};
+    champsim::address ip{};
+    champsim::address tag_location{};
+
+    std::vector<uint64_t> instr_depend_on_me{};
+    std::vector<std::deque<response_type>*> to_return{};
+  };
+  std::vector<miss_entry> inflight;
+
+  // Reads of main memory whose data is not needed, because the cache hit after the predictor started them.
+  // A later miss of the same block takes over the read, rather than issuing its own, since the lower level may merge the two.
+  std::vector<champsim::block_number> orphaned_reads;
+
+  std::deque<response_type> tag_returned;
+  std::deque<champsim::address> pending_fills;
+  std::deque<champsim::address> pending_footprint;
+  std::deque<request_type> pending_writebacks;
+
+  std::vector<uint8_t> miss_predictor;
+
+  struct footprint_entry {
+    uint64_t key = 0;
+    uint64_t footprint = 0;
+  };
+  struct footprint_indexer {
+    auto operator()(const footprint_entry& entry) const { return entry.key; }
+  };
+  champsim::msl::lru_table<footprint_entry, footprint_indexer, footprint_indexer> footprint_table;
+
+  void initiate_requests();
+  bool add_rq(const request_type& packet, channel_type* ul);
+  bool add_wq(const request_type& packet);
+
+  long handle_tag_returns();
+  long handle_memory_returns();
+  long issue_memory_reads();
+  long issue_fills();
+  long issue_writebacks();
+
+  void finish_tag_check(miss_entry& entry);
+  void finish_miss(miss_entry& entry);
+  void respond(miss_entry& entry);
+
+  [[nodiscard]] std::size_t get_set_index(champsim::address addr) const;
+  [[nodiscard]] champsim::address page_of(champsim::address addr) const;
+  [[nodiscard]] std::size_t block_index(champsim::address addr) const;
+  [[nodiscard]] frame_type* find_frame(champsim::address addr);
+  [[nodiscard]] frame_type* find_victim(champsim::address addr);
+  [[nodiscard]] champsim::address location(const frame_type* frame, champsim::address addr) const;
+  frame_type* allocate(champsim::address addr);
+
+  [[nodiscard]] std::size_t predictor_index(const miss_entry& entry) const;
+  [[nodiscard]] bool predict_miss(const miss_entry& entry) const;
+  void train_predictor(const miss_entry& entry, bool miss);
+  [[nodiscard]] uint64_t footprint_key(const miss_entry& entry) const;
+
+  bool add_tag_read(champsim::address loc);
+  bool add_fill(champsim::address loc);
+
+public:
+  std::vector<DRAM_CHANNEL> channels;
+
+  using stats_type = dram_cache_stats;
+  stats_type roi_stats, sim_stats;
+
+  DRAM_CACHE(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas,
+             std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul, channel_type* ll, std::size_t rq_size,
+             std::size_t wq_size, std::size_t chans, champsim::data::bytes chan_width, std::size_t columns, std::size_t ranks, std::size_t bankgroups,
+             std::size_t banks, std::size_t refreshes_per_period, dram_cache_parameters cache_params = {});
+
+  void initialize() final;
+  long operate() final;
+  void begin_phase() final;
+  void end_phase(unsigned cpu) final;
+  void print_deadlock() final;
+
+  [[nodiscard]] champsim::data::bytes size() const;
+};
+
+#endif
@@ -22,17 +22,25 @@
 #include <cstddef>  // for size_t
 #include <cstdint>  // for uint64_t, uint32_t, uint8_t
 #include <deque>    // for deque
+#include <fstream>
 #include <iterator> // for end
 #include <limits>
+#include <memory>
 #include <optional>
+#include <random>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "address.h"
 #include "channel.h"
 #include "chrono.h"
 #include "dram_stats.h"
 #include "extent_set.h"
+#include "modules.h"
+#include "msl/lru_table.h"
 #include "operable.h"
+#include "page_profile.h"
 
 struct DRAM_ADDRESS_MAPPING {
   constexpr static std::size_t SLICER_OFFSET_IDX = 0;
@@ -90,6 +98,72 @@ struct DRAM_ADDRESS_MAPPING {
   std::size_t channels() const;
 };
 
+/**
+ * A read-only snapshot of the memory controller's data bus activity, for use by bandwidth-aware modules.
+ * The counters are cumulative over the whole simulation, so rates are taken as the difference between two snapshots.
+ */
+struct dram_telemetry {
+  champsim::chrono::clock::time_point time{};
+  champsim::chrono::picoseconds data_bus_period{};
+  std::size_t channels = 0;
+
+  champsim::chrono::clock::duration dbus_busy{};
+  long dbus_cycle_congested = 0;
+  uint64_t dbus_count_congested = 0;
+
+  std::size_t rq_occupancy = 0;
+  std::size_t rq_size = 0;
+  std::size_t wq_occupancy = 0;
+  std::size_t wq_size = 0;
+
+  /**
+   * The fraction of the available data bus time that was spent transferring data since the earlier snapshot.
+   */
+  [[nodiscard]] double utilization_since(const dram_telemetry& earlier) const;
+
+  /**
+   * The number of data bus cycles that requests spent waiting on a busy bus since the earlier snapshot, per elapsed data bus cycle.
+   */
+  [[nodiscard]] double congestion_since(const dram_telemetry& earlier) const;
+};
+
+/**
+ * Parameters for the memory-side prefetchers.
+ *
+ * The prefetcher modules observe the read stream as it arrives at the memory controller. Depending on the mode, the blocks they predict are
+ * either read into a small buffer in each channel, where later reads find them without accessing DRAM, or their rows are activated in idle
+ * banks so that later reads become row buffer hits.
+ */
+struct dram_prefetch_parameters {
+  enum class mode_type { buffer, open_row };
+
+  mode_type mode = mode_type::buffer;
+  std::size_t buffer_size = 16;
+  std::size_t degree = 2;
+};
+
+/**
+ * Parameters for the RowHammer mitigation of each channel.
+ *
+ * PARA refreshes the neighbors of each activated row with a fixed probability. Graphene counts the activations of each bank in a small table
+ * of the most frequently activated rows, and refreshes the neighbors of a row each time its count reaches the threshold. DDR5 refresh
+ * management counts every activation of a bank, and issues an RFM command whenever the count reaches the threshold, which then removes the
+ * threshold from the count. A periodic refresh also removes the threshold from the count.
+ *
+ * A neighbor refresh activates and precharges each victim row on both sides of the aggressor, so it occupies the bank for tRAS + tRP per row.
+ * An RFM command occupies the bank for tRFC, or for as long as a neighbor refresh if that is longer.
+ */
+struct dram_rowhammer_parameters {
+  enum class mitigation_type { none, para, graphene, rfm };
+
+  mitigation_type mitigation = mitigation_type::none;
+  double para_probability = 0.001;
+  std::size_t threshold = 1024;
+  std::size_t table_size = 64;
+  std::size_t blast_radius = 1;
+  uint64_t seed = 0;
+};
+
 struct DRAM_CHANNEL final : public champsim::operable {
   using response_type = typename champsim::channel::response_type;
 
@@ -98,6 +172,7 @@ struct DRAM_CHANNEL final : public champsim::operable {
   struct request_type {
     bool scheduled = false;
     bool forward_checked = false;
+    bool memory_prefetch = false;
 
     uint8_t asid[2] = {std::numeric_limits<uint8_t>::max(), std::numeric_limits<uint8_t>::max()};
 
@@ -124,7 +199,7 @@ struct DRAM_CHANNEL final : public champsim::operable {
    */
 
   struct BANK_REQUEST {
-    bool valid = false, row_buffer_hit = false, need_refresh = false, under_refresh = false;
+    bool valid = false, row_buffer_hit = false, need_refresh = false, under_refresh = false, under_mitigation = false;
 
     std::optional<std::size_t> open_row{};
 
@@ -143,6 +218,17 @@ struct DRAM_CHANNEL final : public champsim::operable {
   std::vector<champsim::chrono::clock::time_point> bankgroup_readytime{address_mapping.ranks() * address_mapping.bankgroups(),
                                                                        champsim::chrono::clock::time_point{}};
 
+  struct prefetch_buffer_entry {
+    champsim::block_number block{};
+  };
+  struct prefetch_buffer_indexer {
+    auto operator()(const prefetch_buffer_entry& entry) const { return entry.block; }
+  };
+  champsim::msl::lru_table<prefetch_buffer_entry, prefetch_buffer_indexer, prefetch_buffer_indexer> prefetch_buffer;
+
+  // Reads served from the prefetch buffer, which return once their data has crossed the data bus
+  std::deque<request_type> buffer_returns;
+
   std::size_t bank_request_index(champsim::address addr) const;
   std::size_t bankgroup_request_index(champsim::address addr) const;
 
@@ -153,9 +239,34 @@ struct DRAM_CHANNEL final : public champsim::operable {
   champsim::chrono::clock::time_point last_refresh{};
   std::size_t DRAM_ROWS_PER_REFRESH;
 
+  const dram_rowhammer_parameters rowhammer_params;
+
+  struct activation_counter {
+    std::size_t row = 0;
+    std::size_t count = 0;
+  };
+  struct rowhammer_bank_state {
+    std::vector<activation_counter> table{}; // Graphene: the most frequently activated rows
+    std::size_t spillover = 0;               // Graphene: the count that any row not in the table may have reached
+    std::size_t raa = 0;                     // RFM: the rolling count of activations
+    champsim::chrono::clock::duration pending{};
+  };
+  std::vector<rowhammer_bank_state> rowhammer_state;
+  std::mt19937_64 rowhammer_rng;
+
+  // The accesses to each page and each bank in the current profiling epoch. They are only counted while profiling is enabled.
+  bool profile_pages = false;
+  champsim::page_counter_table<page_access_counts> page_accesses{};
+  std::vector<page_access_counts> bank_accesses{};
+
   using stats_type = dram_stats;
   stats_type roi_stats, sim_stats;
 
+  // Cumulative data bus counters for telemetry. Unlike the statistics, these are not reset between phases.
+  champsim::chrono::clock::duration dbus_busy_total{};
+  long dbus_cycle_congested_total = 0;
+  uint64_t dbus_count_congested_total = 0;
+
   // Latencies
   const champsim::chrono::clock::duration tRP, tRCD, tCAS, tRAS, tREF, tRFC, DRAM_DBUS_TURN_AROUND_TIME, DRAM_DBUS_RETURN_TIME, DRAM_DBUS_BANKGROUP_STALL;
 
@@ -164,12 +275,16 @@ struct DRAM_CHANNEL final : public champsim::operable {
 
   DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas,
                std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::size_t refreshes_per_period, champsim::data::bytes width,
-               std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapping);
+               std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapping, std::size_t prefetch_buffer_size = 1,
+               dram_rowhammer_parameters rh_params = {});
 
   void check_write_collision();
   void check_read_collision();
   long finish_dbus_request();
+  long finish_buffer_returns();
   long schedule_refresh();
+  long schedule_mitigation();
+  void record_activation(std::size_t bank, std::size_t row);
   void swap_write_mode();
   long populate_dbus();
   DRAM_CHANNEL::queue_type::iterator schedule_packet();
@@ -184,8 +299,21 @@ struct DRAM_CHANNEL final : public champsim::operable {
   std::size_t bank_request_capacity() const;
   std::size_t bankgroup_request_capacity() const;
   [[nodiscard]] champsim::data::bytes density() const;
+
+  [[nodiscard]] std::size_t rq_occupancy() const;
+  [[nodiscard]] std::size_t wq_occupancy() const;
+
+  bool add_prefetch(champsim::address addr);
+  bool open_row(champsim::address addr);
 };
 
+namespace champsim
+{
+template <typename... Ps>
+struct dram_prefetcher_type_holder {
+};
+} // namespace champsim
+
 class MEMORY_CONTROLLER : public champsim::operable
 {
   using channel_type = champsim::channel;
@@ -200,16 +328,81 @@ class MEMORY_CONTROLLER : public champsim::operable
 
   const DRAM_ADDRESS_MAPPING address_mapping;
 
+  const dram_prefetch_parameters prefetch_params;
+
+  const page_profile_parameters profile_params;
+  std::ofstream profile_file{};
+  long profile_epoch = 0;
+  long profile_epoch_cycles = 0;
+
+  void end_profile_epoch();
+
   // data bus period
   champsim::chrono::picoseconds data_bus_period{};
 
+  struct prefetcher_module_concept {
+    virtual ~prefetcher_module_concept() = default;
+
+    virtual void impl_prefetcher_initialize() = 0;
+    virtual void impl_prefetcher_operate(champsim::address addr, bool buffer_hit) = 0;
+    virtual void impl_prefetcher_final_stats() = 0;
+  };
+
+  template <typename... Ps>
+  struct prefetcher_module_model final : prefetcher_module_concept {
+    std::tuple<Ps...> intern_;
+    explicit prefetcher_module_model(MEMORY_CONTROLLER* controller) : intern_(Ps{controller}...)
+    {
+      (void)controller; /* silence -Wunused-but-set-parameter when sizeof...(Ps) == 0 */
+    }
+
+    void impl_prefetcher_initialize() final;
+    void impl_prefetcher_operate(champsim::address addr, bool buffer_hit) final;
+    void impl_prefetcher_final_stats() final;
+  };
+
+  std::unique_ptr<prefetcher_module_concept> pref_module_pimpl = std::make_unique<prefetcher_module_model<>>(this);
+
+  void impl_prefetcher_initialize() const;
+  void impl_prefetcher_operate(champsim::address addr, bool buffer_hit) const;
+
 public:
   std::vector<DRAM_CHANNEL> channels;
 
   MEMORY_CONTROLLER(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas,
                     std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul, std::size_t rq_size, std::size_t wq_size,
                     std::size_t chans, champsim::data::bytes chan_width, std::size_t rows, std::size_t columns, std::size_t ranks, std::size_t bankgroups,
-                    std::size_t banks, std::size_t refreshes_per_period);
+                    std::size_t banks, std::size_t refreshes_per_period, dram_prefetch_parameters pf_params = {}, dram_rowhammer_parameters rh_params = {},
+                    page_profile_parameters profile_params_ = {});
+
+  template <typename... Ps>
+  MEMORY_CONTROLLER(champsim::dram_prefetcher_type_holder<Ps...> /*prefetchers*/, champsim::chrono::picoseconds dbus_period,
+                    champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas, std::size_t t_ras,
+                    champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul, std::size_t rq_size, std::size_t wq_size,
+                    std::size_t chans, champsim::data::bytes chan_width, std::size_t rows, std::size_t columns, std::size_t ranks, std::size_t bankgroups,
+                    std::size_t banks, std::size_t refreshes_per_period, dram_prefetch_parameters pf_params = {}, dram_rowhammer_parameters rh_params = {},
+                    page_profile_parameters profile_params_ = {})
+      : MEMORY_CONTROLLER(dbus_period, mc_period, t_rp, t_rcd, t_cas, t_ras, refresh_period, std::move(ul), rq_size, wq_size, chans, chan_width, rows,
+                          columns, ranks, bankgroups, banks, refreshes_per_period, pf_params, rh_params, profile_params_)
+  {
+    pref_module_pimpl = std::make_unique<prefetcher_module_model<Ps...>>(this);
+  }
+
+  MEMORY_CONTROLLER(const MEMORY_CONTROLLER&) = delete;
+  MEMORY_CONTROLLER(MEMORY_CONTROLLER&&) = delete;
+  MEMORY_CONTROLLER& operator=(const MEMORY_CONTROLLER&) = delete;
+  MEMORY_CONTROLLER& operator=(MEMORY_CONTROLLER&&) = delete;
+
+  /**
+   * Prefetch a block on behalf of a memory-side prefetcher, according to the prefetch mode.
+   *
+   * :param pf_addr: The address of the block to prefetch
+   * :returns: true if the block was queued to be read into the prefetch buffer, or its row was opened
+   */
+  bool prefetch_line(champsim::address pf_addr);
+  [[nodiscard]] std::size_t prefetch_degree() const;
+
+  void impl_prefetcher_final_stats() const;
 
   void initialize() final;
   long operate() final;
@@ -218,6 +411,43 @@ public:
   void print_deadlock() final;
 
   [[nodiscard]] champsim::data::bytes size() const;
+  [[nodiscard]] dram_telemetry telemetry() const;
 };
 
+template <typename... Ps>
+void MEMORY_CONTROLLER::prefetcher_module_model<Ps...>::impl_prefetcher_initialize()
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (dram_prefetcher::has_initialize<decltype(p)>)
+      p.dram_prefetcher_initialize();
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Ps>
+void MEMORY_CONTROLLER::prefetcher_module_model<Ps...>::impl_prefetcher_operate(champsim::address addr, bool buffer_hit)
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (dram_prefetcher::has_operate<decltype(p), champsim::address, bool>)
+      p.dram_prefetcher_operate(addr, buffer_hit);
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Ps>
+void MEMORY_CONTROLLER::prefetcher_module_model<Ps...>::impl_prefetcher_final_stats()
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (dram_prefetcher::has_final_stats<decltype(p)>)
+      p.dram_prefetcher_final_stats();
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
 #endif
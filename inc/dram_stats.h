@@ -10,8 +10,21 @@ struct dram_stats {
   uint64_t dbus_count_congested = 0;
   uint64_t refresh_cycles = 0;
   unsigned WQ_ROW_BUFFER_HIT = 0, WQ_ROW_BUFFER_MISS = 0, RQ_ROW_BUFFER_HIT = 0, RQ_ROW_BUFFER_MISS = 0, WQ_FULL = 0;
+  unsigned PREFETCH_ISSUED = 0, PREFETCH_BUFFER_HIT = 0, PREFETCH_ROW_OPENED = 0;
+  uint64_t activations = 0;
+  uint64_t rowhammer_mitigations = 0, rowhammer_busy_cycles = 0, rowhammer_stall_cycles = 0;
 };
 
 dram_stats operator-(dram_stats lhs, dram_stats rhs);
 
+struct dram_cache_stats {
+  std::string name{};
+  uint64_t read_hits = 0, read_misses = 0, writes = 0;
+  uint64_t predicted_misses = 0, mispredicted_hits = 0;
+  uint64_t tag_reads = 0, cache_writes = 0;
+  uint64_t memory_reads = 0, footprint_fetches = 0, unused_fetches = 0, writebacks = 0;
+};
+
+dram_cache_stats operator-(dram_cache_stats lhs, dram_cache_stats rhs);
+
 #endif
@@ -0,0 +1,85 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <optional>
+
+#include "champsim.h"
+#include "chrono.h"
+#include "util/units.h"
+
+namespace champsim
+{
+/**
+ * The dynamic energy of a read and of a write of a structure, in picojoules, and its leakage, in picojoules per cycle.
+ */
+struct access_energy {
+  double read = 0;
+  double write = 0;
+  double leakage = 0;
+};
+
+/**
+ * An access energy of which some parts may be left unspecified. The parts that are not given are taken from an estimate.
+ */
+struct partial_access_energy {
+  std::optional<double> read{};
+  std::optional<double> write{};
+  std::optional<double> leakage{};
+
+  partial_access_energy() = default;
+  partial_access_energy(std::optional<double> read_, std::optional<double> write_, std::optional<double> leakage_);
+  partial_access_energy(access_energy energy); // NOLINT(google-explicit-constructor): a full energy is a partial energy with every part given
+
+  [[nodiscard]] access_energy value_or(access_energy estimate) const;
+};
+
+/**
+ * Estimate the energy of an array of the given capacity, of which the given number of ways are read in parallel.
+ *
+ * This is a parametric fit in the manner of CACTI. The energy of an access grows with the square root of the capacity, which sets the length of the
+ * wordlines and bitlines, and with the number of ways. The leakage grows with the capacity. The estimates give the relative cost of structures;
+ * where the absolute numbers matter, they should be replaced with figures for the target technology.
+ */
+access_energy estimate_energy(champsim::data::bytes capacity, long ways);
+
+/**
+ * The energy spent by a component, in picojoules, and the time over which it was spent.
+ */
+struct energy_stats {
+  double dynamic = 0;
+  double leakage = 0;
+  champsim::chrono::picoseconds elapsed{};
+
+  [[nodiscard]] double total() const { return dynamic + leakage; }
+
+  /**
+   * The average power, in watts
+   */
+  [[nodiscard]] double power() const;
+};
+
+energy_stats operator-(energy_stats lhs, energy_stats rhs);
+
+/**
+ * Combine the energy of two components that run side by side. The energy adds, but the time over which it was spent does not.
+ */
+energy_stats combine_concurrent(energy_stats lhs, const energy_stats& rhs);
+} // namespace champsim
+
+#endif
@@ -54,50 +54,6 @@ struct dynamic_extent {
   constexpr dynamic_extent(champsim::data::bits low, std::size_t size) : dynamic_extent(low + champsim::data::bits{size}, low) {}
 };
 
-/**
- * An extent that is always the size of a page number
- */
-struct page_number_extent : dynamic_extent {
-  /**
-   * This extent can only be default-initialized.
-   * It will have ``upper == champsim::address::bits`` and ``lower == LOG2_PAGE_SIZE``.
-   */
-  page_number_extent();
-};
-
-/**
- * An extent that is always the size of a page offset
- */
-struct page_offset_extent : dynamic_extent {
-  /**
-   * This extent can only be default-initialized.
-   * It will have ``upper == LOG2_PAGE_SIZE`` and ``lower == 0``.
-   */
-  page_offset_extent();
-};
-
-/**
- * An extent that is always the size of a block number
- */
-struct block_number_extent : dynamic_extent {
-  /**
-   * This extent can only be default-initialized.
-   * It will have ``upper == champsim::address::bits`` and ``lower == LOG2_BLOCK_SIZE``.
-   */
-  block_number_extent();
-};
-
-/**
- * An extent that is always the size of a block offset
- */
-struct block_offset_extent : dynamic_extent {
-  /**
-   * This extent can only be default-initialized.
-   * It will have ``upper == LOG2_BLOCK_SIZE`` and ``lower == 0``.
-   */
-  block_offset_extent();
-};
-
 /**
  * An extent with compile-time size
  */
@@ -118,10 +74,6 @@ struct static_extent {
  * Give the width of the extent. For static_extent, this function can be constexpr.
  */
 std::size_t size(dynamic_extent ext);
-std::size_t size(page_number_extent ext);
-std::size_t size(page_offset_extent ext);
-std::size_t size(block_number_extent ext);
-std::size_t size(block_offset_extent ext);
 
 template <champsim::data::bits UP, champsim::data::bits LOW>
 constexpr std::size_t size(static_extent<UP, LOW> ext)
@@ -0,0 +1,67 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+
+namespace champsim::stats
+{
+/**
+ * A histogram whose buckets double in width.
+ *
+ * Bucket 0 counts samples below 1, and bucket i counts samples in [2^(i-1), 2^i). The last bucket also counts every larger sample.
+ */
+class log2_histogram
+{
+public:
+  static constexpr std::size_t num_buckets = 20;
+  using value_type = long;
+
+private:
+  std::array<value_type, num_buckets> counts{};
+
+public:
+  void add(long long sample)
+  {
+    std::size_t bucket = 0;
+    while (bucket + 1 < num_buckets && sample >= lower_bound(bucket + 1))
+      ++bucket;
+    ++counts.at(bucket);
+  }
+
+  [[nodiscard]] value_type at(std::size_t bucket) const { return counts.at(bucket); }
+  [[nodiscard]] value_type total() const { return std::accumulate(std::begin(counts), std::end(counts), value_type{}); }
+
+  /**
+   * The number of buckets up to and including the last nonempty one
+   */
+  [[nodiscard]] std::size_t used_buckets() const
+  {
+    auto last = std::find_if(std::rbegin(counts), std::rend(counts), [](auto x) { return x != 0; });
+    return static_cast<std::size_t>(std::distance(last, std::rend(counts)));
+  }
+
+  /**
+   * The smallest sample counted in the bucket
+   */
+  [[nodiscard]] static constexpr long long lower_bound(std::size_t bucket) { return bucket == 0 ? 0 : (1LL << (bucket - 1)); }
+
+  log2_histogram& operator-=(const log2_histogram& rhs)
+  {
+    std::transform(std::begin(counts), std::end(counts), std::begin(rhs.counts), std::begin(counts), std::minus<>{});
+    return *this;
+  }
+
+  friend log2_histogram operator-(log2_histogram lhs, const log2_histogram& rhs)
+  {
+    lhs -= rhs;
+    return lhs;
+  }
+};
+} // namespace champsim::stats
+
+#endif
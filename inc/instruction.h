@@ -22,7 +22,11 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "address.h"
@@ -42,7 +46,7 @@ enum branch_type {
   NOT_BRANCH
 };
 
-using PHYSICAL_REGISTER_ID = int16_t; // signed to use -1 to indicate no physical register
+using PHYSICAL_REGISTER_ID = int32_t; // signed to use -1 to indicate no physical register, and wide enough for any 16-bit architectural register
 
 using namespace std::literals::string_view_literals;
 inline constexpr std::array branch_type_names{"BRANCH_DIRECT_JUMP"sv, "BRANCH_INDIRECT"sv,      "BRANCH_CONDITIONAL"sv,
@@ -94,6 +98,20 @@ struct program_ordered {
 };
 } // namespace champsim
 
+namespace champsim
+{
+/**
+ * The parts of a decoded instruction that are fixed by its IP and register operands.
+ */
+struct static_instr_info {
+  branch_type branch{NOT_BRANCH};
+  bool branch_always_taken = false;
+  bool branch_follows_trace = false;
+  std::vector<PHYSICAL_REGISTER_ID> destination_registers = {};
+  std::vector<PHYSICAL_REGISTER_ID> source_registers = {};
+};
+} // namespace champsim
+
 struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
   champsim::address ip{};
   champsim::chrono::clock::time_point ready_time{};
@@ -108,6 +126,11 @@ struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
   branch_type branch{NOT_BRANCH};
   champsim::address branch_target{};
 
+  uint8_t instr_class = 0;
+
+  // Whether the trace reader found this instruction in its decode cache. It is empty if the instruction did not come through a decode cache.
+  std::optional<bool> decode_cache_hit{};
+
   bool dib_checked = false;
   bool fetch_issued = false;
   bool fetch_completed = false;
@@ -130,70 +153,108 @@ struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
 
 private:
   template <typename T>
-  ooo_model_instr(T instr, std::array<uint8_t, 2> local_asid) : ip(instr.ip), is_branch(instr.is_branch), branch_taken(instr.branch_taken), asid(local_asid)
+  ooo_model_instr(T instr, std::array<uint8_t, 2> local_asid, const champsim::static_instr_info& static_info)
+      : ip(instr.ip), is_branch(instr.is_branch || static_info.branch != NOT_BRANCH), branch_taken(static_info.branch_always_taken || (static_info.branch_follows_trace && instr.branch_taken)),
+        asid(local_asid), branch(static_info.branch), destination_registers(static_info.destination_registers), source_registers(static_info.source_registers)
+  {
+    if constexpr (std::is_same_v<T, extended_instr>) {
+      if (instr.version != EXTENDED_TRACE_VERSION) {
+        throw std::invalid_argument{"Unsupported extended trace version " + std::to_string(instr.version)};
+      }
+      instr_class = instr.instr_class;
+      add_sized_operands(this->destination_memory, instr.destination_memory, instr.destination_memory_size);
+      add_sized_operands(this->source_memory, instr.source_memory, instr.source_memory_size);
+    } else {
+      auto dmem_end = std::remove(std::begin(instr.destination_memory), std::end(instr.destination_memory), uint64_t{0});
+      std::transform(std::begin(instr.destination_memory), dmem_end, std::back_inserter(this->destination_memory), [](auto x) { return champsim::address{x}; });
+
+      auto smem_end = std::remove(std::begin(instr.source_memory), std::end(instr.source_memory), uint64_t{0});
+      std::transform(std::begin(instr.source_memory), smem_end, std::back_inserter(this->source_memory), [](auto x) { return champsim::address{x}; });
+    }
+  }
+
+  // Add each operand that is present once for every block it touches, so that an access that crosses a block boundary is split
+  template <typename A, typename S>
+  static void add_sized_operands(std::vector<champsim::address>& operands, const A& addrs, const S& sizes)
   {
-    std::remove_copy(std::begin(instr.destination_registers), std::end(instr.destination_registers), std::back_inserter(this->destination_registers), 0);
-    std::remove_copy(std::begin(instr.source_registers), std::end(instr.source_registers), std::back_inserter(this->source_registers), 0);
+    for (std::size_t i = 0; i < std::size(addrs); ++i) {
+      if (sizes[i] > 0) {
+        champsim::address addr{addrs[i]};
+        operands.push_back(addr);
 
-    auto dmem_end = std::remove(std::begin(instr.destination_memory), std::end(instr.destination_memory), uint64_t{0});
-    std::transform(std::begin(instr.destination_memory), dmem_end, std::back_inserter(this->destination_memory), [](auto x) { return champsim::address{x}; });
+        champsim::block_number last_block{addr + (sizes[i] - 1)};
+        for (auto block = champsim::block_number{addr} + 1; block <= last_block; block += 1) {
+          operands.emplace_back(block);
+        }
+      }
+    }
+  }
 
-    auto smem_end = std::remove(std::begin(instr.source_memory), std::end(instr.source_memory), uint64_t{0});
-    std::transform(std::begin(instr.source_memory), smem_end, std::back_inserter(this->source_memory), [](auto x) { return champsim::address{x}; });
+public:
+  /**
+   * Derive the parts of a trace instruction that depend only on its IP and register operands.
+   */
+  template <typename T>
+  static champsim::static_instr_info decode(const T& instr)
+  {
+    champsim::static_instr_info info;
+    std::remove_copy(std::begin(instr.destination_registers), std::end(instr.destination_registers), std::back_inserter(info.destination_registers), 0);
+    std::remove_copy(std::begin(instr.source_registers), std::end(instr.source_registers), std::back_inserter(info.source_registers), 0);
 
-    bool writes_sp = std::count(std::begin(destination_registers), std::end(destination_registers), champsim::REG_STACK_POINTER);
-    bool writes_ip = std::count(std::begin(destination_registers), std::end(destination_registers), champsim::REG_INSTRUCTION_POINTER);
-    bool reads_sp = std::count(std::begin(source_registers), std::end(source_registers), champsim::REG_STACK_POINTER);
-    bool reads_flags = std::count(std::begin(source_registers), std::end(source_registers), champsim::REG_FLAGS);
-    bool reads_ip = std::count(std::begin(source_registers), std::end(source_registers), champsim::REG_INSTRUCTION_POINTER);
-    bool reads_other = std::count_if(std::begin(source_registers), std::end(source_registers), [](uint8_t r) {
+    const auto& dst = info.destination_registers;
+    const auto& src = info.source_registers;
+    bool writes_sp = std::count(std::begin(dst), std::end(dst), champsim::REG_STACK_POINTER);
+    bool writes_ip = std::count(std::begin(dst), std::end(dst), champsim::REG_INSTRUCTION_POINTER);
+    bool reads_sp = std::count(std::begin(src), std::end(src), champsim::REG_STACK_POINTER);
+    bool reads_flags = std::count(std::begin(src), std::end(src), champsim::REG_FLAGS);
+    bool reads_ip = std::count(std::begin(src), std::end(src), champsim::REG_INSTRUCTION_POINTER);
+    bool reads_other = std::count_if(std::begin(src), std::end(src), [](auto r) {
       return r != champsim::REG_STACK_POINTER && r != champsim::REG_FLAGS && r != champsim::REG_INSTRUCTION_POINTER;
     });
 
     // determine what kind of branch this is, if any
     if (!reads_sp && !reads_flags && writes_ip && !reads_other) {
       // direct jump
-      is_branch = true;
-      branch_taken = true;
-      branch = BRANCH_DIRECT_JUMP;
+      info.branch = BRANCH_DIRECT_JUMP;
     } else if (!reads_sp && !reads_ip && !reads_flags && writes_ip && reads_other) {
       // indirect branch
-      is_branch = true;
-      branch_taken = true;
-      branch = BRANCH_INDIRECT;
+      info.branch = BRANCH_INDIRECT;
     } else if (!reads_sp && reads_ip && !writes_sp && writes_ip && (reads_flags || reads_other)) {
       // conditional branch
-      is_branch = true;
-      branch_taken = instr.branch_taken; // don't change this
-      branch = BRANCH_CONDITIONAL;
+      info.branch = BRANCH_CONDITIONAL;
     } else if (reads_sp && reads_ip && writes_sp && writes_ip && !reads_flags && !reads_other) {
       // direct call
-      is_branch = true;
-      branch_taken = true;
-      branch = BRANCH_DIRECT_CALL;
+      info.branch = BRANCH_DIRECT_CALL;
     } else if (reads_sp && reads_ip && writes_sp && writes_ip && !reads_flags && reads_other) {
       // indirect call
-      is_branch = true;
-      branch_taken = true;
-      branch = BRANCH_INDIRECT_CALL;
+      info.branch = BRANCH_INDIRECT_CALL;
     } else if (reads_sp && !reads_ip && writes_sp && writes_ip) {
       // return
-      is_branch = true;
-      branch_taken = true;
-      branch = BRANCH_RETURN;
+      info.branch = BRANCH_RETURN;
     } else if (writes_ip) {
       // some other branch type that doesn't fit the above categories
-      is_branch = true;
-      branch_taken = instr.branch_taken; // don't change this
-      branch = BRANCH_OTHER;
-    } else {
-      branch_taken = false;
+      info.branch = BRANCH_OTHER;
     }
+
+    // Conditional and uncategorized branches take their direction from the trace. All other branches are always taken.
+    info.branch_follows_trace = (info.branch == BRANCH_CONDITIONAL || info.branch == BRANCH_OTHER);
+    info.branch_always_taken = (info.branch != NOT_BRANCH && !info.branch_follows_trace);
+    return info;
   }
 
-public:
-  ooo_model_instr(uint8_t cpu, input_instr instr) : ooo_model_instr(instr, {cpu, cpu}) {}
-  ooo_model_instr(uint8_t /*cpu*/, cloudsuite_instr instr) : ooo_model_instr(instr, {instr.asid[0], instr.asid[1]}) {}
+  ooo_model_instr(uint8_t cpu, input_instr instr) : ooo_model_instr(cpu, instr, decode(instr)) {}
+  ooo_model_instr(uint8_t cpu, cloudsuite_instr instr) : ooo_model_instr(cpu, instr, decode(instr)) {}
+  ooo_model_instr(uint8_t cpu, extended_instr instr) : ooo_model_instr(cpu, instr, decode(instr)) {}
+
+  /**
+   * Construct an instruction whose static parts have already been decoded, for instance by a champsim::decode_cache.
+   */
+  ooo_model_instr(uint8_t cpu, input_instr instr, const champsim::static_instr_info& static_info) : ooo_model_instr(instr, {cpu, cpu}, static_info) {}
+  ooo_model_instr(uint8_t /*cpu*/, cloudsuite_instr instr, const champsim::static_instr_info& static_info)
+      : ooo_model_instr(instr, {instr.asid[0], instr.asid[1]}, static_info)
+  {
+  }
+  ooo_model_instr(uint8_t cpu, extended_instr instr, const champsim::static_instr_info& static_info) : ooo_model_instr(instr, {cpu, cpu}, static_info) {}
 
   [[nodiscard]] std::size_t num_mem_ops() const { return std::size(destination_memory) + std::size(source_memory); }
 };
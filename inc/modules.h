@@ -27,6 +27,7 @@
 #include "champsim.h"
 
 class CACHE;
+class MEMORY_CONTROLLER;
 class O3_CPU;
 namespace champsim::modules
 {
@@ -73,6 +74,7 @@ struct branch_predictor : public bound_to<O3_CPU> {
 
 struct btb : public bound_to<O3_CPU> {
   explicit btb(O3_CPU* cpu) : bound_to<O3_CPU>(cpu) {}
+  void insert_fetch_bubble(long cycles) const;
 
   template <typename T, typename... Args>
   static auto initialize_member_impl(int) -> decltype(std::declval<T>().initialize_btb(std::declval<Args>()...), std::true_type{});
@@ -95,8 +97,24 @@ struct btb : public bound_to<O3_CPU> {
   template <typename T, typename... Args>
   constexpr static bool has_update_btb = decltype(update_member_impl<T, Args...>(0))::value;
 
+  template <typename T, typename... Args>
+  static auto prefetch_member_impl(int) -> decltype(std::declval<T>().prefetch_btb(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto prefetch_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_btb_prediction = decltype(predict_branch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_prefetch_btb = decltype(prefetch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  static auto final_stats_member_impl(int) -> decltype(std::declval<T>().btb_final_stats(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto final_stats_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_final_stats = decltype(final_stats_member_impl<T, Args...>(0))::value;
 };
 
 struct prefetcher : public bound_to<CACHE> {
@@ -153,6 +171,35 @@ struct prefetcher : public bound_to<CACHE> {
   constexpr static bool has_branch_operate = decltype(branch_operate_member_impl<T, Args...>(0))::value;
 };
 
+struct dram_prefetcher : public bound_to<MEMORY_CONTROLLER> {
+  explicit dram_prefetcher(MEMORY_CONTROLLER* controller) : bound_to<MEMORY_CONTROLLER>(controller) {}
+  bool prefetch_line(champsim::address pf_addr) const;
+
+  template <typename T, typename... Args>
+  static auto initialize_member_impl(int) -> decltype(std::declval<T>().dram_prefetcher_initialize(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto initialize_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto operate_member_impl(int) -> decltype(std::declval<T>().dram_prefetcher_operate(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto operate_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto final_stats_member_impl(int) -> decltype(std::declval<T>().dram_prefetcher_final_stats(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto final_stats_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_operate = decltype(operate_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_final_stats = decltype(final_stats_member_impl<T, Args...>(0))::value;
+};
+
 struct replacement : public bound_to<CACHE> {
   explicit replacement(CACHE* cache) : bound_to<CACHE>(cache) {}
 
@@ -166,6 +213,11 @@ struct replacement : public bound_to<CACHE> {
   template <typename, typename...>
   static auto find_victim_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto peek_victim_member_impl(int) -> decltype(std::declval<T>().peek_victim(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto peek_victim_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   static auto update_state_member_impl(int) -> decltype(std::declval<T>().update_replacement_state(std::declval<Args>()...), std::true_type{});
   template <typename, typename...>
@@ -187,6 +239,9 @@ struct replacement : public bound_to<CACHE> {
   template <typename T, typename... Args>
   constexpr static bool has_find_victim = decltype(find_victim_member_impl<T, Args...>(0))::value;
 
+  template <typename T, typename... Args>
+  constexpr static bool has_peek_victim = decltype(peek_victim_member_impl<T, Args...>(0))::value;
+
   template <typename T, typename... Args>
   constexpr static bool has_update_state = decltype(update_state_member_impl<T, Args...>(0))::value;
 
@@ -20,8 +20,10 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -64,8 +66,42 @@ constexpr bool cmp_equal(T t, U u) noexcept
   else
     return u < 0 ? false : t == UU(u);
 }
+
+/**
+ * Tags that can be compared as raw integers. Tables whose tag projection yields one of these types keep their tags in a packed array.
+ */
+template <typename Tag, typename = void>
+struct packed_tag {
+  constexpr static bool value = false;
+};
+
+template <typename Tag>
+struct packed_tag<Tag, std::enable_if_t<std::is_integral_v<Tag>>> {
+  constexpr static bool value = true;
+  static uint64_t pack(Tag tag) { return static_cast<uint64_t>(tag); }
+};
+
+template <typename Tag>
+struct packed_tag<Tag, std::enable_if_t<champsim::is_specialization_v<Tag, champsim::address_slice>>> {
+  constexpr static bool value = true;
+  static uint64_t pack(Tag tag) { return tag.template to<uint64_t>(); }
+};
 } // namespace detail
 
+/**
+ * A set-associative table with least-recently-used replacement.
+ *
+ * The LRU stamps and the stored elements are kept in separate contiguous arrays.
+ * If the tag projection produces an integral type or an address slice, the tags are also kept in their own array,
+ * so that the tag match is a tight loop over plain integers, and the tag projection is invoked once per lookup rather than once per way.
+ * The victim search is a reduction over the stamps, which the compiler vectorizes with the baseline instruction set.
+ * This choice is made inside the member functions, because projections that are nested in the class that holds the table
+ * may not have a deducible return type until that class is complete.
+ *
+ * LRU stamps are 32 bits wide and wrap. Recency is compared as the distance from the current access count,
+ * so the ordering is exact as long as no valid entry goes more than 2^32 table accesses without being touched.
+ * A stamp of zero marks an invalid way.
+ */
 template <typename T, typename SetProj = detail::table_indexer<T>, typename TagProj = detail::table_tagger<T>>
 class lru_table
 {
@@ -73,22 +109,26 @@ public:
   using value_type = T;
 
 private:
-  struct block_t {
-    uint64_t last_used = 0;
-    value_type data;
-  };
-  using block_vec_type = std::vector<block_t>;
-  using diff_type = typename block_vec_type::difference_type;
+  using stamp_type = uint32_t;
+  using diff_type = typename std::vector<value_type>::difference_type;
+
+  template <typename U = T>
+  using tag_traits = detail::packed_tag<std::decay_t<std::invoke_result_t<TagProj, const U&>>>;
+
+  template <typename U = T>
+  constexpr static bool is_packed = tag_traits<U>::value;
 
   SetProj set_projection;
   TagProj tag_projection;
 
   diff_type NUM_SET;
   diff_type NUM_WAY;
-  uint64_t access_count = 0;
-  block_vec_type block;
+  stamp_type access_count = 0;
+  std::vector<uint64_t> tags; // only populated when is_packed
+  std::vector<stamp_type> last_used;
+  std::vector<value_type> data;
 
-  auto get_set_span(const value_type& elem)
+  diff_type get_set_offset(const value_type& elem) const
   {
     diff_type set_idx;
     if constexpr (champsim::is_specialization_v<std::invoke_result_t<SetProj, decltype(elem)>, champsim::address_slice>) {
@@ -98,75 +138,111 @@ private:
     }
     if (set_idx < 0)
       throw std::range_error{"Set projection produced negative set index: " + std::to_string(set_idx)};
-    diff_type raw_idx{(set_idx % NUM_SET) * NUM_WAY};
-    auto begin = std::next(std::begin(block), raw_idx);
-    auto end = std::next(begin, NUM_WAY);
-    return std::pair{begin, end};
+    return (set_idx % NUM_SET) * NUM_WAY;
+  }
+
+  stamp_type next_stamp()
+  {
+    ++access_count;
+    if (access_count == 0) {
+      ++access_count; // zero is reserved for invalid ways
+    }
+    return access_count;
   }
 
-  auto match_func(const value_type& elem)
+  // Returns NUM_WAY if no valid way matches.
+  diff_type find_way(diff_type set_offset, const value_type& elem) const
   {
-    return [tag = tag_projection(elem), proj = this->tag_projection](const block_t& x) {
-      return x.last_used > 0 && proj(x.data) == tag;
-    };
+    const stamp_type* set_stamps = std::data(last_used) + set_offset;
+    if constexpr (is_packed<>) {
+      const uint64_t tag = tag_traits<>::pack(tag_projection(elem));
+      const uint64_t* set_tags = std::data(tags) + set_offset;
+      for (diff_type way = 0; way < NUM_WAY; ++way) {
+        if (set_stamps[way] != 0 && set_tags[way] == tag) {
+          return way;
+        }
+      }
+    } else {
+      const auto tag = tag_projection(elem);
+      const value_type* set_data = std::data(data) + set_offset;
+      for (diff_type way = 0; way < NUM_WAY; ++way) {
+        if (set_stamps[way] != 0 && tag_projection(set_data[way]) == tag) {
+          return way;
+        }
+      }
+    }
+    return NUM_WAY;
   }
 
-  template <typename U>
-  auto match_and_check(U tag)
+  // Invalid ways are the oldest possible, so they are chosen before any valid way.
+  // The age is computed without a branch so that the reduction can be vectorized.
+  stamp_type age(stamp_type stamp) const { return static_cast<stamp_type>(access_count - stamp) | static_cast<stamp_type>(-static_cast<stamp_type>(stamp == 0)); }
+
+  diff_type find_victim(diff_type set_offset) const
   {
-    return [tag, proj = this->tag_projection](const auto& x, const auto& y) {
-      auto x_valid = x.last_used > 0;
-      auto y_valid = y.last_used > 0;
-      auto x_match = proj(x.data) == tag;
-      auto y_match = proj(y.data) == tag;
-      auto cmp_lru = x.last_used < y.last_used;
-      return !x_valid || (y_valid && ((!x_match && y_match) || ((x_match == y_match) && cmp_lru)));
-    };
+    const stamp_type* set_stamps = std::data(last_used) + set_offset;
+    stamp_type oldest = 0;
+    for (diff_type way = 0; way < NUM_WAY; ++way) {
+      const stamp_type way_age = age(set_stamps[way]);
+      oldest = (way_age > oldest) ? way_age : oldest;
+    }
+    diff_type victim = 0;
+    while (age(set_stamps[victim]) != oldest) {
+      ++victim;
+    }
+    return victim;
   }
 
 public:
   std::optional<value_type> check_hit(const value_type& elem)
   {
-    auto [set_begin, set_end] = get_set_span(elem);
-    auto hit = std::find_if(set_begin, set_end, match_func(elem));
+    auto set_offset = get_set_offset(elem);
+    auto way = find_way(set_offset, elem);
 
-    if (hit == set_end) {
+    if (way == NUM_WAY) {
       return std::nullopt;
     }
 
-    hit->last_used = ++access_count;
-    return hit->data;
+    auto idx = static_cast<std::size_t>(set_offset + way);
+    last_used[idx] = next_stamp();
+    return data[idx];
   }
 
   void fill(const value_type& elem)
   {
-    auto tag = tag_projection(elem);
-    auto [set_begin, set_end] = get_set_span(elem);
-    if (set_begin != set_end) {
-      auto [miss, hit] = std::minmax_element(set_begin, set_end, match_and_check(tag));
-
-      if (tag_projection(hit->data) == tag) {
-        *hit = {++access_count, elem};
-      } else {
-        *miss = {++access_count, elem};
+    if (NUM_WAY > 0) {
+      auto set_offset = get_set_offset(elem);
+      auto way = find_way(set_offset, elem);
+      if (way == NUM_WAY) {
+        way = find_victim(set_offset);
       }
+
+      auto idx = static_cast<std::size_t>(set_offset + way);
+      if constexpr (is_packed<>) {
+        tags[idx] = tag_traits<>::pack(tag_projection(elem));
+      }
+      last_used[idx] = next_stamp();
+      data[idx] = elem;
     }
   }
 
   std::optional<value_type> invalidate(const value_type& elem)
   {
-    auto [set_begin, set_end] = get_set_span(elem);
-    auto hit = std::find_if(set_begin, set_end, match_func(elem));
+    auto set_offset = get_set_offset(elem);
+    auto way = find_way(set_offset, elem);
 
-    if (hit == set_end) {
+    if (way == NUM_WAY) {
       return std::nullopt;
     }
 
-    return std::exchange(*hit, {}).data;
+    auto idx = static_cast<std::size_t>(set_offset + way);
+    last_used[idx] = 0;
+    return std::exchange(data[idx], {});
   }
 
   lru_table(std::size_t sets, std::size_t ways, SetProj set_proj, TagProj tag_proj)
-      : set_projection(set_proj), tag_projection(tag_proj), NUM_SET(static_cast<diff_type>(sets)), NUM_WAY(static_cast<diff_type>(ways)), block(sets * ways)
+      : set_projection(set_proj), tag_projection(tag_proj), NUM_SET(static_cast<diff_type>(sets)), NUM_WAY(static_cast<diff_type>(ways)),
+        last_used(sets * ways), data(sets * ways)
   {
     if (!detail::cmp_equal(sets, static_cast<diff_type>(sets)))
       throw std::overflow_error{"Sets is out of bounds"};
@@ -176,6 +252,9 @@ public:
       throw std::range_error{"Sets is not positive"};
     if ((sets & (sets - 1)) != 0)
       throw std::range_error{"Sets is not a power of 2"};
+    if constexpr (is_packed<>) {
+      tags.resize(sets * ways);
+    }
   }
 
   lru_table(std::size_t sets, std::size_t ways, SetProj set_proj) : lru_table(sets, ways, set_proj, {}) {}
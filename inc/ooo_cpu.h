@@ -22,9 +22,11 @@
 #undef CHAMPSIM_MODULE
 #endif
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <deque>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -42,7 +44,7 @@
 #include "modules.h"
 #include "operable.h"
 #include "register_allocator.h"
-#include "util/lru_table.h"
+#include "uop_cache.h"
 #include "util/to_underlying.h"
 
 class CACHE;
@@ -84,6 +86,7 @@ class O3_CPU : public champsim::operable
 {
 public:
   uint32_t cpu = 0;
+  const champsim::core_model MODEL;
 
   // cycle
   champsim::chrono::clock::time_point begin_phase_time{};
@@ -103,11 +106,7 @@ public:
   stats_type roi_stats{}, sim_stats{};
 
   // instruction buffer
-  struct dib_shift {
-    champsim::data::bits shamt;
-    auto operator()(champsim::address val) const { return val.slice_upper(shamt); }
-  };
-  using dib_type = champsim::lru_table<champsim::address, dib_shift, dib_shift>;
+  using dib_type = champsim::uop_cache;
   dib_type DIB;
 
   // reorder buffer, load/store queue, register file
@@ -130,15 +129,47 @@ public:
   champsim::chrono::clock::duration DECODE_LATENCY;
   champsim::chrono::clock::duration SCHEDULING_LATENCY;
   champsim::chrono::clock::duration EXEC_LATENCY;
+  std::vector<champsim::chrono::clock::duration> CLASS_EXEC_LATENCY;
   champsim::chrono::clock::duration DIB_HIT_LATENCY;
+  champsim::chrono::clock::duration DIB_SWITCH_PENALTY;
+  bool DIB_INCLUSIVE;
 
   champsim::bandwidth::maximum_type L1I_BANDWIDTH, L1D_BANDWIDTH;
 
+  // The energy of each access to the reorder buffer, the load and store queues, and the branch predictor
+  champsim::access_energy ROB_ENERGY, LQ_ENERGY, SQ_ENERGY, BP_ENERGY;
+
+  const std::size_t IP_ATTRIBUTION_SIZE;
+
+  // The organization of the BTB, for the modules that accept one. An empty list leaves the organization to the module.
+  const std::vector<champsim::btb_level> BTB_LEVELS;
+  const bool BTB_PREFETCH_FROM_L1I;
+
   RegisterAllocator reg_allocator{REGISTER_FILE_SIZE};
 
   // branch
   champsim::chrono::clock::time_point fetch_resume_time{};
 
+  // decode
+  champsim::chrono::clock::time_point decode_resume_time{};
+  bool last_delivery_from_dib = false;
+  std::deque<champsim::address> l1i_evictions{};
+
+  // interval and in-order models
+  struct interval_register {
+    uint64_t producer = 0;
+    champsim::chrono::clock::time_point ready{};
+    bool pending = false;
+  };
+  struct interval_load {
+    uint64_t instr_id;
+    std::size_t issued = 0;
+    std::vector<bool> returned{}; // one flag for each source memory operand
+  };
+  std::vector<interval_register> interval_registers{};
+  std::deque<interval_load> interval_loads{};
+  champsim::chrono::clock::time_point interval_wake_time{}; // the interval core skips its stages until this time or a memory response
+
   const long IN_QUEUE_SIZE;
   std::deque<ooo_model_instr> input_queue;
 
@@ -161,8 +192,29 @@ public:
   long operate_lsq();
   long complete_inflight_instruction();
   long handle_memory_return();
+  long handle_instruction_return();
   long retire_rob();
 
+  long operate_interval();
+  long interval_dispatch();
+  long interval_issue_loads();
+  long interval_handle_data_return();
+  long interval_retire();
+  void interval_charge_stall();
+  [[nodiscard]] bool interval_can_read_trace() const;
+  [[nodiscard]] champsim::chrono::clock::time_point interval_next_event() const;
+  void interval_dispatch_one(ooo_model_instr instr);
+  void interval_resolve(ooo_model_instr& instr, champsim::chrono::clock::time_point complete);
+  [[nodiscard]] champsim::chrono::clock::duration interval_latency(const ooo_model_instr& instr) const;
+  interval_register& interval_reg(PHYSICAL_REGISTER_ID reg);
+
+  long operate_in_order();
+  long in_order_issue();
+
+  // Stall fetch for the given number of cycles, e.g. for a slower BTB level. This never shortens a stall already in progress,
+  // and applies in warmup as well, so that warmup fetches at the same rate as the measured phase.
+  void insert_fetch_bubble(long cycles);
+
   bool do_init_instruction(ooo_model_instr& instr);
   bool do_predict_branch(ooo_model_instr& instr);
   void do_check_dib(ooo_model_instr& instr);
@@ -170,6 +222,7 @@ public:
   void do_dib_update(const ooo_model_instr& instr);
   void do_scheduling(ooo_model_instr& instr);
   void do_execution(ooo_model_instr& instr);
+  [[nodiscard]] champsim::chrono::clock::duration execute_latency(const ooo_model_instr& instr) const;
   void do_memory_scheduling(ooo_model_instr& instr);
   void do_complete_execution(ooo_model_instr& instr);
   void do_sq_forward_to_lq(LSQ_ENTRY& sq_entry, LSQ_ENTRY& lq_entry);
@@ -201,6 +254,8 @@ public:
     virtual void impl_initialize_btb() = 0;
     virtual void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) = 0;
     virtual std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) = 0;
+    virtual void impl_prefetch_btb(champsim::address block_address) = 0;
+    virtual void impl_btb_final_stats() = 0;
   };
 
   template <typename... Bs>
@@ -221,6 +276,8 @@ public:
     void impl_initialize_btb() final;
     void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) final;
+    void impl_prefetch_btb(champsim::address block_address) final;
+    void impl_btb_final_stats() final;
   };
 
   std::unique_ptr<branch_module_concept> branch_module_pimpl;
@@ -234,23 +291,30 @@ public:
   void impl_initialize_btb() const;
   void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) const;
   [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) const;
+  void impl_prefetch_btb(champsim::address block_address) const;
+  void impl_btb_final_stats() const;
   // NOLINTEND(readability-make-member-function-const)
 
   template <typename... Bs, typename... Ts>
   explicit O3_CPU(champsim::core_builder<champsim::core_builder_module_type_holder<Bs...>, champsim::core_builder_module_type_holder<Ts...>> b)
-      : champsim::operable(b.m_clock_period), cpu(b.m_cpu),
-        DIB(b.m_dib_set, b.m_dib_way, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}),
+      : champsim::operable(b.m_clock_period), cpu(b.m_cpu), MODEL(b.m_model),
+        DIB(b.m_dib_set, b.m_dib_way, b.m_dib_window, b.m_dib_uops_per_line, b.m_dib_ways_per_window),
         LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
         REGISTER_FILE_SIZE(b.m_register_file_size), ROB_SIZE(b.m_rob_size), SQ_SIZE(b.m_sq_size), DIB_HIT_BUFFER_SIZE(b.m_dib_hit_buffer_size),
         FETCH_WIDTH(b.m_fetch_width), DECODE_WIDTH(b.m_decode_width), DISPATCH_WIDTH(b.m_dispatch_width), SCHEDULER_SIZE(b.m_schedule_width),
         EXEC_WIDTH(b.m_execute_width), DIB_INORDER_WIDTH(b.m_dib_inorder_width), LQ_WIDTH(b.m_lq_width), SQ_WIDTH(b.m_sq_width), RETIRE_WIDTH(b.m_retire_width),
         BRANCH_MISPREDICT_PENALTY(b.m_mispredict_penalty * b.m_clock_period), DISPATCH_LATENCY(b.m_dispatch_latency * b.m_clock_period),
         DECODE_LATENCY(b.m_decode_latency * b.m_clock_period), SCHEDULING_LATENCY(b.m_schedule_latency * b.m_clock_period),
-        EXEC_LATENCY(b.m_execute_latency * b.m_clock_period), DIB_HIT_LATENCY(b.m_dib_hit_latency * b.m_clock_period), L1I_BANDWIDTH(b.m_l1i_bw),
-        L1D_BANDWIDTH(b.m_l1d_bw), IN_QUEUE_SIZE(2 * champsim::to_underlying(b.m_fetch_width)), L1I_bus(b.m_cpu, b.m_fetch_queues),
-        L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this)),
+        EXEC_LATENCY(b.m_execute_latency * b.m_clock_period), DIB_HIT_LATENCY(b.m_dib_hit_latency * b.m_clock_period),
+        DIB_SWITCH_PENALTY(b.m_dib_switch_penalty * b.m_clock_period), DIB_INCLUSIVE(b.m_dib_inclusive), L1I_BANDWIDTH(b.m_l1i_bw),
+        L1D_BANDWIDTH(b.m_l1d_bw), ROB_ENERGY(b.get_rob_energy()), LQ_ENERGY(b.get_lq_energy()), SQ_ENERGY(b.get_sq_energy()),
+        BP_ENERGY(b.get_bp_energy()), IP_ATTRIBUTION_SIZE(b.m_ip_attribution), BTB_LEVELS(b.m_btb_levels),
+        BTB_PREFETCH_FROM_L1I(b.m_btb_prefetch_from_l1i), IN_QUEUE_SIZE(2 * champsim::to_underlying(b.m_fetch_width)),
+        L1I_bus(b.m_cpu, b.m_fetch_queues), L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this)),
         btb_module_pimpl(std::make_unique<btb_module_model<Ts...>>(this))
   {
+    std::transform(std::begin(b.m_class_execute_latency), std::end(b.m_class_execute_latency), std::back_inserter(CLASS_EXEC_LATENCY),
+                   [period = b.m_clock_period](auto latency) { return latency * period; });
   }
 };
 
@@ -374,4 +438,28 @@ std::pair<champsim::address, bool> O3_CPU::btb_module_model<Ts...>::impl_btb_pre
 #define CHAMPSIM_MODULE
 #endif
 
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_prefetch_btb(champsim::address block_address)
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_prefetch_btb<decltype(t), champsim::address>)
+      t.prefetch_btb(block_address);
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_btb_final_stats()
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_final_stats<decltype(t)>)
+      t.btb_final_stats();
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
 #endif
@@ -0,0 +1,143 @@
+#ifndef PAGE_PROFILE_H
+#define PAGE_PROFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "msl/bits.h"
+
+/**
+ * Parameters for the page hotness profile of the memory controller and the virtual memory.
+ *
+ * The profile is written as CSV to the given file, and is disabled if no file is given. The memory controller writes its counts at the end
+ * of each epoch of the given number of its cycles, and at the end of each phase. An epoch length of zero ends epochs only at the ends of phases.
+ * The virtual memory ignores the epoch length, and writes its counts at the end of each phase. Warmup phases are not profiled.
+ */
+struct page_profile_parameters {
+  std::string file{};
+  long epoch_length = 0;
+
+  [[nodiscard]] bool enabled() const { return !std::empty(file); }
+};
+
+struct page_access_counts {
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+  uint64_t row_hits = 0;
+
+  void add(bool write, bool row_hit)
+  {
+    ++(write ? writes : reads);
+    if (row_hit)
+      ++row_hits;
+  }
+
+  page_access_counts& operator+=(const page_access_counts& rhs)
+  {
+    reads += rhs.reads;
+    writes += rhs.writes;
+    row_hits += rhs.row_hits;
+    return *this;
+  }
+};
+
+namespace champsim
+{
+/**
+ * A table of counters keyed by page number.
+ *
+ * The counters are held in a single open-addressed array with linear probing, which doubles in size when it becomes three quarters full.
+ * The table never removes single entries, only clears all of them, which keeps the probe sequences intact without tombstones.
+ */
+template <typename T>
+class page_counter_table
+{
+public:
+  using key_type = uint64_t;
+  using value_type = std::pair<key_type, T>;
+
+private:
+  static constexpr key_type empty_key = std::numeric_limits<key_type>::max();
+
+  std::vector<value_type> slots;
+  std::size_t used = 0;
+
+  [[nodiscard]] std::size_t home(key_type key) const
+  {
+    // Fibonacci hashing spreads consecutive pages over the whole array
+    const auto bits = champsim::msl::lg2(std::size(slots));
+    return bits == 0 ? 0 : static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ULL) >> (std::numeric_limits<key_type>::digits - bits));
+  }
+
+  value_type& probe(key_type key)
+  {
+    auto idx = home(key);
+    while (slots[idx].first != empty_key && slots[idx].first != key)
+      idx = (idx + 1) & (std::size(slots) - 1);
+    return slots[idx];
+  }
+
+  void grow()
+  {
+    auto old_slots = std::exchange(slots, std::vector<value_type>(2 * std::size(slots), value_type{empty_key, T{}}));
+    for (auto& slot : old_slots) {
+      if (slot.first != empty_key)
+        probe(slot.first) = std::move(slot);
+    }
+  }
+
+public:
+  explicit page_counter_table(std::size_t initial_capacity = 64)
+      : slots(champsim::msl::next_pow2(std::max<std::size_t>(initial_capacity, 2)), value_type{empty_key, T{}})
+  {
+  }
+
+  /**
+   * The counter for the page, which is created if it does not exist
+   */
+  T& operator[](key_type key)
+  {
+    if (4 * (used + 1) > 3 * std::size(slots))
+      grow();
+
+    auto& slot = probe(key);
+    if (slot.first == empty_key) {
+      slot.first = key;
+      ++used;
+    }
+    return slot.second;
+  }
+
+  [[nodiscard]] std::size_t size() const { return used; }
+  [[nodiscard]] std::size_t capacity() const { return std::size(slots); }
+
+  /**
+   * Remove every counter, keeping the capacity
+   */
+  void clear()
+  {
+    std::fill(std::begin(slots), std::end(slots), value_type{empty_key, T{}});
+    used = 0;
+  }
+
+  /**
+   * The counters, in order of page number
+   */
+  [[nodiscard]] std::vector<value_type> sorted() const
+  {
+    std::vector<value_type> result;
+    result.reserve(used);
+    std::copy_if(std::begin(slots), std::end(slots), std::back_inserter(result), [](const auto& slot) { return slot.first != empty_key; });
+    std::sort(std::begin(result), std::end(result), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return result;
+  }
+};
+} // namespace champsim
+
+#endif
@@ -24,8 +24,10 @@
 #include <vector>
 
 #include "cache_stats.h"
+#include "channel.h"
 #include "core_stats.h"
 #include "dram_stats.h"
+#include "ptw_stats.h"
 
 namespace champsim
 {
@@ -44,6 +46,9 @@ struct phase_stats {
   std::vector<O3_CPU::stats_type> roi_cpu_stats, sim_cpu_stats;
   std::vector<CACHE::stats_type> roi_cache_stats, sim_cache_stats;
   std::vector<DRAM_CHANNEL::stats_type> roi_dram_stats, sim_dram_stats;
+  std::vector<dram_cache_stats> roi_dram_cache_stats, sim_dram_cache_stats;
+  std::vector<link_stats> roi_link_stats, sim_link_stats;
+  std::vector<ptw_stats> roi_ptw_stats, sim_ptw_stats;
 };
 
 } // namespace champsim
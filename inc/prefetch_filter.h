@@ -0,0 +1,67 @@
+#ifndef PREFETCH_FILTER_H
+#define PREFETCH_FILTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "msl/lru_table.h"
+
+namespace champsim
+{
+/**
+ * An admission filter for prefetch candidates, checked before they are placed in a cache's internal prefetch queue.
+ *
+ * A small exact table remembers the most recently issued prefetches. A counting Bloom filter tracks the blocks that are resident in the cache
+ * or in flight to it, and is kept up to date as blocks are filled and evicted. The Bloom filter may report blocks that are not present,
+ * but never misses a block that is.
+ */
+class prefetch_filter
+{
+public:
+  static constexpr std::size_t RECENT_SETS = 16;
+  static constexpr std::size_t RECENT_WAYS = 4;
+  static constexpr std::size_t BLOOM_HASHES = 3;
+  static constexpr std::size_t BLOOM_COUNTERS_PER_BLOCK = 16;
+
+  /**
+   * Construct a filter sized for the given number of resident and in-flight blocks.
+   */
+  explicit prefetch_filter(std::size_t tracked_blocks);
+
+  /**
+   * Check whether a prefetch to this block was issued recently, and refresh its entry if so.
+   */
+  bool recently_issued(uint64_t block);
+
+  /**
+   * Check whether the block may be resident or in flight.
+   */
+  [[nodiscard]] bool may_contain(uint64_t block) const;
+
+  void record_issue(uint64_t block);
+
+  /**
+   * Count the block as resident or in flight. Each insertion must be matched by exactly one erasure of the same block.
+   */
+  void insert(uint64_t block);
+  void erase(uint64_t block);
+
+private:
+  struct recent_entry {
+    uint64_t block;
+  };
+  struct recent_indexer {
+    auto operator()(const recent_entry& entry) const { return entry.block; }
+  };
+
+  champsim::msl::lru_table<recent_entry, recent_indexer, recent_indexer> recent_issues{RECENT_SETS, RECENT_WAYS};
+  std::vector<uint16_t> counters;
+  unsigned index_bits;
+
+  [[nodiscard]] std::array<std::size_t, BLOOM_HASHES> hash(uint64_t block) const;
+};
+} // namespace champsim
+
+#endif
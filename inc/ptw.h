@@ -28,6 +28,7 @@
 #include "channel.h"
 #include "operable.h"
 #include "ptw_builder.h"
+#include "ptw_stats.h"
 #include "util/lru_table.h"
 #include "waitable.h"
 
@@ -81,12 +82,17 @@ class PageTableWalker : public champsim::operable
   void finish_packet(const response_type& packet);
 
 public:
+  using stats_type = ptw_stats;
+
+  stats_type sim_stats, roi_stats;
+
   const std::string NAME;
   const uint32_t MSHR_SIZE;
   champsim::bandwidth::maximum_type MAX_READ, MAX_FILL;
   const champsim::chrono::clock::duration HIT_LATENCY;
 
   std::vector<pscl_type> pscl;
+  std::vector<champsim::access_energy> pscl_energy;
   VirtualMemory* vmem;
 
   const champsim::address CR3_addr;
@@ -96,6 +102,7 @@ public:
   long operate() final;
 
   void begin_phase() final;
+  void end_phase(unsigned cpu) final;
   void print_deadlock() final;
 };
 
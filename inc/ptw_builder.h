@@ -25,6 +25,7 @@
 
 #include "bandwidth.h"
 #include "chrono.h"
+#include "energy.h"
 
 class VirtualMemory;
 class PageTableWalker;
@@ -46,10 +47,12 @@ class ptw_builder
   std::vector<champsim::channel*> m_uls{};
   champsim::channel* m_ll{};
   VirtualMemory* m_vmem{};
+  champsim::partial_access_energy m_pscl_energy{};
 
   friend class ::PageTableWalker;
 
   uint32_t scaled_by_ul_size(double factor) const;
+  champsim::access_energy get_pscl_energy(uint32_t sets, uint32_t ways) const;
 
 public:
   ptw_builder& name(std::string_view name_);
@@ -65,6 +68,7 @@ public:
   ptw_builder& upper_levels(std::vector<champsim::channel*>&& uls_);
   ptw_builder& lower_level(champsim::channel* ll_);
   ptw_builder& virtual_memory(VirtualMemory* vmem_);
+  ptw_builder& pscl_energy(champsim::partial_access_energy pscl_energy_);
 };
 } // namespace champsim
 
@@ -0,0 +1,19 @@
+#ifndef PTW_STATS_H
+#define PTW_STATS_H
+
+#include <cstdint>
+#include <string>
+
+#include "energy.h"
+
+struct ptw_stats {
+  std::string name;
+  uint64_t pscl_lookups = 0;
+  uint64_t pscl_fills = 0;
+
+  champsim::energy_stats energy{};
+};
+
+ptw_stats operator-(ptw_stats lhs, ptw_stats rhs);
+
+#endif
@@ -3,6 +3,7 @@
 #include <list>
 #include <optional>
 #include <queue>
+#include <vector>
 
 #ifndef REG_ALLOC_H
 #define REG_ALLOC_H
@@ -19,14 +20,14 @@ struct physical_register {
 class RegisterAllocator
 {
 private:
-  std::array<PHYSICAL_REGISTER_ID, std::numeric_limits<uint8_t>::max() + 1> frontend_RAT, backend_RAT;
+  std::vector<PHYSICAL_REGISTER_ID> frontend_RAT, backend_RAT; // indexed by architectural register
   std::queue<PHYSICAL_REGISTER_ID> free_registers;
   std::vector<physical_register> physical_register_file;
 
 public:
   RegisterAllocator(size_t num_physical_registers);
-  PHYSICAL_REGISTER_ID rename_dest_register(int16_t reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id);
-  PHYSICAL_REGISTER_ID rename_src_register(int16_t reg);
+  PHYSICAL_REGISTER_ID rename_dest_register(PHYSICAL_REGISTER_ID reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id);
+  PHYSICAL_REGISTER_ID rename_src_register(PHYSICAL_REGISTER_ID reg);
   void complete_dest_register(PHYSICAL_REGISTER_ID physreg);
   void retire_dest_register(PHYSICAL_REGISTER_ID physreg);
   void free_register(PHYSICAL_REGISTER_ID physreg);
@@ -0,0 +1,128 @@
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace champsim::stats
+{
+/**
+ * A space-saving sketch, which finds the keys with the largest counts in a stream using bounded memory.
+ *
+ * The sketch tracks a fixed number of keys. When an untracked key arrives and the sketch is full, it replaces the key with the smallest count,
+ * inheriting that count as its error. A key's true count lies between ``count - error`` and ``count``. Any key whose true count exceeds the
+ * total divided by the number of tracked keys is guaranteed to be tracked. To make the reported keys reliable, the sketch tracks several times as many
+ * keys as it reports.
+ *
+ * Each tracked key also accumulates a weight, such as the latency of its misses. The weight is only accumulated while the key is tracked.
+ *
+ * A sketch that reports no keys is disabled, and ignores its input.
+ */
+template <typename Key>
+class space_saving
+{
+public:
+  using key_type = std::remove_cv_t<Key>;
+  using value_type = long;
+
+  struct entry {
+    key_type key;
+    value_type count;
+    value_type error;
+    value_type weight;
+  };
+
+  static constexpr std::size_t oversampling = 4;
+
+private:
+  std::size_t reported = 0;
+  std::vector<entry> entries{};
+
+  auto find(key_type key) { return std::find_if(std::begin(entries), std::end(entries), [key](const auto& x) { return x.key == key; }); }
+  auto find(key_type key) const { return std::find_if(std::begin(entries), std::end(entries), [key](const auto& x) { return x.key == key; }); }
+
+public:
+  space_saving() = default;
+  explicit space_saving(std::size_t reported_) : reported(reported_) {}
+
+  [[nodiscard]] bool enabled() const { return reported > 0; }
+  [[nodiscard]] std::size_t capacity() const { return reported * oversampling; }
+  [[nodiscard]] std::size_t size() const { return std::size(entries); }
+
+  /**
+   * Count an occurrence of the key, and add to its weight
+   */
+  void increment(key_type key, value_type count = 1, value_type weight = 0)
+  {
+    if (!enabled())
+      return;
+
+    auto found = find(key);
+    if (found == std::end(entries)) {
+      if (std::size(entries) < capacity()) {
+        entries.push_back({key, 0, 0, 0});
+        found = std::prev(std::end(entries));
+      } else {
+        found = std::min_element(std::begin(entries), std::end(entries), [](const auto& lhs, const auto& rhs) { return lhs.count < rhs.count; });
+        *found = entry{key, found->count, found->count, 0};
+      }
+    }
+
+    found->count += count;
+    found->weight += weight;
+  }
+
+  /**
+   * Add to the weight of the key, if it is tracked
+   */
+  void add_weight(key_type key, value_type weight)
+  {
+    if (auto found = find(key); found != std::end(entries))
+      found->weight += weight;
+  }
+
+  [[nodiscard]] value_type count_or(key_type key, value_type val) const
+  {
+    auto found = find(key);
+    return found == std::end(entries) ? val : found->count;
+  }
+
+  /**
+   * The reported number of keys with the largest counts, largest first
+   */
+  [[nodiscard]] std::vector<entry> top() const
+  {
+    auto result = entries;
+    auto by_count = [](const auto& lhs, const auto& rhs) { return lhs.count > rhs.count || (lhs.count == rhs.count && lhs.key < rhs.key); };
+    auto n = std::min(reported, std::size(result));
+    std::partial_sort(std::begin(result), std::next(std::begin(result), static_cast<long>(n)), std::end(result), by_count);
+    result.resize(n);
+    return result;
+  }
+
+  /**
+   * Remove the counts of an earlier snapshot of this sketch. Keys that the earlier snapshot did not track are left unchanged.
+   */
+  space_saving<key_type>& operator-=(const space_saving<key_type>& rhs)
+  {
+    for (auto& x : entries) {
+      if (auto found = rhs.find(x.key); found != std::end(rhs.entries)) {
+        x.count -= found->count;
+        x.weight -= found->weight;
+        x.error = std::max<value_type>(x.error - found->error, 0);
+      }
+    }
+    return *this;
+  }
+
+  friend auto operator-(space_saving<key_type> lhs, const space_saving<key_type>& rhs)
+  {
+    lhs -= rhs;
+    return lhs;
+  }
+};
+} // namespace champsim::stats
+
+#endif
@@ -19,9 +19,11 @@
 #include <vector>
 
 #include "cache.h"
+#include "dram_cache.h"
 #include "dram_controller.h"
 #include "ooo_cpu.h"
 #include "phase_info.h"
+#include "ptw.h"
 
 namespace champsim
 {
@@ -37,7 +39,11 @@ public:
   static std::vector<std::string> format(O3_CPU::stats_type stats);
   static std::vector<std::string> format(CACHE::stats_type stats);
   static std::vector<std::string> format(DRAM_CHANNEL::stats_type stats);
+  static std::vector<std::string> format(DRAM_CACHE::stats_type stats);
+  static std::vector<std::string> format(link_stats stats);
+  static std::vector<std::string> format(PageTableWalker::stats_type stats);
   static std::vector<std::string> format(phase_stats& stats);
+  static std::vector<std::string> format_energy(const phase_stats& stats);
 };
 
 class json_printer
@@ -32,6 +32,12 @@ constexpr std::size_t NUM_INSTR_DESTINATIONS_SPARC = 4;
 constexpr std::size_t NUM_INSTR_DESTINATIONS = 2;
 constexpr std::size_t NUM_INSTR_SOURCES = 4;
 
+// extended instruction format
+constexpr unsigned char EXTENDED_TRACE_VERSION = 1;
+constexpr std::size_t NUM_EXTENDED_DESTINATION_REGISTERS = 8;
+constexpr std::size_t NUM_EXTENDED_SOURCE_REGISTERS = 8;
+constexpr std::size_t NUM_EXTENDED_MEMORY_OPERANDS = 16;
+
 // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays): These classes are deliberately trivial
 struct input_instr {
   // instruction pointer or PC (Program Counter)
@@ -64,6 +70,30 @@ struct cloudsuite_instr {
 
   unsigned char asid[2];
 };
+
+struct extended_instr {
+  // instruction pointer or PC (Program Counter)
+  unsigned long long ip;
+
+  unsigned char version; // must be EXTENDED_TRACE_VERSION
+
+  // branch info
+  unsigned char is_branch;
+  unsigned char branch_taken;
+
+  unsigned char instr_class; // a category defined by the tracer, which selects the execution latency. 0 is unclassified.
+  unsigned char reserved[4];
+
+  unsigned short destination_registers[NUM_EXTENDED_DESTINATION_REGISTERS]; // output registers
+  unsigned short source_registers[NUM_EXTENDED_SOURCE_REGISTERS];           // input registers
+
+  unsigned long long destination_memory[NUM_EXTENDED_MEMORY_OPERANDS]; // output memory
+  unsigned long long source_memory[NUM_EXTENDED_MEMORY_OPERANDS];      // input memory
+
+  // The size of each memory operand in bytes. Operands with size 0 are not present.
+  unsigned char destination_memory_size[NUM_EXTENDED_MEMORY_OPERANDS];
+  unsigned char source_memory_size[NUM_EXTENDED_MEMORY_OPERANDS];
+};
 // NOLINTEND(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
 
 #endif
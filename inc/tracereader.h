@@ -24,6 +24,7 @@
 #include <string>
 #include <type_traits>
 
+#include "decode_cache.h"
 #include "instruction.h"
 #include "util/detect.h"
 
@@ -86,7 +87,9 @@ class bulk_tracereader
 
   constexpr static std::size_t buffer_size = 128;
   constexpr static std::size_t refresh_thresh = 1;
+  constexpr static std::size_t decode_cache_size = 4096;
   std::deque<ooo_model_instr> instr_buffer;
+  decode_cache<T> decoded_instrs{decode_cache_size};
 
 public:
   ooo_model_instr operator()();
@@ -126,7 +129,7 @@ ooo_model_instr bulk_tracereader<T, F>::operator()()
     // Inflate trace format into core model instructions
     auto begin = std::begin(trace_read_buf);
     auto end = std::next(begin, bytes_read / sizeof(T));
-    std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
+    std::transform(begin, end, std::back_inserter(instr_buffer), [this](const T& t) { return decoded_instrs(cpu, t); });
 
     // Set branch targets
     set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
@@ -139,8 +142,14 @@ ooo_model_instr bulk_tracereader<T, F>::operator()()
 }
 
 std::string get_fptr_cmd(std::string_view fname);
+
+/**
+ * The record formats that a trace may be written in
+ */
+enum class trace_format { standard, cloudsuite, extended };
 } // namespace champsim
 
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, champsim::trace_format format, bool repeat);
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat);
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef UOP_CACHE_H
+#define UOP_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "address.h"
+#include "msl/lru_table.h"
+
+namespace champsim
+{
+/**
+ * The decoded instruction buffer, modeled as a micro-op cache.
+ *
+ * Instructions are grouped into aligned windows. The micro-ops of a window are held in one or more lines, each with a fixed capacity,
+ * and all lines of a window reside in the same set. A window that needs more lines than it may occupy is not cached at all,
+ * and a window is only delivered from the cache if all of its lines are present.
+ *
+ * A capacity of zero micro-ops per line leaves the lines unbounded, so that each window occupies a single way.
+ * Each instruction is counted as one micro-op, the first time it is placed in its window. The instructions of a window are told apart
+ * by their offset in it; in windows larger than 64 bytes, instructions whose offsets share a 1/64 slice of the window are counted once.
+ */
+class uop_cache
+{
+public:
+  /**
+   * Construct a micro-op cache.
+   *
+   * \param sets The number of sets
+   * \param ways The number of ways in each set
+   * \param window_size The size of the aligned window, in bytes
+   * \param uops_per_line The number of micro-ops each line can hold, or zero for no limit
+   * \param ways_per_window The number of ways a single window may occupy, or zero to allow the whole set
+   */
+  uop_cache(std::size_t sets, std::size_t ways, std::size_t window_size, std::size_t uops_per_line = 0, std::size_t ways_per_window = 0);
+
+  /**
+   * Check whether the window containing this instruction can be delivered from the cache, and refresh its lines if so.
+   */
+  bool check_hit(champsim::address ip);
+
+  /**
+   * Place the micro-ops of a decoded instruction in the cache. An instruction that is already in its window adds nothing.
+   *
+   * \return false if the window outgrew the ways it may occupy and was removed
+   */
+  bool fill(champsim::address ip);
+
+  /**
+   * Remove every window that overlaps the given block.
+   *
+   * \return the number of windows that were removed
+   */
+  std::size_t invalidate(champsim::block_number block);
+
+private:
+  struct entry_type {
+    uint64_t window = 0;
+    std::size_t line = 0;
+    std::size_t uops = 0;
+    std::size_t lines = 1; // only meaningful in the first line of a window
+    uint64_t ips = 0;      // only meaningful in the first line of a window: the offsets of the instructions placed in it
+  };
+
+  struct indexer {
+    auto operator()(const entry_type& entry) const { return entry.window; }
+  };
+
+  struct tagger {
+    std::size_t max_lines;
+    auto operator()(const entry_type& entry) const { return entry.window * max_lines + entry.line; }
+  };
+
+  std::size_t UOPS_PER_LINE;
+  std::size_t MAX_LINES;
+  champsim::data::bits window_bits;
+  champsim::data::bits offset_shift;
+  champsim::msl::lru_table<entry_type, indexer, tagger> table;
+
+  [[nodiscard]] uint64_t window_of(champsim::address ip) const;
+  [[nodiscard]] uint64_t offset_bit(champsim::address ip) const;
+  bool invalidate_window(uint64_t window);
+};
+} // namespace champsim
+
+#endif
@@ -19,18 +19,44 @@
 
 #include <cstdint>
 #include <deque>
+#include <fstream>
 #include <map>
 #include <optional>
 #include <random>
+#include <vector>
 
 #include "address.h"
 #include "champsim.h"
 #include "chrono.h"
+#include "page_profile.h"
 
 class MEMORY_CONTROLLER;
 
 using pte_entry = champsim::data::size<long long, std::ratio<8>>;
 
+/**
+ * Parameters for the placement of virtual pages in physical memory.
+ *
+ * The random policy hands out pages in a shuffled order if a randomization seed is given, and in order otherwise. The sequential policy always
+ * hands them out in order. The coloring policy gives each virtual page a physical page of the same color, where the colors are either the sets
+ * of the last-level cache that a page maps to, or the DRAM bank that holds the start of the page. The buddy policy hands out the blocks of a
+ * fragmented buddy allocator in a random order, so that runs of contiguous pages are as long as the fragmentation allows. The NUMA policy
+ * divides physical memory evenly into nodes, and places the pages of each core in its own node.
+ *
+ * Whenever the preferred pages have run out, pages are taken from the next color or node that has some left.
+ */
+struct page_allocation_parameters {
+  enum class policy_type { random, sequential, coloring, buddy, numa };
+  enum class color_type { llc, bank };
+
+  policy_type policy = policy_type::random;
+  color_type color = color_type::llc;
+  std::size_t llc_sets = 2048;
+  double fragmentation = 0.5; // The probability that each free block is split, at each order
+  std::size_t max_order = 10;
+  std::size_t nodes = 1;
+};
+
 class VirtualMemory
 {
 private:
@@ -38,6 +64,8 @@ private:
   std::map<std::tuple<uint32_t, uint32_t, champsim::address_slice<champsim::dynamic_extent>>, champsim::address> page_table;
   std::optional<uint64_t> randomization_seed;
   MEMORY_CONTROLLER& dram;
+  const page_allocation_parameters allocation;
+  const page_profile_parameters profile_params;
 
 public:
   const champsim::chrono::clock::duration minor_fault_penalty;
@@ -45,18 +73,25 @@ public:
   const pte_entry pte_page_size; // Size of a PTE page
 
 private:
-  std::deque<champsim::page_number> ppage_free_list;
+  // One free list for each color or node, or a single list for the other policies
+  std::vector<std::deque<champsim::page_number>> ppage_free_lists;
   champsim::page_number active_pte_page{};
   champsim::address_slice<champsim::dynamic_extent> next_pte_page;
 
-  // champsim::page_number next_ppage;
-  // champsim::page_number last_ppage;
+  // The number of translations of each virtual page in the current phase, for each core
+  std::vector<champsim::page_counter_table<uint64_t>> translations{};
+  std::ofstream profile_file{};
 
-  [[nodiscard]] champsim::page_number ppage_front() const;
-  void ppage_pop();
+  [[nodiscard]] champsim::page_number ppage_front(std::size_t list) const;
+  void ppage_pop(std::size_t list);
+
+  [[nodiscard]] std::size_t num_free_lists() const;
+  [[nodiscard]] std::size_t free_list_of(champsim::page_number ppage, std::size_t index, std::size_t count) const;
+  [[nodiscard]] std::size_t free_list_for(uint32_t cpu_num, champsim::page_number vaddr) const;
 
   void shuffle_pages();
   void populate_pages();
+  void order_buddy_blocks(std::vector<champsim::page_number>& pages) const;
 
 public:
   /**
@@ -74,6 +109,11 @@ public:
                 MEMORY_CONTROLLER& dram_);
   VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
                 MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_);
+  VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
+                MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_, page_allocation_parameters allocation_params);
+  VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
+                MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_, page_allocation_parameters allocation_params,
+                page_profile_parameters profile_params_);
 
   /**
    * Find the bit location of the lowest bit for the given page table level.
@@ -96,6 +136,16 @@ public:
    */
   [[nodiscard]] std::size_t available_ppages() const;
 
+  /**
+   * The color of the given page, under the coloring policy.
+   */
+  [[nodiscard]] std::size_t page_color(champsim::page_number page) const;
+
+  /**
+   * The number of page colors, under the coloring policy.
+   */
+  [[nodiscard]] std::size_t num_colors() const;
+
   /**
    * Translate the given address from the virtual space to the physical space.
    * If a page translation does not already exist, one will be created and the minor fault penalty will be applied.
@@ -118,6 +168,17 @@ public:
    * :returns: A pair of the page table page address and the latency to be applied to the operation.
    */
   std::pair<champsim::address, champsim::chrono::clock::duration> get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level);
+
+  /**
+   * Discard the translation counts of every core, at the start of a phase.
+   */
+  void clear_page_profile();
+
+  /**
+   * Write the translation counts of the given core to the profile, with the physical page that each virtual page maps to, and discard them.
+   * The physical pages join this profile to the page counts of the memory controller.
+   */
+  void write_page_profile(uint32_t cpu_num);
 };
 
 #endif
@@ -0,0 +1,115 @@
+#include "bop.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+
+#include "cache.h"
+
+namespace
+{
+bool has_only_small_factors(long n)
+{
+  for (auto p : {2, 3, 5}) {
+    while (n % p == 0)
+      n /= p;
+  }
+  return n == 1;
+}
+} // namespace
+
+void bop::prefetcher_initialize()
+{
+  // Candidate offsets are the integers whose prime factors are no greater than 5. Offsets that always leave the page can never be issued.
+  const auto limit = std::min<offset_type>(MAX_OFFSET, PAGE_SIZE / BLOCK_SIZE);
+  for (offset_type offset = 1; offset < limit; ++offset) {
+    if (has_only_small_factors(offset)) {
+      candidates.push_back(offset);
+      candidates.push_back(-offset);
+    }
+  }
+  scores.assign(std::size(candidates), 0);
+}
+
+void bop::end_phase()
+{
+  auto best = std::max_element(std::begin(scores), std::end(scores));
+  best_offset = candidates.at(static_cast<std::size_t>(std::distance(std::begin(scores), best)));
+  best_score = *best;
+
+  // Throttle on low scores: a poor best offset is issued at a reduced degree, and a useless one turns prefetching off
+  if (best_score <= BAD_SCORE)
+    degree = 0;
+  else if (best_score < LOW_SCORE)
+    degree = 1;
+  else
+    degree = MAX_DEGREE;
+
+  ++stats.phases;
+  if (degree == 0)
+    ++stats.phases_disabled;
+
+  std::fill(std::begin(scores), std::end(scores), 0);
+  test_index = 0;
+  round = 0;
+}
+
+void bop::learn(champsim::block_number cl_addr)
+{
+  auto idx = test_index;
+  const auto base = cl_addr - candidates.at(idx);
+  if (champsim::page_number{base} == champsim::page_number{cl_addr} && recent_requests.check_hit({base}).has_value())
+    ++scores.at(idx);
+
+  ++test_index;
+  if (test_index == std::size(candidates)) {
+    test_index = 0;
+    ++round;
+  }
+
+  if (scores.at(idx) >= SCORE_MAX || round >= ROUND_MAX)
+    end_phase();
+}
+
+uint32_t bop::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                       uint32_t metadata_in)
+{
+  // Only misses and first hits on prefetched blocks would have benefitted from a prefetch
+  if (cache_hit && !useful_prefetch)
+    return metadata_in;
+
+  champsim::block_number cl_addr{addr};
+  learn(cl_addr);
+
+  for (int i = 1; i <= degree; ++i) {
+    champsim::address pf_addr{cl_addr + (i * best_offset)};
+    if (champsim::page_number{pf_addr} != champsim::page_number{addr})
+      break;
+
+    if (prefetch_line(pf_addr, true, metadata_in))
+      ++stats.issued;
+  }
+
+  return metadata_in;
+}
+
+uint32_t bop::prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in)
+{
+  champsim::block_number cl_addr{addr};
+
+  // A prefetched fill records the access that would have triggered it. While prefetching is off, demand fills are recorded so that learning can continue.
+  if (prefetch) {
+    const auto base = cl_addr - best_offset;
+    if (champsim::page_number{base} == champsim::page_number{cl_addr})
+      recent_requests.fill({base});
+  } else if (degree == 0) {
+    recent_requests.fill({cl_addr});
+  }
+
+  return metadata_in;
+}
+
+void bop::prefetcher_final_stats()
+{
+  fmt::print("{} BOP best offset: {} score: {} degree: {} phases: {} phases disabled: {} issued: {}\n", intern_->NAME, best_offset, best_score, degree,
+             stats.phases, stats.phases_disabled, stats.issued);
+}
@@ -0,0 +1,83 @@
+#ifndef PREFETCHER_BOP_H
+#define PREFETCHER_BOP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "address.h"
+#include "champsim.h"
+#include "modules.h"
+#include "msl/bits.h"
+#include "msl/lru_table.h"
+
+/*
+ * Best-Offset prefetcher (Michaud, DPC-2 / HPCA 2016)
+ *
+ * The prefetcher learns a single offset D such that prefetching X+D on an access to X would have completed in time. Completed fills are recorded in
+ * the recent requests (RR) table as their base address (Y-D for a prefetched fill of Y). On each triggering access X, one candidate offset d is
+ * tested: if X-d is in the RR table, a prefetch with offset d would have been timely, and the score of d is incremented. At the end of a learning
+ * phase, the best-scoring offset becomes the prefetch offset.
+ */
+class bop : public champsim::modules::prefetcher
+{
+public:
+  using offset_type = champsim::block_number::difference_type;
+
+  static constexpr std::size_t RR_SETS = 256;
+  static constexpr int SCORE_MAX = 31;
+  static constexpr int ROUND_MAX = 100;
+  static constexpr int BAD_SCORE = 1;
+  static constexpr int LOW_SCORE = 10;
+  static constexpr int MAX_DEGREE = 2;
+  static constexpr offset_type MAX_OFFSET = 256;
+
+private:
+  struct rr_entry {
+    champsim::block_number base{};
+  };
+
+  struct rr_indexer {
+    auto operator()(const rr_entry& entry) const
+    {
+      auto raw = entry.base.to<uint64_t>();
+      return (raw ^ (raw >> champsim::msl::lg2(RR_SETS))) & (RR_SETS - 1);
+    }
+  };
+  struct rr_tagger {
+    auto operator()(const rr_entry& entry) const { return entry.base; }
+  };
+
+  champsim::msl::lru_table<rr_entry, rr_indexer, rr_tagger> recent_requests{RR_SETS, 1};
+
+  std::vector<offset_type> candidates{};
+  std::vector<int> scores{};
+  std::size_t test_index = 0;
+  int round = 0;
+
+  offset_type best_offset = 1;
+  int best_score = 0;
+  int degree = 1;
+
+  struct {
+    uint64_t phases = 0;
+    uint64_t phases_disabled = 0;
+    uint64_t issued = 0;
+  } stats;
+
+  void learn(champsim::block_number cl_addr);
+  void end_phase();
+
+public:
+  using prefetcher::prefetcher;
+
+  void prefetcher_initialize();
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                    uint32_t metadata_in);
+  uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
+  void prefetcher_final_stats();
+
+  [[nodiscard]] offset_type current_offset() const { return best_offset; }
+  [[nodiscard]] int current_degree() const { return degree; }
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "pythia.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+
+#include "cache.h"
+
+namespace
+{
+std::size_t feature_hash(uint64_t key)
+{
+  // Thomas Wang's 64 bit mix function
+  key = (~key) + (key << 21);
+  key = key ^ (key >> 24);
+  key = (key + (key << 3)) + (key << 8);
+  key = key ^ (key >> 14);
+  key = (key + (key << 2)) + (key << 4);
+  key = key ^ (key >> 28);
+  key = key + (key << 31);
+  return static_cast<std::size_t>(key);
+}
+} // namespace
+
+void pythia::prefetcher_initialize()
+{
+  // Optimistic initialization, so that every action is tried before it is ruled out
+  for (auto& feature : qtable)
+    for (auto& row : feature)
+      row.fill(1.0 / (1.0 - GAMMA));
+}
+
+double pythia::q_value(const state_type& state, std::size_t action) const
+{
+  double retval = 0;
+  for (std::size_t i = 0; i < NUM_FEATURES; ++i)
+    retval += qtable.at(i).at(state.at(i)).at(action);
+  return retval;
+}
+
+std::size_t pythia::select_action(const state_type& state)
+{
+  ++stats.actions;
+  if (explore_dist(rng) < EPSILON) {
+    ++stats.explored;
+    return action_dist(rng);
+  }
+
+  std::size_t best = 0;
+  for (std::size_t action = 1; action < std::size(ACTIONS); ++action) {
+    if (q_value(state, action) > q_value(state, best))
+      best = action;
+  }
+  return best;
+}
+
+void pythia::update(const eq_entry& entry, const eq_entry& next)
+{
+  // SARSA: move Q(s,a) toward r + gamma * Q(s',a')
+  const auto target = entry.reward.value_or(0) + GAMMA * q_value(next.state, next.action);
+  const auto error = target - q_value(entry.state, entry.action);
+  for (std::size_t i = 0; i < NUM_FEATURES; ++i)
+    qtable.at(i).at(entry.state.at(i)).at(entry.action) += ALPHA * error;
+}
+
+void pythia::insert(eq_entry entry)
+{
+  if (!entry.reward.has_value())
+    eq_unrewarded.emplace(entry.pf_addr.to<uint64_t>(), eq_front_seq + std::size(evaluation_queue));
+  evaluation_queue.push_back(entry);
+
+  if (std::size(evaluation_queue) > EQ_SIZE) {
+    auto& victim = evaluation_queue.front();
+    if (!victim.reward.has_value()) {
+      victim.reward = high_bandwidth ? R_INACCURATE_HIGH_BW : R_INACCURATE_LOW_BW;
+      ++stats.inaccurate;
+      forget(victim.pf_addr, eq_front_seq);
+    }
+    // SARSA bootstraps from the action that was taken right after the victim's
+    update(victim, evaluation_queue.at(1));
+    evaluation_queue.pop_front();
+    ++eq_front_seq;
+  }
+}
+
+void pythia::forget(champsim::block_number pf_addr, uint64_t seq)
+{
+  auto [begin, end] = eq_unrewarded.equal_range(pf_addr.to<uint64_t>());
+  auto found = std::find_if(begin, end, [seq](const auto& x) { return x.second == seq; });
+  if (found != end)
+    eq_unrewarded.erase(found);
+}
+
+uint32_t pythia::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                          uint32_t metadata_in)
+{
+  champsim::block_number cl_addr{addr};
+  champsim::page_number page{addr};
+
+  // Reward the actions that prefetched this block
+  auto [rewarded_begin, rewarded_end] = eq_unrewarded.equal_range(cl_addr.to<uint64_t>());
+  for (auto it = rewarded_begin; it != rewarded_end; ++it) {
+    auto& entry = evaluation_queue.at(it->second - eq_front_seq);
+    entry.reward = entry.filled ? R_ACCURATE_TIMELY : R_ACCURATE_LATE;
+    ++(entry.filled ? stats.accurate_timely : stats.accurate_late);
+  }
+  eq_unrewarded.erase(rewarded_begin, rewarded_end);
+
+  // Update the delta history of this page
+  page_tracker tracked{page, cl_addr, {}};
+  if (auto found = tracker.check_hit(tracked); found.has_value()) {
+    tracked.deltas = found->deltas;
+    std::rotate(std::begin(tracked.deltas), std::next(std::begin(tracked.deltas)), std::end(tracked.deltas));
+    tracked.deltas.back() = champsim::offset(found->last_block, cl_addr);
+  }
+  tracker.fill(tracked);
+
+  // Build the state from the program context
+  uint64_t delta_signature = 0;
+  for (auto delta : tracked.deltas)
+    delta_signature = (delta_signature << 8) ^ static_cast<uint64_t>(delta);
+  state_type state{feature_hash(ip.to<uint64_t>() ^ (static_cast<uint64_t>(tracked.deltas.back()) << 48)) % QTABLE_SIZE,
+                   feature_hash(delta_signature) % QTABLE_SIZE};
+
+  eq_entry entry{state, select_action(state), cl_addr, std::nullopt, false};
+  const auto offset = ACTIONS.at(entry.action);
+  if (offset == 0) {
+    entry.reward = high_bandwidth ? R_NO_PREFETCH_HIGH_BW : R_NO_PREFETCH_LOW_BW;
+    ++stats.no_prefetch;
+  } else {
+    entry.pf_addr = cl_addr + offset;
+    if (champsim::page_number{entry.pf_addr} != page) {
+      entry.reward = R_CROSS_PAGE;
+      ++stats.cross_page;
+    } else if (!prefetch_line(champsim::address{entry.pf_addr}, true, metadata_in)) {
+      // An action whose prefetch was not issued has no outcome to learn from
+      ++stats.not_issued;
+      return metadata_in;
+    }
+  }
+
+  insert(entry);
+
+  return metadata_in;
+}
+
+uint32_t pythia::prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in)
+{
+  if (prefetch) {
+    auto [begin, end] = eq_unrewarded.equal_range(champsim::block_number{addr}.to<uint64_t>());
+    for (auto it = begin; it != end; ++it)
+      evaluation_queue.at(it->second - eq_front_seq).filled = true;
+  }
+
+  return metadata_in;
+}
+
+void pythia::sample_bandwidth()
+{
+  if (intern_->memory_controller == nullptr)
+    return;
+
+  auto current = intern_->memory_controller->telemetry();
+  if (last_telemetry.has_value()) {
+    high_bandwidth = current.utilization_since(*last_telemetry) >= HIGH_BW_UTILIZATION || current.congestion_since(*last_telemetry) >= HIGH_BW_CONGESTION;
+    ++stats.epochs;
+    if (high_bandwidth)
+      ++stats.high_bandwidth_epochs;
+  }
+  last_telemetry = current;
+}
+
+void pythia::prefetcher_cycle_operate()
+{
+  if (++cycles_since_sample >= BW_EPOCH) {
+    cycles_since_sample = 0;
+    sample_bandwidth();
+  }
+}
+
+void pythia::prefetcher_final_stats()
+{
+  fmt::print("{} Pythia actions: {} explored: {} no prefetch: {} not issued: {} accurate timely: {} accurate late: {} inaccurate: {} cross page: {}\n",
+             intern_->NAME, stats.actions, stats.explored, stats.no_prefetch, stats.not_issued, stats.accurate_timely, stats.accurate_late, stats.inaccurate,
+             stats.cross_page);
+  fmt::print("{} Pythia high bandwidth epochs: {} of {}\n", intern_->NAME, stats.high_bandwidth_epochs, stats.epochs);
+}
@@ -0,0 +1,123 @@
+#ifndef PREFETCHER_PYTHIA_H
+#define PREFETCHER_PYTHIA_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <random>
+#include <unordered_map>
+
+#include "address.h"
+#include "champsim.h"
+#include "dram_controller.h"
+#include "modules.h"
+#include "msl/lru_table.h"
+
+/*
+ * A reinforcement-learning prefetcher in the style of Pythia (Bera et al., MICRO 2021)
+ *
+ * Each demand access forms a state from program-context features. The agent picks a prefetch offset (or no prefetch) with an epsilon-greedy
+ * policy over a Q-table, and places the action in an evaluation queue. The action is rewarded when a later demand matches the prefetched block
+ * (more if it arrived in time), or penalized when it leaves the queue unused. Penalties for inaccurate prefetches and rewards for not prefetching
+ * depend on whether memory bandwidth usage is high, as reported by the memory controller's telemetry. Q-values are updated with SARSA.
+ */
+class pythia : public champsim::modules::prefetcher
+{
+public:
+  using offset_type = champsim::block_number::difference_type;
+
+  static constexpr std::array<offset_type, 16> ACTIONS{1, 0, -6, -3, -1, 3, 4, 5, 10, 11, 12, 16, 22, 23, 30, 32};
+
+  static constexpr std::size_t NUM_FEATURES = 2;
+  static constexpr std::size_t QTABLE_SIZE = 1024;
+  static constexpr std::size_t EQ_SIZE = 256;
+  static constexpr std::size_t TRACKER_SETS = 64;
+  static constexpr std::size_t TRACKER_WAYS = 4;
+  static constexpr std::size_t DELTA_HISTORY = 4;
+
+  static constexpr double ALPHA = 0.0065;
+  static constexpr double GAMMA = 0.556;
+  static constexpr double EPSILON = 0.002;
+
+  static constexpr double R_ACCURATE_TIMELY = 20;
+  static constexpr double R_ACCURATE_LATE = 12;
+  static constexpr double R_CROSS_PAGE = -12;
+  static constexpr double R_INACCURATE_HIGH_BW = -14;
+  static constexpr double R_INACCURATE_LOW_BW = -8;
+  static constexpr double R_NO_PREFETCH_HIGH_BW = -2;
+  static constexpr double R_NO_PREFETCH_LOW_BW = -4;
+
+  static constexpr long BW_EPOCH = 2048; // cycles between bandwidth samples
+  static constexpr double HIGH_BW_UTILIZATION = 0.5;
+  static constexpr double HIGH_BW_CONGESTION = 0.5;
+
+private:
+  using state_type = std::array<std::size_t, NUM_FEATURES>;
+
+  struct eq_entry {
+    state_type state{};
+    std::size_t action = 0;
+    champsim::block_number pf_addr{};
+    std::optional<double> reward{};
+    bool filled = false;
+  };
+
+  struct page_tracker {
+    champsim::page_number page{};
+    champsim::block_number last_block{};
+    std::array<offset_type, DELTA_HISTORY> deltas{};
+  };
+
+  struct tracker_indexer {
+    auto operator()(const page_tracker& entry) const { return entry.page; }
+  };
+
+  champsim::msl::lru_table<page_tracker, tracker_indexer, tracker_indexer> tracker{TRACKER_SETS, TRACKER_WAYS};
+  std::array<std::array<std::array<double, std::size(ACTIONS)>, QTABLE_SIZE>, NUM_FEATURES> qtable{};
+  std::deque<eq_entry> evaluation_queue{};
+  uint64_t eq_front_seq = 0; // the number of entries that have left the evaluation queue
+
+  // The positions in the evaluation queue of the prefetches that have not yet been rewarded, by prefetched block
+  std::unordered_multimap<uint64_t, uint64_t> eq_unrewarded{};
+
+  std::mt19937_64 rng{};
+  std::uniform_real_distribution<double> explore_dist{0, 1};
+  std::uniform_int_distribution<std::size_t> action_dist{0, std::size(ACTIONS) - 1};
+
+  std::optional<dram_telemetry> last_telemetry{};
+  long cycles_since_sample = 0;
+  bool high_bandwidth = false;
+
+  struct {
+    uint64_t actions = 0;
+    uint64_t explored = 0;
+    uint64_t no_prefetch = 0;
+    uint64_t not_issued = 0;
+    uint64_t accurate_timely = 0;
+    uint64_t accurate_late = 0;
+    uint64_t inaccurate = 0;
+    uint64_t cross_page = 0;
+    uint64_t high_bandwidth_epochs = 0;
+    uint64_t epochs = 0;
+  } stats;
+
+  [[nodiscard]] double q_value(const state_type& state, std::size_t action) const;
+  [[nodiscard]] std::size_t select_action(const state_type& state);
+  void update(const eq_entry& entry, const eq_entry& next);
+  void insert(eq_entry entry);
+  void forget(champsim::block_number pf_addr, uint64_t seq);
+  void sample_bandwidth();
+
+public:
+  using prefetcher::prefetcher;
+
+  void prefetcher_initialize();
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                    uint32_t metadata_in);
+  uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
+  void prefetcher_cycle_operate();
+  void prefetcher_final_stats();
+};
+
+#endif
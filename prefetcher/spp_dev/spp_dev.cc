@@ -1,5 +1,6 @@
 #include "spp_dev.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -20,11 +21,19 @@ void spp_dev::prefetcher_initialize()
   std::cout << std::endl << "Initialize PREFETCH FILTER" << std::endl;
   std::cout << "FILTER_SET: " << FILTER_SET << std::endl;
 
+  if constexpr (PPF_ON) {
+    std::cout << std::endl << "Initialize PERCEPTRON FILTER" << std::endl;
+    std::cout << "PPF_FEATURE: " << PPF_FEATURE << std::endl;
+    std::cout << "PPF_WEIGHT_SET: " << PPF_WEIGHT_SET << std::endl;
+    std::cout << "PPF_TABLE_SET: " << PPF_TABLE_SET << std::endl;
+  }
+
   // pass pointers
   ST._parent = this;
   PT._parent = this;
   FILTER._parent = this;
   GHR._parent = this;
+  PPF._parent = this;
 }
 
 void spp_dev::prefetcher_cycle_operate() {}
@@ -59,6 +68,12 @@ uint32_t spp_dev::prefetcher_cache_operate(champsim::address addr, champsim::add
   // Also check the prefetch filter in parallel to update global accuracy counters
   FILTER.check(addr, spp_dev::L2C_DEMAND);
 
+  // Train the perceptron on the first demand to each prefetched or rejected line
+  if constexpr (PPF_ON) {
+    if (!cache_hit || useful_prefetch)
+      PPF.demand(addr);
+  }
+
   // Stage 2: Update delta patterns stored in PT
   if (last_sig)
     PT.update_pattern(last_sig, delta);
@@ -78,10 +93,32 @@ uint32_t spp_dev::prefetcher_cache_operate(champsim::address addr, champsim::add
         champsim::address pf_addr{champsim::block_number{base_addr} + delta_q[i]};
 
         if (champsim::page_number{pf_addr} == page) { // Prefetch request is in the same physical page
-          if (FILTER.check(pf_addr, ((confidence_q[i] >= FILL_THRESHOLD) ? spp_dev::SPP_L2C_PREFETCH : spp_dev::SPP_LLC_PREFETCH))) {
-            prefetch_line(pf_addr, (confidence_q[i] >= FILL_THRESHOLD), 0); // Use addr (not base_addr) to obey the same physical page boundary
+          bool fill_this_level = (confidence_q[i] >= FILL_THRESHOLD);
+          bool accept = true;
+
+          // The perceptron filter replaces the confidence threshold for the fill level, and may reject the candidate entirely
+          PERCEPTRON_FILTER::index_type ppf_index{};
+          int ppf_sum = 0;
+          if constexpr (PPF_ON) {
+            ppf_index = PERCEPTRON_FILTER::get_index(ip, pf_addr, curr_sig, delta_q[i], confidence_q[i]);
+            ppf_sum = PPF.get_sum(ppf_index) + PERCEPTRON_FILTER::baseline(confidence_q[i]);
+            auto decision = PPF.predict(ppf_sum);
+            accept = (decision != spp_dev::PPF_REJECT);
+            fill_this_level = (decision == spp_dev::PPF_L2C);
+
+            if (!accept)
+              PPF.record(pf_addr, ppf_index, ppf_sum, false);
+          }
+
+          if (accept && FILTER.check(pf_addr, (fill_this_level ? spp_dev::SPP_L2C_PREFETCH : spp_dev::SPP_LLC_PREFETCH))) {
+            bool issued = prefetch_line(pf_addr, fill_this_level, 0); // Use addr (not base_addr) to obey the same physical page boundary
 
-            if (confidence_q[i] >= FILL_THRESHOLD) {
+            if constexpr (PPF_ON) {
+              if (issued)
+                PPF.record(pf_addr, ppf_index, ppf_sum, true);
+            }
+
+            if (fill_this_level) {
               GHR.pf_issued++;
               if (GHR.pf_issued > GLOBAL_COUNTER_MAX) {
                 GHR.pf_issued >>= 1;
@@ -143,10 +180,22 @@ uint32_t spp_dev::prefetcher_cache_fill(champsim::address addr, long set, long w
     FILTER.check(evicted_addr, spp_dev::L2C_EVICT);
   }
 
+  if constexpr (PPF_ON) {
+    // A fill into an invalid way evicts nothing
+    if (evicted_addr != champsim::address{})
+      PPF.evict(evicted_addr);
+  }
+
   return metadata_in;
 }
 
-void spp_dev::prefetcher_final_stats() {}
+void spp_dev::prefetcher_final_stats()
+{
+  if constexpr (PPF_ON) {
+    std::cout << "PPF L2C accept: " << PPF.l2c_accept << " LLC accept: " << PPF.llc_accept << " reject: " << PPF.reject;
+    std::cout << " train positive: " << PPF.train_positive << " train negative: " << PPF.train_negative << std::endl;
+  }
+}
 
 // TODO: Find a good 64-bit hash function
 uint64_t spp_dev::get_hash(uint64_t key)
@@ -556,3 +605,110 @@ uint32_t spp_dev::GLOBAL_REGISTER::check_entry(offset_type page_offset)
 
   return max_conf_way;
 }
+
+auto spp_dev::PERCEPTRON_FILTER::get_index(champsim::address ip, champsim::address pf_addr, uint32_t sig, typename offset_type::difference_type delta,
+                                           uint32_t confidence) -> index_type
+{
+  const auto raw_ip = ip.to<uint64_t>();
+  const auto raw_delta = static_cast<uint64_t>(delta);
+  const auto raw_offset = offset_type{pf_addr}.to<uint64_t>();
+
+  std::array<uint64_t, PPF_FEATURE> feature{raw_ip, raw_ip ^ (raw_delta << 16), sig ^ (raw_delta << SIG_BIT), confidence, raw_offset ^ (raw_delta << 8)};
+
+  index_type index;
+  for (std::size_t i = 0; i < PPF_FEATURE; i++)
+    index[i] = get_hash(feature[i] ^ (uint64_t{i} << 56)) % PPF_WEIGHT_SET;
+  return index;
+}
+
+int spp_dev::PERCEPTRON_FILTER::get_sum(const index_type& index) const
+{
+  int sum = 0;
+  for (std::size_t i = 0; i < PPF_FEATURE; i++)
+    sum += weight[i][index[i]];
+  return sum;
+}
+
+int spp_dev::PERCEPTRON_FILTER::baseline(uint32_t confidence)
+{
+  // The weights start at zero, so this places an untrained filter's sum where it makes the same decision as the confidence threshold
+  return (confidence >= FILL_THRESHOLD) ? 0 : (PPF_TAU_HI + PPF_TAU_LO) / 2;
+}
+
+spp_dev::PPF_DECISION spp_dev::PERCEPTRON_FILTER::predict(int sum)
+{
+  if (sum >= PPF_TAU_HI) {
+    l2c_accept++;
+    return spp_dev::PPF_L2C;
+  }
+  if (sum >= PPF_TAU_LO) {
+    llc_accept++;
+    return spp_dev::PPF_LLC;
+  }
+  reject++;
+  return spp_dev::PPF_REJECT;
+}
+
+void spp_dev::PERCEPTRON_FILTER::record(champsim::address pf_addr, const index_type& index, int sum, bool issued)
+{
+  champsim::block_number cache_line{pf_addr};
+  auto set = get_hash(cache_line.to<uint64_t>()) % PPF_TABLE_SET;
+
+  auto& table = issued ? prefetch_table : reject_table;
+  table[set] = {true, false, cache_line, index, sum};
+
+  // A line cannot be both issued and rejected
+  auto& other = issued ? reject_table : prefetch_table;
+  if (other[set].valid && other[set].cache_line == cache_line)
+    other[set].valid = false;
+}
+
+void spp_dev::PERCEPTRON_FILTER::demand(champsim::address addr)
+{
+  champsim::block_number cache_line{addr};
+  auto set = get_hash(cache_line.to<uint64_t>()) % PPF_TABLE_SET;
+
+  // The prefetch was used: reinforce the features that accepted it
+  if (auto& entry = prefetch_table[set]; entry.valid && !entry.useful && entry.cache_line == cache_line) {
+    entry.useful = true;
+    if (entry.sum < PPF_THETA_POS)
+      train(entry.index, entry.sum, true);
+  }
+
+  // The candidate was wrongly rejected: reinforce the features unless they rejected it beyond the training margin
+  if (auto& entry = reject_table[set]; entry.valid && entry.cache_line == cache_line) {
+    entry.valid = false;
+    if (entry.sum > PPF_THETA_NEG)
+      train(entry.index, entry.sum, true);
+  }
+}
+
+void spp_dev::PERCEPTRON_FILTER::evict(champsim::address addr)
+{
+  champsim::block_number cache_line{addr};
+  auto set = get_hash(cache_line.to<uint64_t>()) % PPF_TABLE_SET;
+
+  // The prefetch left the cache without being used: penalize the features that accepted it
+  if (auto& entry = prefetch_table[set]; entry.valid && entry.cache_line == cache_line) {
+    if (!entry.useful && entry.sum > PPF_THETA_NEG)
+      train(entry.index, entry.sum, false);
+    entry.valid = false;
+  }
+}
+
+void spp_dev::PERCEPTRON_FILTER::train(const index_type& index, int sum, bool positive)
+{
+  if constexpr (SPP_DEBUG_PRINT) {
+    std::cout << "[PPF] " << __func__ << " sum: " << sum << " positive: " << positive << std::endl;
+  }
+
+  for (std::size_t i = 0; i < PPF_FEATURE; i++) {
+    auto& w = weight[i][index[i]];
+    w = positive ? std::min(w + 1, PPF_WEIGHT_MAX) : std::max(w - 1, PPF_WEIGHT_MIN);
+  }
+
+  if (positive)
+    train_positive++;
+  else
+    train_negative++;
+}
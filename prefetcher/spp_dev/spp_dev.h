@@ -1,6 +1,7 @@
 #ifndef SPP_H
 #define SPP_H
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -47,6 +48,18 @@ struct spp_dev : public champsim::modules::prefetcher {
   constexpr static uint32_t GLOBAL_COUNTER_MAX = ((1 << GLOBAL_COUNTER_BIT) - 1);
   constexpr static std::size_t MAX_GHR_ENTRY = 8;
 
+  // Perceptron prefetch filter parameters
+  constexpr static bool PPF_ON = false; // Opt-in: the filter changes the fill levels and the number of prefetches issued
+  constexpr static std::size_t PPF_FEATURE = 5;
+  constexpr static std::size_t PPF_WEIGHT_SET = 4096;
+  constexpr static std::size_t PPF_TABLE_SET = 1024;
+  constexpr static int PPF_WEIGHT_MAX = 15;
+  constexpr static int PPF_WEIGHT_MIN = -16;
+  constexpr static int PPF_TAU_HI = -5;  // At or above: fill L2C
+  constexpr static int PPF_TAU_LO = -15; // At or above: fill LLC, below: reject
+  constexpr static int PPF_THETA_POS = 40;
+  constexpr static int PPF_THETA_NEG = -40;
+
   using prefetcher::prefetcher;
   uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
                                     uint32_t metadata_in);
@@ -57,18 +70,15 @@ struct spp_dev : public champsim::modules::prefetcher {
   void prefetcher_final_stats();
 
   enum FILTER_REQUEST { SPP_L2C_PREFETCH, SPP_LLC_PREFETCH, L2C_DEMAND, L2C_EVICT }; // Request type for prefetch filter
+  enum PPF_DECISION { PPF_REJECT, PPF_LLC, PPF_L2C };                                // Fill decision of the perceptron filter
   static uint64_t get_hash(uint64_t key);
 
-  struct block_in_page_extent : champsim::dynamic_extent {
-    block_in_page_extent() : dynamic_extent(champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_BLOCK_SIZE}) {}
-  };
+  using block_in_page_extent = champsim::static_extent<champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_BLOCK_SIZE}>;
   using offset_type = champsim::address_slice<block_in_page_extent>;
 
   class SIGNATURE_TABLE
   {
-    struct tag_extent : champsim::dynamic_extent {
-      tag_extent() : dynamic_extent(champsim::data::bits{ST_TAG_BIT + LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_PAGE_SIZE}) {}
-    };
+    using tag_extent = champsim::static_extent<champsim::data::bits{ST_TAG_BIT + LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_PAGE_SIZE}>;
 
   public:
     spp_dev* _parent;
@@ -170,10 +180,46 @@ struct spp_dev : public champsim::modules::prefetcher {
     uint32_t check_entry(offset_type page_offset);
   };
 
+  class PERCEPTRON_FILTER
+  {
+  public:
+    using index_type = std::array<std::size_t, PPF_FEATURE>;
+
+    struct record_type {
+      bool valid = false;
+      bool useful = false;
+      champsim::block_number cache_line{};
+      index_type index{};
+      int sum = 0;
+    };
+
+    spp_dev* _parent;
+    std::array<std::array<int, PPF_WEIGHT_SET>, PPF_FEATURE> weight{};
+
+    // Issued prefetches wait here for a demand (useful) or an eviction (useless). Rejected candidates wait for a demand that proves them wrong.
+    std::array<record_type, PPF_TABLE_SET> prefetch_table{}, reject_table{};
+
+    uint64_t l2c_accept = 0, llc_accept = 0, reject = 0, train_positive = 0, train_negative = 0;
+
+    static index_type get_index(champsim::address ip, champsim::address pf_addr, uint32_t sig, typename offset_type::difference_type delta,
+                                uint32_t confidence);
+    int get_sum(const index_type& index) const;
+    static int baseline(uint32_t confidence);
+    PPF_DECISION predict(int sum);
+
+    void record(champsim::address pf_addr, const index_type& index, int sum, bool issued);
+    void demand(champsim::address addr);
+    void evict(champsim::address addr);
+
+  private:
+    void train(const index_type& index, int sum, bool positive);
+  };
+
   SIGNATURE_TABLE ST;
   PATTERN_TABLE PT;
   PREFETCH_FILTER FILTER;
   GLOBAL_REGISTER GHR;
+  PERCEPTRON_FILTER PPF;
 };
 
 #endif
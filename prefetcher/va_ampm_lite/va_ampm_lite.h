@@ -12,9 +12,7 @@
 
 class va_ampm_lite : public champsim::modules::prefetcher
 {
-  struct block_in_page_extent : champsim::dynamic_extent {
-    block_in_page_extent() : dynamic_extent(champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_BLOCK_SIZE}) {}
-  };
+  using block_in_page_extent = champsim::static_extent<champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{LOG2_BLOCK_SIZE}>;
   using block_in_page = champsim::address_slice<block_in_page_extent>;
 
 public:
@@ -85,3 +85,10 @@ long drrip::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, co
   assert(victim < end);
   return std::distance(begin, victim); // cast protected by assertions
 }
+
+long drrip::peek_victim(long set, const champsim::cache_block* current_set) const
+{
+  // Ageing the set does not change which way holds the first maximum RRPV
+  auto begin = std::next(std::begin(rrpv), set * NUM_WAY);
+  return std::distance(begin, std::max_element(begin, std::next(begin, NUM_WAY)));
+}
@@ -20,6 +20,12 @@ long lru::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, cons
   return std::distance(begin, victim);
 }
 
+long lru::peek_victim(long set, const champsim::cache_block* current_set) const
+{
+  auto begin = std::next(std::begin(last_used_cycles), set * NUM_WAY);
+  return std::distance(begin, std::min_element(begin, std::next(begin, NUM_WAY)));
+}
+
 void lru::replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
                                  access_type type)
 {
@@ -38,6 +38,13 @@ long ship::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, con
   return std::distance(begin, victim);
 }
 
+long ship::peek_victim(long set, const champsim::cache_block* current_set) const
+{
+  // Ageing the set does not change which way holds the first maximum RRPV
+  auto begin = std::next(std::begin(rrpv_values), set * NUM_WAY);
+  return std::distance(begin, std::max_element(begin, std::next(begin, NUM_WAY)));
+}
+
 // called on every cache hit and cache fill
 void ship::update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                     champsim::address victim_addr, access_type type, uint8_t hit)
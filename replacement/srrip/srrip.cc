@@ -20,6 +20,8 @@ long srrip::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, co
   return sets.at(static_cast<std::size_t>(set)).victim();
 }
 
+long srrip::peek_victim(long set, const champsim::cache_block* current_set) const { return sets.at(static_cast<std::size_t>(set)).peek_victim(); }
+
 // called on every cache hit and cache fill
 void srrip::update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                      champsim::address victim_addr, access_type type, uint8_t hit)
@@ -43,4 +45,10 @@ long srrip_set_helper::victim()
   return std::distance(std::begin(rrpv_values), victim);
 }
 
+long srrip_set_helper::peek_victim() const
+{
+  // Ageing the set does not change which way holds the first maximum RRPV
+  return std::distance(std::begin(rrpv_values), std::max_element(std::begin(rrpv_values), std::end(rrpv_values)));
+}
+
 void srrip_set_helper::update(long way, bool hit) { get_rrpv(way) = hit ? 0 : (maxRRPV - 1); }
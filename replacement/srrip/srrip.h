@@ -17,6 +17,7 @@ struct srrip_set_helper {
   explicit srrip_set_helper(long ways);
 
   long victim();
+  [[nodiscard]] long peek_victim() const;
   void update(long way, bool hit);
 };
 
@@ -30,6 +31,7 @@ struct srrip : public champsim::modules::replacement {
   // void initialize_replacement() {}
   long find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const champsim::cache_block* current_set, champsim::address ip,
                    champsim::address full_addr, access_type type);
+  long peek_victim(long set, const champsim::cache_block* current_set) const;
   void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
                                 access_type type, uint8_t hit);
 
@@ -21,12 +21,14 @@
 #include <cmath>
 #include <iomanip>
 #include <numeric>
+#include <tuple>
 #include <fmt/core.h>
 
 #include "bandwidth.h"
 #include "champsim.h"
 #include "chrono.h"
 #include "deadlock.h"
+#include "dram_controller.h"
 #include "instruction.h"
 #include "util/algorithm.h"
 #include "util/bits.h"
@@ -36,11 +38,21 @@ CACHE::CACHE(CACHE&& other)
     : operable(other),
 
       upper_levels(std::move(other.upper_levels)), lower_level(std::move(other.lower_level)), lower_translate(std::move(other.lower_translate)),
-
-      cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), MSHR_SIZE(other.MSHR_SIZE), PQ_SIZE(other.PQ_SIZE),
-      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), MAX_TAG(other.MAX_TAG),
+      memory_controller(other.memory_controller),
+
+      cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), MSHR_SIZE(other.MSHR_SIZE),
+      MSHR_DEMAND_RESERVE(other.MSHR_DEMAND_RESERVE), MSHR_PREFETCH_LIMIT(other.MSHR_PREFETCH_LIMIT), PQ_SIZE(other.PQ_SIZE),
+      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS),
+      SECTOR_OFFSET_BITS(other.SECTOR_OFFSET_BITS), block(std::move(other.block)), VICTIM_CACHE_SIZE(other.VICTIM_CACHE_SIZE),
+      PREFETCH_BUFFER_SIZE(other.PREFETCH_BUFFER_SIZE), victim_cache(std::move(other.victim_cache)), prefetch_buffer(std::move(other.prefetch_buffer)),
+      MAX_TAG(other.MAX_TAG),
       MAX_FILL(other.MAX_FILL), prefetch_as_load(other.prefetch_as_load), match_offset_bits(other.match_offset_bits), virtual_prefetch(other.virtual_prefetch),
+      demand_priority(other.demand_priority), fixed_priority(other.fixed_priority), write_through(other.write_through), write_allocate(other.write_allocate),
+      eager_writeback(other.eager_writeback), WRITE_BUFFER_SIZE(other.WRITE_BUFFER_SIZE), IP_ATTRIBUTION_SIZE(other.IP_ATTRIBUTION_SIZE),
       pref_activate_mask(std::move(other.pref_activate_mask)),
+      pf_filter(std::move(other.pf_filter)), tag_energy(other.tag_energy), data_energy(other.data_energy),
+      prefetch_evictions(std::move(other.prefetch_evictions)),
+      eviction_listeners(std::move(other.eviction_listeners)),
 
       sim_stats(std::move(other.sim_stats)), roi_stats(std::move(other.roi_stats)),
 
@@ -59,6 +71,7 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->upper_levels = std::move(other.upper_levels);
   this->lower_level = std::move(other.lower_level);
   this->lower_translate = std::move(other.lower_translate);
+  this->memory_controller = other.memory_controller;
 
   this->cpu = other.cpu;
   this->NAME = std::move(other.NAME);
@@ -66,19 +79,37 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->NUM_WAY = other.NUM_WAY;
   ;
   this->MSHR_SIZE = other.MSHR_SIZE;
-  ;
+  this->MSHR_DEMAND_RESERVE = other.MSHR_DEMAND_RESERVE;
+  this->MSHR_PREFETCH_LIMIT = other.MSHR_PREFETCH_LIMIT;
   this->PQ_SIZE = other.PQ_SIZE;
   this->HIT_LATENCY = other.HIT_LATENCY;
   this->FILL_LATENCY = other.FILL_LATENCY;
   this->OFFSET_BITS = other.OFFSET_BITS;
+  this->SECTOR_OFFSET_BITS = other.SECTOR_OFFSET_BITS;
   ;
   this->block = std::move(other.block);
+  this->VICTIM_CACHE_SIZE = other.VICTIM_CACHE_SIZE;
+  this->PREFETCH_BUFFER_SIZE = other.PREFETCH_BUFFER_SIZE;
+  this->victim_cache = std::move(other.victim_cache);
+  this->prefetch_buffer = std::move(other.prefetch_buffer);
   this->MAX_TAG = other.MAX_TAG;
   this->MAX_FILL = other.MAX_FILL;
   this->prefetch_as_load = other.prefetch_as_load;
   this->match_offset_bits = other.match_offset_bits;
   this->virtual_prefetch = other.virtual_prefetch;
+  this->demand_priority = other.demand_priority;
+  this->fixed_priority = other.fixed_priority;
+  this->write_through = other.write_through;
+  this->write_allocate = other.write_allocate;
+  this->eager_writeback = other.eager_writeback;
+  this->WRITE_BUFFER_SIZE = other.WRITE_BUFFER_SIZE;
+  this->IP_ATTRIBUTION_SIZE = other.IP_ATTRIBUTION_SIZE;
   this->pref_activate_mask = std::move(other.pref_activate_mask);
+  this->pf_filter = std::move(other.pf_filter);
+  this->tag_energy = other.tag_energy;
+  this->data_energy = other.data_energy;
+  this->prefetch_evictions = std::move(other.prefetch_evictions);
+  this->eviction_listeners = std::move(other.eviction_listeners);
 
   this->sim_stats = std::move(other.sim_stats);
   this->roi_stats = std::move(other.roi_stats);
@@ -122,6 +153,7 @@ CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type succes
   retval.instr_depend_on_me = merged_instr;
   retval.to_return = merged_return;
   retval.data_promise = predecessor.data_promise;
+  retval.parts_pending = predecessor.parts_pending;
 
   if constexpr (champsim::debug_print) {
     if (successor.type == access_type::PREFETCH) {
@@ -138,16 +170,17 @@ CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type succes
   return retval;
 }
 
-auto CACHE::fill_block(mshr_type mshr, uint32_t metadata) -> BLOCK
+auto CACHE::fill_block(mshr_type mshr, uint32_t metadata) const -> BLOCK
 {
   CACHE::BLOCK to_fill;
   to_fill.valid = true;
   to_fill.prefetch = mshr.prefetch_from_this;
-  to_fill.dirty = (mshr.type == access_type::WRITE);
+  to_fill.dirty = (mshr.type == access_type::WRITE) && !write_through; // a write-through cache sends the write on instead
   to_fill.address = mshr.address;
   to_fill.v_address = mshr.v_address;
   to_fill.data = mshr.data_promise->data;
   to_fill.pf_metadata = metadata;
+  to_fill.fill_time = current_time;
 
   return to_fill;
 }
@@ -159,6 +192,66 @@ auto CACHE::matches_address(champsim::address addr) const
   };
 }
 
+auto CACHE::matches_sector(champsim::address addr) const
+{
+  return [match = addr.slice_upper(SECTOR_OFFSET_BITS), shamt = SECTOR_OFFSET_BITS](const auto& entry) {
+    return entry.address.slice_upper(shamt) == match;
+  };
+}
+
+uint64_t CACHE::sector_mask(champsim::address address) const
+{
+  return uint64_t{1} << address.slice(champsim::dynamic_extent{OFFSET_BITS, SECTOR_OFFSET_BITS}).to<uint64_t>();
+}
+
+champsim::address CACHE::sector_address(champsim::address address, std::size_t sector) const
+{
+  if (SECTOR_OFFSET_BITS == OFFSET_BITS) {
+    return address;
+  }
+  auto sector_offset = static_cast<champsim::address::difference_type>(sector << champsim::to_underlying(SECTOR_OFFSET_BITS));
+  return champsim::address{address.slice_upper(OFFSET_BITS)} + sector_offset;
+}
+
+champsim::data::bits CACHE::lower_offset_bits() const
+{
+  // A lower level that does not give its block size is taken to match this cache
+  if (lower_level == nullptr || lower_level->offset_bits() == champsim::data::bits{}) {
+    return SECTOR_OFFSET_BITS;
+  }
+  return lower_level->offset_bits();
+}
+
+std::vector<champsim::address> CACHE::lower_level_parts(champsim::address address) const
+{
+  const auto lower_bits = lower_offset_bits();
+  if (lower_bits >= SECTOR_OFFSET_BITS) {
+    return {address};
+  }
+
+  // Split the sector into the blocks of the lower level, keeping the full address for the block that holds it
+  const auto num_parts = std::size_t{1} << (champsim::to_underlying(SECTOR_OFFSET_BITS) - champsim::to_underlying(lower_bits));
+  assert(num_parts <= std::numeric_limits<uint64_t>::digits);
+  std::vector<champsim::address> retval{};
+  const champsim::address sector_begin{address.slice_upper(SECTOR_OFFSET_BITS)};
+  for (std::size_t i = 0; i < num_parts; ++i) {
+    auto part = sector_begin + static_cast<champsim::address::difference_type>(i << champsim::to_underlying(lower_bits));
+    retval.push_back(part.slice_upper(lower_bits) == address.slice_upper(lower_bits) ? address : part);
+  }
+  return retval;
+}
+
+uint64_t CACHE::part_mask(champsim::address address) const
+{
+  const auto lower_bits = lower_offset_bits();
+  if (lower_bits >= SECTOR_OFFSET_BITS) {
+    return 1;
+  }
+  return uint64_t{1} << address.slice(champsim::dynamic_extent{SECTOR_OFFSET_BITS, lower_bits}).to<uint64_t>();
+}
+
+uint64_t CACHE::filter_key(champsim::address address) const { return address.slice_upper(OFFSET_BITS).to<uint64_t>(); }
+
 template <typename T>
 champsim::address CACHE::module_address(const T& element) const
 {
@@ -166,16 +259,141 @@ champsim::address CACHE::module_address(const T& element) const
   return champsim::address{address.slice_upper(match_offset_bits ? champsim::data::bits{} : OFFSET_BITS)};
 }
 
+bool CACHE::write_back(const BLOCK& victim, uint32_t triggering_cpu, uint64_t instr_id)
+{
+  // Each dirty sector is written back, in pieces the size of the lower level's blocks
+  std::vector<champsim::address> writeback_addresses{};
+  for (std::size_t sector = 0; sector < std::numeric_limits<uint64_t>::digits; ++sector) {
+    if (((victim.dirty_sectors >> sector) & 1u) != 0) {
+      auto parts = lower_level_parts(sector_address(victim.address, sector));
+      writeback_addresses.insert(std::end(writeback_addresses), std::begin(parts), std::end(parts));
+    }
+  }
+
+  if (std::size(writeback_addresses) > 1 && lower_level->wq_occupancy() + std::size(writeback_addresses) > lower_level->wq_size()) {
+    return false;
+  }
+
+  for (auto writeback_address : writeback_addresses) {
+    request_type writeback_packet;
+
+    writeback_packet.cpu = triggering_cpu;
+    writeback_packet.address = writeback_address;
+    writeback_packet.data = victim.data;
+    writeback_packet.instr_id = instr_id;
+    writeback_packet.ip = champsim::address{};
+    writeback_packet.type = access_type::WRITE;
+    writeback_packet.pf_metadata = victim.pf_metadata;
+    writeback_packet.response_requested = false;
+
+    if constexpr (champsim::debug_print) {
+      fmt::print("[{}] {} evict address: {:#x} v_address: {:#x} prefetch_metadata: {}\n", NAME, __func__, writeback_packet.address,
+                 writeback_packet.v_address, victim.pf_metadata);
+    }
+
+    auto success = lower_level->add_wq(writeback_packet);
+    if (!success) {
+      return false;
+    }
+  }
+
+  // The victim is read out of the data array
+  sim_stats.energy.dynamic += data_energy.read;
+  return true;
+}
+
+bool CACHE::make_room(side_type& side, std::size_t capacity, uint32_t triggering_cpu, uint64_t instr_id)
+{
+  if (std::size(side) < capacity) {
+    return true;
+  }
+
+  // The least recently used block leaves the cache entirely
+  const auto& victim = side.back();
+  if (victim.dirty) {
+    if (!write_back(victim, triggering_cpu, instr_id)) {
+      return false;
+    }
+    ++sim_stats.wb_eviction;
+  }
+  if (victim.prefetch) {
+    ++sim_stats.pf_useless;
+    record_prefetch_eviction(victim, false);
+  }
+  side.pop_back();
+  return true;
+}
+
+namespace
+{
+// Writebacks carry no instruction address, and stores complete at retirement, so neither is charged to an instruction
+bool attributes_to_ip(access_type type, champsim::address ip)
+{
+  return type != access_type::PREFETCH && type != access_type::WRITE && ip != champsim::address{};
+}
+} // namespace
+
+void CACHE::record_prefetch_eviction(const BLOCK& victim, bool by_prefetch)
+{
+  prefetch_evictions.fill({filter_key(victim.address), by_prefetch});
+}
+
+void CACHE::record_miss(const tag_lookup_type& handle_pkt)
+{
+  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  if (handle_pkt.type == access_type::PREFETCH)
+    return;
+
+  if (::attributes_to_ip(handle_pkt.type, handle_pkt.ip))
+    sim_stats.ip_misses.increment(handle_pkt.ip);
+
+  // A demand miss to a block that a prefetch pushed out of the cache
+  if (auto evicted = prefetch_evictions.invalidate({filter_key(handle_pkt.address), false}); evicted.has_value()) {
+    if (evicted->by_prefetch)
+      ++sim_stats.pf_polluting;
+    else
+      ++sim_stats.pf_early;
+  }
+}
+
+void CACHE::absorb_side_copies(BLOCK& fill)
+{
+  // A block is held in only one place. A copy left in a side structure by a sector that missed is merged into the new fill.
+  for (auto* side : {&victim_cache, &prefetch_buffer}) {
+    auto copy = std::find_if(std::begin(*side), std::end(*side), [matcher = matches_address(fill.address)](const auto& x) { return x.valid && matcher(x); });
+    if (copy != std::end(*side)) {
+      fill.valid_sectors |= copy->valid_sectors;
+      fill.dirty_sectors |= copy->dirty_sectors;
+      fill.dirty = fill.dirty || copy->dirty;
+      side->erase(copy);
+    }
+  }
+}
+
 bool CACHE::handle_fill(const mshr_type& fill_mshr)
 {
   cpu = fill_mshr.cpu;
 
-  // find victim
   auto [set_begin, set_end] = get_set_span(fill_mshr.address);
-  auto way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
-  if (way == set_end) {
-    way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
-                                                fill_mshr.address, fill_mshr.type));
+
+  // A sector is filled into the block that already holds its tag, if there is one
+  auto way = set_end;
+  if (SECTOR_OFFSET_BITS != OFFSET_BITS) {
+    way = std::find_if(set_begin, set_end, [matcher = matches_address(fill_mshr.address)](const auto& x) { return x.valid && matcher(x); });
+  }
+  const bool fill_sector = (way != set_end);
+
+  // A prefetch issued by this cache waits in the prefetch buffer, rather than displacing a block from the main array
+  const bool fill_prefetch_buffer =
+      PREFETCH_BUFFER_SIZE > 0 && !fill_sector && fill_mshr.type == access_type::PREFETCH && fill_mshr.prefetch_from_this;
+
+  // find victim
+  if (!fill_sector && !fill_prefetch_buffer) {
+    way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
+    if (way == set_end) {
+      way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
+                                                  fill_mshr.address, fill_mshr.type));
+    }
   }
   assert(set_begin <= way);
   assert(way <= set_end);
@@ -189,54 +407,105 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
                (fill_mshr.time_enqueued.time_since_epoch()) / clock_period, (current_time.time_since_epoch()) / clock_period);
   }
 
-  if (way != set_end && way->valid && way->dirty) {
-    request_type writeback_packet;
-
-    writeback_packet.cpu = fill_mshr.cpu;
-    writeback_packet.address = way->address;
-    writeback_packet.data = way->data;
-    writeback_packet.instr_id = fill_mshr.instr_id;
-    writeback_packet.ip = champsim::address{};
-    writeback_packet.type = access_type::WRITE;
-    writeback_packet.pf_metadata = way->pf_metadata;
-    writeback_packet.response_requested = false;
-
-    if constexpr (champsim::debug_print) {
-      fmt::print("[{}] {} evict address: {:#x} v_address: {:#x} prefetch_metadata: {}\n", NAME, __func__, writeback_packet.address, writeback_packet.v_address,
-                 fill_mshr.data_promise->pf_metadata);
+  // An evicted block moves to the victim cache, if there is one. Otherwise, it is written back if it is dirty.
+  const bool evicting = !fill_sector && way != set_end && way->valid;
+  if (evicting && VICTIM_CACHE_SIZE > 0) {
+    if (!make_room(victim_cache, VICTIM_CACHE_SIZE, fill_mshr.cpu, fill_mshr.instr_id)) {
+      return false;
     }
-
-    auto success = lower_level->add_wq(writeback_packet);
-    if (!success) {
+  } else if (evicting && way->dirty) {
+    if (!write_back(*way, fill_mshr.cpu, fill_mshr.instr_id)) {
       return false;
     }
+    ++sim_stats.wb_eviction;
+  }
+
+  if (fill_prefetch_buffer && !make_room(prefetch_buffer, PREFETCH_BUFFER_SIZE, fill_mshr.cpu, fill_mshr.instr_id)) {
+    return false;
   }
 
   champsim::address evicting_address{};
-  if (way != set_end && way->valid) {
+  if (evicting) {
     evicting_address = module_address(*way);
+    for (auto* listener : eviction_listeners)
+      listener->push_back(way->v_address);
+  }
+
+  // A block that returns to the cache is no longer waiting to be classified
+  if (!fill_sector) {
+    prefetch_evictions.invalidate({filter_key(fill_mshr.address), false});
   }
 
-  auto metadata_thru = impl_prefetcher_cache_fill(module_address(fill_mshr), get_set_index(fill_mshr.address), way_idx,
-                                                  (fill_mshr.type == access_type::PREFETCH), evicting_address, fill_mshr.data_promise->pf_metadata);
-  impl_replacement_cache_fill(fill_mshr.cpu, get_set_index(fill_mshr.address), way_idx, module_address(fill_mshr), fill_mshr.ip, evicting_address,
-                              fill_mshr.type);
+  // The MSHR's entry retires with the fill. A sector fill lands in a block that is already counted.
+  if (pf_filter.has_value()) {
+    pf_filter->erase(filter_key(fill_mshr.address));
+    if (!fill_sector && way != set_end && way->valid)
+      pf_filter->erase(filter_key(way->address));
+    if (!fill_sector && way != set_end)
+      pf_filter->insert(filter_key(fill_mshr.address));
+  }
+
+  // The prefetcher and the replacement policy see the block when it is moved into the main array
+  auto metadata_thru = fill_mshr.data_promise->pf_metadata;
+  if (!fill_prefetch_buffer) {
+    metadata_thru = impl_prefetcher_cache_fill(module_address(fill_mshr), get_set_index(fill_mshr.address), way_idx, (fill_mshr.type == access_type::PREFETCH),
+                                               evicting_address, metadata_thru);
+    impl_replacement_cache_fill(fill_mshr.cpu, get_set_index(fill_mshr.address), way_idx, module_address(fill_mshr), fill_mshr.ip, evicting_address,
+                                fill_mshr.type);
+  }
+
+  if (fill_prefetch_buffer) {
+    ++sim_stats.pf_fill;
+
+    auto to_fill = fill_block(fill_mshr, metadata_thru);
+    to_fill.valid_sectors = sector_mask(fill_mshr.address);
+    to_fill.dirty_sectors = 0;
+    absorb_side_copies(to_fill);
+    prefetch_buffer.push_front(to_fill);
+  }
 
   if (way != set_end) {
-    if (way->valid && way->prefetch) {
+    if (evicting && way->prefetch && VICTIM_CACHE_SIZE == 0) {
       ++sim_stats.pf_useless;
+      record_prefetch_eviction(*way, false);
+    } else if (evicting && fill_mshr.prefetch_from_this && VICTIM_CACHE_SIZE == 0) {
+      record_prefetch_eviction(*way, true);
     }
 
     if (fill_mshr.type == access_type::PREFETCH) {
       ++sim_stats.pf_fill;
     }
 
-    *way = fill_block(fill_mshr, metadata_thru);
+    const auto filled_sector = sector_mask(fill_mshr.address);
+    if (fill_sector) {
+      way->prefetch = way->prefetch || fill_mshr.prefetch_from_this;
+      way->pf_metadata = metadata_thru;
+    } else {
+      if (evicting && VICTIM_CACHE_SIZE > 0) {
+        victim_cache.push_front(*way);
+      }
+      *way = fill_block(fill_mshr, metadata_thru);
+      way->valid_sectors = 0;
+      way->dirty_sectors = 0;
+      absorb_side_copies(*way);
+    }
+    way->valid_sectors |= filled_sector;
+    if (fill_mshr.type == access_type::WRITE && write_through) {
+      buffer_write(fill_mshr.address, fill_mshr.v_address, fill_mshr.cpu, fill_mshr.instr_id);
+    } else if (fill_mshr.type == access_type::WRITE) {
+      way->dirty = true;
+      way->dirty_sectors |= filled_sector;
+    }
   }
 
   // COLLECT STATS
-  if (fill_mshr.type != access_type::PREFETCH)
-    sim_stats.total_miss_latency_cycles += (current_time - (fill_mshr.time_enqueued + clock_period)) / clock_period;
+  sim_stats.energy.dynamic += tag_energy.write + data_energy.write;
+  if (fill_mshr.type != access_type::PREFETCH) {
+    auto miss_latency = (current_time - (fill_mshr.time_enqueued + clock_period)) / clock_period;
+    sim_stats.total_miss_latency_cycles += miss_latency;
+    if (::attributes_to_ip(fill_mshr.type, fill_mshr.ip))
+      sim_stats.ip_misses.add_weight(fill_mshr.ip, miss_latency);
+  }
   sim_stats.mshr_return.increment(std::pair{fill_mshr.type, fill_mshr.cpu});
 
   response_type response{fill_mshr.address, fill_mshr.v_address, fill_mshr.data_promise->data, metadata_thru, fill_mshr.instr_depend_on_me};
@@ -247,15 +516,118 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
   return true;
 }
 
+auto CACHE::promote(side_type& side, side_type::iterator found, const tag_lookup_type& handle_pkt) -> set_type::iterator
+{
+  auto [set_begin, set_end] = get_set_span(handle_pkt.address);
+  const auto set_idx = get_set_index(handle_pkt.address);
+
+  auto way = std::find_if_not(set_begin, set_end, [](const auto& x) { return x.valid; });
+  if (way == set_end) {
+    way = std::next(set_begin, impl_find_victim(handle_pkt.cpu, handle_pkt.instr_id, set_idx, &*set_begin, handle_pkt.ip, handle_pkt.address, handle_pkt.type));
+  }
+  if (way == set_end) {
+    return set_end;
+  }
+
+  // The displaced block takes the place of the promoted one in the victim cache, or moves there, or is written back
+  const bool from_victim_cache = (&side == &victim_cache);
+  if (way->valid && VICTIM_CACHE_SIZE > 0) {
+    if (!from_victim_cache && !make_room(victim_cache, VICTIM_CACHE_SIZE, handle_pkt.cpu, handle_pkt.instr_id)) {
+      return set_end;
+    }
+  } else if (way->valid && way->dirty) {
+    if (!write_back(*way, handle_pkt.cpu, handle_pkt.instr_id)) {
+      return set_end;
+    }
+    ++sim_stats.wb_eviction;
+  }
+
+  champsim::address evicting_address{};
+  if (way->valid) {
+    evicting_address = module_address(*way);
+    for (auto* listener : eviction_listeners)
+      listener->push_back(way->v_address);
+    if (pf_filter.has_value())
+      pf_filter->erase(filter_key(way->address));
+    if (way->prefetch && VICTIM_CACHE_SIZE == 0) {
+      ++sim_stats.pf_useless;
+      record_prefetch_eviction(*way, false);
+    }
+  }
+
+  auto displaced = *way;
+  *way = *found;
+  side.erase(found);
+  if (displaced.valid && VICTIM_CACHE_SIZE > 0) {
+    victim_cache.push_front(displaced);
+  }
+  if (pf_filter.has_value())
+    pf_filter->insert(filter_key(way->address));
+
+  // A block from the prefetch buffer enters the main array for the first time. Every block there was filled by a prefetch.
+  const auto way_idx = std::distance(set_begin, way);
+  if (!from_victim_cache) {
+    way->pf_metadata = impl_prefetcher_cache_fill(module_address(*way), set_idx, way_idx, true, evicting_address, way->pf_metadata);
+  }
+  impl_replacement_cache_fill(handle_pkt.cpu, set_idx, way_idx, module_address(handle_pkt), handle_pkt.ip, evicting_address, handle_pkt.type);
+  return way;
+}
+
+auto CACHE::check_side_structures(const tag_lookup_type& handle_pkt) -> std::pair<set_type::iterator, BLOCK*>
+{
+  auto set_end = get_set_span(handle_pkt.address).second;
+  for (auto [side, hits, promotions] : {std::tuple{&victim_cache, &sim_stats.victim_hits, &sim_stats.victim_promotions},
+                                        std::tuple{&prefetch_buffer, &sim_stats.pf_buffer_hits, &sim_stats.pf_buffer_promotions}}) {
+    auto found =
+        std::find_if(std::begin(*side), std::end(*side), [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
+    if (found == std::end(*side)) {
+      continue;
+    }
+
+    const bool sector_present = (found->valid_sectors & sector_mask(handle_pkt.address)) != 0;
+    if (sector_present) {
+      ++*hits;
+    }
+
+    // A prefetch that finds its block leaves it in place. Any other access moves the block into the main array, if room can be made for it.
+    if (handle_pkt.type != access_type::PREFETCH || !sector_present) {
+      if (auto way = promote(*side, found, handle_pkt); way != set_end) {
+        ++*promotions;
+        return {way, nullptr};
+      }
+    }
+
+    std::rotate(std::begin(*side), found, std::next(found));
+    return {set_end, &side->front()};
+  }
+
+  return {set_end, nullptr};
+}
+
 bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 {
   cpu = handle_pkt.cpu;
+  sim_stats.energy.dynamic += tag_energy.read;
 
   // access cache
   auto [set_begin, set_end] = get_set_span(handle_pkt.address);
   auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
-  const auto hit = (way != set_end);
-  const auto useful_prefetch = (hit && way->prefetch && !handle_pkt.prefetch_from_this);
+
+  // A block that is not in the main array may be held in the victim cache or the prefetch buffer
+  BLOCK* side_block = nullptr;
+  if (way == set_end) {
+    std::tie(way, side_block) = check_side_structures(handle_pkt);
+  }
+  BLOCK* hit_block = (way != set_end) ? &*way : side_block;
+
+  // In a sectored cache, the block may be present without the requested sector
+  if (hit_block != nullptr && (hit_block->valid_sectors & sector_mask(handle_pkt.address)) == 0) {
+    ++sim_stats.sector_misses;
+    way = set_end;
+    hit_block = nullptr;
+  }
+  const auto hit = (hit_block != nullptr);
+  const auto useful_prefetch = (hit && hit_block->prefetch && !handle_pkt.prefetch_from_this);
 
   if constexpr (champsim::debug_print) {
     fmt::print("[{}] {} instr_id: {} address: {} v_address: {} data: {} set: {} way: {} ({}) type: {} cycle: {}\n", NAME, __func__, handle_pkt.instr_id,
@@ -271,22 +643,29 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
   // update replacement policy
   const auto way_idx = std::distance(set_begin, way);
   impl_update_replacement_state(handle_pkt.cpu, get_set_index(handle_pkt.address), way_idx, module_address(handle_pkt), handle_pkt.ip, {}, handle_pkt.type,
-                                hit);
+                                way != set_end);
 
   if (hit) {
     sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    sim_stats.energy.dynamic += (handle_pkt.type == access_type::WRITE) ? data_energy.write : data_energy.read;
 
-    response_type response{handle_pkt.address, handle_pkt.v_address, way->data, metadata_thru, handle_pkt.instr_depend_on_me};
+    response_type response{handle_pkt.address, handle_pkt.v_address, hit_block->data, metadata_thru, handle_pkt.instr_depend_on_me};
     for (auto* ret : handle_pkt.to_return) {
       ret->push_back(response);
     }
 
-    way->dirty |= (handle_pkt.type == access_type::WRITE);
+    if (handle_pkt.type == access_type::WRITE && write_through) {
+      buffer_write(handle_pkt.address, handle_pkt.v_address, handle_pkt.cpu, handle_pkt.instr_id);
+    } else if (handle_pkt.type == access_type::WRITE) {
+      hit_block->dirty = true;
+      hit_block->dirty_sectors |= sector_mask(handle_pkt.address);
+    }
 
     // update prefetch stats and reset prefetch bit
     if (useful_prefetch) {
       ++sim_stats.pf_useful;
-      way->prefetch = false;
+      sim_stats.pf_use_distance.add((current_time - hit_block->fill_time) / clock_period);
+      hit_block->prefetch = false;
     }
   }
 
@@ -317,6 +696,17 @@ auto CACHE::mshr_and_forward_packet(const tag_lookup_type& handle_pkt) -> std::p
   return std::pair{std::move(to_allocate), std::move(fwd_pkt)};
 }
 
+bool CACHE::mshr_available(access_type type) const
+{
+  if (type != access_type::PREFETCH) {
+    return std::size(MSHR) < MSHR_SIZE;
+  }
+
+  // Prefetches may not take the entries held back for demand misses, nor more than their own limit
+  const auto prefetch_occupancy = std::count_if(std::begin(MSHR), std::end(MSHR), [](const auto& entry) { return entry.type == access_type::PREFETCH; });
+  return std::size(MSHR) + MSHR_DEMAND_RESERVE < MSHR_SIZE && prefetch_occupancy < MSHR_PREFETCH_LIMIT;
+}
+
 bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
 {
   if constexpr (champsim::debug_print) {
@@ -332,8 +722,7 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   auto mshr_pkt = mshr_and_forward_packet(handle_pkt);
 
   // check mshr
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(handle_pkt.address));
-  bool mshr_full = (MSHR.size() == MSHR_SIZE);
+  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_sector(handle_pkt.address));
 
   if (mshr_entry != MSHR.end()) // miss already inflight
   {
@@ -341,6 +730,8 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
       // Mark the prefetch as useful
       if (mshr_entry->prefetch_from_this) {
         ++sim_stats.pf_useful;
+        ++sim_stats.pf_late;
+        sim_stats.pf_late_distance.add((current_time - mshr_entry->time_enqueued) / clock_period);
       }
     }
 
@@ -349,24 +740,45 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
 
     *mshr_entry = mshr_type::merge(*mshr_entry, to_allocate);
   } else {
-    if (mshr_full) { // not enough MSHR resource
-      return false;  // TODO should we allow prefetches anyway if they will not be filled to this level?
+    if (!mshr_available(handle_pkt.type)) { // not enough MSHR resource
+      sim_stats.mshr_full.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+      return false; // TODO should we allow prefetches anyway if they will not be filled to this level?
     }
 
     const bool send_to_rq = (prefetch_as_load || handle_pkt.type != access_type::PREFETCH);
-    bool success = send_to_rq ? lower_level->add_rq(mshr_pkt.second) : lower_level->add_pq(mshr_pkt.second);
 
-    if (!success) {
-      return false;
+    // If the lower level has smaller blocks, request each of them. All of the requests must fit.
+    const auto parts = lower_level_parts(handle_pkt.address);
+    if (std::size(parts) > 1) {
+      const auto occupancy = send_to_rq ? lower_level->rq_occupancy() : lower_level->pq_occupancy();
+      const auto capacity = send_to_rq ? lower_level->rq_size() : lower_level->pq_size();
+      if (occupancy + std::size(parts) > capacity) {
+        return false;
+      }
+    }
+
+    mshr_pkt.first.parts_pending = 0;
+    for (auto part : parts) {
+      auto part_pkt = mshr_pkt.second;
+      part_pkt.address = part;
+      part_pkt.v_address = handle_pkt.v_address + champsim::offset(handle_pkt.address, part);
+      bool success = send_to_rq ? lower_level->add_rq(part_pkt) : lower_level->add_pq(part_pkt);
+
+      if (!success) {
+        return false;
+      }
+      mshr_pkt.first.parts_pending |= part_mask(part);
     }
 
     // Allocate an MSHR
     if (mshr_pkt.second.response_requested) {
       MSHR.emplace_back(std::move(mshr_pkt.first));
+      if (pf_filter.has_value())
+        pf_filter->insert(filter_key(handle_pkt.address));
     }
   }
 
-  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  record_miss(handle_pkt);
 
   return true;
 }
@@ -382,12 +794,112 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
   mshr_type to_allocate{handle_pkt, current_time};
   to_allocate.data_promise.ready_at(current_time + (warmup ? champsim::chrono::clock::duration{} : FILL_LATENCY));
   inflight_writes.push_back(to_allocate);
+  if (pf_filter.has_value())
+    pf_filter->insert(filter_key(handle_pkt.address));
 
-  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  record_miss(handle_pkt);
+
+  return true;
+}
+
+bool CACHE::handle_write_around(const tag_lookup_type& handle_pkt)
+{
+  if constexpr (champsim::debug_print) {
+    fmt::print("[{}] {} instr_id: {} address: {} v_address: {} type: {} cycle: {}\n", NAME, __func__, handle_pkt.instr_id, handle_pkt.address,
+               handle_pkt.v_address, access_type_names.at(champsim::to_underlying(handle_pkt.type)), current_time.time_since_epoch() / clock_period);
+  }
+
+  if (write_through) {
+    buffer_write(handle_pkt.address, handle_pkt.v_address, handle_pkt.cpu, handle_pkt.instr_id);
+  } else {
+    request_type fwd_pkt;
+    fwd_pkt.cpu = handle_pkt.cpu;
+    fwd_pkt.address = handle_pkt.address;
+    fwd_pkt.v_address = handle_pkt.v_address;
+    fwd_pkt.data = handle_pkt.data;
+    fwd_pkt.instr_id = handle_pkt.instr_id;
+    fwd_pkt.ip = handle_pkt.ip;
+    fwd_pkt.type = access_type::WRITE;
+    fwd_pkt.response_requested = false;
+
+    if (!lower_level->add_wq(fwd_pkt)) {
+      return false;
+    }
+    ++sim_stats.wb_write_around;
+  }
+
+  record_miss(handle_pkt);
 
   return true;
 }
 
+void CACHE::buffer_write(champsim::address address, champsim::address v_address, uint32_t triggering_cpu, uint64_t instr_id)
+{
+  // A write to a block that is already waiting is merged with it
+  if (std::any_of(std::begin(write_buffer), std::end(write_buffer), matches_address(address))) {
+    ++sim_stats.write_buffer_merges;
+    return;
+  }
+
+  request_type write_pkt;
+  write_pkt.cpu = triggering_cpu;
+  write_pkt.address = address;
+  write_pkt.v_address = v_address;
+  write_pkt.instr_id = instr_id;
+  write_pkt.type = access_type::WRITE;
+  write_pkt.response_requested = false;
+  write_buffer.push_back(write_pkt);
+}
+
+long CACHE::drain_write_buffer()
+{
+  // One buffered write leaves each cycle, if the lower level accepts it
+  if (!std::empty(write_buffer) && lower_level->add_wq(write_buffer.front())) {
+    write_buffer.pop_front();
+    ++sim_stats.wb_write_through;
+    return 1;
+  }
+  return 0;
+}
+
+long CACHE::issue_eager_writeback()
+{
+  if (!eager_writeback) {
+    return 0;
+  }
+
+  // Writes are sent early only while none are waiting at the memory controller, so that they do not bring on a write drain
+  const auto waiting_writes = (memory_controller != nullptr) ? memory_controller->telemetry().wq_occupancy : lower_level->wq_occupancy();
+  if (waiting_writes > 0 || lower_level->wq_occupancy() >= lower_level->wq_size()) {
+    return 0;
+  }
+
+  // One set is examined each cycle. Only a full set will evict, and it will evict the block the replacement policy chooses.
+  // The policy is only asked which block it would choose, since asking it to choose one may change its state. Policies that cannot answer are not helped.
+  const auto set_idx = eager_writeback_set;
+  eager_writeback_set = (eager_writeback_set + 1) % NUM_SET;
+  auto set_begin = std::next(std::begin(block), set_idx * NUM_WAY);
+  auto set_end = std::next(set_begin, NUM_WAY);
+  if (std::any_of(set_begin, set_end, [](const auto& x) { return !x.valid; })) {
+    return 0;
+  }
+
+  auto victim = impl_peek_victim(set_idx, &*set_begin);
+  if (!victim.has_value()) {
+    return 0;
+  }
+
+  auto way = std::next(set_begin, *victim);
+  if (way == set_end || !way->dirty || !write_back(*way, cpu, 0)) {
+    return 0;
+  }
+
+  way->dirty = false;
+  way->dirty_sectors = 0;
+  ++sim_stats.wb_eager;
+  return 1;
+}
+
 template <bool UpdateRequest>
 auto CACHE::initiate_tag_check(champsim::channel* ul)
 {
@@ -397,7 +909,7 @@ auto CACHE::initiate_tag_check(champsim::channel* ul)
 
     if constexpr (UpdateRequest) {
       if (entry.response_requested) {
-        retval.to_return = {&ul->returned};
+        retval.to_return = {ul->response_target()};
       }
     } else {
       (void)ul; // supress warning about ul being unused
@@ -416,6 +928,9 @@ long CACHE::operate()
 {
   long progress{0};
 
+  sim_stats.energy.leakage += tag_energy.leakage + data_energy.leakage;
+  sim_stats.energy.elapsed += clock_period;
+
   auto is_ready = [time = current_time](const auto& entry) {
     return entry.event_cycle <= time;
   };
@@ -449,6 +964,9 @@ long CACHE::operate()
     q.get().erase(fill_begin, complete_end);
   }
 
+  progress += drain_write_buffer();
+  progress += issue_eager_writeback();
+
   // Initiate tag checks
   const champsim::bandwidth::maximum_type bandwidth_from_tag_checks{champsim::to_underlying(MAX_TAG) * (long)(HIT_LATENCY / clock_period)
                                                                     - (long)std::size(inflight_tag_check)};
@@ -461,25 +979,45 @@ long CACHE::operate()
   initiate_tag_bw.consume(stash_bandwidth_consumed);
   std::vector<long long> channels_bandwidth_consumed{};
 
-  if (std::size(upper_levels) > 1) {
+  if (std::size(upper_levels) > 1 && !fixed_priority) {
     std::rotate(upper_levels.begin(), upper_levels.begin() + 1, upper_levels.end());
   }
 
-  // upper levels get an equal portion of the remaining bandwidth
+  // upper levels get an equal portion of the remaining bandwidth, unless they are served in a fixed order
   champsim::bandwidth::maximum_type per_upper_bandwidth =
       std::size(upper_levels) >= 1
-          ? (champsim::bandwidth::maximum_type)std::max((size_t)initiate_tag_bw.amount_remaining() / std::size(upper_levels), size_t{1})
+          ? (champsim::bandwidth::maximum_type)std::max((size_t)initiate_tag_bw.amount_remaining() / (fixed_priority ? size_t{1} : std::size(upper_levels)),
+                                                        size_t{1})
           : champsim::bandwidth::maximum_type{};
 
-  for (auto* ul : upper_levels) {
-    for (auto q : {std::ref(ul->WQ), std::ref(ul->RQ), std::ref(ul->PQ)}) {
-      // this needs to be in this loop, we need to ensure that for cases where bandwidth doesn't divide nicely across upstreams,
-      // we don't accidentally consume more bandwidth than expected
-      champsim::bandwidth per_upper_tag_bw{std::min(per_upper_bandwidth, champsim::bandwidth::maximum_type{initiate_tag_bw.amount_remaining()})};
-      auto bandwidth_consumed =
-          champsim::transform_while_n(q.get(), std::back_inserter(inflight_tag_check), per_upper_tag_bw, can_translate, initiate_tag_check<true>(ul));
-      channels_bandwidth_consumed.push_back(bandwidth_consumed);
-      initiate_tag_bw.consume(bandwidth_consumed);
+  auto initiate_from = [&](channel_type* ul, std::deque<request_type>& q) {
+    // this needs to be done for each queue, we need to ensure that for cases where bandwidth doesn't divide nicely across upstreams,
+    // we don't accidentally consume more bandwidth than expected
+    champsim::bandwidth per_upper_tag_bw{std::min(per_upper_bandwidth, champsim::bandwidth::maximum_type{initiate_tag_bw.amount_remaining()})};
+    auto bandwidth_consumed =
+        champsim::transform_while_n(q, std::back_inserter(inflight_tag_check), per_upper_tag_bw, can_translate, initiate_tag_check<true>(ul));
+    channels_bandwidth_consumed.push_back(bandwidth_consumed);
+    initiate_tag_bw.consume(bandwidth_consumed);
+  };
+
+  // A write-through cache takes no more writes while its write buffer is full
+  const bool take_writes = !write_through || std::size(write_buffer) < WRITE_BUFFER_SIZE;
+  std::deque<request_type> no_writes{};
+
+  if (demand_priority) {
+    // Demand requests from every upper level are taken before any prefetch
+    for (auto* ul : upper_levels) {
+      initiate_from(ul, take_writes ? ul->WQ : no_writes);
+      initiate_from(ul, ul->RQ);
+    }
+    for (auto* ul : upper_levels) {
+      initiate_from(ul, ul->PQ);
+    }
+  } else {
+    for (auto* ul : upper_levels) {
+      for (auto q : {std::ref(take_writes ? ul->WQ : no_writes), std::ref(ul->RQ), std::ref(ul->PQ)}) {
+        initiate_from(ul, q.get());
+      }
     }
   }
 
@@ -499,12 +1037,21 @@ long CACHE::operate()
 
   // Perform tag checks
   auto do_handle_miss = [this](const auto& pkt) {
+    if (pkt.type == access_type::WRITE && !this->write_allocate) {
+      return this->handle_write_around(pkt); // Send writes on without allocating
+    }
     if (pkt.type == access_type::WRITE && !this->match_offset_bits) {
       return this->handle_write(pkt); // Treat writes (that is, writebacks) like fills
     }
     return this->handle_miss(pkt); // Treat writes (that is, stores) like reads
   };
   champsim::bandwidth tag_check_bw{MAX_TAG};
+  if (demand_priority || MSHR_DEMAND_RESERVE > 0 || MSHR_PREFETCH_LIMIT < MSHR_SIZE) {
+    // Ready demand requests are checked first, so that prefetches waiting for an MSHR do not hold them up
+    std::stable_partition(std::begin(inflight_tag_check), std::end(inflight_tag_check), [is_ready, is_translated](const auto& pkt) {
+      return is_ready(pkt) && is_translated(pkt) && pkt.type != access_type::PREFETCH;
+    });
+  }
   auto [tag_check_ready_begin, tag_check_ready_end] =
       champsim::get_span_p(std::begin(inflight_tag_check), std::end(inflight_tag_check), tag_check_bw,
                            [is_ready, is_translated](const auto& pkt) { return is_ready(pkt) && is_translated(pkt); });
@@ -567,7 +1114,19 @@ long CACHE::invalidate_entry(champsim::address inval_addr)
   auto inv_way = std::find_if(begin, end, matches_address(inval_addr));
 
   if (inv_way != end) {
+    if (pf_filter.has_value() && inv_way->valid)
+      pf_filter->erase(filter_key(inv_way->address));
+    if (inv_way->valid) {
+      for (auto* listener : eviction_listeners)
+        listener->push_back(inv_way->v_address);
+    }
     inv_way->valid = false;
+    inv_way->valid_sectors = 0;
+    inv_way->dirty_sectors = 0;
+  }
+
+  for (auto* side : {&victim_cache, &prefetch_buffer}) {
+    side->erase(std::remove_if(std::begin(*side), std::end(*side), matches_address(inval_addr)), std::end(*side));
   }
 
   return std::distance(begin, inv_way);
@@ -577,6 +1136,13 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
 {
   ++sim_stats.pf_requested;
 
+  // Drop candidates that would only find their block already present. Virtual prefetch addresses cannot be checked against the resident blocks.
+  if (pf_filter.has_value()
+      && (pf_filter->recently_issued(filter_key(pf_addr)) || (!virtual_prefetch && pf_filter->may_contain(filter_key(pf_addr))))) {
+    ++sim_stats.pf_filtered;
+    return false;
+  }
+
   if (std::size(internal_PQ) >= PQ_SIZE) {
     return false;
   }
@@ -592,6 +1158,9 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
   internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
   ++sim_stats.pf_issued;
 
+  if (pf_filter.has_value())
+    pf_filter->record_issue(filter_key(pf_addr));
+
   return true;
 }
 
@@ -609,9 +1178,37 @@ bool CACHE::prefetch_line(uint64_t /*deprecated*/, uint64_t /*deprecated*/, uint
 
 void CACHE::finish_packet(const response_type& packet)
 {
+  auto finish = [this, &packet](auto mshr_entry) {
+    auto first_unreturned = std::find_if(MSHR.begin(), MSHR.end(), [](const auto& x) { return x.data_promise.has_unknown_readiness(); });
+
+    // MSHR holds the most updated information about this request
+    mshr_type::returned_value finished_value{packet.data, packet.pf_metadata};
+    mshr_entry->data_promise = champsim::waitable{finished_value, current_time + (warmup ? champsim::chrono::clock::duration{} : FILL_LATENCY)};
+    if constexpr (champsim::debug_print) {
+      fmt::print("[{}_MSHR] finish_packet instr_id: {} address: {} data: {} type: {} current: {}\n", this->NAME, mshr_entry->instr_id, mshr_entry->address,
+                 mshr_entry->data_promise->data, access_type_names.at(champsim::to_underlying(mshr_entry->type)),
+                 current_time.time_since_epoch() / clock_period);
+    }
+
+    // Order this entry after previously-returned entries, but before non-returned
+    // entries
+    std::iter_swap(mshr_entry, first_unreturned);
+  };
+
+  // A lower level with larger blocks returns every sector within its block. A later response for one of those sectors finds nothing to do.
+  if (const auto lower_bits = lower_offset_bits(); lower_bits > SECTOR_OFFSET_BITS) {
+    auto covered = [match = packet.address.slice_upper(lower_bits), lower_bits](const auto& entry) {
+      return entry.data_promise.has_unknown_readiness() && entry.address.slice_upper(lower_bits) == match;
+    };
+    for (auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), covered); mshr_entry != std::end(MSHR);
+         mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), covered)) {
+      finish(mshr_entry);
+    }
+    return;
+  }
+
   // check MSHR information
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(packet.address));
-  auto first_unreturned = std::find_if(MSHR.begin(), MSHR.end(), [](auto x) { return x.data_promise.has_unknown_readiness(); });
+  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_sector(packet.address));
 
   // sanity check
   if (mshr_entry == MSHR.end()) {
@@ -619,17 +1216,11 @@ void CACHE::finish_packet(const response_type& packet)
     assert(0);
   }
 
-  // MSHR holds the most updated information about this request
-  mshr_type::returned_value finished_value{packet.data, packet.pf_metadata};
-  mshr_entry->data_promise = champsim::waitable{finished_value, current_time + (warmup ? champsim::chrono::clock::duration{} : FILL_LATENCY)};
-  if constexpr (champsim::debug_print) {
-    fmt::print("[{}_MSHR] finish_packet instr_id: {} address: {} data: {} type: {} current: {}\n", this->NAME, mshr_entry->instr_id, mshr_entry->address,
-               mshr_entry->data_promise->data, access_type_names.at(champsim::to_underlying(mshr_entry->type)), current_time.time_since_epoch() / clock_period);
+  // The fill waits for every block that was requested from the lower level
+  mshr_entry->parts_pending &= ~part_mask(packet.address);
+  if (mshr_entry->parts_pending == 0) {
+    finish(mshr_entry);
   }
-
-  // Order this entry after previously-returned entries, but before non-returned
-  // entries
-  std::iter_swap(mshr_entry, first_unreturned);
 }
 
 void CACHE::finish_translation(const response_type& packet)
@@ -823,6 +1414,8 @@ long CACHE::impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long se
   return repl_module_pimpl->impl_find_victim(triggering_cpu, instr_id, set, current_set, ip, full_addr, type);
 }
 
+std::optional<long> CACHE::impl_peek_victim(long set, const BLOCK* current_set) const { return repl_module_pimpl->impl_peek_victim(set, current_set); }
+
 void CACHE::impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                           champsim::address victim_addr, access_type type, bool hit) const
 {
@@ -851,6 +1444,9 @@ void CACHE::begin_phase()
   new_roi_stats.name = NAME;
   new_sim_stats.name = NAME;
 
+  new_roi_stats.ip_misses = champsim::stats::space_saving<champsim::address>{IP_ATTRIBUTION_SIZE};
+  new_sim_stats.ip_misses = champsim::stats::space_saving<champsim::address>{IP_ATTRIBUTION_SIZE};
+
   roi_stats = new_roi_stats;
   sim_stats = new_sim_stats;
 
@@ -866,17 +1462,37 @@ void CACHE::end_phase(unsigned finished_cpu)
 {
   finished_cpu = finished_cpu;
   roi_stats.total_miss_latency_cycles = sim_stats.total_miss_latency_cycles;
+  roi_stats.ip_misses = sim_stats.ip_misses;
 
   roi_stats.hits = sim_stats.hits;
   roi_stats.misses = sim_stats.misses;
   roi_stats.mshr_merge = sim_stats.mshr_merge;
   roi_stats.mshr_return = sim_stats.mshr_return;
+  roi_stats.mshr_full = sim_stats.mshr_full;
+
+  roi_stats.wb_eviction = sim_stats.wb_eviction;
+  roi_stats.wb_eager = sim_stats.wb_eager;
+  roi_stats.wb_write_through = sim_stats.wb_write_through;
+  roi_stats.wb_write_around = sim_stats.wb_write_around;
+  roi_stats.write_buffer_merges = sim_stats.write_buffer_merges;
+  roi_stats.energy = sim_stats.energy;
 
   roi_stats.pf_requested = sim_stats.pf_requested;
   roi_stats.pf_issued = sim_stats.pf_issued;
   roi_stats.pf_useful = sim_stats.pf_useful;
   roi_stats.pf_useless = sim_stats.pf_useless;
   roi_stats.pf_fill = sim_stats.pf_fill;
+  roi_stats.pf_filtered = sim_stats.pf_filtered;
+  roi_stats.pf_late = sim_stats.pf_late;
+  roi_stats.pf_early = sim_stats.pf_early;
+  roi_stats.pf_polluting = sim_stats.pf_polluting;
+  roi_stats.pf_use_distance = sim_stats.pf_use_distance;
+  roi_stats.pf_late_distance = sim_stats.pf_late_distance;
+  roi_stats.sector_misses = sim_stats.sector_misses;
+  roi_stats.victim_hits = sim_stats.victim_hits;
+  roi_stats.victim_promotions = sim_stats.victim_promotions;
+  roi_stats.pf_buffer_hits = sim_stats.pf_buffer_hits;
+  roi_stats.pf_buffer_promotions = sim_stats.pf_buffer_promotions;
 
   for (auto* ul : upper_levels) {
     ul->roi_stats.RQ_ACCESS = ul->sim_stats.RQ_ACCESS;
@@ -8,10 +8,29 @@ cache_stats operator-(cache_stats lhs, cache_stats rhs)
   result.pf_useful = lhs.pf_useful - rhs.pf_useful;
   result.pf_useless = lhs.pf_useless - rhs.pf_useless;
   result.pf_fill = lhs.pf_fill - rhs.pf_fill;
+  result.pf_filtered = lhs.pf_filtered - rhs.pf_filtered;
+  result.pf_late = lhs.pf_late - rhs.pf_late;
+  result.pf_early = lhs.pf_early - rhs.pf_early;
+  result.pf_polluting = lhs.pf_polluting - rhs.pf_polluting;
+  result.pf_use_distance = lhs.pf_use_distance - rhs.pf_use_distance;
+  result.pf_late_distance = lhs.pf_late_distance - rhs.pf_late_distance;
+  result.sector_misses = lhs.sector_misses - rhs.sector_misses;
+  result.victim_hits = lhs.victim_hits - rhs.victim_hits;
+  result.victim_promotions = lhs.victim_promotions - rhs.victim_promotions;
+  result.pf_buffer_hits = lhs.pf_buffer_hits - rhs.pf_buffer_hits;
+  result.pf_buffer_promotions = lhs.pf_buffer_promotions - rhs.pf_buffer_promotions;
+  result.wb_eviction = lhs.wb_eviction - rhs.wb_eviction;
+  result.wb_eager = lhs.wb_eager - rhs.wb_eager;
+  result.wb_write_through = lhs.wb_write_through - rhs.wb_write_through;
+  result.wb_write_around = lhs.wb_write_around - rhs.wb_write_around;
+  result.write_buffer_merges = lhs.write_buffer_merges - rhs.write_buffer_merges;
 
   result.hits = lhs.hits - rhs.hits;
   result.misses = lhs.misses - rhs.misses;
+  result.mshr_full = lhs.mshr_full - rhs.mshr_full;
 
   result.total_miss_latency_cycles = lhs.total_miss_latency_cycles - rhs.total_miss_latency_cycles;
+  result.ip_misses = lhs.ip_misses - rhs.ip_misses;
+  result.energy = lhs.energy - rhs.energy;
   return result;
 }
@@ -27,6 +27,7 @@
 #include "ooo_cpu.h"
 #include "operable.h"
 #include "phase_info.h"
+#include "ptw.h"
 #include "tracereader.h"
 
 constexpr int DEADLOCK_CYCLE{500};
@@ -171,7 +172,23 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
   std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
   std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
 
-  auto dram = env.dram_view();
+  auto dram_caches = env.dram_cache_view();
+  std::transform(std::begin(dram_caches), std::end(dram_caches), std::back_inserter(stats.sim_dram_cache_stats),
+                 [](const DRAM_CACHE& dram_cache) { return dram_cache.sim_stats; });
+  std::transform(std::begin(dram_caches), std::end(dram_caches), std::back_inserter(stats.roi_dram_cache_stats),
+                 [](const DRAM_CACHE& dram_cache) { return dram_cache.roi_stats; });
+
+  auto ptws = env.ptw_view();
+  std::transform(std::begin(ptws), std::end(ptws), std::back_inserter(stats.sim_ptw_stats), [](const PageTableWalker& ptw) { return ptw.sim_stats; });
+  std::transform(std::begin(ptws), std::end(ptws), std::back_inserter(stats.roi_ptw_stats), [](const PageTableWalker& ptw) { return ptw.roi_stats; });
+
+  auto links = env.link_view();
+  std::transform(std::begin(links), std::end(links), std::back_inserter(stats.sim_link_stats),
+                 [](const champsim::channel& link) { return link.sim_link_stats; });
+  std::transform(std::begin(links), std::end(links), std::back_inserter(stats.roi_link_stats),
+                 [](const champsim::channel& link) { return link.roi_link_stats; });
+
+  const auto& dram = env.dram_view();
   std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
                  [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
   std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
@@ -16,6 +16,7 @@
 
 #include "channel.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/core.h>
 
@@ -29,6 +30,13 @@ champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t
 {
 }
 
+champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset,
+                           std::string_view name, link_parameters link_params)
+    : operable(link_params.clock_period), RQ_SIZE(rq_size), PQ_SIZE(pq_size), WQ_SIZE(wq_size), OFFSET_BITS(offset_bits), match_offset_bits(match_offset),
+      link(link_params), NAME(name)
+{
+}
+
 template <typename Iter, typename F>
 bool do_collision_for(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt, F&& func)
 {
@@ -87,7 +95,7 @@ void champsim::channel::check_collision()
 
   // Check RQ for forwarding from WQ (return if found), then for duplicates (merge if found)
   for (auto rq_it = std::find_if(std::begin(RQ), std::end(RQ), std::not_fn(&request_type::forward_checked)); rq_it != std::end(RQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
+    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, *response_target())) {
       sim_stats.WQ_FORWARD++;
       rq_it = RQ.erase(rq_it);
     } else if (do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
@@ -101,7 +109,7 @@ void champsim::channel::check_collision()
 
   // Check PQ for forwarding from WQ (return if found), then for duplicates (merge if found)
   for (auto pq_it = std::find_if(std::begin(PQ), std::end(PQ), std::not_fn(&request_type::forward_checked)); pq_it != std::end(PQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
+    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, *response_target())) {
       sim_stats.WQ_FORWARD++;
       pq_it = PQ.erase(pq_it);
     } else if (do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
@@ -114,22 +122,130 @@ void champsim::channel::check_collision()
   }
 }
 
-template <typename R>
-bool champsim::channel::do_add_queue(R& queue, std::size_t queue_size, const typename R::value_type& packet)
+bool champsim::channel::do_add_queue(std::deque<request_type> channel::*queue, std::size_t queue_size, const request_type& packet)
 {
-  // check occupancy
-  if (std::size(queue) >= queue_size) {
+  // check occupancy, including the packets that are crossing the link
+  if (occupancy(queue) >= queue_size) {
     return false; // cannot handle this request
   }
 
   // Insert the packet ahead of the translation misses
   auto fwd_pkt = packet;
   fwd_pkt.forward_checked = false;
-  queue.push_back(fwd_pkt);
+  if (timed() && !warmup) {
+    // The packet may begin to cross the link in the next link cycle
+    request_transfer xfer{{fwd_pkt, current_time + clock_period, (queue == &channel::WQ) ? data_flits() : 1, 0}, queue};
+    request_waiting.push_back(xfer);
+  } else {
+    (this->*queue).push_back(fwd_pkt);
+  }
 
   return true;
 }
 
+std::size_t champsim::channel::occupancy(std::deque<request_type> channel::*queue) const
+{
+  auto to_queue = [queue](const auto& xfer) {
+    return xfer.destination == queue;
+  };
+  return std::size(this->*queue) + static_cast<std::size_t>(std::count_if(std::begin(request_waiting), std::end(request_waiting), to_queue))
+         + static_cast<std::size_t>(std::count_if(std::begin(request_wire), std::end(request_wire), to_queue));
+}
+
+long champsim::channel::data_flits() const { return std::max<long>(1, static_cast<long>((BLOCK_SIZE + link.flit_size.count() - 1) / link.flit_size.count())); }
+
+template <typename Q>
+long champsim::channel::transmit(Q& waiting, Q& wire, long latency, uint64_t& packets, uint64_t& flits, uint64_t& busy_cycles, uint64_t& queue_delay)
+{
+  long progress{0};
+  long budget = (link.flits_per_cycle > 0) ? link.flits_per_cycle : std::numeric_limits<long>::max();
+  bool busy = false;
+  while (!std::empty(waiting) && budget > 0) {
+    auto& xfer = waiting.front();
+    if (xfer.flits_sent == 0) {
+      queue_delay += static_cast<uint64_t>((current_time - xfer.event_time) / clock_period);
+    }
+
+    auto sent = std::min(budget, xfer.flits - xfer.flits_sent);
+    xfer.flits_sent += sent;
+    budget -= sent;
+    busy = true;
+
+    if (xfer.flits_sent < xfer.flits) {
+      break;
+    }
+
+    ++packets;
+    flits += static_cast<uint64_t>(xfer.flits);
+    xfer.event_time = current_time + latency * clock_period;
+    wire.push_back(std::move(xfer));
+    waiting.pop_front();
+    ++progress;
+  }
+
+  if (busy) {
+    ++busy_cycles;
+  }
+  return progress;
+}
+
+long champsim::channel::operate()
+{
+  long progress{0};
+  ++sim_link_stats.cycles;
+
+  std::transform(std::begin(returning), std::end(returning), std::back_inserter(response_waiting),
+                 [time = current_time, flits = data_flits()](const auto& pkt) { return transfer<response_type>{pkt, time, flits, 0}; });
+  returning.clear();
+
+  progress += transmit(request_waiting, request_wire, warmup ? 0 : link.request_latency, sim_link_stats.request_packets, sim_link_stats.request_flits,
+                       sim_link_stats.request_busy_cycles, sim_link_stats.request_queue_delay);
+  progress += transmit(response_waiting, response_wire, warmup ? 0 : link.response_latency, sim_link_stats.response_packets, sim_link_stats.response_flits,
+                       sim_link_stats.response_busy_cycles, sim_link_stats.response_queue_delay);
+
+  // The latency is the same for every packet, so packets arrive in the order they were sent
+  auto arrived = [time = current_time](const auto& xfer) {
+    return xfer.event_time <= time;
+  };
+  auto request_end = std::find_if_not(std::begin(request_wire), std::end(request_wire), arrived);
+  std::for_each(std::begin(request_wire), request_end, [this](const auto& xfer) { (this->*(xfer.destination)).push_back(xfer.packet); });
+  request_wire.erase(std::begin(request_wire), request_end);
+
+  auto response_end = std::find_if_not(std::begin(response_wire), std::end(response_wire), arrived);
+  std::transform(std::begin(response_wire), response_end, std::back_inserter(returned), [](const auto& xfer) { return xfer.packet; });
+  response_wire.erase(std::begin(response_wire), response_end);
+
+  return progress;
+}
+
+void champsim::channel::begin_phase()
+{
+  link_stats_type new_stats;
+  new_stats.name = NAME;
+  sim_link_stats = new_stats;
+  roi_link_stats = new_stats;
+}
+
+void champsim::channel::end_phase(unsigned /*cpu*/) { roi_link_stats = sim_link_stats; }
+
+bool champsim::channel::timed() const { return link.clock_period > champsim::chrono::picoseconds{}; }
+
+std::deque<champsim::channel::response_type>* champsim::channel::response_target() { return (timed() && !warmup) ? &returning : &returned; }
+
+champsim::link_stats champsim::operator-(champsim::link_stats lhs, champsim::link_stats rhs)
+{
+  lhs.cycles -= rhs.cycles;
+  lhs.request_packets -= rhs.request_packets;
+  lhs.request_flits -= rhs.request_flits;
+  lhs.request_busy_cycles -= rhs.request_busy_cycles;
+  lhs.request_queue_delay -= rhs.request_queue_delay;
+  lhs.response_packets -= rhs.response_packets;
+  lhs.response_flits -= rhs.response_flits;
+  lhs.response_busy_cycles -= rhs.response_busy_cycles;
+  lhs.response_queue_delay -= rhs.response_queue_delay;
+  return lhs;
+}
+
 bool champsim::channel::add_rq(const request_type& packet)
 {
   if constexpr (champsim::debug_print) {
@@ -139,7 +255,7 @@ bool champsim::channel::add_rq(const request_type& packet)
 
   sim_stats.RQ_ACCESS++;
 
-  auto result = do_add_queue(RQ, RQ_SIZE, packet);
+  auto result = do_add_queue(&channel::RQ, RQ_SIZE, packet);
 
   if (result) {
     sim_stats.RQ_TO_CACHE++;
@@ -159,7 +275,7 @@ bool champsim::channel::add_wq(const request_type& packet)
 
   sim_stats.WQ_ACCESS++;
 
-  auto result = do_add_queue(WQ, WQ_SIZE, packet);
+  auto result = do_add_queue(&channel::WQ, WQ_SIZE, packet);
 
   if (result) {
     sim_stats.WQ_TO_CACHE++;
@@ -180,7 +296,7 @@ bool champsim::channel::add_pq(const request_type& packet)
   sim_stats.PQ_ACCESS++;
 
   auto fwd_pkt = packet;
-  auto result = do_add_queue(PQ, PQ_SIZE, fwd_pkt);
+  auto result = do_add_queue(&channel::PQ, PQ_SIZE, fwd_pkt);
   if (result) {
     sim_stats.PQ_TO_CACHE++;
   } else {
@@ -190,14 +306,16 @@ bool champsim::channel::add_pq(const request_type& packet)
   return result;
 }
 
-std::size_t champsim::channel::rq_occupancy() const { return std::size(RQ); }
+std::size_t champsim::channel::rq_occupancy() const { return occupancy(&channel::RQ); }
 
-std::size_t champsim::channel::wq_occupancy() const { return std::size(WQ); }
+std::size_t champsim::channel::wq_occupancy() const { return occupancy(&channel::WQ); }
 
-std::size_t champsim::channel::pq_occupancy() const { return std::size(PQ); }
+std::size_t champsim::channel::pq_occupancy() const { return occupancy(&channel::PQ); }
 
 std::size_t champsim::channel::rq_size() const { return RQ_SIZE; }
 
 std::size_t champsim::channel::wq_size() const { return WQ_SIZE; }
 
 std::size_t champsim::channel::pq_size() const { return PQ_SIZE; }
+
+champsim::data::bits champsim::channel::offset_bits() const { return OFFSET_BITS; }
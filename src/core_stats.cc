@@ -8,8 +8,38 @@ cpu_stats operator-(cpu_stats lhs, cpu_stats rhs)
   lhs.end_cycles -= rhs.end_cycles;
   lhs.total_rob_occupancy_at_branch_mispredict -= rhs.total_rob_occupancy_at_branch_mispredict;
 
+  lhs.dib_lookups -= rhs.dib_lookups;
+  lhs.dib_hits -= rhs.dib_hits;
+  lhs.dib_uops_delivered -= rhs.dib_uops_delivered;
+  lhs.decoder_uops_delivered -= rhs.decoder_uops_delivered;
+  lhs.dib_delivery_cycles -= rhs.dib_delivery_cycles;
+  lhs.decoder_delivery_cycles -= rhs.decoder_delivery_cycles;
+  lhs.dib_switches -= rhs.dib_switches;
+  lhs.dib_overflows -= rhs.dib_overflows;
+  lhs.dib_inclusion_invalidations -= rhs.dib_inclusion_invalidations;
+
+  lhs.decode_cache_hits -= rhs.decode_cache_hits;
+  lhs.decode_cache_misses -= rhs.decode_cache_misses;
+
+  lhs.interval_dispatch_cycles -= rhs.interval_dispatch_cycles;
+  lhs.interval_frontend_stall_cycles -= rhs.interval_frontend_stall_cycles;
+  lhs.interval_branch_stall_cycles -= rhs.interval_branch_stall_cycles;
+  lhs.interval_memory_stall_cycles -= rhs.interval_memory_stall_cycles;
+  lhs.interval_window_stall_cycles -= rhs.interval_window_stall_cycles;
+
+  lhs.in_order_issue_cycles -= rhs.in_order_issue_cycles;
+  lhs.in_order_use_stall_cycles -= rhs.in_order_use_stall_cycles;
+  lhs.in_order_frontend_stall_cycles -= rhs.in_order_frontend_stall_cycles;
+  lhs.in_order_branch_stall_cycles -= rhs.in_order_branch_stall_cycles;
+  lhs.in_order_window_stall_cycles -= rhs.in_order_window_stall_cycles;
+
   lhs.total_branch_types -= rhs.total_branch_types;
   lhs.branch_type_misses -= rhs.branch_type_misses;
 
+  lhs.energy = lhs.energy - rhs.energy;
+
+  lhs.ip_mispredicts -= rhs.ip_mispredicts;
+  lhs.ip_rob_stalls -= rhs.ip_rob_stalls;
+
   return lhs;
 }
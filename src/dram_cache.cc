@@ -0,0 +1,559 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dram_cache.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <fmt/core.h>
+
+#include "deadlock.h"
+#include "instruction.h"
+#include "util/bits.h" // for lg2, next_pow2
+#include "util/span.h"
+
+namespace
+{
+constexpr uint8_t predictor_max = 7;
+constexpr uint8_t predictor_threshold = 4;
+constexpr std::size_t footprint_table_ways = 4;
+
+// The number of rows in each bank, so that the cache's capacity fits in its DRAM
+std::size_t rows_for(champsim::data::bytes size, champsim::data::bytes chan_width, std::size_t chans, std::size_t columns, std::size_t ranks,
+                     std::size_t bankgroups, std::size_t banks)
+{
+  auto row_set_size = static_cast<std::size_t>(chan_width.count()) * chans * columns * ranks * bankgroups * banks;
+  return champsim::next_pow2(std::max<std::size_t>(static_cast<std::size_t>(size.count()) / row_set_size, 1));
+}
+} // namespace
+
+DRAM_CACHE::DRAM_CACHE(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd,
+                       std::size_t t_cas, std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul, channel_type* ll,
+                       std::size_t rq_size, std::size_t wq_size, std::size_t chans, champsim::data::bytes chan_width, std::size_t columns, std::size_t ranks,
+                       std::size_t bankgroups, std::size_t banks, std::size_t refreshes_per_period, dram_cache_parameters cache_params)
+    : champsim::operable(mc_period), upper_levels(std::move(ul)), lower_level(ll), params(cache_params),
+      address_mapping(chan_width, BLOCK_SIZE / chan_width.count(), chans, bankgroups, banks, columns, ranks,
+                      rows_for(cache_params.size, chan_width, chans, columns, ranks, bankgroups, banks)),
+      PAGE_OFFSET_BITS{champsim::lg2(static_cast<uint64_t>(cache_params.page_size.count()))},
+      NUM_SET(std::max<std::size_t>(static_cast<std::size_t>(cache_params.size.count() / cache_params.page_size.count()) / cache_params.ways, 1)),
+      miss_predictor(std::max<std::size_t>(cache_params.predictor_size, 1), 0),
+      footprint_table{std::max<std::size_t>(cache_params.footprint_table_size / footprint_table_ways, 1), footprint_table_ways}
+{
+  // Each page is tracked with one bit per block
+  assert(params.page_size.count() >= BLOCK_SIZE);
+  assert(params.page_size.count() <= std::numeric_limits<uint64_t>::digits * BLOCK_SIZE);
+  assert(params.ways >= 1);
+
+  for (std::size_t i{0}; i < chans; ++i) {
+    channels.emplace_back(dbus_period, mc_period, t_rp, t_rcd, t_cas, t_ras, refresh_period, refreshes_per_period, chan_width, rq_size, wq_size,
+                          address_mapping);
+  }
+}
+
+long DRAM_CACHE::operate()
+{
+  long progress{0};
+
+  progress += handle_memory_returns();
+  progress += handle_tag_returns();
+  inflight.erase(std::remove_if(std::begin(inflight), std::end(inflight), [](const auto& x) { return x.finished; }), std::end(inflight));
+
+  progress += issue_memory_reads();
+  progress += issue_writebacks();
+  progress += issue_fills();
+
+  initiate_requests();
+
+  for (auto& channel : channels) {
+    progress += channel._operate();
+  }
+
+  return progress;
+}
+
+void DRAM_CACHE::initiate_requests()
+{
+  for (auto* ul : upper_levels) {
+    for (auto q : {std::ref(ul->RQ), std::ref(ul->PQ)}) {
+      auto [begin, end] = champsim::get_span_p(std::cbegin(q.get()), std::cend(q.get()), [ul, this](const auto& pkt) { return this->add_rq(pkt, ul); });
+      q.get().erase(begin, end);
+    }
+
+    auto [wq_begin, wq_end] = champsim::get_span_p(std::cbegin(ul->WQ), std::cend(ul->WQ), [this](const auto& pkt) { return this->add_wq(pkt); });
+    ul->WQ.erase(wq_begin, wq_end);
+  }
+}
+
+bool DRAM_CACHE::add_rq(const request_type& packet, channel_type* ul)
+{
+  // Reads of a block that is already being looked up or fetched wait for it
+  champsim::block_number block{packet.address};
+  if (auto found = std::find_if(std::begin(inflight), std::end(inflight), [block](const auto& x) { return champsim::block_number{x.address} == block; });
+      found != std::end(inflight)) {
+    if (packet.response_requested && std::find(std::begin(found->to_return), std::end(found->to_return), ul->response_target()) == std::end(found->to_return)) {
+      found->to_return.push_back(ul->response_target());
+    }
+    auto instr_copy = std::move(found->instr_depend_on_me);
+    found->instr_depend_on_me.clear();
+    std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(packet.instr_depend_on_me), std::end(packet.instr_depend_on_me),
+                   std::back_inserter(found->instr_depend_on_me));
+    return true;
+  }
+
+  if (std::size(inflight) >= params.mshr_size || std::size(pending_writebacks) >= params.mshr_size) {
+    return false;
+  }
+
+  // The tags are read from the row that would hold the block
+  auto frame = find_frame(packet.address);
+  if (frame == nullptr) {
+    frame = find_victim(packet.address);
+  }
+  auto tag_location = location(frame, packet.address);
+  if (!add_tag_read(tag_location)) {
+    return false;
+  }
+
+  miss_entry entry;
+  entry.type = packet.type;
+  entry.cpu = packet.cpu;
+  entry.pf_metadata = packet.pf_metadata;
+  entry.address = packet.address;
+  entry.v_address = packet.v_address;
+  entry.ip = packet.ip;
+  entry.tag_location = tag_location;
+  entry.instr_depend_on_me = packet.instr_depend_on_me;
+  if (packet.response_requested) {
+    entry.to_return = {ul->response_target()};
+  }
+
+  // Main memory is read in parallel with the tags if a miss is predicted
+  entry.memory_wanted = predict_miss(entry);
+
+  inflight.push_back(std::move(entry));
+  return true;
+}
+
+bool DRAM_CACHE::add_wq(const request_type& packet)
+{
+  if (std::size(pending_fills) >= params.mshr_size || std::size(pending_writebacks) >= params.mshr_size) {
+    return false;
+  }
+
+  // Writes are allocated without fetching the rest of the page
+  auto frame = find_frame(packet.address);
+  if (frame == nullptr) {
+    frame = allocate(packet.address);
+  }
+
+  auto bit = uint64_t{1} << block_index(packet.address);
+  frame->valid_blocks |= bit;
+  frame->dirty_blocks |= bit;
+  frame->last_used = ++access_count;
+  pending_fills.push_back(location(frame, packet.address));
+
+  ++sim_stats.writes;
+  return true;
+}
+
+bool DRAM_CACHE::add_tag_read(champsim::address loc)
+{
+  auto& channel = channels[address_mapping.get_channel(loc)];
+  auto rq_it = std::find_if_not(std::begin(channel.RQ), std::end(channel.RQ), [](const auto& pkt) { return pkt.has_value(); });
+  if (rq_it == std::end(channel.RQ)) {
+    return false;
+  }
+
+  request_type packet;
+  packet.address = loc;
+  packet.v_address = loc;
+
+  *rq_it = DRAM_CHANNEL::request_type{packet};
+  rq_it->value().forward_checked = false;
+  rq_it->value().scheduled = false;
+  rq_it->value().ready_time = current_time;
+  rq_it->value().to_return = {&tag_returned};
+
+  ++sim_stats.tag_reads;
+  return true;
+}
+
+bool DRAM_CACHE::add_fill(champsim::address loc)
+{
+  auto& channel = channels[address_mapping.get_channel(loc)];
+  auto wq_it = std::find_if_not(std::begin(channel.WQ), std::end(channel.WQ), [](const auto& pkt) { return pkt.has_value(); });
+  if (wq_it == std::end(channel.WQ)) {
+    return false;
+  }
+
+  request_type packet;
+  packet.address = loc;
+  packet.v_address = loc;
+
+  *wq_it = DRAM_CHANNEL::request_type{packet};
+  wq_it->value().forward_checked = false;
+  wq_it->value().scheduled = false;
+  wq_it->value().ready_time = current_time;
+
+  ++sim_stats.cache_writes;
+  return true;
+}
+
+long DRAM_CACHE::handle_tag_returns()
+{
+  long progress{0};
+
+  // Reads of the same location are merged by the channel, so a response completes every lookup that read it
+  for (const auto& response : tag_returned) {
+    for (auto& entry : inflight) {
+      if (!entry.finished && !entry.tag_checked && !entry.footprint_fetch && entry.tag_location == response.address) {
+        finish_tag_check(entry);
+      }
+    }
+    ++progress;
+  }
+  tag_returned.clear();
+
+  return progress;
+}
+
+long DRAM_CACHE::handle_memory_returns()
+{
+  long progress{0};
+
+  for (const auto& response : lower_level->returned) {
+    // The lower level may have merged several reads of the block, so the response completes all of them
+    champsim::block_number block{response.address};
+    orphaned_reads.erase(std::remove(std::begin(orphaned_reads), std::end(orphaned_reads), block), std::end(orphaned_reads));
+    for (auto& entry : inflight) {
+      if (!entry.finished && entry.memory_issued && !entry.memory_returned && champsim::block_number{entry.address} == block) {
+        entry.memory_returned = true;
+        if (entry.tag_checked) {
+          finish_miss(entry);
+        }
+      }
+    }
+    ++progress;
+  }
+  lower_level->returned.clear();
+
+  return progress;
+}
+
+long DRAM_CACHE::issue_memory_reads()
+{
+  long progress{0};
+
+  // The rest of the footprint of each newly allocated page is fetched, unless it has since been filled or evicted
+  while (!std::empty(pending_footprint) && std::size(inflight) < params.mshr_size) {
+    auto addr = pending_footprint.front();
+    pending_footprint.pop_front();
+
+    auto frame = find_frame(addr);
+    champsim::block_number block{addr};
+    if (frame != nullptr && (frame->valid_blocks & (uint64_t{1} << block_index(addr))) == 0
+        && std::none_of(std::begin(inflight), std::end(inflight), [block](const auto& x) { return champsim::block_number{x.address} == block; })) {
+      miss_entry entry;
+      entry.footprint_fetch = true;
+      entry.tag_checked = true;
+      entry.memory_wanted = true;
+      entry.type = access_type::PREFETCH;
+      entry.address = addr;
+      entry.v_address = addr;
+      inflight.push_back(std::move(entry));
+      ++sim_stats.footprint_fetches;
+    }
+  }
+
+  for (auto& entry : inflight) {
+    if (entry.memory_wanted && !entry.memory_issued) {
+      // A read that is still outstanding for the block is taken over, rather than duplicated
+      if (auto orphan = std::find(std::begin(orphaned_reads), std::end(orphaned_reads), champsim::block_number{entry.address});
+          orphan != std::end(orphaned_reads)) {
+        orphaned_reads.erase(orphan);
+        entry.memory_issued = true;
+        ++progress;
+        continue;
+      }
+
+      request_type packet;
+      packet.type = entry.type;
+      packet.cpu = entry.cpu;
+      packet.address = entry.address;
+      packet.v_address = entry.v_address;
+      packet.ip = entry.ip;
+      if (!lower_level->add_rq(packet)) {
+        break;
+      }
+
+      entry.memory_issued = true;
+      ++sim_stats.memory_reads;
+      ++progress;
+    }
+  }
+
+  return progress;
+}
+
+long DRAM_CACHE::issue_fills()
+{
+  long progress{0};
+  while (!std::empty(pending_fills) && add_fill(pending_fills.front())) {
+    pending_fills.pop_front();
+    ++progress;
+  }
+  return progress;
+}
+
+long DRAM_CACHE::issue_writebacks()
+{
+  long progress{0};
+  while (!std::empty(pending_writebacks) && lower_level->add_wq(pending_writebacks.front())) {
+    pending_writebacks.pop_front();
+    ++progress;
+  }
+  return progress;
+}
+
+void DRAM_CACHE::finish_tag_check(miss_entry& entry)
+{
+  entry.tag_checked = true;
+
+  auto frame = find_frame(entry.address);
+  auto bit = uint64_t{1} << block_index(entry.address);
+  bool hit = (frame != nullptr) && ((frame->valid_blocks & bit) != 0);
+  train_predictor(entry, !hit);
+
+  if (hit) {
+    ++sim_stats.read_hits;
+    frame->used_blocks |= bit;
+    frame->last_used = ++access_count;
+
+    // A read of main memory that the predictor started is no longer needed
+    if (entry.memory_wanted) {
+      ++sim_stats.mispredicted_hits;
+      if (entry.memory_issued && !entry.memory_returned) {
+        orphaned_reads.emplace_back(entry.address);
+      }
+    }
+    entry.memory_wanted = false;
+    respond(entry);
+  } else {
+    ++sim_stats.read_misses;
+    if (entry.memory_wanted) {
+      ++sim_stats.predicted_misses;
+    }
+    entry.memory_wanted = true;
+    if (entry.memory_returned) {
+      finish_miss(entry);
+    }
+  }
+}
+
+void DRAM_CACHE::finish_miss(miss_entry& entry)
+{
+  auto frame = find_frame(entry.address);
+  if (frame == nullptr) {
+    // The page of a footprint fetch was evicted before the fetch returned
+    if (entry.footprint_fetch && std::empty(entry.to_return)) {
+      entry.finished = true;
+      return;
+    }
+
+    frame = allocate(entry.address);
+    if (params.organization == dram_cache_parameters::organization_type::unison) {
+      frame->footprint_key = footprint_key(entry);
+      if (auto predicted = footprint_table.check_hit({frame->footprint_key, 0}); predicted.has_value()) {
+        auto footprint = predicted->footprint & ~(uint64_t{1} << block_index(entry.address));
+        for (std::size_t i = 0; footprint != 0; ++i, footprint >>= 1) {
+          if ((footprint & 1) != 0) {
+            pending_footprint.push_back(frame->page + static_cast<champsim::address::difference_type>(i * BLOCK_SIZE));
+          }
+        }
+      }
+    }
+  }
+
+  auto bit = uint64_t{1} << block_index(entry.address);
+  frame->valid_blocks |= bit;
+  if (!entry.footprint_fetch || !std::empty(entry.to_return)) {
+    frame->used_blocks |= bit;
+  }
+  frame->last_used = ++access_count;
+  pending_fills.push_back(location(frame, entry.address));
+
+  respond(entry);
+}
+
+void DRAM_CACHE::respond(miss_entry& entry)
+{
+  response_type response{entry.address, entry.v_address, champsim::address{}, entry.pf_metadata, entry.instr_depend_on_me};
+  for (auto* ret : entry.to_return) {
+    ret->push_back(response);
+  }
+  entry.finished = true;
+}
+
+auto DRAM_CACHE::allocate(champsim::address addr) -> frame_type*
+{
+  auto victim = find_victim(addr);
+  if (victim->valid) {
+    // Each dirty block is written back to main memory
+    auto dirty = victim->dirty_blocks;
+    for (std::size_t i = 0; dirty != 0; ++i, dirty >>= 1) {
+      if ((dirty & 1) != 0) {
+        request_type packet;
+        packet.type = access_type::WRITE;
+        packet.address = victim->page + static_cast<champsim::address::difference_type>(i * BLOCK_SIZE);
+        packet.v_address = packet.address;
+        packet.response_requested = false;
+        pending_writebacks.push_back(packet);
+        ++sim_stats.writebacks;
+      }
+    }
+
+    sim_stats.unused_fetches += std::bitset<std::numeric_limits<uint64_t>::digits>{victim->valid_blocks & ~victim->used_blocks}.count();
+
+    // The blocks that were used while the page was resident are fetched the next time the same access misses
+    if (params.organization == dram_cache_parameters::organization_type::unison && victim->used_blocks != 0) {
+      footprint_table.fill({victim->footprint_key, victim->used_blocks});
+    }
+  }
+
+  *victim = frame_type{true, page_of(addr), 0, 0, 0, 0, ++access_count};
+  return victim;
+}
+
+std::size_t DRAM_CACHE::get_set_index(champsim::address addr) const { return addr.slice_upper(PAGE_OFFSET_BITS).to<std::size_t>() % NUM_SET; }
+
+champsim::address DRAM_CACHE::page_of(champsim::address addr) const { return champsim::address{addr.slice_upper(PAGE_OFFSET_BITS)}; }
+
+std::size_t DRAM_CACHE::block_index(champsim::address addr) const
+{
+  return addr.slice(champsim::dynamic_extent{PAGE_OFFSET_BITS, champsim::data::bits{LOG2_BLOCK_SIZE}}).to<std::size_t>();
+}
+
+auto DRAM_CACHE::find_frame(champsim::address addr) -> frame_type*
+{
+  auto set = frames.find(get_set_index(addr));
+  if (set == std::end(frames)) {
+    return nullptr;
+  }
+  auto found = std::find_if(std::begin(set->second), std::end(set->second), [page = page_of(addr)](const auto& x) { return x.valid && x.page == page; });
+  return (found == std::end(set->second)) ? nullptr : &*found;
+}
+
+auto DRAM_CACHE::find_victim(champsim::address addr) -> frame_type*
+{
+  auto& set = frames.try_emplace(get_set_index(addr), params.ways).first->second;
+  if (auto invalid = std::find_if_not(std::begin(set), std::end(set), [](const auto& x) { return x.valid; }); invalid != std::end(set)) {
+    return &*invalid;
+  }
+  return &*std::min_element(std::begin(set), std::end(set), [](const auto& lhs, const auto& rhs) { return lhs.last_used < rhs.last_used; });
+}
+
+champsim::address DRAM_CACHE::location(const frame_type* frame, champsim::address addr) const
+{
+  auto set_idx = get_set_index(addr);
+  auto way = static_cast<uint64_t>(frame - frames.at(set_idx).data());
+  auto frame_idx = set_idx * params.ways + way;
+  return champsim::address{frame_idx * static_cast<uint64_t>(params.page_size.count()) + block_index(addr) * BLOCK_SIZE};
+}
+
+std::size_t DRAM_CACHE::predictor_index(const miss_entry& entry) const
+{
+  auto ip = entry.ip.to<uint64_t>();
+  return static_cast<std::size_t>((ip ^ (ip >> 12) ^ (uint64_t{entry.cpu} << 8)) % std::size(miss_predictor));
+}
+
+bool DRAM_CACHE::predict_miss(const miss_entry& entry) const
+{
+  return params.miss_predictor == dram_cache_parameters::predictor_type::map_i && miss_predictor[predictor_index(entry)] >= predictor_threshold;
+}
+
+void DRAM_CACHE::train_predictor(const miss_entry& entry, bool miss)
+{
+  if (params.miss_predictor != dram_cache_parameters::predictor_type::map_i) {
+    return;
+  }
+
+  auto& counter = miss_predictor[predictor_index(entry)];
+  if (miss && counter < predictor_max) {
+    ++counter;
+  } else if (!miss && counter > 0) {
+    --counter;
+  }
+}
+
+uint64_t DRAM_CACHE::footprint_key(const miss_entry& entry) const
+{
+  auto ip = entry.ip.to<uint64_t>();
+  return (uint64_t{static_cast<uint32_t>(ip ^ (ip >> 32))} << std::numeric_limits<uint8_t>::digits) + block_index(entry.address);
+}
+
+champsim::data::bytes DRAM_CACHE::size() const { return champsim::data::bytes{static_cast<long long>(NUM_SET * params.ways) * params.page_size.count()}; }
+
+void DRAM_CACHE::initialize()
+{
+  std::string_view organization = (params.organization == dram_cache_parameters::organization_type::unison) ? "unison" : "alloy";
+  fmt::print("DRAM Cache Size: {} Organization: {} Channels: {}\n", champsim::data::mebibytes{size()}, organization, std::size(channels));
+}
+
+void DRAM_CACHE::begin_phase()
+{
+  std::size_t chan_idx = 0;
+  for (auto& chan : channels) {
+    DRAM_CHANNEL::stats_type new_stats;
+    new_stats.name = "Channel " + std::to_string(chan_idx++);
+    chan.sim_stats = new_stats;
+    chan.warmup = warmup;
+  }
+
+  stats_type new_stats;
+  new_stats.name = "DRAM cache";
+  sim_stats = new_stats;
+
+  for (auto* ul : upper_levels) {
+    channel_type::stats_type ul_new_roi_stats;
+    channel_type::stats_type ul_new_sim_stats;
+    ul->roi_stats = ul_new_roi_stats;
+    ul->sim_stats = ul_new_sim_stats;
+  }
+}
+
+void DRAM_CACHE::end_phase(unsigned cpu)
+{
+  roi_stats = sim_stats;
+  for (auto& chan : channels) {
+    chan.end_phase(cpu);
+  }
+}
+
+// LCOV_EXCL_START Exclude the following function from LCOV
+void DRAM_CACHE::print_deadlock()
+{
+  champsim::range_print_deadlock(inflight, "DRAM cache", "address: {} tag_checked: {} memory_issued: {} memory_returned: {}", [](const auto& entry) {
+    return std::tuple{entry.address, entry.tag_checked, entry.memory_issued, entry.memory_returned};
+  });
+
+  int j = 0;
+  for (auto& chan : channels) {
+    fmt::print("DRAM Cache Channel {}\n", j++);
+    chan.print_deadlock();
+  }
+}
+// LCOV_EXCL_STOP
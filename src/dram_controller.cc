@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cfenv>
 #include <cmath>
+#include <stdexcept>
 #include <fmt/core.h>
 
 #include "deadlock.h"
@@ -30,21 +31,36 @@
 MEMORY_CONTROLLER::MEMORY_CONTROLLER(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd,
                                      std::size_t t_cas, std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul,
                                      std::size_t rq_size, std::size_t wq_size, std::size_t chans, champsim::data::bytes chan_width, std::size_t rows,
-                                     std::size_t columns, std::size_t ranks, std::size_t bankgroups, std::size_t banks, std::size_t refreshes_per_period)
+                                     std::size_t columns, std::size_t ranks, std::size_t bankgroups, std::size_t banks, std::size_t refreshes_per_period,
+                                     dram_prefetch_parameters pf_params, dram_rowhammer_parameters rh_params, page_profile_parameters profile_params_)
     : champsim::operable(mc_period), queues(std::move(ul)), channel_width(chan_width),
-      address_mapping(chan_width, BLOCK_SIZE / chan_width.count(), chans, bankgroups, banks, columns, ranks, rows), data_bus_period(dbus_period)
+      address_mapping(chan_width, BLOCK_SIZE / chan_width.count(), chans, bankgroups, banks, columns, ranks, rows), prefetch_params(pf_params),
+      profile_params(std::move(profile_params_)), data_bus_period(dbus_period)
 {
   for (std::size_t i{0}; i < chans; ++i) {
+    auto channel_rh_params = rh_params;
+    channel_rh_params.seed += i; // Each channel draws its own sequence
     channels.emplace_back(dbus_period, mc_period, t_rp, t_rcd, t_cas, t_ras, refresh_period, refreshes_per_period, chan_width, rq_size, wq_size,
-                          address_mapping);
+                          address_mapping, prefetch_params.buffer_size, channel_rh_params);
+    channels.back().profile_pages = profile_params.enabled();
+  }
+
+  if (profile_params.enabled()) {
+    profile_file.open(profile_params.file);
+    if (!profile_file)
+      throw std::runtime_error{"Could not open the page profile file " + profile_params.file};
+    profile_file << "epoch,kind,id,reads,writes,row_hits\n";
   }
 }
 
 DRAM_CHANNEL::DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd,
                            std::size_t t_cas, std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::size_t refreshes_per_period,
-                           champsim::data::bytes width, std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapper)
+                           champsim::data::bytes width, std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapper,
+                           std::size_t prefetch_buffer_size, dram_rowhammer_parameters rh_params)
     : champsim::operable(mc_period), address_mapping(addr_mapper), WQ{wq_size}, RQ{rq_size}, channel_width(width),
-      DRAM_ROWS_PER_REFRESH(address_mapping.rows() / refreshes_per_period), tRP(t_rp * mc_period), tRCD(t_rcd * mc_period), tCAS(t_cas * mc_period),
+      prefetch_buffer{1, std::max(prefetch_buffer_size, std::size_t{1})},
+      DRAM_ROWS_PER_REFRESH(address_mapping.rows() / refreshes_per_period), rowhammer_params(rh_params), rowhammer_rng(rh_params.seed), tRP(t_rp * mc_period),
+      tRCD(t_rcd * mc_period), tCAS(t_cas * mc_period),
       tRAS(t_ras * mc_period), tREF(refresh_period / refreshes_per_period),
       tRFC(std::chrono::duration_cast<champsim::chrono::clock::duration>(
           std::sqrt(champsim::data::bits_per_byte * (double)champsim::data::gibibytes{density()}.count()) * mc_period * t_ras)),
@@ -57,6 +73,9 @@ DRAM_CHANNEL::DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::
   request_array_type br(address_mapping.ranks() * address_mapping.banks() * address_mapping.bankgroups());
   bank_request = br;
   active_request = std::end(bank_request);
+  rowhammer_state.resize(std::size(bank_request));
+  bank_accesses.resize(std::size(bank_request));
+  assert(rowhammer_params.mitigation == dram_rowhammer_parameters::mitigation_type::none || rowhammer_params.threshold > 0);
 }
 
 DRAM_ADDRESS_MAPPING::DRAM_ADDRESS_MAPPING(champsim::data::bytes channel_width_, std::size_t pref_size_, std::size_t channels_, std::size_t bankgroups_,
@@ -101,6 +120,10 @@ long MEMORY_CONTROLLER::operate()
     progress += channel._operate();
   }
 
+  if (profile_params.enabled() && !warmup && profile_params.epoch_length > 0 && ++profile_epoch_cycles >= profile_params.epoch_length) {
+    end_profile_epoch();
+  }
+
   return progress;
 }
 
@@ -127,13 +150,24 @@ long DRAM_CHANNEL::operate()
       }
       entry.reset();
     }
+
+    for (auto& entry : buffer_returns) {
+      response_type response{entry.address, entry.v_address, entry.data, entry.pf_metadata, entry.instr_depend_on_me};
+      for (auto* ret : entry.to_return) {
+        ret->push_back(response);
+      }
+      ++progress;
+    }
+    buffer_returns.clear();
   }
 
   check_write_collision();
   check_read_collision();
   progress += finish_dbus_request();
+  progress += finish_buffer_returns();
   swap_write_mode();
   progress += schedule_refresh();
+  progress += schedule_mitigation();
   progress += populate_dbus();
   progress += service_packet(schedule_packet());
 
@@ -151,6 +185,11 @@ long DRAM_CHANNEL::finish_dbus_request()
       ret->push_back(response);
     }
 
+    // Memory-side prefetches are held until a read asks for them, unless a read already merged with the prefetch
+    if (active_request->pkt->value().memory_prefetch && std::empty(active_request->pkt->value().to_return)) {
+      prefetch_buffer.fill({champsim::block_number{active_request->pkt->value().address}});
+    }
+
     active_request->valid = false;
 
     active_request->pkt->reset();
@@ -161,6 +200,23 @@ long DRAM_CHANNEL::finish_dbus_request()
   return progress;
 }
 
+long DRAM_CHANNEL::finish_buffer_returns()
+{
+  long progress{0};
+
+  while (!std::empty(buffer_returns) && buffer_returns.front().ready_time <= current_time) {
+    const auto& entry = buffer_returns.front();
+    response_type response{entry.address, entry.v_address, entry.data, entry.pf_metadata, entry.instr_depend_on_me};
+    for (auto* ret : entry.to_return) {
+      ret->push_back(response);
+    }
+    buffer_returns.pop_front();
+    ++progress;
+  }
+
+  return progress;
+}
+
 long DRAM_CHANNEL::schedule_refresh()
 {
   long progress = {0};
@@ -172,8 +228,19 @@ long DRAM_CHANNEL::schedule_refresh()
     last_refresh = current_time;
     refresh_row += DRAM_ROWS_PER_REFRESH;
     sim_stats.refresh_cycles++;
-    if (refresh_row >= address_mapping.rows())
+    if (refresh_row >= address_mapping.rows()) {
       refresh_row -= address_mapping.rows();
+
+      // Every row has been refreshed, so the activation counts start again
+      for (auto& state : rowhammer_state) {
+        state.table.clear();
+        state.spillover = 0;
+      }
+    }
+
+    for (auto& state : rowhammer_state) {
+      state.raa -= std::min(state.raa, rowhammer_params.threshold);
+    }
   }
 
   // go through each bank, and handle refreshes
@@ -183,7 +250,7 @@ long DRAM_CHANNEL::schedule_refresh()
       b_req.need_refresh = true;
     }
     // refresh is being scheduled for this bank
-    if (b_req.need_refresh && !b_req.valid) {
+    if (b_req.need_refresh && !b_req.valid && !b_req.under_mitigation) {
       b_req.ready_time = current_time + tRFC;
       b_req.need_refresh = false;
       b_req.under_refresh = true;
@@ -201,6 +268,85 @@ long DRAM_CHANNEL::schedule_refresh()
   return (progress);
 }
 
+void DRAM_CHANNEL::record_activation(std::size_t bank, std::size_t row)
+{
+  ++sim_stats.activations;
+
+  auto& state = rowhammer_state.at(bank);
+  const auto neighbor_refresh = champsim::chrono::clock::duration{(tRAS + tRP) * 2 * rowhammer_params.blast_radius};
+  switch (rowhammer_params.mitigation) {
+  case dram_rowhammer_parameters::mitigation_type::para:
+    if (std::bernoulli_distribution{rowhammer_params.para_probability}(rowhammer_rng)) {
+      state.pending += neighbor_refresh;
+      ++sim_stats.rowhammer_mitigations;
+    }
+    break;
+
+  case dram_rowhammer_parameters::mitigation_type::graphene: {
+    // Misra-Gries frequent item counting: a row that is not tracked replaces the smallest count, if that count is no more than the spillover
+    auto entry = std::find_if(std::begin(state.table), std::end(state.table), [row](const auto& x) { return x.row == row; });
+    if (entry == std::end(state.table)) {
+      if (std::size(state.table) < rowhammer_params.table_size) {
+        entry = state.table.insert(std::end(state.table), {row, state.spillover});
+      } else {
+        entry = std::min_element(std::begin(state.table), std::end(state.table), [](const auto& x, const auto& y) { return x.count < y.count; });
+        if (entry == std::end(state.table) || entry->count > state.spillover) {
+          ++state.spillover;
+          break;
+        }
+        entry->row = row;
+      }
+    }
+
+    ++entry->count;
+    if (entry->count % rowhammer_params.threshold == 0) {
+      state.pending += neighbor_refresh;
+      ++sim_stats.rowhammer_mitigations;
+    }
+  } break;
+
+  case dram_rowhammer_parameters::mitigation_type::rfm:
+    ++state.raa;
+    if (state.raa >= rowhammer_params.threshold) {
+      state.raa -= rowhammer_params.threshold;
+      state.pending += std::max(champsim::chrono::clock::duration{tRFC}, neighbor_refresh);
+      ++sim_stats.rowhammer_mitigations;
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+long DRAM_CHANNEL::schedule_mitigation()
+{
+  long progress{0};
+
+  for (std::size_t i = 0; i < std::size(bank_request); ++i) {
+    auto* b_req = &bank_request[i];
+    auto* state = &rowhammer_state[i];
+    // a mitigation is started once the bank is idle
+    if (state->pending > champsim::chrono::clock::duration::zero() && !b_req->valid && !b_req->under_refresh && !b_req->under_mitigation) {
+      b_req->ready_time = current_time + state->pending;
+      b_req->under_mitigation = true;
+      sim_stats.rowhammer_busy_cycles += static_cast<uint64_t>(state->pending / clock_period);
+      state->pending = champsim::chrono::clock::duration::zero();
+    }
+    // the mitigation is done for this bank
+    else if (b_req->under_mitigation && b_req->ready_time <= current_time) {
+      b_req->under_mitigation = false;
+      b_req->open_row.reset();
+      progress++;
+    }
+
+    if (b_req->under_mitigation)
+      progress++;
+  }
+
+  return progress;
+}
+
 void DRAM_CHANNEL::swap_write_mode()
 {
   // these values control when to send out a burst of writes
@@ -211,6 +357,7 @@ void DRAM_CHANNEL::swap_write_mode()
   // Check queue occupancy
   auto wq_occu = static_cast<std::size_t>(std::count_if(std::begin(WQ), std::end(WQ), [](const auto& x) { return x.has_value(); }));
   auto rq_occu = static_cast<std::size_t>(std::count_if(std::begin(RQ), std::end(RQ), [](const auto& x) { return x.has_value(); }));
+  rq_occu += std::size(buffer_returns); // Buffered reads also wait for the bus in read mode
 
   // Change modes if the queues are unbalanced
   if ((!write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
@@ -234,6 +381,8 @@ void DRAM_CHANNEL::swap_write_mode()
     // Add data bus turn-around time
     if (active_request != std::end(bank_request)) {
       dbus_cycle_available = active_request->ready_time + DRAM_DBUS_TURN_AROUND_TIME; // After ongoing finish
+    } else if (!std::empty(buffer_returns) && buffer_returns.front().ready_time != champsim::chrono::clock::time_point::max()) {
+      dbus_cycle_available = std::max(buffer_returns.front().ready_time, current_time) + DRAM_DBUS_TURN_AROUND_TIME; // After buffered read finishes
     } else {
       dbus_cycle_available = current_time + DRAM_DBUS_TURN_AROUND_TIME;
     }
@@ -248,6 +397,15 @@ long DRAM_CHANNEL::populate_dbus()
 {
   long progress{0};
 
+  // Reads served from the prefetch buffer do not access a bank, but their data takes the data bus ahead of the banks
+  if (!write_mode && !std::empty(buffer_returns) && buffer_returns.front().ready_time == champsim::chrono::clock::time_point::max()
+      && active_request == std::end(bank_request) && dbus_cycle_available <= current_time) {
+    buffer_returns.front().ready_time = current_time + DRAM_DBUS_RETURN_TIME;
+    dbus_cycle_available = buffer_returns.front().ready_time;
+    dbus_busy_total += DRAM_DBUS_RETURN_TIME;
+    ++progress;
+  }
+
   auto iter_next_process = std::min_element(std::begin(bank_request), std::end(bank_request),
                                             [](const auto& lhs, const auto& rhs) { return !rhs.valid || (lhs.valid && lhs.ready_time < rhs.ready_time); });
   if (iter_next_process->valid && iter_next_process->ready_time <= current_time) {
@@ -270,6 +428,8 @@ long DRAM_CHANNEL::populate_dbus()
       // set when bankgroup dbus will be next ready
       bankgroup_readytime[op_bankgroup] = current_time + DRAM_DBUS_RETURN_TIME + DRAM_DBUS_BANKGROUP_STALL;
 
+      dbus_busy_total += DRAM_DBUS_RETURN_TIME;
+
       if (iter_next_process->row_buffer_hit) {
         if (write_mode) {
           ++sim_stats.WQ_ROW_BUFFER_HIT;
@@ -282,15 +442,26 @@ long DRAM_CHANNEL::populate_dbus()
         ++sim_stats.RQ_ROW_BUFFER_MISS;
       }
 
+      if (profile_pages && !warmup) {
+        const auto page = champsim::page_number{iter_next_process->pkt->value().address};
+        const auto bank = static_cast<std::size_t>(std::distance(std::begin(bank_request), iter_next_process));
+        page_accesses[page.to<uint64_t>()].add(write_mode, iter_next_process->row_buffer_hit);
+        bank_accesses.at(bank).add(write_mode, iter_next_process->row_buffer_hit);
+      }
+
       ++progress;
     } else {
       // Bus is congested
+      long congested_cycles{};
       if (active_request != std::end(bank_request)) {
-        sim_stats.dbus_cycle_congested += (active_request->ready_time - current_time) / data_bus_period;
+        congested_cycles = (active_request->ready_time - current_time) / data_bus_period;
       } else {
-        sim_stats.dbus_cycle_congested += (dbus_cycle_available - current_time) / data_bus_period;
+        congested_cycles = (dbus_cycle_available - current_time) / data_bus_period;
       }
+      sim_stats.dbus_cycle_congested += congested_cycles;
+      dbus_cycle_congested_total += congested_cycles;
       ++sim_stats.dbus_count_congested;
+      ++dbus_count_congested_total;
     }
   }
 
@@ -347,18 +518,30 @@ long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
     auto op_row = address_mapping.get_row(pkt->value().address);
     auto op_idx = bank_request_index(pkt->value().address);
 
-    if (!bank_request[op_idx].valid && !bank_request[op_idx].under_refresh) {
+    if (!bank_request[op_idx].valid && !bank_request[op_idx].under_refresh && !bank_request[op_idx].under_mitigation) {
       bool row_buffer_hit = (bank_request[op_idx].open_row.has_value() && *(bank_request[op_idx].open_row) == op_row);
 
-      // this bank is now busy
+      // this bank is now busy, after any activation that the memory-side prefetcher started
+      auto bank_available = std::max(current_time, bank_request[op_idx].ready_time);
       auto row_charge_delay = champsim::chrono::clock::duration{bank_request[op_idx].open_row.has_value() ? tRP + tRCD : tRCD};
-      bank_request[op_idx] = {true,  row_buffer_hit,        false,
-                              false, std::optional{op_row}, current_time + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay),
+      bank_request[op_idx] = {true,
+                              row_buffer_hit,
+                              false,
+                              false,
+                              false,
+                              std::optional{op_row},
+                              bank_available + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay),
                               pkt};
       pkt->value().scheduled = true;
       pkt->value().ready_time = champsim::chrono::clock::time_point::max();
 
+      if (!row_buffer_hit) {
+        record_activation(op_idx, op_row);
+      }
+
       ++progress;
+    } else if (bank_request[op_idx].under_mitigation) {
+      ++sim_stats.rowhammer_stall_cycles;
     }
   }
 
@@ -381,12 +564,16 @@ void MEMORY_CONTROLLER::initialize()
   }
   fmt::print(" Channels: {} Width: {}-bit Data Rate: {} MT/s\n", std::size(channels), champsim::data::bits_per_byte * channel_width.count(),
              1us / (data_bus_period));
+
+  impl_prefetcher_initialize();
 }
 
 void DRAM_CHANNEL::initialize() {}
 
 void MEMORY_CONTROLLER::begin_phase()
 {
+  profile_epoch_cycles = 0;
+
   std::size_t chan_idx = 0;
   for (auto& chan : channels) {
     DRAM_CHANNEL::stats_type new_stats;
@@ -410,6 +597,36 @@ void MEMORY_CONTROLLER::end_phase(unsigned cpu)
   for (auto& chan : channels) {
     chan.end_phase(cpu);
   }
+
+  if (profile_params.enabled() && !warmup) {
+    end_profile_epoch();
+  }
+}
+
+void MEMORY_CONTROLLER::end_profile_epoch()
+{
+  // The blocks of a page are interleaved across the channels
+  champsim::page_counter_table<page_access_counts> pages{};
+  for (auto& chan : channels) {
+    for (const auto& [page, counts] : chan.page_accesses.sorted())
+      pages[page] += counts;
+    chan.page_accesses.clear();
+  }
+
+  for (const auto& [page, counts] : pages.sorted())
+    profile_file << fmt::format("{},page,{},{},{},{}\n", profile_epoch, page, counts.reads, counts.writes, counts.row_hits);
+
+  std::size_t bank_id = 0;
+  for (auto& chan : channels) {
+    for (auto& counts : chan.bank_accesses) {
+      profile_file << fmt::format("{},bank,{},{},{},{}\n", profile_epoch, bank_id++, counts.reads, counts.writes, counts.row_hits);
+      counts = {};
+    }
+  }
+
+  profile_file.flush();
+  ++profile_epoch;
+  profile_epoch_cycles = 0;
 }
 
 void DRAM_CHANNEL::end_phase(unsigned /*cpu*/) { roi_stats = sim_stats; }
@@ -518,6 +735,18 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
 {
   auto& channel = channels[address_mapping.get_channel(packet.address)];
 
+  // Reads that find their block in the prefetch buffer do not access DRAM, but their data must still cross the data bus
+  if (channel.prefetch_buffer.invalidate({champsim::block_number{packet.address}}).has_value()) {
+    if (packet.response_requested) {
+      auto& buffered = channel.buffer_returns.emplace_back(packet);
+      buffered.to_return = {ul->response_target()};
+    }
+
+    ++channel.sim_stats.PREFETCH_BUFFER_HIT;
+    impl_prefetcher_operate(packet.address, true);
+    return true;
+  }
+
   if (auto rq_it = std::find_if_not(std::begin(channel.RQ), std::end(channel.RQ), [this](const auto& pkt) { return pkt.has_value(); });
       rq_it != std::end(channel.RQ)) {
     *rq_it = DRAM_CHANNEL::request_type{packet};
@@ -525,8 +754,9 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
     rq_it->value().scheduled = false;
     rq_it->value().ready_time = current_time;
     if (packet.response_requested)
-      rq_it->value().to_return = {&ul->returned};
+      rq_it->value().to_return = {ul->response_target()};
 
+    impl_prefetcher_operate(packet.address, false);
     return true;
   }
 
@@ -545,6 +775,9 @@ bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
     wq_it->value().scheduled = false;
     wq_it->value().ready_time = current_time;
 
+    // A buffered copy of this block is now stale
+    channel.prefetch_buffer.invalidate({champsim::block_number{packet.address}});
+
     return true;
   }
 
@@ -552,6 +785,90 @@ bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
   return false;
 }
 
+bool MEMORY_CONTROLLER::prefetch_line(champsim::address pf_addr)
+{
+  auto& channel = channels[address_mapping.get_channel(pf_addr)];
+  if (prefetch_params.mode == dram_prefetch_parameters::mode_type::buffer)
+    return channel.add_prefetch(pf_addr);
+  return channel.open_row(pf_addr);
+}
+
+std::size_t MEMORY_CONTROLLER::prefetch_degree() const { return prefetch_params.degree; }
+
+void MEMORY_CONTROLLER::impl_prefetcher_initialize() const { pref_module_pimpl->impl_prefetcher_initialize(); }
+
+void MEMORY_CONTROLLER::impl_prefetcher_operate(champsim::address addr, bool buffer_hit) const
+{
+  pref_module_pimpl->impl_prefetcher_operate(addr, buffer_hit);
+}
+
+void MEMORY_CONTROLLER::impl_prefetcher_final_stats() const { pref_module_pimpl->impl_prefetcher_final_stats(); }
+
+bool DRAM_CHANNEL::add_prefetch(champsim::address addr)
+{
+  if (prefetch_buffer.check_hit({champsim::block_number{addr}}).has_value())
+    return false;
+
+  // Reads are answered without timing during warmup, so the block goes straight into the buffer
+  if (warmup) {
+    prefetch_buffer.fill({champsim::block_number{addr}});
+    ++sim_stats.PREFETCH_ISSUED;
+    return true;
+  }
+
+  // Prefetches may only use the lower half of the read queue, so that they cannot keep demand reads out
+  if (rq_occupancy() >= std::size(RQ) / 2)
+    return false;
+
+  auto collides = [this, addr](const auto& pkt) {
+    return pkt.has_value() && address_mapping.is_collision(pkt.value().address, addr);
+  };
+  if (std::any_of(std::begin(RQ), std::end(RQ), collides) || std::any_of(std::begin(WQ), std::end(WQ), collides))
+    return false;
+
+  auto rq_it = std::find_if_not(std::begin(RQ), std::end(RQ), [](const auto& pkt) { return pkt.has_value(); });
+  assert(rq_it != std::end(RQ));
+
+  champsim::channel::request_type packet;
+  packet.address = addr;
+  packet.v_address = addr;
+  packet.type = access_type::PREFETCH;
+  packet.response_requested = false;
+
+  *rq_it = request_type{packet};
+  rq_it->value().memory_prefetch = true;
+  rq_it->value().forward_checked = false;
+  rq_it->value().scheduled = false;
+  rq_it->value().ready_time = current_time;
+
+  ++sim_stats.PREFETCH_ISSUED;
+  return true;
+}
+
+bool DRAM_CHANNEL::open_row(champsim::address addr)
+{
+  auto op_row = address_mapping.get_row(addr);
+  auto op_idx = bank_request_index(addr);
+  auto& bank = bank_request[op_idx];
+
+  if (bank.valid || bank.need_refresh || bank.under_refresh || bank.under_mitigation || bank.open_row == op_row || bank.ready_time > current_time)
+    return false;
+
+  // Do not close a row that a queued request is waiting on
+  auto waits_on_bank = [this, op_idx](const auto& pkt) {
+    return pkt.has_value() && !pkt.value().scheduled && bank_request_index(pkt.value().address) == op_idx;
+  };
+  if (std::any_of(std::begin(RQ), std::end(RQ), waits_on_bank) || std::any_of(std::begin(WQ), std::end(WQ), waits_on_bank))
+    return false;
+
+  // The bank is busy until the open row is closed and the new one is activated
+  bank.ready_time = current_time + (bank.open_row.has_value() ? tRP + tRCD : tRCD);
+  bank.open_row = op_row;
+  record_activation(op_idx, op_row);
+  ++sim_stats.PREFETCH_ROW_OPENED;
+  return true;
+}
+
 unsigned long DRAM_ADDRESS_MAPPING::swizzle_bits(champsim::address address, unsigned long segment_size, champsim::data::bits segment_offset,
                                                  unsigned long field, unsigned long field_bits) const
 {
@@ -612,6 +929,51 @@ std::size_t DRAM_ADDRESS_MAPPING::channels() const { return std::size_t{1} << ch
 std::size_t DRAM_CHANNEL::bank_request_capacity() const { return std::size(bank_request); }
 std::size_t DRAM_CHANNEL::bankgroup_request_capacity() const { return std::size(bankgroup_readytime); };
 
+std::size_t DRAM_CHANNEL::rq_occupancy() const
+{
+  return static_cast<std::size_t>(std::count_if(std::begin(RQ), std::end(RQ), [](const auto& x) { return x.has_value(); }));
+}
+std::size_t DRAM_CHANNEL::wq_occupancy() const
+{
+  return static_cast<std::size_t>(std::count_if(std::begin(WQ), std::end(WQ), [](const auto& x) { return x.has_value(); }));
+}
+
+dram_telemetry MEMORY_CONTROLLER::telemetry() const
+{
+  dram_telemetry retval;
+  retval.time = current_time;
+  retval.data_bus_period = data_bus_period;
+  retval.channels = std::size(channels);
+
+  for (const auto& chan : channels) {
+    retval.dbus_busy += chan.dbus_busy_total;
+    retval.dbus_cycle_congested += chan.dbus_cycle_congested_total;
+    retval.dbus_count_congested += chan.dbus_count_congested_total;
+    retval.rq_occupancy += chan.rq_occupancy();
+    retval.rq_size += std::size(chan.RQ);
+    retval.wq_occupancy += chan.wq_occupancy();
+    retval.wq_size += std::size(chan.WQ);
+  }
+
+  return retval;
+}
+
+double dram_telemetry::utilization_since(const dram_telemetry& earlier) const
+{
+  auto elapsed = (time - earlier.time) * static_cast<long>(channels);
+  if (elapsed <= champsim::chrono::clock::duration{})
+    return 0;
+  return std::chrono::duration<double>(dbus_busy - earlier.dbus_busy) / std::chrono::duration<double>(elapsed);
+}
+
+double dram_telemetry::congestion_since(const dram_telemetry& earlier) const
+{
+  auto elapsed_cycles = ((time - earlier.time) / data_bus_period) * static_cast<long>(channels);
+  if (elapsed_cycles <= 0)
+    return 0;
+  return static_cast<double>(dbus_cycle_congested - earlier.dbus_cycle_congested) / static_cast<double>(elapsed_cycles);
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void MEMORY_CONTROLLER::print_deadlock()
 {
@@ -9,5 +9,28 @@ dram_stats operator-(dram_stats lhs, dram_stats rhs)
   lhs.RQ_ROW_BUFFER_HIT -= rhs.RQ_ROW_BUFFER_HIT;
   lhs.RQ_ROW_BUFFER_MISS -= rhs.RQ_ROW_BUFFER_MISS;
   lhs.WQ_FULL -= rhs.WQ_FULL;
+  lhs.PREFETCH_ISSUED -= rhs.PREFETCH_ISSUED;
+  lhs.PREFETCH_BUFFER_HIT -= rhs.PREFETCH_BUFFER_HIT;
+  lhs.PREFETCH_ROW_OPENED -= rhs.PREFETCH_ROW_OPENED;
+  lhs.activations -= rhs.activations;
+  lhs.rowhammer_mitigations -= rhs.rowhammer_mitigations;
+  lhs.rowhammer_busy_cycles -= rhs.rowhammer_busy_cycles;
+  lhs.rowhammer_stall_cycles -= rhs.rowhammer_stall_cycles;
+  return lhs;
+}
+
+dram_cache_stats operator-(dram_cache_stats lhs, dram_cache_stats rhs)
+{
+  lhs.read_hits -= rhs.read_hits;
+  lhs.read_misses -= rhs.read_misses;
+  lhs.writes -= rhs.writes;
+  lhs.predicted_misses -= rhs.predicted_misses;
+  lhs.mispredicted_hits -= rhs.mispredicted_hits;
+  lhs.tag_reads -= rhs.tag_reads;
+  lhs.cache_writes -= rhs.cache_writes;
+  lhs.memory_reads -= rhs.memory_reads;
+  lhs.footprint_fetches -= rhs.footprint_fetches;
+  lhs.unused_fetches -= rhs.unused_fetches;
+  lhs.writebacks -= rhs.writebacks;
   return lhs;
 }
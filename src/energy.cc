@@ -0,0 +1,70 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "energy.h"
+
+#include <algorithm>
+#include <cmath>
+
+champsim::access_energy champsim::estimate_energy(champsim::data::bytes capacity, long ways)
+{
+  // Fitted so that a 32 KiB, 8-way array takes about 14 pJ to read and a 2 MiB, 16-way array about 150 pJ
+  constexpr double energy_per_sqrt_byte = 0.05;
+  constexpr double ways_per_doubling = 16;
+  constexpr double write_factor = 1.2;
+  constexpr double leakage_per_byte = 0.0002;
+
+  const auto bytes = static_cast<double>(capacity.count());
+  const auto read = energy_per_sqrt_byte * std::sqrt(bytes) * (1 + static_cast<double>(ways) / ways_per_doubling);
+  return access_energy{read, write_factor * read, leakage_per_byte * bytes};
+}
+
+champsim::partial_access_energy::partial_access_energy(std::optional<double> read_, std::optional<double> write_, std::optional<double> leakage_)
+    : read(read_), write(write_), leakage(leakage_)
+{
+}
+
+champsim::partial_access_energy::partial_access_energy(access_energy energy) : read(energy.read), write(energy.write), leakage(energy.leakage) {}
+
+champsim::access_energy champsim::partial_access_energy::value_or(access_energy estimate) const
+{
+  return access_energy{read.value_or(estimate.read), write.value_or(estimate.write), leakage.value_or(estimate.leakage)};
+}
+
+double champsim::energy_stats::power() const
+{
+  if (elapsed == champsim::chrono::picoseconds{}) {
+    return 0;
+  }
+  // Picojoules per picosecond are watts
+  return total() / static_cast<double>(elapsed.count());
+}
+
+champsim::energy_stats champsim::operator-(champsim::energy_stats lhs, champsim::energy_stats rhs)
+{
+  lhs.dynamic -= rhs.dynamic;
+  lhs.leakage -= rhs.leakage;
+  lhs.elapsed -= rhs.elapsed;
+  return lhs;
+}
+
+champsim::energy_stats champsim::combine_concurrent(champsim::energy_stats lhs, const champsim::energy_stats& rhs)
+{
+  lhs.dynamic += rhs.dynamic;
+  lhs.leakage += rhs.leakage;
+  lhs.elapsed = std::max(lhs.elapsed, rhs.elapsed);
+  return lhs;
+}
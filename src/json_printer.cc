@@ -15,11 +15,47 @@
  */
 
 #include <algorithm>
+#include <optional>
+#include <ratio>
 #include <utility>
+#include <string_view>
+#include <fmt/core.h>
 #include <nlohmann/json.hpp>
 
 #include "stats_printer.h"
 
+namespace champsim
+{
+namespace stats
+{
+template <typename Key>
+nlohmann::json top_ips(const champsim::stats::space_saving<Key>& sketch, std::string_view count_name, std::string_view weight_name = {})
+{
+  auto result = nlohmann::json::array();
+  for (const auto& x : sketch.top()) {
+    nlohmann::json entry{{"ip", fmt::format("{}", x.key)}, {count_name, x.count}, {"error", x.error}};
+    if (!std::empty(weight_name))
+      entry[std::string{weight_name}] = x.weight;
+    result.push_back(entry);
+  }
+  return result;
+}
+
+void to_json(nlohmann::json& j, const log2_histogram& hist)
+{
+  j = nlohmann::json::array();
+  for (std::size_t bucket = 0; bucket < hist.used_buckets(); ++bucket)
+    j.push_back(nlohmann::json{{"from", log2_histogram::lower_bound(bucket)}, {"count", hist.at(bucket)}});
+}
+} // namespace stats
+
+void to_json(nlohmann::json& j, const champsim::energy_stats& stats)
+{
+  j = nlohmann::json{{"dynamic nJ", stats.dynamic / std::kilo::num}, {"leakage nJ", stats.leakage / std::kilo::num}, {"power W", stats.power()}};
+}
+
+} // namespace champsim
+
 void to_json(nlohmann::json& j, const O3_CPU::stats_type& stats)
 {
   constexpr std::array types{branch_type::BRANCH_DIRECT_JUMP, branch_type::BRANCH_INDIRECT,      branch_type::BRANCH_CONDITIONAL,
@@ -36,7 +72,45 @@ void to_json(nlohmann::json& j, const O3_CPU::stats_type& stats)
   j = nlohmann::json{{"instructions", stats.instrs()},
                      {"cycles", stats.cycles()},
                      {"Avg ROB occupancy at mispredict", std::ceil(stats.total_rob_occupancy_at_branch_mispredict) / std::ceil(total_mispredictions)},
-                     {"mispredict", mpki}};
+                     {"mispredict", mpki},
+                     {"DIB",
+                      {{"lookups", stats.dib_lookups},
+                       {"hits", stats.dib_hits},
+                       {"uops delivered", stats.dib_uops_delivered},
+                       {"delivery cycles", stats.dib_delivery_cycles},
+                       {"decoder uops delivered", stats.decoder_uops_delivered},
+                       {"decoder delivery cycles", stats.decoder_delivery_cycles},
+                       {"switches", stats.dib_switches},
+                       {"overflowed windows", stats.dib_overflows},
+                       {"L1I invalidations", stats.dib_inclusion_invalidations}}}};
+
+  if (stats.decode_cache_hits + stats.decode_cache_misses > 0) {
+    j["decode cache"] = nlohmann::json{{"hits", stats.decode_cache_hits}, {"misses", stats.decode_cache_misses}};
+  }
+
+  if (stats.interval_dispatch_cycles > 0) {
+    j["interval"] = nlohmann::json{{"dispatch cycles", stats.interval_dispatch_cycles},
+                                   {"frontend stall cycles", stats.interval_frontend_stall_cycles},
+                                   {"branch stall cycles", stats.interval_branch_stall_cycles},
+                                   {"memory stall cycles", stats.interval_memory_stall_cycles},
+                                   {"window stall cycles", stats.interval_window_stall_cycles}};
+  }
+
+  if (stats.in_order_issue_cycles > 0) {
+    j["in-order"] = nlohmann::json{{"issue cycles", stats.in_order_issue_cycles},
+                                   {"stall-on-use cycles", stats.in_order_use_stall_cycles},
+                                   {"frontend stall cycles", stats.in_order_frontend_stall_cycles},
+                                   {"branch stall cycles", stats.in_order_branch_stall_cycles},
+                                   {"window stall cycles", stats.in_order_window_stall_cycles}};
+  }
+
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    j["energy"] = stats.energy;
+
+  if (stats.ip_mispredicts.enabled()) {
+    j["top IPs"] = nlohmann::json{{"mispredict", champsim::stats::top_ips(stats.ip_mispredicts, "mispredicts")},
+                                  {"ROB head stall", champsim::stats::top_ips(stats.ip_rob_stalls, "stall cycles")}};
+  }
 }
 
 void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
@@ -45,12 +119,40 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
   using misses_value_type = typename decltype(stats.misses)::value_type;
   using mshr_merge_value_type = typename decltype(stats.mshr_merge)::value_type;
   using mshr_return_value_type = typename decltype(stats.mshr_return)::value_type;
+  using mshr_full_value_type = typename decltype(stats.mshr_full)::value_type;
 
   std::map<std::string, nlohmann::json> statsmap;
   statsmap.emplace("prefetch requested", stats.pf_requested);
   statsmap.emplace("prefetch issued", stats.pf_issued);
   statsmap.emplace("useful prefetch", stats.pf_useful);
   statsmap.emplace("useless prefetch", stats.pf_useless);
+  statsmap.emplace("filtered prefetch", stats.pf_filtered);
+  if (stats.pf_late + stats.pf_early + stats.pf_polluting + stats.pf_use_distance.total() > 0) {
+    statsmap.emplace("prefetch timeliness", nlohmann::json{{"late", stats.pf_late},
+                                                           {"early", stats.pf_early},
+                                                           {"polluting", stats.pf_polluting},
+                                                           {"use distance", stats.pf_use_distance},
+                                                           {"lateness", stats.pf_late_distance}});
+  }
+  if (stats.sector_misses > 0)
+    statsmap.emplace("sector miss", stats.sector_misses);
+  statsmap.emplace("writeback", nlohmann::json{{"eviction", stats.wb_eviction},
+                                                {"eager", stats.wb_eager},
+                                                {"write through", stats.wb_write_through},
+                                                {"write around", stats.wb_write_around},
+                                                {"write buffer merge", stats.write_buffer_merges}});
+  if (stats.victim_hits > 0) {
+    statsmap.emplace("victim cache hit", stats.victim_hits);
+    statsmap.emplace("victim cache promotion", stats.victim_promotions);
+  }
+  if (stats.pf_buffer_hits > 0) {
+    statsmap.emplace("prefetch buffer hit", stats.pf_buffer_hits);
+    statsmap.emplace("prefetch buffer promotion", stats.pf_buffer_promotions);
+  }
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    statsmap.emplace("energy", stats.energy);
+  if (stats.ip_misses.enabled())
+    statsmap.emplace("top IPs", champsim::stats::top_ips(stats.ip_misses, "misses", "miss latency"));
 
   uint64_t total_downstream_demands = stats.mshr_return.total();
   for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu)
@@ -61,19 +163,29 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
     std::vector<hits_value_type> hits;
     std::vector<misses_value_type> misses;
     std::vector<mshr_merge_value_type> mshr_merges;
+    std::vector<mshr_full_value_type> mshr_fulls;
 
     for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu) {
       hits.push_back(stats.hits.value_or(std::pair{type, cpu}, hits_value_type{}));
       misses.push_back(stats.misses.value_or(std::pair{type, cpu}, misses_value_type{}));
       mshr_merges.push_back(stats.mshr_merge.value_or(std::pair{type, cpu}, mshr_merge_value_type{}));
+      mshr_fulls.push_back(stats.mshr_full.value_or(std::pair{type, cpu}, mshr_full_value_type{}));
     }
 
-    statsmap.emplace(access_type_names.at(champsim::to_underlying(type)), nlohmann::json{{"hit", hits}, {"miss", misses}, {"mshr_merge", mshr_merges}});
+    statsmap.emplace(access_type_names.at(champsim::to_underlying(type)),
+                     nlohmann::json{{"hit", hits}, {"miss", misses}, {"mshr_merge", mshr_merges}, {"mshr_full", mshr_fulls}});
   }
 
   j = statsmap;
 }
 
+void to_json(nlohmann::json& j, const PageTableWalker::stats_type& stats)
+{
+  j = nlohmann::json{{"PSCL lookups", stats.pscl_lookups}, {"PSCL fills", stats.pscl_fills}};
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    j["energy"] = stats.energy;
+}
+
 void to_json(nlohmann::json& j, const DRAM_CHANNEL::stats_type stats)
 {
   j = nlohmann::json{{"RQ ROW_BUFFER_HIT", stats.RQ_ROW_BUFFER_HIT},
@@ -81,11 +193,65 @@ void to_json(nlohmann::json& j, const DRAM_CHANNEL::stats_type stats)
                      {"WQ ROW_BUFFER_HIT", stats.WQ_ROW_BUFFER_HIT},
                      {"WQ ROW_BUFFER_MISS", stats.WQ_ROW_BUFFER_MISS},
                      {"AVG DBUS CONGESTED CYCLE", (std::ceil(stats.dbus_cycle_congested) / std::ceil(stats.dbus_count_congested))},
-                     {"REFRESHES ISSUED", stats.refresh_cycles}};
+                     {"REFRESHES ISSUED", stats.refresh_cycles},
+                     {"PREFETCH ISSUED", stats.PREFETCH_ISSUED},
+                     {"PREFETCH BUFFER HIT", stats.PREFETCH_BUFFER_HIT},
+                     {"PREFETCH ROW OPENED", stats.PREFETCH_ROW_OPENED},
+                     {"ACTIVATIONS", stats.activations},
+                     {"ROWHAMMER MITIGATIONS", stats.rowhammer_mitigations},
+                     {"ROWHAMMER BANK BUSY CYCLES", stats.rowhammer_busy_cycles},
+                     {"ROWHAMMER STALL CYCLES", stats.rowhammer_stall_cycles}};
+}
+
+void to_json(nlohmann::json& j, const DRAM_CACHE::stats_type stats)
+{
+  j = nlohmann::json{{"read hit", stats.read_hits},
+                     {"read miss", stats.read_misses},
+                     {"write", stats.writes},
+                     {"predicted miss", stats.predicted_misses},
+                     {"mispredicted hit", stats.mispredicted_hits},
+                     {"tag read", stats.tag_reads},
+                     {"cache write", stats.cache_writes},
+                     {"memory read", stats.memory_reads},
+                     {"footprint fetch", stats.footprint_fetches},
+                     {"unused fetch", stats.unused_fetches},
+                     {"writeback", stats.writebacks}};
 }
 
 namespace champsim
 {
+std::optional<nlohmann::json> total_energy(const std::vector<O3_CPU::stats_type>& cpu_stats, const std::vector<CACHE::stats_type>& cache_stats,
+                            const std::vector<PageTableWalker::stats_type>& ptw_stats)
+{
+  champsim::energy_stats total{};
+  auto accumulate = [&total](const auto& stat) { total = champsim::combine_concurrent(total, stat.energy); };
+  std::for_each(std::begin(cpu_stats), std::end(cpu_stats), accumulate);
+  std::for_each(std::begin(cache_stats), std::end(cache_stats), accumulate);
+  std::for_each(std::begin(ptw_stats), std::end(ptw_stats), accumulate);
+  if (total.elapsed == champsim::chrono::picoseconds{})
+    return std::nullopt;
+
+  auto instrs = std::accumulate(std::begin(cpu_stats), std::end(cpu_stats), 0LL, [](auto acc, const auto& x) { return acc + x.instrs(); });
+
+  nlohmann::json j = total;
+  j["instructions per microjoule"] = static_cast<double>(instrs * std::mega::num) / total.total();
+  return j;
+}
+
+void to_json(nlohmann::json& j, const champsim::link_stats stats)
+{
+  auto direction = [cycles = stats.cycles](auto packets, auto flits, auto busy_cycles, auto queue_delay) {
+    return nlohmann::json{{"packets", packets},
+                          {"flits", flits},
+                          {"busy cycles", busy_cycles},
+                          {"utilization", std::ceil(busy_cycles) / std::ceil(cycles)},
+                          {"average queue delay", std::ceil(queue_delay) / std::ceil(packets)}};
+  };
+  j = nlohmann::json{{"cycles", stats.cycles},
+                     {"request", direction(stats.request_packets, stats.request_flits, stats.request_busy_cycles, stats.request_queue_delay)},
+                     {"response", direction(stats.response_packets, stats.response_flits, stats.response_busy_cycles, stats.response_queue_delay)}};
+}
+
 void to_json(nlohmann::json& j, const champsim::phase_stats stats)
 {
   std::map<std::string, nlohmann::json> roi_stats;
@@ -94,6 +260,22 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
   for (auto x : stats.roi_cache_stats) {
     roi_stats.emplace(x.name, x);
   }
+  for (auto x : stats.roi_dram_cache_stats) {
+    roi_stats.emplace(x.name, x);
+  }
+  for (auto x : stats.roi_ptw_stats) {
+    roi_stats.emplace(x.name, x);
+  }
+  if (!std::empty(stats.roi_link_stats)) {
+    std::map<std::string, nlohmann::json> links;
+    for (auto x : stats.roi_link_stats) {
+      links.emplace(x.name, x);
+    }
+    roi_stats.emplace("links", links);
+  }
+  if (auto energy = total_energy(stats.roi_cpu_stats, stats.roi_cache_stats, stats.roi_ptw_stats); energy.has_value()) {
+    roi_stats.emplace("energy", energy.value());
+  }
 
   std::map<std::string, nlohmann::json> sim_stats;
   sim_stats.emplace("cores", stats.sim_cpu_stats);
@@ -101,6 +283,22 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
   for (auto x : stats.sim_cache_stats) {
     sim_stats.emplace(x.name, x);
   }
+  for (auto x : stats.sim_dram_cache_stats) {
+    sim_stats.emplace(x.name, x);
+  }
+  for (auto x : stats.sim_ptw_stats) {
+    sim_stats.emplace(x.name, x);
+  }
+  if (!std::empty(stats.sim_link_stats)) {
+    std::map<std::string, nlohmann::json> links;
+    for (auto x : stats.sim_link_stats) {
+      links.emplace(x.name, x);
+    }
+    sim_stats.emplace("links", links);
+  }
+  if (auto energy = total_energy(stats.sim_cpu_stats, stats.sim_cache_stats, stats.sim_ptw_stats); energy.has_value()) {
+    sim_stats.emplace("energy", energy.value());
+  }
 
   std::map<std::string, nlohmann::json> statsmap{{"name", stats.name}, {"traces", stats.trace_names}};
   statsmap.emplace("roi", roi_stats);
@@ -44,12 +44,8 @@ std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases,
 using configured_environment = champsim::configured::generated_environment<CHAMPSIM_BUILD>;
 
 const std::size_t NUM_CPUS = configured_environment::num_cpus;
-
-const unsigned BLOCK_SIZE = configured_environment::block_size;
-const unsigned PAGE_SIZE = configured_environment::page_size;
+static_assert(configured_environment::block_size == BLOCK_SIZE && configured_environment::page_size == PAGE_SIZE);
 #endif
-const unsigned LOG2_BLOCK_SIZE = champsim::lg2(BLOCK_SIZE);
-const unsigned LOG2_PAGE_SIZE = champsim::lg2(PAGE_SIZE);
 
 #ifndef CHAMPSIM_TEST_BUILD
 int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
@@ -59,6 +55,7 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   CLI::App app{"A microarchitecture simulator for research and education"};
 
   bool knob_cloudsuite{false};
+  bool knob_extended{false};
   long long warmup_instructions = 0;
   long long simulation_instructions = std::numeric_limits<long long>::max();
   std::string json_file_name;
@@ -70,7 +67,8 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     }
   };
 
-  app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format");
+  auto* cloudsuite_option = app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format");
+  app.add_flag("-x,--extended", knob_extended, "Read all traces using the extended format")->excludes(cloudsuite_option);
   app.add_flag("--hide-heartbeat", set_heartbeat_callback, "Hide the heartbeat output");
   auto* warmup_instr_option = app.add_option("-w,--warmup-instructions", warmup_instructions, "The number of instructions in the warmup phase");
   auto* deprec_warmup_instr_option =
@@ -104,10 +102,17 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     warmup_instructions = simulation_instructions / 5;
   }
 
+  auto trace_format = champsim::trace_format::standard;
+  if (knob_cloudsuite) {
+    trace_format = champsim::trace_format::cloudsuite;
+  }
+  if (knob_extended) {
+    trace_format = champsim::trace_format::extended;
+  }
+
   std::vector<champsim::tracereader> traces;
-  std::transform(
-      std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
-      [knob_cloudsuite, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, repeat); });
+  std::transform(std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
+                 [trace_format, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, trace_format, repeat); });
 
   std::vector<champsim::phase_info> phases{
       {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names},
@@ -134,6 +139,12 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     cache.impl_replacement_final_stats();
   }
 
+  for (O3_CPU& cpu : gen_environment.cpu_view()) {
+    cpu.impl_btb_final_stats();
+  }
+
+  gen_environment.dram_view().impl_prefetcher_final_stats();
+
   if (json_option->count() > 0) {
     if (json_file_name.empty()) {
       champsim::json_printer{std::cout}.print(phase_stats);
@@ -17,6 +17,8 @@
 #include "modules.h"
 
 #include "cache.h"
+#include "dram_controller.h"
+#include "ooo_cpu.h"
 
 bool champsim::modules::prefetcher::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata) const
 {
@@ -29,3 +31,7 @@ bool champsim::modules::prefetcher::prefetch_line(uint64_t pf_addr, bool fill_th
   return prefetch_line(champsim::address{pf_addr}, fill_this_level, prefetch_metadata);
 }
 // LCOV_EXCL_STOP
+
+bool champsim::modules::dram_prefetcher::prefetch_line(champsim::address pf_addr) const { return intern_->prefetch_line(pf_addr); }
+
+void champsim::modules::btb::insert_fetch_bubble(long cycles) const { intern_->insert_fetch_bubble(cycles); }
@@ -37,20 +37,28 @@ constexpr long long STAT_PRINTING_PERIOD = 10000000;
 long O3_CPU::operate()
 {
   long progress{0};
-  progress += retire_rob();                    // retire
-  progress += complete_inflight_instruction(); // finalize execution
-  progress += execute_instruction();           // execute instructions
-  progress += schedule_instruction();          // schedule instructions
-  progress += handle_memory_return();          // finalize memory transactions
-  progress += operate_lsq();                   // execute memory transactions
-
-  progress += dispatch_instruction(); // dispatch
-  progress += decode_instruction();   // decode
-  progress += promote_to_decode();
-
-  progress += fetch_instruction(); // fetch
-  progress += check_dib();
-  initialize_instruction();
+  sim_stats.energy.leakage += ROB_ENERGY.leakage + LQ_ENERGY.leakage + SQ_ENERGY.leakage + BP_ENERGY.leakage;
+  sim_stats.energy.elapsed += clock_period;
+  if (MODEL == champsim::core_model::interval) {
+    progress += operate_interval();
+  } else if (MODEL == champsim::core_model::in_order) {
+    progress += operate_in_order();
+  } else {
+    progress += retire_rob();                    // retire
+    progress += complete_inflight_instruction(); // finalize execution
+    progress += execute_instruction();           // execute instructions
+    progress += schedule_instruction();          // schedule instructions
+    progress += handle_memory_return();          // finalize memory transactions
+    progress += operate_lsq();                   // execute memory transactions
+
+    progress += dispatch_instruction(); // dispatch
+    progress += decode_instruction();   // decode
+    progress += promote_to_decode();
+
+    progress += fetch_instruction(); // fetch
+    progress += check_dib();
+    initialize_instruction();
+  }
 
   // heartbeat
   if (show_heartbeat && (num_retired >= (last_heartbeat_instr + STAT_PRINTING_PERIOD))) {
@@ -76,18 +84,25 @@ void O3_CPU::initialize()
   // BRANCH PREDICTOR & BTB
   impl_initialize_branch_predictor();
   impl_initialize_btb();
+
+  if (DIB_INCLUSIVE && l1i != nullptr) {
+    l1i->eviction_listeners.push_back(&l1i_evictions);
+  }
 }
 
 void O3_CPU::begin_phase()
 {
   begin_phase_instr = num_retired;
   begin_phase_time = current_time;
+  interval_wake_time = current_time;
 
   // Record where the next phase begins
   stats_type stats;
   stats.name = "CPU " + std::to_string(cpu);
   stats.begin_instrs = num_retired;
   stats.begin_cycles = begin_phase_time.time_since_epoch() / clock_period;
+  stats.ip_mispredicts = champsim::stats::space_saving<champsim::address>{IP_ATTRIBUTION_SIZE};
+  stats.ip_rob_stalls = champsim::stats::space_saving<champsim::address>{IP_ATTRIBUTION_SIZE};
   sim_stats = stats;
 }
 
@@ -116,6 +131,9 @@ void O3_CPU::initialize_instruction()
 
     stop_fetch = do_init_instruction(input_queue.front());
 
+    if (input_queue.front().decode_cache_hit.has_value())
+      ++(*input_queue.front().decode_cache_hit ? sim_stats.decode_cache_hits : sim_stats.decode_cache_misses);
+
     // Add to IFETCH_BUFFER
     IFETCH_BUFFER.push_back(input_queue.front());
     input_queue.pop_front();
@@ -153,6 +171,7 @@ bool O3_CPU::do_predict_branch(ooo_model_instr& arch_instr)
 
   // handle branch prediction for all instructions as at this point we do not know if the instruction is a branch
   sim_stats.total_branch_types.increment(arch_instr.branch);
+  sim_stats.energy.dynamic += BP_ENERGY.read;
   auto [predicted_branch_target, always_taken] = impl_btb_prediction(arch_instr.ip, arch_instr.branch);
   arch_instr.branch_prediction = impl_predict_branch(arch_instr.ip, predicted_branch_target, always_taken, arch_instr.branch) || always_taken;
   if (!arch_instr.branch_prediction) {
@@ -172,6 +191,7 @@ bool O3_CPU::do_predict_branch(ooo_model_instr& arch_instr)
             && arch_instr.branch_taken != arch_instr.branch_prediction)) { // conditional branches are re-evaluated at decode when the target is computed
       sim_stats.total_rob_occupancy_at_branch_mispredict += std::size(ROB);
       sim_stats.branch_type_misses.increment(arch_instr.branch);
+      sim_stats.ip_mispredicts.increment(arch_instr.ip);
       if (!warmup) {
         fetch_resume_time = champsim::chrono::clock::time_point::max();
         stop_fetch = true;
@@ -181,6 +201,7 @@ bool O3_CPU::do_predict_branch(ooo_model_instr& arch_instr)
       stop_fetch = arch_instr.branch_taken; // if correctly predicted taken, then we can't fetch anymore instructions this cycle
     }
 
+    sim_stats.energy.dynamic += BP_ENERGY.write;
     impl_update_btb(arch_instr.ip, arch_instr.branch_target, arch_instr.branch_taken, arch_instr.branch);
     impl_last_branch_result(arch_instr.ip, arch_instr.branch_target, arch_instr.branch_taken, arch_instr.branch);
   }
@@ -196,12 +217,26 @@ bool O3_CPU::do_init_instruction(ooo_model_instr& arch_instr)
     arch_instr.destination_registers.clear();
   }
 
+  // An instruction needs all of its load or store queue entries at once to dispatch, so operands beyond the size of the queues are dropped
+  if (std::size(arch_instr.source_memory) > std::size(LQ)) {
+    arch_instr.source_memory.resize(std::size(LQ));
+  }
+  if (std::size(arch_instr.destination_memory) > SQ_SIZE) {
+    arch_instr.destination_memory.resize(SQ_SIZE);
+  }
+
   ::do_stack_pointer_folding(arch_instr);
   return do_predict_branch(arch_instr);
 }
 
 long O3_CPU::check_dib()
 {
+  // Keep the DIB inclusive of the L1I
+  for (auto evicted : l1i_evictions) {
+    sim_stats.dib_inclusion_invalidations += DIB.invalidate(champsim::block_number{evicted});
+  }
+  l1i_evictions.clear();
+
   // scan through IFETCH_BUFFER to find instructions that hit in the decoded instruction buffer
   auto begin = std::find_if(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), [](const ooo_model_instr& x) { return !x.dib_checked; });
   auto [window_begin, window_end] = champsim::get_span(begin, std::end(IFETCH_BUFFER), champsim::bandwidth{FETCH_WIDTH});
@@ -213,7 +248,9 @@ void O3_CPU::do_check_dib(ooo_model_instr& instr)
 {
   // Check DIB to see if we recently fetched this line
   auto dib_result = DIB.check_hit(instr.ip);
+  ++sim_stats.dib_lookups;
   if (dib_result) {
+    ++sim_stats.dib_hits;
     // The cache line is in the L0, so we can mark this as complete
     instr.fetch_completed = true;
 
@@ -227,7 +264,7 @@ void O3_CPU::do_check_dib(ooo_model_instr& instr)
   instr.dib_checked = true;
 
   if constexpr (champsim::debug_print) {
-    fmt::print("[DIB] {} instr_id: {} ip: {:#x} hit: {} cycle: {}\n", __func__, instr.instr_id, instr.ip, dib_result.has_value(),
+    fmt::print("[DIB] {} instr_id: {} ip: {:#x} hit: {} cycle: {}\n", __func__, instr.instr_id, instr.ip, dib_result,
                current_time.time_since_epoch() / clock_period);
   }
 }
@@ -322,6 +359,10 @@ long O3_CPU::promote_to_decode()
 }
 long O3_CPU::decode_instruction()
 {
+  if (current_time < decode_resume_time) {
+    return 0;
+  }
+
   auto is_ready = [time = current_time](const auto& x) {
     return x.ready_time <= time;
   };
@@ -337,26 +378,54 @@ long O3_CPU::decode_instruction()
   champsim::bandwidth available_dib_inorder_bandwidth{
       std::min(DIB_INORDER_WIDTH, champsim::bandwidth::maximum_type{static_cast<long>(DISPATCH_BUFFER_SIZE - std::size(DISPATCH_BUFFER))})};
 
+  // switching between the decoders and the DIB stalls delivery for a penalty
+  bool switch_stall = false;
+  auto may_deliver = [&, this](bool from_dib) {
+    if (from_dib == this->last_delivery_from_dib) {
+      return true;
+    }
+    this->last_delivery_from_dib = from_dib;
+    ++this->sim_stats.dib_switches;
+    if (this->warmup || this->DIB_SWITCH_PENALTY == champsim::chrono::clock::duration{}) {
+      return true;
+    }
+    this->decode_resume_time = this->current_time + this->DIB_SWITCH_PENALTY;
+    switch_stall = true;
+    return false;
+  };
+
   // conditions choose how many instructions sent to dispatch_buffer
   while (dib_hit_buffer_end != std::end(DIB_HIT_BUFFER) && decode_buffer_end != std::end(DECODE_BUFFER) && available_dib_inorder_bandwidth.has_remaining()
          && available_decode_bandwidth.has_remaining() && is_ready(std::min(*dib_hit_buffer_end, *decode_buffer_end, ooo_model_instr::program_order))) {
     if (ooo_model_instr::program_order(*dib_hit_buffer_end, *decode_buffer_end)) {
+      if (!may_deliver(true)) {
+        break;
+      }
       dib_hit_buffer_end++;
       available_dib_inorder_bandwidth.consume();
     } else {
+      if (!may_deliver(false)) {
+        break;
+      }
       decode_buffer_end++;
       available_dib_inorder_bandwidth.consume();
       available_decode_bandwidth.consume();
     }
   }
-  while (dib_hit_buffer_end != std::end(DIB_HIT_BUFFER) && available_dib_inorder_bandwidth.has_remaining() && is_ready(*dib_hit_buffer_end)
+  while (!switch_stall && dib_hit_buffer_end != std::end(DIB_HIT_BUFFER) && available_dib_inorder_bandwidth.has_remaining() && is_ready(*dib_hit_buffer_end)
          && (decode_buffer_end == std::end(DECODE_BUFFER) || ooo_model_instr::program_order(*dib_hit_buffer_end, *decode_buffer_end))) {
+    if (!may_deliver(true)) {
+      break;
+    }
     dib_hit_buffer_end++;
     available_dib_inorder_bandwidth.consume();
   }
-  while (decode_buffer_end != std::end(DECODE_BUFFER) && available_dib_inorder_bandwidth.has_remaining() && available_decode_bandwidth.has_remaining()
-         && is_ready(*decode_buffer_end)
+  while (!switch_stall && decode_buffer_end != std::end(DECODE_BUFFER) && available_dib_inorder_bandwidth.has_remaining()
+         && available_decode_bandwidth.has_remaining() && is_ready(*decode_buffer_end)
          && (dib_hit_buffer_end == std::end(DIB_HIT_BUFFER) || ooo_model_instr::program_order(*decode_buffer_end, *dib_hit_buffer_end))) {
+    if (!may_deliver(false)) {
+      break;
+    }
     decode_buffer_end++;
     available_dib_inorder_bandwidth.consume();
     available_decode_bandwidth.consume();
@@ -392,7 +461,18 @@ long O3_CPU::decode_instruction()
   std::for_each(decode_buffer_begin, decode_buffer_end, do_decode);
   std::for_each(dib_hit_buffer_begin, dib_hit_buffer_end, do_dib_hit);
 
-  long progress{std::distance(dib_hit_buffer_begin, dib_hit_buffer_end) + std::distance(decode_buffer_begin, decode_buffer_end)};
+  auto dib_delivered = std::distance(dib_hit_buffer_begin, dib_hit_buffer_end);
+  auto decoder_delivered = std::distance(decode_buffer_begin, decode_buffer_end);
+  sim_stats.dib_uops_delivered += static_cast<uint64_t>(dib_delivered);
+  sim_stats.decoder_uops_delivered += static_cast<uint64_t>(decoder_delivered);
+  if (dib_delivered > 0) {
+    ++sim_stats.dib_delivery_cycles;
+  }
+  if (decoder_delivered > 0) {
+    ++sim_stats.decoder_delivery_cycles;
+  }
+
+  long progress{dib_delivered + decoder_delivered};
 
   std::merge(dib_hit_buffer_begin, dib_hit_buffer_end, decode_buffer_begin, decode_buffer_end, std::back_inserter(DISPATCH_BUFFER),
              ooo_model_instr::program_order);
@@ -402,7 +482,12 @@ long O3_CPU::decode_instruction()
   return progress;
 }
 
-void O3_CPU::do_dib_update(const ooo_model_instr& instr) { DIB.fill(instr.ip); }
+void O3_CPU::do_dib_update(const ooo_model_instr& instr)
+{
+  if (!DIB.fill(instr.ip)) {
+    ++sim_stats.dib_overflows;
+  }
+}
 
 long O3_CPU::dispatch_instruction()
 {
@@ -416,6 +501,7 @@ long O3_CPU::dispatch_instruction()
          && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
     ROB.push_back(std::move(DISPATCH_BUFFER.front()));
     DISPATCH_BUFFER.pop_front();
+    sim_stats.energy.dynamic += ROB_ENERGY.write;
     do_memory_scheduling(ROB.back());
 
     available_dispatch_bandwidth.consume();
@@ -482,22 +568,30 @@ long O3_CPU::execute_instruction()
   return exec_bw.amount_consumed();
 }
 
+champsim::chrono::clock::duration O3_CPU::execute_latency(const ooo_model_instr& instr) const
+{
+  if (warmup) {
+    return champsim::chrono::clock::duration{};
+  }
+  return instr.instr_class < std::size(CLASS_EXEC_LATENCY) ? CLASS_EXEC_LATENCY[instr.instr_class] : EXEC_LATENCY;
+}
+
 void O3_CPU::do_execution(ooo_model_instr& instr)
 {
   instr.executed = true;
-  instr.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+  instr.ready_time = current_time + execute_latency(instr);
 
   // Mark LQ entries as ready to translate
   for (auto& lq_entry : LQ) {
     if (lq_entry.has_value() && lq_entry->instr_id == instr.instr_id) {
-      lq_entry->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+      lq_entry->ready_time = current_time + execute_latency(instr);
     }
   }
 
   // Mark SQ entries as ready to translate
   for (auto& sq_entry : SQ) {
     if (sq_entry.instr_id == instr.instr_id) {
-      sq_entry.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+      sq_entry.ready_time = current_time + execute_latency(instr);
     }
   }
 
@@ -513,8 +607,10 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
     auto q_entry = std::find_if_not(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return lq_entry.has_value(); });
     assert(q_entry != std::end(LQ));
     q_entry->emplace(smem, instr.instr_id, instr.ip, instr.asid); // add it to the load queue
+    sim_stats.energy.dynamic += LQ_ENERGY.write;
 
     // Check for forwarding
+    sim_stats.energy.dynamic += SQ_ENERGY.read;
     auto sq_it = std::max_element(std::begin(SQ), std::end(SQ), [smem](const auto& lhs, const auto& rhs) {
       return lhs.virtual_address != smem || (rhs.virtual_address == smem && LSQ_ENTRY::program_order(lhs, rhs));
     });
@@ -537,6 +633,7 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
   // store
   for (auto& dmem : instr.destination_memory) {
     SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid); // add it to the store queue
+    sim_stats.energy.dynamic += SQ_ENERGY.write;
   }
 
   if constexpr (champsim::debug_print) {
@@ -566,6 +663,7 @@ long O3_CPU::operate_lsq()
 
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(SQ), std::cend(SQ), store_bw, do_complete);
   store_bw.consume(std::distance(complete_begin, complete_end));
+  sim_stats.energy.dynamic += SQ_ENERGY.read * static_cast<double>(std::distance(complete_begin, complete_end));
   SQ.erase(complete_begin, complete_end);
 
   champsim::bandwidth load_bw{LQ_WIDTH};
@@ -577,6 +675,7 @@ long O3_CPU::operate_lsq()
       if (success) {
         load_bw.consume();
         lq_entry->fetch_issued = true;
+        sim_stats.energy.dynamic += LQ_ENERGY.read;
       }
     }
   }
@@ -658,7 +757,7 @@ long O3_CPU::complete_inflight_instruction()
   return complete_bw.amount_consumed();
 }
 
-long O3_CPU::handle_memory_return()
+long O3_CPU::handle_instruction_return()
 {
   long progress{0};
 
@@ -683,11 +782,19 @@ long O3_CPU::handle_memory_return()
 
     // remove this entry if we have serviced all of its instructions
     if (l1i_entry.instr_depend_on_me.empty()) {
+      impl_prefetch_btb(l1i_entry.v_address);
       L1I_bus.lower_level->returned.pop_front();
       ++progress;
     }
   }
 
+  return progress;
+}
+
+long O3_CPU::handle_memory_return()
+{
+  long progress = handle_instruction_return();
+
   auto l1d_it = std::begin(L1D_bus.lower_level->returned);
   for (champsim::bandwidth l1d_bw{L1D_BANDWIDTH}; l1d_bw.has_remaining() && l1d_it != std::end(L1D_bus.lower_level->returned); l1d_bw.consume(), ++l1d_it) {
     for (auto& lq_entry : LQ) {
@@ -725,6 +832,9 @@ long O3_CPU::retire_rob()
 
   auto retire_count = std::distance(retire_begin, retire_end);
   num_retired += retire_count;
+  sim_stats.energy.dynamic += ROB_ENERGY.read * static_cast<double>(retire_count);
+  if (retire_count == 0 && !std::empty(ROB))
+    sim_stats.ip_rob_stalls.increment(ROB.front().ip);
   ROB.erase(retire_begin, retire_end);
 
   return retire_count;
@@ -754,6 +864,15 @@ std::pair<champsim::address, bool> O3_CPU::impl_btb_prediction(champsim::address
   return btb_module_pimpl->impl_btb_prediction(ip, branch_type);
 }
 
+void O3_CPU::impl_prefetch_btb(champsim::address block_address) const { btb_module_pimpl->impl_prefetch_btb(block_address); }
+
+void O3_CPU::impl_btb_final_stats() const { btb_module_pimpl->impl_btb_final_stats(); }
+
+void O3_CPU::insert_fetch_bubble(long cycles)
+{
+  fetch_resume_time = std::max(fetch_resume_time, current_time + cycles * clock_period);
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void O3_CPU::print_deadlock()
 {
@@ -0,0 +1,81 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The in-order core model.
+ *
+ * Instructions are fetched as in the other models and issued in program order, up to the dispatch width in each cycle.
+ * An instruction does not issue until all of its source registers are ready, and no younger instruction may pass it.
+ * Loads do not block issue by themselves: only a later use of the loaded register stalls (stall-on-use).
+ * The ROB bounds the number of instructions that have issued but not retired.
+ *
+ * The window, load issue, and retirement are shared with the interval model.
+ */
+
+#include <algorithm>
+
+#include "ooo_cpu.h"
+
+long O3_CPU::operate_in_order()
+{
+  long progress{0};
+  progress += interval_retire();
+  progress += interval_handle_data_return();
+  progress += interval_issue_loads();
+  progress += handle_instruction_return();
+  progress += in_order_issue();
+  progress += fetch_instruction();
+  progress += check_dib();
+  initialize_instruction();
+  return progress;
+}
+
+long O3_CPU::in_order_issue()
+{
+  auto operands_ready = [this](const ooo_model_instr& instr) {
+    return std::all_of(std::begin(instr.source_registers), std::end(instr.source_registers), [this](auto src) {
+      const auto& reg = interval_reg(src);
+      return !reg.pending && reg.ready <= current_time;
+    });
+  };
+
+  champsim::bandwidth issue_bw{DISPATCH_WIDTH};
+  bool use_stall = false;
+  while (issue_bw.has_remaining() && std::size(ROB) < ROB_SIZE && !std::empty(IFETCH_BUFFER) && IFETCH_BUFFER.front().fetch_completed) {
+    if (!operands_ready(IFETCH_BUFFER.front())) {
+      use_stall = true;
+      break;
+    }
+    interval_dispatch_one(std::move(IFETCH_BUFFER.front()));
+    IFETCH_BUFFER.pop_front();
+    issue_bw.consume();
+  }
+
+  // Charge the cycle to the first reason that issue could not proceed
+  if (issue_bw.amount_consumed() > 0) {
+    ++sim_stats.in_order_issue_cycles;
+  } else if (use_stall) {
+    ++sim_stats.in_order_use_stall_cycles;
+  } else if (std::size(ROB) >= ROB_SIZE) {
+    ++sim_stats.in_order_window_stall_cycles;
+  } else if (current_time < fetch_resume_time) {
+    ++sim_stats.in_order_branch_stall_cycles;
+  } else if (!std::empty(IFETCH_BUFFER) || !std::empty(input_queue)) {
+    ++sim_stats.in_order_frontend_stall_cycles;
+  }
+
+  return issue_bw.amount_consumed();
+}
@@ -0,0 +1,360 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The interval core model.
+ *
+ * Instructions are fetched through the L1I as in the out-of-order model, then dispatched in order into a window the size of the ROB.
+ * Each instruction's completion time is computed when its register operands are known, rather than by scheduling it in every cycle.
+ * Loads are issued to the L1D as soon as their operands are ready, so that all of the misses in the window overlap.
+ * Dispatch stalls when the window is full, when the front end has not delivered, or while a mispredicted branch resolves.
+ * When no stage can act before a known time or a memory response, the core skips its stages until then, and charges each skipped cycle to the stall.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <fmt/core.h>
+
+#include "ooo_cpu.h"
+
+namespace
+{
+template <typename Window>
+auto find_in_window(Window& window, uint64_t instr_id)
+{
+  auto found = std::lower_bound(std::begin(window), std::end(window), instr_id, [](const auto& x, auto id) { return x.instr_id < id; });
+  assert(found != std::end(window) && found->instr_id == instr_id);
+  return found;
+}
+
+bool is_resolved_at_decode(const ooo_model_instr& instr)
+{
+  return (instr.branch == BRANCH_DIRECT_JUMP) || (instr.branch == BRANCH_DIRECT_CALL)
+         || (((instr.branch == BRANCH_CONDITIONAL) || (instr.branch == BRANCH_OTHER)) && instr.branch_taken == instr.branch_prediction);
+}
+} // namespace
+
+long O3_CPU::operate_interval()
+{
+  const bool woken = std::size(L1I_bus.lower_level->returned) + std::size(L1D_bus.lower_level->returned) > 0 || interval_can_read_trace();
+  if (current_time < interval_wake_time && !woken) {
+    interval_charge_stall();
+    if (!std::empty(ROB))
+      sim_stats.ip_rob_stalls.increment(ROB.front().ip);
+    return 0;
+  }
+
+  long progress{0};
+  progress += interval_retire();
+  progress += interval_handle_data_return();
+  progress += interval_issue_loads();
+  progress += handle_instruction_return();
+  progress += interval_dispatch();
+  progress += fetch_instruction();
+  progress += check_dib();
+  initialize_instruction();
+  interval_wake_time = interval_next_event();
+  return progress;
+}
+
+bool O3_CPU::interval_can_read_trace() const
+{
+  return current_time >= fetch_resume_time && std::size(IFETCH_BUFFER) < IFETCH_BUFFER_SIZE && !std::empty(input_queue);
+}
+
+champsim::chrono::clock::time_point O3_CPU::interval_next_event() const
+{
+  // Any stage that could act now keeps the core awake
+  const bool can_retire = !std::empty(ROB) && ROB.front().executed && ROB.front().ready_time <= current_time;
+  const bool can_dispatch = std::size(ROB) < ROB_SIZE && !std::empty(IFETCH_BUFFER) && IFETCH_BUFFER.front().fetch_completed;
+  const bool can_fetch = std::any_of(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), [](const auto& x) { return !x.dib_checked || !x.fetch_issued; });
+  if (can_retire || can_dispatch || can_fetch || interval_can_read_trace()) {
+    return current_time;
+  }
+
+  // Otherwise, wake for the first of the head's completion, a load's operands becoming ready, and the end of a fetch stall
+  auto next_event = champsim::chrono::clock::time_point::max();
+  if (!std::empty(ROB) && ROB.front().executed) {
+    next_event = ROB.front().ready_time;
+  }
+  for (const auto& load : interval_loads) {
+    auto instr = find_in_window(ROB, load.instr_id);
+    if (!instr->scheduled) {
+      next_event = std::min(next_event, instr->ready_time);
+    }
+  }
+  if (fetch_resume_time > current_time) {
+    next_event = std::min(next_event, fetch_resume_time);
+  }
+  return std::max(next_event, current_time);
+}
+
+champsim::chrono::clock::duration O3_CPU::interval_latency(const ooo_model_instr& instr) const
+{
+  // Every instruction takes at least a cycle after its operands are ready
+  return warmup ? champsim::chrono::clock::duration{} : (SCHEDULING_LATENCY + execute_latency(instr) + clock_period);
+}
+
+auto O3_CPU::interval_reg(PHYSICAL_REGISTER_ID reg) -> interval_register&
+{
+  auto idx = static_cast<std::size_t>(static_cast<std::make_unsigned_t<PHYSICAL_REGISTER_ID>>(reg));
+  if (idx >= std::size(interval_registers)) {
+    interval_registers.resize(idx + 1);
+  }
+  return interval_registers[idx];
+}
+
+long O3_CPU::interval_dispatch()
+{
+  champsim::bandwidth dispatch_bw{DISPATCH_WIDTH};
+  while (dispatch_bw.has_remaining() && std::size(ROB) < ROB_SIZE && !std::empty(IFETCH_BUFFER) && IFETCH_BUFFER.front().fetch_completed) {
+    interval_dispatch_one(std::move(IFETCH_BUFFER.front()));
+    IFETCH_BUFFER.pop_front();
+    dispatch_bw.consume();
+  }
+
+  if (dispatch_bw.amount_consumed() > 0) {
+    ++sim_stats.interval_dispatch_cycles;
+  } else {
+    interval_charge_stall();
+  }
+
+  return dispatch_bw.amount_consumed();
+}
+
+void O3_CPU::interval_charge_stall()
+{
+  // Charge the cycle to the first reason that dispatch could not proceed
+  if (std::size(ROB) >= ROB_SIZE) {
+    if (!std::empty(ROB.front().source_memory) && !ROB.front().executed) {
+      ++sim_stats.interval_memory_stall_cycles;
+    } else {
+      ++sim_stats.interval_window_stall_cycles;
+    }
+  } else if (current_time < fetch_resume_time) {
+    ++sim_stats.interval_branch_stall_cycles;
+  } else if (!std::empty(IFETCH_BUFFER) || !std::empty(input_queue)) {
+    ++sim_stats.interval_frontend_stall_cycles;
+  }
+}
+
+void O3_CPU::interval_dispatch_one(ooo_model_instr instr)
+{
+  instr.ready_time = current_time;
+  instr.num_reg_dependent = 0;
+  instr.completed_mem_ops = 0;
+  instr.registers_instrs_depend_on_me.clear();
+  ROB.push_back(std::move(instr));
+  sim_stats.energy.dynamic += ROB_ENERGY.write;
+  auto& dispatched = ROB.back();
+
+  // Wait on the producers of the source registers that have not completed
+  for (auto src : dispatched.source_registers) {
+    const auto& reg = interval_reg(src);
+    if (reg.pending) {
+      auto producer = find_in_window(ROB, reg.producer);
+      producer->registers_instrs_depend_on_me.emplace_back(dispatched);
+      ++dispatched.num_reg_dependent;
+    } else {
+      dispatched.ready_time = std::max(dispatched.ready_time, reg.ready);
+    }
+  }
+
+  for (auto dst : dispatched.destination_registers) {
+    interval_reg(dst) = {dispatched.instr_id, champsim::chrono::clock::time_point::max(), true};
+  }
+
+  // These branches detect the misprediction at decode
+  if (dispatched.branch_mispredicted && is_resolved_at_decode(dispatched)) {
+    dispatched.branch_mispredicted = false;
+    fetch_resume_time = current_time + BRANCH_MISPREDICT_PENALTY;
+  }
+
+  if (dispatched.num_reg_dependent == 0) {
+    if (std::empty(dispatched.source_memory)) {
+      interval_resolve(dispatched, dispatched.ready_time + interval_latency(dispatched));
+    } else {
+      interval_loads.push_back({dispatched.instr_id, 0, std::vector<bool>(std::size(dispatched.source_memory))});
+    }
+  }
+
+  if constexpr (champsim::debug_print) {
+    fmt::print("[INTERVAL] {} instr_id: {} waits on: {} cycle: {}\n", __func__, dispatched.instr_id, dispatched.num_reg_dependent,
+               current_time.time_since_epoch() / clock_period);
+  }
+}
+
+void O3_CPU::interval_resolve(ooo_model_instr& instr, champsim::chrono::clock::time_point complete)
+{
+  instr.ready_time = complete;
+  std::vector<std::reference_wrapper<ooo_model_instr>> worklist{instr};
+  while (!std::empty(worklist)) {
+    ooo_model_instr& resolved = worklist.back();
+    worklist.pop_back();
+    resolved.executed = true;
+
+    for (auto dst : resolved.destination_registers) {
+      auto& reg = interval_reg(dst);
+      if (reg.pending && reg.producer == resolved.instr_id) {
+        reg.ready = resolved.ready_time;
+        reg.pending = false;
+      }
+    }
+
+    // Fetch resumes once the mispredicted branch executes
+    if (resolved.branch_mispredicted) {
+      resolved.branch_mispredicted = false;
+      fetch_resume_time = resolved.ready_time + BRANCH_MISPREDICT_PENALTY;
+    }
+
+    for (ooo_model_instr& dependent : resolved.registers_instrs_depend_on_me) {
+      dependent.ready_time = std::max(dependent.ready_time, resolved.ready_time);
+      if (--dependent.num_reg_dependent == 0) {
+        if (std::empty(dependent.source_memory)) {
+          dependent.ready_time += interval_latency(dependent);
+          worklist.emplace_back(dependent);
+        } else {
+          interval_loads.push_back({dependent.instr_id, 0, std::vector<bool>(std::size(dependent.source_memory))});
+        }
+      }
+    }
+    resolved.registers_instrs_depend_on_me.clear();
+  }
+}
+
+long O3_CPU::interval_issue_loads()
+{
+  champsim::bandwidth load_bw{LQ_WIDTH};
+  // Resolving a load may queue its dependents, so the queue is walked by index
+  std::size_t load_idx = 0;
+  while (load_bw.has_remaining() && load_idx < std::size(interval_loads)) {
+    auto load_it = std::next(std::begin(interval_loads), static_cast<long>(load_idx));
+    auto instr = find_in_window(ROB, load_it->instr_id);
+    if (instr->ready_time > current_time || instr->scheduled) {
+      ++load_idx;
+      continue;
+    }
+
+    while (load_bw.has_remaining() && load_it->issued < std::size(instr->source_memory)) {
+      auto addr = instr->source_memory.at(load_it->issued);
+
+      // Loads that find their address in an older store are forwarded
+      auto forwards = [addr](const auto& x) {
+        return std::find(std::begin(x.destination_memory), std::end(x.destination_memory), addr) != std::end(x.destination_memory);
+      };
+      if (std::any_of(std::begin(ROB), instr, forwards)) {
+        load_it->returned.at(load_it->issued) = true;
+        ++instr->completed_mem_ops;
+      } else {
+        CacheBus::request_type data_packet;
+        data_packet.v_address = addr;
+        data_packet.instr_id = instr->instr_id;
+        data_packet.ip = instr->ip;
+        data_packet.instr_depend_on_me = {instr->instr_id};
+        if (!L1D_bus.issue_read(data_packet)) {
+          return load_bw.amount_consumed();
+        }
+        sim_stats.energy.dynamic += LQ_ENERGY.read;
+        load_bw.consume();
+      }
+      ++load_it->issued;
+    }
+
+    if (load_it->issued < std::size(instr->source_memory)) {
+      break;
+    }
+
+    // The load waits here for its responses once all of its reads have issued
+    instr->fetch_issued = true;
+    instr->scheduled = true;
+    if (instr->completed_mem_ops >= std::size(instr->source_memory)) {
+      interval_loads.erase(load_it);
+      interval_resolve(*instr, current_time + interval_latency(*instr));
+    } else {
+      ++load_idx;
+    }
+  }
+
+  return load_bw.amount_consumed();
+}
+
+long O3_CPU::interval_handle_data_return()
+{
+  long progress{0};
+  auto l1d_it = std::begin(L1D_bus.lower_level->returned);
+  for (champsim::bandwidth l1d_bw{L1D_BANDWIDTH}; l1d_bw.has_remaining() && l1d_it != std::end(L1D_bus.lower_level->returned); l1d_bw.consume(), ++l1d_it) {
+    const champsim::block_number returned_block{l1d_it->v_address};
+    for (auto instr_id : l1d_it->instr_depend_on_me) {
+      auto load_it = std::find_if(std::begin(interval_loads), std::end(interval_loads), [instr_id](const auto& x) { return x.instr_id == instr_id; });
+      if (load_it == std::end(interval_loads)) {
+        continue;
+      }
+
+      // Complete each issued operand in the block once, however many responses carry it
+      auto instr = find_in_window(ROB, instr_id);
+      for (std::size_t i = 0; i < load_it->issued; ++i) {
+        if (!load_it->returned.at(i) && champsim::block_number{instr->source_memory.at(i)} == returned_block) {
+          load_it->returned.at(i) = true;
+          ++instr->completed_mem_ops;
+        }
+      }
+
+      if (instr->scheduled && instr->completed_mem_ops >= std::size(instr->source_memory)) {
+        interval_loads.erase(load_it);
+        interval_resolve(*instr, current_time + interval_latency(*instr));
+      }
+    }
+    ++progress;
+  }
+  L1D_bus.lower_level->returned.erase(std::begin(L1D_bus.lower_level->returned), l1d_it);
+
+  return progress;
+}
+
+long O3_CPU::interval_retire()
+{
+  champsim::bandwidth retire_bw{RETIRE_WIDTH};
+  while (retire_bw.has_remaining() && !std::empty(ROB) && ROB.front().executed && ROB.front().ready_time <= current_time) {
+    auto& head = ROB.front();
+
+    // Stores are written when they retire
+    while (!std::empty(head.destination_memory)) {
+      CacheBus::request_type data_packet;
+      data_packet.v_address = head.destination_memory.front();
+      data_packet.instr_id = head.instr_id;
+      data_packet.ip = head.ip;
+      if (!L1D_bus.issue_write(data_packet)) {
+        return retire_bw.amount_consumed();
+      }
+      sim_stats.energy.dynamic += SQ_ENERGY.read;
+      head.destination_memory.erase(std::begin(head.destination_memory));
+    }
+
+    if constexpr (champsim::debug_print) {
+      fmt::print("[INTERVAL] {} instr_id: {} is retired cycle: {}\n", __func__, head.instr_id, current_time.time_since_epoch() / clock_period);
+    }
+
+    ROB.pop_front();
+    ++num_retired;
+    sim_stats.energy.dynamic += ROB_ENERGY.read;
+    retire_bw.consume();
+  }
+
+  if (retire_bw.amount_consumed() == 0 && !std::empty(ROB))
+    sim_stats.ip_rob_stalls.increment(ROB.front().ip);
+
+  return retire_bw.amount_consumed();
+}
@@ -36,6 +36,20 @@ auto print_ratio(N num, D denom)
   }
   return std::string{"-"};
 }
+
+std::string format_energy(std::string_view name, const champsim::energy_stats& energy)
+{
+  return fmt::format("{} ENERGY DYNAMIC: {:.4g} nJ LEAKAGE: {:.4g} nJ POWER: {:.4g} W", name, energy.dynamic / std::kilo::num,
+                     energy.leakage / std::kilo::num, energy.power());
+}
+
+std::string format_histogram(std::string_view name, const champsim::stats::log2_histogram& hist)
+{
+  std::string result{name};
+  for (std::size_t bucket = 0; bucket < hist.used_buckets(); ++bucket)
+    result += fmt::format(" {}+: {}", champsim::stats::log2_histogram::lower_bound(bucket), hist.at(bucket));
+  return result;
+}
 } // namespace
 
 std::vector<std::string> champsim::plain_printer::format(O3_CPU::stats_type stats)
@@ -62,6 +76,35 @@ std::vector<std::string> champsim::plain_printer::format(O3_CPU::stats_type stat
                                 ::print_ratio(std::kilo::num * stats.branch_type_misses.value_or(idx, 0), stats.instrs())));
   }
 
+  if (stats.dib_lookups > 0) {
+    lines.push_back(fmt::format("{} DIB hit rate: {}% uops per DIB cycle: {} uops per decoder cycle: {} switches: {} overflowed windows: {} L1I invalidations: {}",
+                                stats.name, ::print_ratio(100 * stats.dib_hits, stats.dib_lookups),
+                                ::print_ratio(stats.dib_uops_delivered, stats.dib_delivery_cycles),
+                                ::print_ratio(stats.decoder_uops_delivered, stats.decoder_delivery_cycles), stats.dib_switches, stats.dib_overflows,
+                                stats.dib_inclusion_invalidations));
+  }
+
+  if (stats.decode_cache_hits + stats.decode_cache_misses > 0) {
+    lines.push_back(fmt::format("{} Decode cache hit rate: {}% hits: {} misses: {}", stats.name,
+                                ::print_ratio(100 * stats.decode_cache_hits, stats.decode_cache_hits + stats.decode_cache_misses), stats.decode_cache_hits,
+                                stats.decode_cache_misses));
+  }
+
+  if (stats.interval_dispatch_cycles > 0) {
+    lines.push_back(fmt::format("{} Interval dispatch cycles: {} frontend stalls: {} branch stalls: {} memory stalls: {} window stalls: {}", stats.name,
+                                stats.interval_dispatch_cycles, stats.interval_frontend_stall_cycles, stats.interval_branch_stall_cycles,
+                                stats.interval_memory_stall_cycles, stats.interval_window_stall_cycles));
+  }
+
+  if (stats.in_order_issue_cycles > 0) {
+    lines.push_back(fmt::format("{} In-order issue cycles: {} stall-on-use: {} frontend stalls: {} branch stalls: {} window stalls: {}", stats.name,
+                                stats.in_order_issue_cycles, stats.in_order_use_stall_cycles, stats.in_order_frontend_stall_cycles,
+                                stats.in_order_branch_stall_cycles, stats.in_order_window_stall_cycles));
+  }
+
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    lines.push_back(::format_energy(stats.name, stats.energy));
+
   return lines;
 }
 
@@ -118,12 +161,41 @@ std::vector<std::string> champsim::plain_printer::format(CACHE::stats_type stats
 
     lines.push_back(fmt::format("cpu{}->{} PREFETCH REQUESTED: {:10} ISSUED: {:10} USEFUL: {:10} USELESS: {:10}", cpu, stats.name, stats.pf_requested,
                                 stats.pf_issued, stats.pf_useful, stats.pf_useless));
+    if (stats.pf_filtered > 0)
+      lines.push_back(fmt::format("cpu{}->{} PREFETCH FILTERED: {:10}", cpu, stats.name, stats.pf_filtered));
+    if (stats.pf_late + stats.pf_early + stats.pf_polluting + stats.pf_use_distance.total() > 0) {
+      lines.push_back(fmt::format("cpu{}->{} PREFETCH LATE: {:10} EARLY: {:10} POLLUTING: {:10}", cpu, stats.name, stats.pf_late, stats.pf_early,
+                                  stats.pf_polluting));
+      lines.push_back(::format_histogram(fmt::format("cpu{}->{} PREFETCH USE DISTANCE (cycles)", cpu, stats.name), stats.pf_use_distance));
+      lines.push_back(::format_histogram(fmt::format("cpu{}->{} PREFETCH LATENESS (cycles)", cpu, stats.name), stats.pf_late_distance));
+    }
+    if (stats.sector_misses > 0)
+      lines.push_back(fmt::format("cpu{}->{} SECTOR MISS: {:10}", cpu, stats.name, stats.sector_misses));
+    if (stats.mshr_full.total() > 0) {
+      lines.push_back(fmt::format("cpu{}->{} MSHR FULL LOAD: {:10} RFO: {:10} PREFETCH: {:10} WRITE: {:10} TRANSLATION: {:10}", cpu, stats.name,
+                                  stats.mshr_full.value_or(std::pair{access_type::LOAD, cpu}, 0),
+                                  stats.mshr_full.value_or(std::pair{access_type::RFO, cpu}, 0),
+                                  stats.mshr_full.value_or(std::pair{access_type::PREFETCH, cpu}, 0),
+                                  stats.mshr_full.value_or(std::pair{access_type::WRITE, cpu}, 0),
+                                  stats.mshr_full.value_or(std::pair{access_type::TRANSLATION, cpu}, 0)));
+    }
+    if (stats.wb_eviction + stats.wb_eager + stats.wb_write_through + stats.wb_write_around > 0) {
+      lines.push_back(fmt::format("cpu{}->{} WRITEBACK EVICTION: {:10} EAGER: {:10} WRITE THROUGH: {:10} WRITE AROUND: {:10}", cpu, stats.name,
+                                  stats.wb_eviction, stats.wb_eager, stats.wb_write_through, stats.wb_write_around));
+    }
+    if (stats.victim_hits > 0)
+      lines.push_back(fmt::format("cpu{}->{} VICTIM CACHE HIT: {:10} PROMOTED: {:10}", cpu, stats.name, stats.victim_hits, stats.victim_promotions));
+    if (stats.pf_buffer_hits > 0)
+      lines.push_back(fmt::format("cpu{}->{} PREFETCH BUFFER HIT: {:10} PROMOTED: {:10}", cpu, stats.name, stats.pf_buffer_hits, stats.pf_buffer_promotions));
 
     uint64_t total_downstream_demands = total_mshr_return - stats.mshr_return.value_or(std::pair{access_type::PREFETCH, cpu}, mshr_return_value_type{});
     lines.push_back(
         fmt::format("cpu{}->{} AVERAGE MISS LATENCY: {} cycles", cpu, stats.name, ::print_ratio(stats.total_miss_latency_cycles, total_downstream_demands)));
   }
 
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    lines.push_back(::format_energy(stats.name, stats.energy));
+
   return lines;
 }
 
@@ -142,6 +214,74 @@ std::vector<std::string> champsim::plain_printer::format(DRAM_CHANNEL::stats_typ
   else
     lines.push_back(fmt::format("{} REFRESHES ISSUED: -", stats.name));
 
+  if (stats.PREFETCH_ISSUED > 0 || stats.PREFETCH_ROW_OPENED > 0) {
+    lines.push_back(fmt::format("{} PREFETCH ISSUED: {:10}", stats.name, stats.PREFETCH_ISSUED));
+    lines.push_back(fmt::format("  BUFFER_HIT: {:10}", stats.PREFETCH_BUFFER_HIT));
+    lines.push_back(fmt::format("  ROW_OPENED: {:10}", stats.PREFETCH_ROW_OPENED));
+  }
+
+  if (stats.rowhammer_mitigations > 0) {
+    lines.push_back(fmt::format("{} ROWHAMMER MITIGATIONS: {:10}", stats.name, stats.rowhammer_mitigations));
+    lines.push_back(fmt::format("  ACTIVATIONS: {:10}", stats.activations));
+    lines.push_back(fmt::format("  BANK BUSY CYCLES: {:10}", stats.rowhammer_busy_cycles));
+    lines.push_back(fmt::format("  STALL CYCLES: {:10}", stats.rowhammer_stall_cycles));
+  }
+
+  return lines;
+}
+
+std::vector<std::string> champsim::plain_printer::format(DRAM_CACHE::stats_type stats)
+{
+  std::vector<std::string> lines{};
+  lines.push_back(fmt::format("{} READ HIT: {:10} MISS: {:10} WRITE: {:10}", stats.name, stats.read_hits, stats.read_misses, stats.writes));
+  lines.push_back(fmt::format("{} PREDICTED MISS: {:10} MISPREDICTED HIT: {:10}", stats.name, stats.predicted_misses, stats.mispredicted_hits));
+  lines.push_back(fmt::format("{} TAG READ: {:10} CACHE WRITE: {:10} BANDWIDTH BLOAT: {}", stats.name, stats.tag_reads, stats.cache_writes,
+                              ::print_ratio(stats.tag_reads + stats.cache_writes, stats.read_hits)));
+  lines.push_back(fmt::format("{} MEMORY READ: {:10} WRITEBACK: {:10}", stats.name, stats.memory_reads, stats.writebacks));
+
+  if (stats.footprint_fetches > 0 || stats.unused_fetches > 0)
+    lines.push_back(fmt::format("{} FOOTPRINT FETCH: {:10} UNUSED FETCH: {:10}", stats.name, stats.footprint_fetches, stats.unused_fetches));
+
+  return lines;
+}
+
+std::vector<std::string> champsim::plain_printer::format(champsim::link_stats stats)
+{
+  std::vector<std::string> lines{};
+  lines.push_back(fmt::format("{} REQUEST  PACKETS: {:10} FLITS: {:10} UTILIZATION: {} AVERAGE QUEUE DELAY: {} cycles", stats.name, stats.request_packets,
+                              stats.request_flits, ::print_ratio(stats.request_busy_cycles, stats.cycles),
+                              ::print_ratio(stats.request_queue_delay, stats.request_packets)));
+  lines.push_back(fmt::format("{} RESPONSE PACKETS: {:10} FLITS: {:10} UTILIZATION: {} AVERAGE QUEUE DELAY: {} cycles", stats.name, stats.response_packets,
+                              stats.response_flits, ::print_ratio(stats.response_busy_cycles, stats.cycles),
+                              ::print_ratio(stats.response_queue_delay, stats.response_packets)));
+  return lines;
+}
+
+std::vector<std::string> champsim::plain_printer::format(PageTableWalker::stats_type stats)
+{
+  std::vector<std::string> lines{};
+  lines.push_back(fmt::format("{} PSCL LOOKUPS: {:10} FILLS: {:10}", stats.name, stats.pscl_lookups, stats.pscl_fills));
+  if (stats.energy.elapsed > champsim::chrono::picoseconds{})
+    lines.push_back(::format_energy(stats.name, stats.energy));
+  return lines;
+}
+
+std::vector<std::string> champsim::plain_printer::format_energy(const champsim::phase_stats& stats)
+{
+  champsim::energy_stats total{};
+  auto accumulate = [&total](const auto& stat) { total = champsim::combine_concurrent(total, stat.energy); };
+  std::for_each(std::begin(stats.roi_cpu_stats), std::end(stats.roi_cpu_stats), accumulate);
+  std::for_each(std::begin(stats.roi_cache_stats), std::end(stats.roi_cache_stats), accumulate);
+  std::for_each(std::begin(stats.roi_ptw_stats), std::end(stats.roi_ptw_stats), accumulate);
+
+  if (total.elapsed == champsim::chrono::picoseconds{})
+    return {};
+
+  auto instrs = std::accumulate(std::begin(stats.roi_cpu_stats), std::end(stats.roi_cpu_stats), 0LL, [](auto acc, const auto& x) { return acc + x.instrs(); });
+
+  std::vector<std::string> lines{};
+  lines.push_back(::format_energy("TOTAL", total));
+  lines.push_back(fmt::format("INSTRUCTIONS PER MICROJOULE: {}", ::print_ratio(instrs * std::mega::num, total.total())));
   return lines;
 }
 
@@ -193,6 +333,36 @@ std::vector<std::string> champsim::plain_printer::format(champsim::phase_stats&
     std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
   }
 
+  if (!std::empty(stats.roi_dram_cache_stats)) {
+    lines.emplace_back("");
+    lines.emplace_back("DRAM Cache Statistics");
+    for (const auto& stat : stats.roi_dram_cache_stats) {
+      auto sublines = format(stat);
+      lines.emplace_back("");
+      std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
+    }
+  }
+
+  if (!std::empty(stats.roi_link_stats)) {
+    lines.emplace_back("");
+    lines.emplace_back("Link Statistics");
+    for (const auto& stat : stats.roi_link_stats) {
+      auto sublines = format(stat);
+      lines.emplace_back("");
+      std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
+    }
+  }
+
+  if (!std::empty(stats.roi_ptw_stats)) {
+    lines.emplace_back("");
+    lines.emplace_back("Page Table Walker Statistics");
+    for (const auto& stat : stats.roi_ptw_stats) {
+      auto sublines = format(stat);
+      lines.emplace_back("");
+      std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
+    }
+  }
+
   lines.emplace_back("");
   lines.emplace_back("DRAM Statistics");
   for (const auto& stat : stats.roi_dram_stats) {
@@ -201,6 +371,13 @@ std::vector<std::string> champsim::plain_printer::format(champsim::phase_stats&
     std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
   }
 
+  if (auto energy_lines = format_energy(stats); !std::empty(energy_lines)) {
+    lines.emplace_back("");
+    lines.emplace_back("Energy Statistics");
+    lines.emplace_back("");
+    std::move(std::begin(energy_lines), std::end(energy_lines), std::back_inserter(lines));
+  }
+
   return lines;
 }
 
@@ -0,0 +1,48 @@
+#include "prefetch_filter.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "util/bits.h" // for lg2, next_pow2
+
+champsim::prefetch_filter::prefetch_filter(std::size_t tracked_blocks)
+    : counters(champsim::next_pow2(std::max<std::size_t>(tracked_blocks * BLOOM_COUNTERS_PER_BLOCK, 2))),
+      index_bits(static_cast<unsigned>(champsim::lg2(std::size(counters))))
+{
+}
+
+auto champsim::prefetch_filter::hash(uint64_t block) const -> std::array<std::size_t, BLOOM_HASHES>
+{
+  // Multiplicative hashes with distinct odd multipliers, taking the high bits of the product
+  constexpr std::array<uint64_t, BLOOM_HASHES> multipliers{0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull};
+
+  std::array<std::size_t, BLOOM_HASHES> retval{};
+  std::transform(std::begin(multipliers), std::end(multipliers), std::begin(retval),
+                 [block, shamt = 64 - index_bits](auto mult) { return static_cast<std::size_t>((block * mult) >> shamt); });
+  return retval;
+}
+
+bool champsim::prefetch_filter::recently_issued(uint64_t block) { return recent_issues.check_hit({block}).has_value(); }
+
+bool champsim::prefetch_filter::may_contain(uint64_t block) const
+{
+  auto indices = hash(block);
+  return std::all_of(std::begin(indices), std::end(indices), [this](auto idx) { return counters.at(idx) > 0; });
+}
+
+void champsim::prefetch_filter::record_issue(uint64_t block) { recent_issues.fill({block}); }
+
+void champsim::prefetch_filter::insert(uint64_t block)
+{
+  for (auto idx : hash(block))
+    ++counters.at(idx);
+}
+
+void champsim::prefetch_filter::erase(uint64_t block)
+{
+  // A removal with no matching insertion would take a count from whichever blocks share these counters, and could hide them
+  for (auto idx : hash(block)) {
+    assert(counters.at(idx) > 0);
+    --counters.at(idx);
+  }
+}
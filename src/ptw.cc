@@ -29,6 +29,12 @@
 #include "util/span.h"
 #include "vmem.h"
 
+namespace
+{
+// The bits of a page offset that select a page table entry
+using pte_offset_extent = champsim::static_extent<champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(pte_entry::byte_multiple)}>;
+} // namespace
+
 PageTableWalker::PageTableWalker(champsim::ptw_builder b)
     : champsim::operable(b.m_clock_period), upper_levels(b.m_uls), lower_level(b.m_ll), NAME(b.m_name),
       MSHR_SIZE(b.m_mshr_size.value_or(std::lround(b.m_mshr_factor * std::floor(std::size(upper_levels))))),
@@ -42,6 +48,7 @@ PageTableWalker::PageTableWalker(champsim::ptw_builder b)
 
   for (auto [level, sets, ways] : local_pscl_dims) {
     pscl.emplace_back(sets, ways, pscl_indexer{b.m_vmem->shamt(level)}, pscl_indexer{b.m_vmem->shamt(level)});
+    pscl_energy.push_back(b.get_pscl_energy(sets, ways));
   }
 }
 
@@ -58,18 +65,18 @@ auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type*
   pscl_entry walk_init = {handle_pkt.v_address, CR3_addr, std::size(pscl)};
   std::vector<std::optional<pscl_entry>> pscl_hits;
   std::transform(std::begin(pscl), std::end(pscl), std::back_inserter(pscl_hits), [walk_init](auto& x) { return x.check_hit(walk_init); });
+  ++sim_stats.pscl_lookups;
+  sim_stats.energy.dynamic += std::accumulate(std::begin(pscl_energy), std::end(pscl_energy), 0.0, [](auto sum, const auto& x) { return sum + x.read; });
   walk_init =
       std::accumulate(std::begin(pscl_hits), std::end(pscl_hits), std::optional<pscl_entry>(walk_init), [](auto x, auto& y) { return y.value_or(*x); }).value();
 
-  champsim::address_slice walk_offset{
-      champsim::dynamic_extent{champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(pte_entry::byte_multiple)}},
-      vmem->get_offset(handle_pkt.address, walk_init.level)};
+  champsim::address_slice walk_offset{pte_offset_extent{}, vmem->get_offset(handle_pkt.address, walk_init.level)};
 
   mshr_type fwd_mshr{handle_pkt, walk_init.level};
   fwd_mshr.address = champsim::address{champsim::splice(champsim::page_number{walk_init.ptw_addr}, champsim::page_offset{walk_offset})};
   fwd_mshr.v_address = handle_pkt.address;
   if (handle_pkt.response_requested) {
-    fwd_mshr.to_return = {&ul->returned};
+    fwd_mshr.to_return = {ul->response_target()};
   }
 
   if constexpr (champsim::debug_print) {
@@ -83,14 +90,15 @@ auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type*
 auto PageTableWalker::handle_fill(const mshr_type& fill_mshr) -> std::optional<mshr_type>
 {
   if constexpr (champsim::debug_print) {
-    champsim::dynamic_extent pte_offset_extent{champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(pte_entry::byte_multiple)}};
     fmt::print("[{}] {} address: {} v_address: {} data: {} pt_page_offset: {} translation_level: {} cycle: {}\n", NAME, __func__, fill_mshr.address,
-               fill_mshr.v_address, *fill_mshr.data, champsim::address_slice{pte_offset_extent, fill_mshr.data.value()}.to<int>(), fill_mshr.translation_level,
+               fill_mshr.v_address, *fill_mshr.data, champsim::address_slice{pte_offset_extent{}, fill_mshr.data.value()}.to<int>(), fill_mshr.translation_level,
                current_time.time_since_epoch() / clock_period);
   }
 
   const auto pscl_idx = std::size(pscl) - fill_mshr.translation_level;
   pscl.at(pscl_idx).fill({fill_mshr.v_address, *fill_mshr.data, fill_mshr.translation_level - 1});
+  ++sim_stats.pscl_fills;
+  sim_stats.energy.dynamic += pscl_energy.at(pscl_idx).write;
 
   mshr_type fwd_mshr = fill_mshr;
   fwd_mshr.address = *fill_mshr.data;
@@ -122,6 +130,8 @@ auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional
 long PageTableWalker::operate()
 {
   long progress{0};
+  sim_stats.energy.leakage += std::accumulate(std::begin(pscl_energy), std::end(pscl_energy), 0.0, [](auto sum, const auto& x) { return sum + x.leakage; });
+  sim_stats.energy.elapsed += clock_period;
 
   auto is_ready = [time = current_time](const auto& pkt) {
     return pkt.data.is_ready_at(time);
@@ -224,6 +234,17 @@ void PageTableWalker::finish_packet(const response_type& packet)
 
 void PageTableWalker::begin_phase()
 {
+  stats_type new_roi_stats;
+  stats_type new_sim_stats;
+
+  new_roi_stats.name = NAME;
+  new_sim_stats.name = NAME;
+
+  roi_stats = new_roi_stats;
+  sim_stats = new_sim_stats;
+
+  vmem->clear_page_profile();
+
   for (auto* ul : upper_levels) {
     channel_type::stats_type ul_new_roi_stats;
     channel_type::stats_type ul_new_sim_stats;
@@ -232,6 +253,14 @@ void PageTableWalker::begin_phase()
   }
 }
 
+void PageTableWalker::end_phase(unsigned cpu)
+{
+  roi_stats = sim_stats;
+
+  if (!warmup)
+    vmem->write_page_profile(cpu);
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void PageTableWalker::print_deadlock()
 {
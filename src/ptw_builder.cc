@@ -97,7 +97,20 @@ auto champsim::ptw_builder::virtual_memory(VirtualMemory* vmem_) -> ptw_builder&
   return *this;
 }
 
+auto champsim::ptw_builder::pscl_energy(champsim::partial_access_energy pscl_energy_) -> ptw_builder&
+{
+  m_pscl_energy = pscl_energy_;
+  return *this;
+}
+
 auto champsim::ptw_builder::scaled_by_ul_size(double factor) const -> uint32_t
 {
   return factor < 0 ? 0 : static_cast<uint32_t>(std::lround(factor * std::floor(std::size(m_uls))));
 }
+
+auto champsim::ptw_builder::get_pscl_energy(uint32_t sets, uint32_t ways) const -> champsim::access_energy
+{
+  // Each entry holds a virtual address and the address of the next level of the table
+  constexpr long long pscl_entry_bytes = 16;
+  return m_pscl_energy.value_or(champsim::estimate_energy(champsim::data::bytes{pscl_entry_bytes * sets * ways}, ways));
+}
@@ -0,0 +1,9 @@
+#include "ptw_stats.h"
+
+ptw_stats operator-(ptw_stats lhs, ptw_stats rhs)
+{
+  lhs.pscl_lookups -= rhs.pscl_lookups;
+  lhs.pscl_fills -= rhs.pscl_fills;
+  lhs.energy = lhs.energy - rhs.energy;
+  return lhs;
+}
@@ -3,17 +3,16 @@
 #include <cassert>
 
 RegisterAllocator::RegisterAllocator(size_t num_physical_registers)
+    : frontend_RAT(std::numeric_limits<uint16_t>::max() + 1, -1), backend_RAT(std::numeric_limits<uint16_t>::max() + 1, -1) // -1 means no mapping
 {
   assert(num_physical_registers <= std::numeric_limits<PHYSICAL_REGISTER_ID>::max());
   for (size_t i = 0; i < num_physical_registers; ++i) {
     free_registers.push(static_cast<PHYSICAL_REGISTER_ID>(i));
   }
   physical_register_file = std::vector<physical_register>(num_physical_registers, {0, 0, false, false});
-  frontend_RAT.fill(-1); // default value for no mapping
-  backend_RAT.fill(-1);
 }
 
-PHYSICAL_REGISTER_ID RegisterAllocator::rename_dest_register(int16_t reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id)
+PHYSICAL_REGISTER_ID RegisterAllocator::rename_dest_register(PHYSICAL_REGISTER_ID reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id)
 {
   assert(!free_registers.empty());
 
@@ -25,7 +24,7 @@ PHYSICAL_REGISTER_ID RegisterAllocator::rename_dest_register(int16_t reg, champs
   return phys_reg;
 }
 
-PHYSICAL_REGISTER_ID RegisterAllocator::rename_src_register(int16_t reg)
+PHYSICAL_REGISTER_ID RegisterAllocator::rename_src_register(PHYSICAL_REGISTER_ID reg)
 {
   PHYSICAL_REGISTER_ID phys = frontend_RAT[reg];
 
@@ -91,6 +90,9 @@ void RegisterAllocator::print_deadlock()
 {
   fmt::print("Frontend Register Allocation Table        Backend Register Allocation Table\n");
   for (size_t i = 0; i < frontend_RAT.size(); ++i) {
+    if (frontend_RAT[i] == -1 && backend_RAT[i] == -1) {
+      continue;
+    }
     fmt::print("Arch reg: {:3}    Phys reg: {:3}            Arch reg: {:3}    Phys reg: {:3}\n", i, frontend_RAT[i], i, backend_RAT[i]);
   }
 
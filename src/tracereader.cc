@@ -54,6 +54,19 @@ champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu)
 template <typename T, typename S>
 using repeatable_reader_t = champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string>;
 
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, champsim::trace_format format, bool repeat)
+{
+  if (format == champsim::trace_format::extended && repeat) {
+    return champsim::get_tracereader_for_type<repeatable_reader_t, extended_instr>(fname, cpu);
+  }
+
+  if (format == champsim::trace_format::extended && !repeat) {
+    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, extended_instr>(fname, cpu);
+  }
+
+  return get_tracereader(fname, cpu, format == champsim::trace_format::cloudsuite, repeat);
+}
+
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat)
 {
   if (is_cloudsuite && repeat) {
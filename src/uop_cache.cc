@@ -0,0 +1,106 @@
+#include "uop_cache.h"
+
+#include <algorithm>
+
+#include "util/bits.h" // for lg2
+
+champsim::uop_cache::uop_cache(std::size_t sets, std::size_t ways, std::size_t window_size, std::size_t uops_per_line, std::size_t ways_per_window)
+    : UOPS_PER_LINE(uops_per_line),
+      MAX_LINES(uops_per_line == 0 ? 1 : std::max<std::size_t>(1, ways_per_window == 0 ? ways : std::min(ways, ways_per_window))),
+      window_bits{champsim::lg2(window_size)}, offset_shift{window_size > 64 ? champsim::lg2(window_size) - 6 : 0},
+      table(sets, ways, indexer{}, tagger{MAX_LINES})
+{
+}
+
+uint64_t champsim::uop_cache::window_of(champsim::address ip) const { return ip.slice_upper(window_bits).to<uint64_t>(); }
+
+uint64_t champsim::uop_cache::offset_bit(champsim::address ip) const
+{
+  return uint64_t{1} << ip.slice_lower(window_bits).slice_upper(offset_shift).to<uint64_t>();
+}
+
+bool champsim::uop_cache::check_hit(champsim::address ip)
+{
+  const auto window = window_of(ip);
+  auto head = table.check_hit({window, 0});
+  if (!head.has_value())
+    return false;
+
+  for (std::size_t line = 1; line < head->lines; ++line) {
+    if (!table.check_hit({window, line}).has_value())
+      return false;
+  }
+  return true;
+}
+
+bool champsim::uop_cache::fill(champsim::address ip)
+{
+  const auto window = window_of(ip);
+  const auto ip_bit = offset_bit(ip);
+  auto head = table.check_hit({window, 0});
+  if (!head.has_value()) {
+    table.fill({window, 0, 1, 1, ip_bit});
+    return true;
+  }
+
+  // The micro-ops of an instruction that was placed before are already held
+  if ((head->ips & ip_bit) != 0)
+    return true;
+
+  // If part of the window was evicted, begin it again
+  auto last = table.check_hit({window, head->lines - 1});
+  if (!last.has_value()) {
+    invalidate_window(window);
+    table.fill({window, 0, 1, 1, ip_bit});
+    return true;
+  }
+
+  head->ips |= ip_bit;
+  if (head->lines == 1)
+    last = head;
+
+  if (UOPS_PER_LINE == 0) {
+    table.fill(*head);
+    return true;
+  }
+
+  if (last->uops < UOPS_PER_LINE) {
+    ++last->uops;
+    table.fill(*last);
+    if (last->line != 0)
+      table.fill(*head);
+    return true;
+  }
+
+  if (head->lines < MAX_LINES) {
+    table.fill({window, head->lines, 1, 1});
+    ++head->lines;
+    table.fill(*head);
+    return true;
+  }
+
+  // The window does not fit in the ways it may occupy
+  invalidate_window(window);
+  return false;
+}
+
+bool champsim::uop_cache::invalidate_window(uint64_t window)
+{
+  bool found = false;
+  for (std::size_t line = 0; line < MAX_LINES; ++line)
+    found = table.invalidate({window, line}).has_value() || found;
+  return found;
+}
+
+std::size_t champsim::uop_cache::invalidate(champsim::block_number block)
+{
+  const auto first = window_of(champsim::address{block});
+  const auto last = std::max(first, window_of(champsim::address{block + 1}) - 1);
+
+  std::size_t count = 0;
+  for (auto window = first; window <= last; ++window) {
+    if (invalidate_window(window))
+      ++count;
+  }
+  return count;
+}
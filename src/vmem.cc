@@ -16,8 +16,11 @@
 
 #include "vmem.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/core.h>
+#include <numeric>
+#include <stdexcept>
 
 #include "champsim.h"
 #include "dram_controller.h"
@@ -26,14 +29,18 @@
 using namespace champsim::data::data_literals;
 
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
-                             MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_)
-    : randomization_seed(randomization_seed_), dram(dram_), minor_fault_penalty(minor_penalty), pt_levels(page_table_levels),
+                             MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_, page_allocation_parameters allocation_params,
+                             page_profile_parameters profile_params_)
+    : randomization_seed(randomization_seed_), dram(dram_), allocation(allocation_params), profile_params(std::move(profile_params_)),
+      minor_fault_penalty(minor_penalty), pt_levels(page_table_levels),
       pte_page_size(page_table_page_size),
       next_pte_page(
           champsim::dynamic_extent{champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(champsim::data::bytes{pte_page_size}.count())}}, 0)
 {
   assert(pte_page_size > 1_kiB);
   assert(champsim::is_power_of_2(pte_page_size.count()));
+  assert(allocation.nodes > 0);
+  assert(allocation.fragmentation >= 0 && allocation.fragmentation <= 1);
 
   champsim::page_number last_vpage{
       champsim::lowest_address_for_size(champsim::data::bytes{PAGE_SIZE + champsim::ipow(pte_page_size.count(), static_cast<unsigned>(pt_levels))})};
@@ -46,6 +53,25 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
   }
   populate_pages();
   shuffle_pages();
+
+  if (profile_params.enabled()) {
+    profile_file.open(profile_params.file);
+    if (!profile_file)
+      throw std::runtime_error{"Could not open the page profile file " + profile_params.file};
+    profile_file << "cpu,vpage,ppage,translations\n";
+  }
+}
+
+VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
+                             MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_, page_allocation_parameters allocation_params)
+    : VirtualMemory(page_table_page_size, page_table_levels, minor_penalty, dram_, randomization_seed_, allocation_params, {})
+{
+}
+
+VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
+                             MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_)
+    : VirtualMemory(page_table_page_size, page_table_levels, minor_penalty, dram_, randomization_seed_, {})
+{
 }
 
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
@@ -57,20 +83,133 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
 void VirtualMemory::populate_pages()
 {
   assert(dram.size() > 1_MiB);
-  ppage_free_list.resize(((dram.size() - 1_MiB) / PAGE_SIZE).count());
-  assert(ppage_free_list.size() != 0);
+  std::vector<champsim::page_number> pages(((dram.size() - 1_MiB) / PAGE_SIZE).count());
+  assert(pages.size() != 0);
   champsim::page_number base_address =
       champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
-  for (auto it = ppage_free_list.begin(); it != ppage_free_list.end(); it++) {
+  for (auto it = pages.begin(); it != pages.end(); it++) {
     *it = base_address;
     base_address++;
   }
+
+  if (allocation.policy == page_allocation_parameters::policy_type::buddy) {
+    order_buddy_blocks(pages);
+  }
+
+  ppage_free_lists.assign(num_free_lists(), {});
+  for (std::size_t i = 0; i < pages.size(); ++i) {
+    ppage_free_lists.at(free_list_of(pages[i], i, pages.size())).push_back(pages[i]);
+  }
 }
 
 void VirtualMemory::shuffle_pages()
 {
-  if (randomization_seed.has_value())
-    std::shuffle(ppage_free_list.begin(), ppage_free_list.end(), std::mt19937_64{randomization_seed.value()});
+  // The sequential and buddy policies keep the order that the pages were placed in
+  if (randomization_seed.has_value() && allocation.policy != page_allocation_parameters::policy_type::sequential
+      && allocation.policy != page_allocation_parameters::policy_type::buddy) {
+    std::mt19937_64 rng{randomization_seed.value()};
+    for (auto& free_list : ppage_free_lists) {
+      std::shuffle(free_list.begin(), free_list.end(), rng);
+    }
+  }
+}
+
+void VirtualMemory::order_buddy_blocks(std::vector<champsim::page_number>& pages) const
+{
+  std::mt19937_64 rng{randomization_seed.value_or(0)};
+  std::bernoulli_distribution split{allocation.fragmentation};
+
+  // Divide memory into blocks of the largest order, then split each free block in half with the given probability, down to single pages
+  std::vector<std::pair<std::size_t, std::size_t>> blocks; // (first index, size)
+  std::vector<std::pair<std::size_t, std::size_t>> to_split;
+  const std::size_t max_block = std::size_t{1} << allocation.max_order;
+  for (std::size_t first = 0; first < pages.size(); first += max_block) {
+    to_split.emplace_back(first, std::min(max_block, pages.size() - first));
+  }
+  while (!to_split.empty()) {
+    auto [first, size] = to_split.back();
+    to_split.pop_back();
+    if (size > 1 && split(rng)) {
+      to_split.emplace_back(first + size / 2, size - size / 2);
+      to_split.emplace_back(first, size / 2);
+    } else {
+      blocks.emplace_back(first, size);
+    }
+  }
+
+  // The free blocks are handed out in no particular order, and the pages within each block in order
+  std::shuffle(blocks.begin(), blocks.end(), rng);
+  std::vector<champsim::page_number> ordered;
+  ordered.reserve(pages.size());
+  for (auto [first, size] : blocks) {
+    auto begin = std::next(pages.begin(), static_cast<std::ptrdiff_t>(first));
+    ordered.insert(ordered.end(), begin, std::next(begin, static_cast<std::ptrdiff_t>(size)));
+  }
+  pages = std::move(ordered);
+}
+
+std::size_t VirtualMemory::num_colors() const
+{
+  if (allocation.color == page_allocation_parameters::color_type::bank) {
+    const auto& mapping = dram.channels.front().address_mapping;
+    return mapping.channels() * mapping.ranks() * mapping.bankgroups() * mapping.banks();
+  }
+  return std::max<std::size_t>(1, allocation.llc_sets * BLOCK_SIZE / PAGE_SIZE);
+}
+
+std::size_t VirtualMemory::page_color(champsim::page_number page) const
+{
+  if (allocation.color == page_allocation_parameters::color_type::bank) {
+    const auto& mapping = dram.channels.front().address_mapping;
+    champsim::address addr{page};
+    auto bank = ((mapping.get_channel(addr) * mapping.ranks() + mapping.get_rank(addr)) * mapping.bankgroups() + mapping.get_bankgroup(addr)) * mapping.banks()
+                + mapping.get_bank(addr);
+    return static_cast<std::size_t>(bank);
+  }
+  return static_cast<std::size_t>(page.to<uint64_t>() % num_colors());
+}
+
+std::size_t VirtualMemory::num_free_lists() const
+{
+  switch (allocation.policy) {
+  case page_allocation_parameters::policy_type::coloring:
+    return num_colors();
+  case page_allocation_parameters::policy_type::numa:
+    return allocation.nodes;
+  default:
+    return 1;
+  }
+}
+
+std::size_t VirtualMemory::free_list_of(champsim::page_number ppage, std::size_t index, std::size_t count) const
+{
+  switch (allocation.policy) {
+  case page_allocation_parameters::policy_type::coloring:
+    return page_color(ppage);
+  case page_allocation_parameters::policy_type::numa:
+    return index * allocation.nodes / count;
+  default:
+    return 0;
+  }
+}
+
+std::size_t VirtualMemory::free_list_for(uint32_t cpu_num, champsim::page_number vaddr) const
+{
+  std::size_t preferred = 0;
+  if (allocation.policy == page_allocation_parameters::policy_type::coloring) {
+    preferred = page_color(vaddr);
+  } else if (allocation.policy == page_allocation_parameters::policy_type::numa) {
+    preferred = cpu_num % allocation.nodes;
+  }
+
+  // Fall back to the next list that has pages left
+  for (std::size_t i = 0; i < std::size(ppage_free_lists); ++i) {
+    auto list = (preferred + i) % std::size(ppage_free_lists);
+    if (!ppage_free_lists[list].empty()) {
+      return list;
+    }
+  }
+  return preferred;
 }
 
 champsim::dynamic_extent VirtualMemory::extent(std::size_t level) const
@@ -86,15 +225,15 @@ uint64_t VirtualMemory::get_offset(champsim::address vaddr, std::size_t level) c
 
 uint64_t VirtualMemory::get_offset(champsim::page_number vaddr, std::size_t level) const { return get_offset(champsim::address{vaddr}, level); }
 
-champsim::page_number VirtualMemory::ppage_front() const
+champsim::page_number VirtualMemory::ppage_front(std::size_t list) const
 {
-  assert(available_ppages() > 0);
-  return ppage_free_list.front();
+  assert(!ppage_free_lists.at(list).empty());
+  return ppage_free_lists.at(list).front();
 }
 
-void VirtualMemory::ppage_pop()
+void VirtualMemory::ppage_pop(std::size_t list)
 {
-  ppage_free_list.pop_front();
+  ppage_free_lists.at(list).pop_front();
   if (available_ppages() == 0) {
     fmt::print("[VMEM] WARNING: Out of physical memory, freeing ppages\n");
     populate_pages();
@@ -102,19 +241,32 @@ void VirtualMemory::ppage_pop()
   }
 }
 
-std::size_t VirtualMemory::available_ppages() const { return (ppage_free_list.size()); }
+std::size_t VirtualMemory::available_ppages() const
+{
+  return std::accumulate(std::begin(ppage_free_lists), std::end(ppage_free_lists), std::size_t{0},
+                         [](std::size_t acc, const auto& free_list) { return acc + free_list.size(); });
+}
 
 std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemory::va_to_pa(uint32_t cpu_num, champsim::page_number vaddr)
 {
-  auto [ppage, fault] = vpage_to_ppage_map.try_emplace({cpu_num, champsim::page_number{vaddr}}, ppage_front());
+  auto ppage = vpage_to_ppage_map.find({cpu_num, vaddr});
+  bool fault = (ppage == std::end(vpage_to_ppage_map));
 
   // this vpage doesn't yet have a ppage mapping
   if (fault) {
-    ppage_pop();
+    auto free_list = free_list_for(cpu_num, vaddr);
+    ppage = vpage_to_ppage_map.try_emplace({cpu_num, vaddr}, ppage_front(free_list)).first;
+    ppage_pop(free_list);
   }
 
   auto penalty = fault ? minor_fault_penalty : champsim::chrono::clock::duration::zero();
 
+  if (profile_params.enabled()) {
+    if (std::size(translations) <= cpu_num)
+      translations.resize(cpu_num + 1);
+    ++translations.at(cpu_num)[vaddr.to<uint64_t>()];
+  }
+
   if constexpr (champsim::debug_print) {
     fmt::print("[VMEM] {} paddr: {} vpage: {} fault: {}\n", __func__, ppage->second, champsim::page_number{vaddr}, fault);
   }
@@ -125,8 +277,9 @@ std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemor
 std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level)
 {
   if (champsim::page_offset{next_pte_page} == champsim::page_offset{0}) {
-    active_pte_page = ppage_front();
-    ppage_pop();
+    auto free_list = free_list_for(cpu_num, vaddr);
+    active_pte_page = ppage_front(free_list);
+    ppage_pop(free_list);
   }
 
   champsim::dynamic_extent pte_table_entry_extent{champsim::address::bits, shamt(level)};
@@ -154,3 +307,22 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
 
   return {paddr, penalty};
 }
+
+void VirtualMemory::clear_page_profile()
+{
+  for (auto& table : translations)
+    table.clear();
+}
+
+void VirtualMemory::write_page_profile(uint32_t cpu_num)
+{
+  if (!profile_params.enabled() || std::size(translations) <= cpu_num)
+    return;
+
+  for (const auto& [vpage, count] : translations.at(cpu_num).sorted()) {
+    auto ppage = vpage_to_ppage_map.at({cpu_num, champsim::page_number{vpage}});
+    profile_file << fmt::format("{},{},{},{}\n", cpu_num, vpage, ppage.to<uint64_t>(), count);
+  }
+  profile_file.flush();
+  translations.at(cpu_num).clear();
+}
@@ -36,10 +36,32 @@ namespace {
       return value;
     }
   };
+
+  // The tag is neither integral nor an address slice, so this selects the unpacked table
+  struct type_with_object_tag
+  {
+    unsigned int value;
+
+    struct tag_type
+    {
+      unsigned int value;
+      bool operator==(const tag_type& other) const { return value == other.value; }
+    };
+
+    auto index() const
+    {
+      return value;
+    }
+
+    auto tag() const
+    {
+      return tag_type{value};
+    }
+  };
 }
 
 TEMPLATE_TEST_CASE("An lru_table is copiable and moveable", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   STATIC_REQUIRE(std::is_copy_constructible_v<TestType>);
   STATIC_REQUIRE(std::is_move_constructible_v<TestType>);
   STATIC_REQUIRE(std::is_copy_assignable_v<TestType>);
@@ -47,7 +69,7 @@ TEMPLATE_TEST_CASE("An lru_table is copiable and moveable", "",
 }
 
 TEMPLATE_TEST_CASE("An empty lru_table misses", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("An empty lru_table") {
     TestType uut{1, 1};
 
@@ -62,7 +84,7 @@ TEMPLATE_TEST_CASE("An empty lru_table misses", "",
 }
 
 TEMPLATE_TEST_CASE("A lru_table can hit", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with one element") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{1, 1};
@@ -80,7 +102,7 @@ TEMPLATE_TEST_CASE("A lru_table can hit", "",
 }
 
 TEMPLATE_TEST_CASE("A lru_table can miss", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with one element") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{1, 1};
@@ -130,7 +152,7 @@ TEST_CASE("A lru_table of addresses can miss") {
 }
 
 TEMPLATE_TEST_CASE("A lru_table replaces LRU", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with two elements") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{1, 2};
@@ -164,7 +186,7 @@ TEMPLATE_TEST_CASE("A lru_table replaces LRU", "",
 }
 
 TEMPLATE_TEST_CASE("A lru_table exhibits set-associative behavior", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with two elements") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{2, 1};
@@ -228,7 +250,7 @@ TEMPLATE_TEST_CASE("A lru_table exhibits set-associative behavior", "",
 }
 
 TEMPLATE_TEST_CASE("A lru_table misses after invalidation", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with one element") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{1, 1};
@@ -246,7 +268,7 @@ TEMPLATE_TEST_CASE("A lru_table misses after invalidation", "",
 }
 
 TEMPLATE_TEST_CASE("A lru_table returns the evicted block on invalidation", "",
-    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>) {
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
   GIVEN("A lru_table with one element") {
     constexpr unsigned int data  = 0xcafebabe;
     TestType uut{1, 1};
@@ -263,3 +285,125 @@ TEMPLATE_TEST_CASE("A lru_table returns the evicted block on invalidation", "",
   }
 }
 
+
+TEMPLATE_TEST_CASE("A lru_table hit updates the LRU order", "",
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
+  GIVEN("A lru_table with two elements") {
+    constexpr unsigned int data  = 0xcafebabe;
+    TestType uut{1, 2};
+    uut.fill({data});
+    uut.fill({data+1});
+
+    WHEN("We check the first-added element and add a new element") {
+      uut.check_hit({data});
+      uut.fill({data+2});
+
+      THEN("A check to the first-added element hits") {
+        auto result = uut.check_hit({data});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data);
+      }
+
+      THEN("A check to the second-added element misses") {
+        auto result = uut.check_hit({data+1});
+
+        REQUIRE_FALSE(result.has_value());
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("A lru_table refill replaces the matching element", "",
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
+  GIVEN("A lru_table with two elements") {
+    constexpr unsigned int data  = 0xcafebabe;
+    TestType uut{1, 2};
+    uut.fill({data});
+    uut.fill({data+1});
+
+    WHEN("We refill the first-added element and add a new element") {
+      uut.fill({data});
+      uut.fill({data+2});
+
+      THEN("A check to the first-added element hits") {
+        auto result = uut.check_hit({data});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data);
+      }
+
+      THEN("A check to the second-added element misses") {
+        auto result = uut.check_hit({data+1});
+
+        REQUIRE_FALSE(result.has_value());
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("A lru_table fills invalidated ways first", "",
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
+  GIVEN("A lru_table with two elements, the newer of which is invalidated") {
+    constexpr unsigned int data  = 0xcafebabe;
+    TestType uut{1, 2};
+    uut.fill({data});
+    uut.fill({data+1});
+    uut.invalidate({data+1});
+
+    WHEN("We add a new element") {
+      uut.fill({data+2});
+
+      THEN("A check to the first-added element hits") {
+        auto result = uut.check_hit({data});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data);
+      }
+
+      THEN("A check to the new element hits") {
+        auto result = uut.check_hit({data+2});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data+2);
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("A lru_table with more than 64 ways can hit in every way", "",
+    (champsim::lru_table<::strong_type<unsigned int>, ::strong_type_getter, ::strong_type_getter>), champsim::lru_table<::type_with_getters>, champsim::lru_table<::type_with_object_tag>) {
+  GIVEN("A full lru_table with 128 ways") {
+    constexpr unsigned int data  = 0xcafebabe;
+    constexpr unsigned int ways = 128;
+    TestType uut{1, ways};
+    for (unsigned int i = 0; i < ways; ++i)
+      uut.fill({data+i});
+
+    THEN("Every element hits") {
+      for (unsigned int i = 0; i < ways; ++i) {
+        auto result = uut.check_hit({data+i});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data+i);
+      }
+    }
+
+    WHEN("We add a new element") {
+      uut.fill({data+ways});
+
+      THEN("A check to the first-added element misses") {
+        auto result = uut.check_hit({data});
+
+        REQUIRE_FALSE(result.has_value());
+      }
+
+      THEN("A check to the new element hits") {
+        auto result = uut.check_hit({data+ways});
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().value == data+ways);
+      }
+    }
+  }
+}
@@ -0,0 +1,47 @@
+#include <catch.hpp>
+
+#include "energy.h"
+
+TEST_CASE("The estimated energy of an array grows with its capacity and associativity") {
+  auto small = champsim::estimate_energy(champsim::data::kibibytes{32}, 8);
+  auto large = champsim::estimate_energy(champsim::data::mebibytes{2}, 8);
+  auto wide = champsim::estimate_energy(champsim::data::kibibytes{32}, 16);
+
+  REQUIRE(small.read > 0);
+  REQUIRE(small.write > small.read);
+  REQUIRE(large.read > small.read);
+  REQUIRE(large.leakage > small.leakage);
+  REQUIRE(wide.read > small.read);
+  REQUIRE(wide.leakage == Approx(small.leakage));
+}
+
+TEST_CASE("The power of a component is its energy over the time it was spent") {
+  champsim::energy_stats uut{};
+  REQUIRE(uut.power() == 0);
+
+  uut.dynamic = 600;
+  uut.leakage = 400;
+  uut.elapsed = champsim::chrono::picoseconds{1000};
+  REQUIRE(uut.total() == Approx(1000));
+  REQUIRE(uut.power() == Approx(1));
+}
+
+TEST_CASE("The energy of a phase is the difference of the energies at its ends") {
+  champsim::energy_stats begin{100, 200, champsim::chrono::picoseconds{1000}};
+  champsim::energy_stats end{400, 600, champsim::chrono::picoseconds{3000}};
+
+  auto uut = end - begin;
+  REQUIRE(uut.dynamic == Approx(300));
+  REQUIRE(uut.leakage == Approx(400));
+  REQUIRE(uut.elapsed == champsim::chrono::picoseconds{2000});
+}
+
+TEST_CASE("The energy of concurrent components adds, but their time does not") {
+  champsim::energy_stats lhs{100, 200, champsim::chrono::picoseconds{1000}};
+  champsim::energy_stats rhs{300, 400, champsim::chrono::picoseconds{1000}};
+
+  auto uut = champsim::combine_concurrent(lhs, rhs);
+  REQUIRE(uut.total() == Approx(1000));
+  REQUIRE(uut.elapsed == champsim::chrono::picoseconds{1000});
+  REQUIRE(uut.power() == Approx(1));
+}
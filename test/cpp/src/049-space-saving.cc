@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include "space_saving.h"
+
+TEST_CASE("A disabled space-saving sketch ignores its input") {
+  champsim::stats::space_saving<int> uut{};
+
+  uut.increment(1);
+  REQUIRE_FALSE(uut.enabled());
+  REQUIRE(uut.size() == 0);
+  REQUIRE(std::empty(uut.top()));
+}
+
+TEST_CASE("A space-saving sketch counts exactly while it has room") {
+  champsim::stats::space_saving<int> uut{2};
+
+  for (int i = 0; i < 3; ++i)
+    uut.increment(1, 1, 10);
+  uut.increment(2);
+  for (int i = 0; i < 5; ++i)
+    uut.increment(3);
+
+  auto top = uut.top();
+  REQUIRE(std::size(top) == 2);
+  REQUIRE(top.at(0).key == 3);
+  REQUIRE(top.at(0).count == 5);
+  REQUIRE(top.at(0).error == 0);
+  REQUIRE(top.at(1).key == 1);
+  REQUIRE(top.at(1).count == 3);
+  REQUIRE(top.at(1).weight == 30);
+}
+
+TEST_CASE("A space-saving sketch replaces its smallest key when it is full") {
+  champsim::stats::space_saving<int> uut{1};
+  REQUIRE(uut.capacity() == champsim::stats::space_saving<int>::oversampling);
+
+  for (int key = 0; key < static_cast<int>(uut.capacity()); ++key) {
+    for (int i = 0; i <= key; ++i)
+      uut.increment(key);
+  }
+  uut.increment(100);
+
+  REQUIRE(uut.size() == uut.capacity());
+  REQUIRE(uut.count_or(0, -1) == -1);
+  REQUIRE(uut.count_or(100, -1) == 2);
+}
+
+TEST_CASE("A heavy hitter is always found by a space-saving sketch") {
+  champsim::stats::space_saving<int> uut{2};
+
+  // Key 0 is a third of the stream; every other key appears once
+  for (int i = 1; i < 1000; ++i) {
+    uut.increment(i);
+    if (i % 2 == 0)
+      uut.increment(0);
+  }
+
+  auto top = uut.top();
+  REQUIRE(top.at(0).key == 0);
+  REQUIRE(top.at(0).count - top.at(0).error <= 499);
+  REQUIRE(top.at(0).count >= 499);
+}
+
+TEST_CASE("The difference of space-saving sketches subtracts the counts of common keys") {
+  champsim::stats::space_saving<int> before{2};
+  before.increment(1, 2, 20);
+
+  auto after = before;
+  after.increment(1, 3, 30);
+  after.increment(2, 4, 40);
+
+  auto uut = after - before;
+  REQUIRE(uut.count_or(1, 0) == 3);
+  REQUIRE(uut.count_or(2, 0) == 4);
+  REQUIRE(uut.top().at(1).weight == 30);
+}
@@ -0,0 +1,46 @@
+#include <catch.hpp>
+
+#include "histogram.h"
+
+TEST_CASE("A log2 histogram places samples in buckets that double in width") {
+  champsim::stats::log2_histogram uut{};
+
+  uut.add(0);
+  uut.add(1);
+  uut.add(2);
+  uut.add(3);
+  uut.add(4);
+  uut.add(1000);
+
+  REQUIRE(uut.at(0) == 1);
+  REQUIRE(uut.at(1) == 1);
+  REQUIRE(uut.at(2) == 2);
+  REQUIRE(uut.at(3) == 1);
+  REQUIRE(uut.at(10) == 1);
+  REQUIRE(uut.total() == 6);
+  REQUIRE(uut.used_buckets() == 11);
+  REQUIRE(champsim::stats::log2_histogram::lower_bound(10) == 512);
+}
+
+TEST_CASE("A log2 histogram counts very large samples in its last bucket") {
+  champsim::stats::log2_histogram uut{};
+
+  uut.add(1LL << 40);
+
+  REQUIRE(uut.at(champsim::stats::log2_histogram::num_buckets - 1) == 1);
+  REQUIRE(uut.used_buckets() == champsim::stats::log2_histogram::num_buckets);
+}
+
+TEST_CASE("A log2 histogram subtracts an earlier snapshot") {
+  champsim::stats::log2_histogram before{};
+  before.add(5);
+
+  auto after = before;
+  after.add(5);
+  after.add(100);
+
+  auto uut = after - before;
+  REQUIRE(uut.at(3) == 1);
+  REQUIRE(uut.at(7) == 1);
+  REQUIRE(uut.total() == 2);
+}
@@ -0,0 +1,66 @@
+#include <catch.hpp>
+
+#include "page_profile.h"
+
+TEST_CASE("A page counter table creates counters on first use") {
+  champsim::page_counter_table<uint64_t> uut{};
+
+  ++uut[5];
+  ++uut[5];
+  ++uut[7];
+
+  REQUIRE(uut.size() == 2);
+  REQUIRE(uut[5] == 2);
+  REQUIRE(uut[7] == 1);
+}
+
+TEST_CASE("A page counter table grows to hold many pages") {
+  champsim::page_counter_table<uint64_t> uut{4};
+
+  for (uint64_t page = 0; page < 1000; ++page)
+    uut[page * 4096] += page;
+
+  REQUIRE(uut.size() == 1000);
+  REQUIRE(4 * uut.size() <= 3 * uut.capacity());
+  for (uint64_t page = 0; page < 1000; ++page)
+    REQUIRE(uut[page * 4096] == page);
+}
+
+TEST_CASE("A page counter table lists its counters in page order") {
+  champsim::page_counter_table<uint64_t> uut{};
+
+  uut[30] = 3;
+  uut[10] = 1;
+  uut[20] = 2;
+
+  auto sorted = uut.sorted();
+  REQUIRE(std::size(sorted) == 3);
+  REQUIRE(sorted.at(0) == std::pair<uint64_t, uint64_t>{10, 1});
+  REQUIRE(sorted.at(1) == std::pair<uint64_t, uint64_t>{20, 2});
+  REQUIRE(sorted.at(2) == std::pair<uint64_t, uint64_t>{30, 3});
+}
+
+TEST_CASE("A cleared page counter table is empty, but keeps its capacity") {
+  champsim::page_counter_table<uint64_t> uut{};
+  for (uint64_t page = 0; page < 100; ++page)
+    ++uut[page];
+  auto capacity = uut.capacity();
+
+  uut.clear();
+
+  REQUIRE(uut.size() == 0);
+  REQUIRE(std::empty(uut.sorted()));
+  REQUIRE(uut.capacity() == capacity);
+  REQUIRE(uut[3] == 0);
+}
+
+TEST_CASE("Page access counts separate reads, writes and row buffer hits") {
+  page_access_counts uut{};
+  uut.add(false, true);
+  uut.add(false, false);
+  uut.add(true, true);
+
+  REQUIRE(uut.reads == 2);
+  REQUIRE(uut.writes == 1);
+  REQUIRE(uut.row_hits == 2);
+}
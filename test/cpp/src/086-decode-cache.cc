@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include "decode_cache.h"
+#include "instruction.h"
+
+namespace
+{
+input_instr trace_instr(unsigned long long ip, unsigned char dst, unsigned char src)
+{
+  input_instr i{};
+  i.ip = ip;
+  i.destination_registers[0] = dst;
+  i.source_registers[0] = src;
+  return i;
+}
+} // namespace
+
+SCENARIO("The decode cache decodes each static instruction once") {
+  GIVEN("An empty decode cache") {
+    champsim::decode_cache<input_instr> uut{16};
+
+    WHEN("A conditional branch is seen several times with different directions") {
+      auto branch = trace_instr(0x1000, champsim::REG_INSTRUCTION_POINTER, champsim::REG_FLAGS);
+      branch.source_registers[1] = champsim::REG_INSTRUCTION_POINTER;
+      branch.is_branch = true;
+
+      branch.branch_taken = true;
+      auto first = uut(0, branch);
+      branch.branch_taken = false;
+      auto second = uut(0, branch);
+
+      THEN("It is decoded once and the direction comes from the trace") {
+        REQUIRE(uut.misses == 1);
+        REQUIRE(uut.hits == 1);
+        REQUIRE(first.decode_cache_hit == false);
+        REQUIRE(second.decode_cache_hit == true);
+        REQUIRE(first.branch == BRANCH_CONDITIONAL);
+        REQUIRE(second.branch == BRANCH_CONDITIONAL);
+        REQUIRE(first.branch_taken);
+        REQUIRE_FALSE(second.branch_taken);
+      }
+    }
+
+    WHEN("Instructions with memory operands are seen twice") {
+      auto load = trace_instr(0x2000, 5, 7);
+      load.source_memory[0] = 0xdead'beef;
+      auto first = uut(0, load);
+      load.source_memory[0] = 0xcafe'babe;
+      auto second = uut(0, load);
+
+      THEN("The addresses are taken from each dynamic instruction") {
+        REQUIRE(uut.hits == 1);
+        REQUIRE(first.source_memory == std::vector{champsim::address{0xdead'beef}});
+        REQUIRE(second.source_memory == std::vector{champsim::address{0xcafe'babe}});
+        REQUIRE(second.destination_registers == std::vector<PHYSICAL_REGISTER_ID>{5});
+        REQUIRE(second.source_registers == std::vector<PHYSICAL_REGISTER_ID>{7});
+      }
+    }
+
+    WHEN("The registers of an IP change") {
+      uut(0, trace_instr(0x3000, 5, 7));
+      auto changed = uut(0, trace_instr(0x3000, champsim::REG_INSTRUCTION_POINTER, 7));
+
+      THEN("The instruction is decoded again") {
+        REQUIRE(uut.misses == 2);
+        REQUIRE(changed.branch == BRANCH_INDIRECT);
+      }
+    }
+  }
+}
+
+SCENARIO("Instructions from the decode cache match those decoded directly") {
+  GIVEN("A decode cache with a single entry") {
+    champsim::decode_cache<input_instr> uut{1};
+    const unsigned char dst = GENERATE(as<unsigned char>{}, 0, 5, champsim::REG_STACK_POINTER, champsim::REG_INSTRUCTION_POINTER);
+    const unsigned char src = GENERATE(as<unsigned char>{}, 0, 7, champsim::REG_STACK_POINTER, champsim::REG_FLAGS, champsim::REG_INSTRUCTION_POINTER);
+    const bool taken = GENERATE(true, false);
+
+    auto instr = trace_instr(0x4000, dst, src);
+    instr.source_registers[1] = champsim::REG_INSTRUCTION_POINTER;
+    instr.branch_taken = taken;
+
+    WHEN("The instruction is constructed through the cache") {
+      auto cached = uut(0, instr);
+      ooo_model_instr direct{0, instr};
+
+      THEN("The branch and registers are the same") {
+        REQUIRE(cached.branch == direct.branch);
+        REQUIRE(cached.is_branch == direct.is_branch);
+        REQUIRE(cached.branch_taken == direct.branch_taken);
+        REQUIRE(cached.destination_registers == direct.destination_registers);
+        REQUIRE(cached.source_registers == direct.source_registers);
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include <catch.hpp>
+#include <cstring>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "ooo_cpu.h"
+#include "tracereader.h"
+
+namespace
+{
+extended_instr make_extended()
+{
+  extended_instr instr{};
+  instr.ip = 0x4c00133a;
+  instr.version = EXTENDED_TRACE_VERSION;
+  return instr;
+}
+} // namespace
+
+TEST_CASE("A tracereader can read the byte representation of an extended_instr") {
+  auto first = make_extended();
+  first.destination_registers[0] = 300;
+  first.source_registers[0] = 1000;
+  first.source_memory[0] = 0x1000;
+  first.source_memory_size[0] = 8;
+
+  auto second = make_extended();
+  second.ip = 0x4c00133e;
+  second.destination_memory[0] = 0x2000;
+  second.destination_memory_size[0] = 4;
+
+  std::string trace(2 * sizeof(extended_instr), '\0');
+  std::memcpy(trace.data(), &first, sizeof(extended_instr));
+  std::memcpy(trace.data() + sizeof(extended_instr), &second, sizeof(extended_instr));
+
+  champsim::bulk_tracereader<extended_instr, std::istringstream> uut{0, std::istringstream{trace}};
+  auto inst0 = uut();
+  REQUIRE(inst0.ip == champsim::address{0x4c00133a});
+  REQUIRE_THAT(inst0.destination_registers, Catch::Matchers::RangeEquals(std::vector{300}));
+  REQUIRE_THAT(inst0.source_registers, Catch::Matchers::RangeEquals(std::vector{1000}));
+  REQUIRE_THAT(inst0.source_memory, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x1000}}));
+  REQUIRE_THAT(inst0.destination_memory, Catch::Matchers::IsEmpty());
+
+  auto inst1 = uut();
+  REQUIRE(inst1.ip == champsim::address{0x4c00133e});
+  REQUIRE_THAT(inst1.destination_memory, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x2000}}));
+  REQUIRE_THAT(inst1.source_memory, Catch::Matchers::IsEmpty());
+}
+
+TEST_CASE("An extended instruction splits the operands that cross a block") {
+  auto instr = make_extended();
+  instr.source_memory[0] = BLOCK_SIZE - 4;
+  instr.source_memory_size[0] = 8;
+
+  ooo_model_instr uut{0, instr};
+  REQUIRE_THAT(uut.source_memory, Catch::Matchers::RangeEquals(std::vector{champsim::address{BLOCK_SIZE - 4}, champsim::address{BLOCK_SIZE}}));
+}
+
+TEST_CASE("An extended instruction keeps every element of a gather") {
+  auto instr = make_extended();
+  for (std::size_t i = 0; i < NUM_EXTENDED_MEMORY_OPERANDS; ++i) {
+    instr.source_memory[i] = 0x10000 + i * BLOCK_SIZE;
+    instr.source_memory_size[i] = 4;
+  }
+
+  ooo_model_instr uut{0, instr};
+  REQUIRE(std::size(uut.source_memory) == NUM_EXTENDED_MEMORY_OPERANDS);
+}
+
+TEST_CASE("An extended instruction ignores the operands without a size") {
+  auto instr = make_extended();
+  instr.source_memory[0] = 0x1000;
+  instr.source_memory[1] = 0x2000;
+  instr.source_memory_size[1] = 8;
+
+  ooo_model_instr uut{0, instr};
+  REQUIRE_THAT(uut.source_memory, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x2000}}));
+}
+
+TEST_CASE("An extended instruction with an unknown version is rejected") {
+  auto instr = make_extended();
+  instr.version = EXTENDED_TRACE_VERSION + 1;
+  REQUIRE_THROWS_AS((ooo_model_instr{0, instr}), std::invalid_argument);
+}
+
+SCENARIO("The instruction class selects the execution latency") {
+  GIVEN("A core with a latency for each of two classes") {
+    const unsigned slow_latency = 20;
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{champsim::defaults::default_core}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .class_execute_latency({1, slow_latency})
+    };
+    uut.warmup = false;
+    uut.begin_phase();
+
+    auto instr = make_extended();
+    instr.destination_registers[0] = 300;
+    instr.source_registers[0] = 301;
+
+    WHEN("An instruction of each class is executed") {
+      ooo_model_instr fast{0, instr};
+      ooo_model_instr slow{0, instr};
+      slow.instr_class = 1;
+      ooo_model_instr unclassified{0, instr};
+      unclassified.instr_class = 2;
+
+      THEN("Each takes the latency of its class") {
+        REQUIRE(uut.execute_latency(fast) == uut.clock_period);
+        REQUIRE(uut.execute_latency(slow) == slow_latency * uut.clock_period);
+        REQUIRE(uut.execute_latency(unclassified) == uut.EXEC_LATENCY);
+      }
+    }
+  }
+}
+
+SCENARIO("A core renames registers beyond the first 256") {
+  GIVEN("A chain of instructions through a wide register") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{champsim::defaults::default_core}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+    };
+    uut.warmup = false;
+    uut.begin_phase();
+
+    auto instr = make_extended();
+    instr.destination_registers[0] = 4000;
+    instr.source_registers[0] = 4000;
+    std::vector test_instructions(4, ooo_model_instr{0, instr});
+    uint64_t id = 1;
+    for (auto& test_instr : test_instructions)
+      test_instr.instr_id = id++;
+
+    WHEN("The instructions pass through the core") {
+      uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(test_instructions), std::end(test_instructions));
+      for (std::size_t i = 0; uut.num_retired < 4 && i < 1000; i++) {
+        for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+          op->_operate();
+      }
+
+      THEN("They all retire") {
+        REQUIRE(uut.num_retired == 4);
+      }
+    }
+  }
+}
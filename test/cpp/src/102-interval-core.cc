@@ -0,0 +1,161 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+
+namespace
+{
+struct interval_harness {
+  do_nothing_MRC mock_L1I, mock_L1D;
+  O3_CPU uut;
+
+  explicit interval_harness(unsigned data_latency)
+      : mock_L1I{}, mock_L1D{static_cast<int>(data_latency)}, uut{champsim::core_builder{champsim::defaults::default_core}
+                                                                     .model(champsim::core_model::interval)
+                                                                     .fetch_queues(&mock_L1I.queues)
+                                                                     .data_queues(&mock_L1D.queues)}
+  {
+    uut.warmup = false;
+    uut.begin_phase();
+  }
+
+  long run(std::vector<ooo_model_instr> instrs)
+  {
+    // The window finds instructions by their id
+    uint64_t id = 1;
+    for (auto& instr : instrs)
+      instr.instr_id = id++;
+    uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(instrs), std::end(instrs));
+    long cycles = 0;
+    for (; static_cast<std::size_t>(uut.num_retired) < std::size(instrs) && cycles < 10000; ++cycles) {
+      for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+        op->_operate();
+    }
+    return cycles;
+  }
+};
+} // namespace
+
+SCENARIO("The interval core retires instructions") {
+  GIVEN("An interval core") {
+    interval_harness harness{1};
+
+    WHEN("Independent instructions are added to the core") {
+      std::vector<ooo_model_instr> instrs{};
+      for (uint8_t i = 0; i < 8; ++i)
+        instrs.push_back(champsim::test::instruction_with_registers(static_cast<uint8_t>(i + 10)));
+      harness.run(instrs);
+
+      THEN("All instructions retire and the dispatch cycles are counted") {
+        REQUIRE(harness.uut.num_retired == 8);
+        REQUIRE(harness.uut.sim_stats.interval_dispatch_cycles > 0);
+        REQUIRE(std::empty(harness.uut.ROB));
+      }
+    }
+  }
+}
+
+SCENARIO("The interval core serializes dependent instructions") {
+  GIVEN("Two interval cores") {
+    interval_harness independent_harness{1};
+    interval_harness dependent_harness{1};
+
+    WHEN("One runs a chain of dependent instructions and the other runs independent instructions") {
+      std::vector<ooo_model_instr> independent{};
+      for (uint8_t i = 0; i < 8; ++i)
+        independent.push_back(champsim::test::instruction_with_registers(static_cast<uint8_t>(i + 10)));
+      std::vector dependent(8, champsim::test::instruction_with_registers(10));
+
+      auto independent_cycles = independent_harness.run(independent);
+      auto dependent_cycles = dependent_harness.run(dependent);
+
+      THEN("The dependent chain takes longer") {
+        REQUIRE(independent_harness.uut.num_retired == 8);
+        REQUIRE(dependent_harness.uut.num_retired == 8);
+        REQUIRE(dependent_cycles > independent_cycles);
+      }
+    }
+  }
+}
+
+SCENARIO("The interval core overlaps independent loads") {
+  GIVEN("An interval core with a slow data cache") {
+    const unsigned data_latency = 50;
+    interval_harness harness{data_latency};
+
+    WHEN("Several independent loads are added to the core") {
+      std::vector<ooo_model_instr> instrs{};
+      for (uint64_t i = 0; i < 4; ++i)
+        instrs.push_back(champsim::test::instruction_with_ip_and_source_memory(champsim::address{1}, champsim::address{0x1000 + 0x100 * i}));
+      auto cycles = harness.run(instrs);
+
+      THEN("The misses overlap") {
+        REQUIRE(harness.uut.num_retired == 4);
+        REQUIRE(harness.mock_L1D.packet_count() == 4);
+        REQUIRE(cycles < 2 * data_latency);
+      }
+    }
+  }
+}
+
+SCENARIO("The interval core completes a load only with the responses to its own reads") {
+  GIVEN("An interval core with a slow data cache") {
+    const unsigned data_latency = 50;
+    interval_harness harness{data_latency};
+
+    WHEN("An older load reads a block that a younger load forwards from a store, while the younger load waits on its other read") {
+      auto store = champsim::test::instruction_with_ip(1);
+      store.destination_memory.push_back(champsim::address{0x1000});
+
+      // The younger load reads its other operand only after a chain of dependent instructions
+      const std::size_t chain_length = 20;
+      auto load = champsim::test::instruction_with_ip_and_source_memory(champsim::address{1}, champsim::address{0x1000});
+      load.source_memory.push_back(champsim::address{0x2000});
+      load.source_registers.push_back(10);
+
+      std::vector<ooo_model_instr> instrs{champsim::test::instruction_with_ip_and_source_memory(champsim::address{1}, champsim::address{0x1000}), store};
+      instrs.insert(std::end(instrs), chain_length, champsim::test::instruction_with_registers(10));
+      instrs.push_back(load);
+      auto cycles = harness.run(instrs);
+
+      THEN("The response to the older load does not complete the younger load") {
+        REQUIRE(harness.uut.num_retired == static_cast<long long>(std::size(instrs)));
+        REQUIRE(cycles > static_cast<long>(chain_length + data_latency));
+      }
+    }
+  }
+}
+
+SCENARIO("The interval core skips its stages while it waits on memory") {
+  GIVEN("An interval core with a slow data cache") {
+    const unsigned data_latency = 50;
+    interval_harness harness{data_latency};
+
+    WHEN("A load is issued and the core has nothing else to do") {
+      auto load = champsim::test::instruction_with_ip_and_source_memory(champsim::address{1}, champsim::address{0x1000});
+      load.instr_id = 1;
+      harness.uut.IFETCH_BUFFER.push_back(load);
+      for (auto i = 0; i < 10; ++i) {
+        for (auto op : std::array<champsim::operable*, 3>{{&harness.uut, &harness.mock_L1I, &harness.mock_L1D}})
+          op->_operate();
+      }
+
+      THEN("The core sleeps until the response arrives") {
+        REQUIRE(harness.mock_L1D.packet_count() == 1);
+        REQUIRE(harness.uut.interval_wake_time == champsim::chrono::clock::time_point::max());
+      }
+
+      AND_WHEN("The response arrives") {
+        for (auto i = 0; i < 2 * static_cast<int>(data_latency) && harness.uut.num_retired == 0; ++i) {
+          for (auto op : std::array<champsim::operable*, 3>{{&harness.uut, &harness.mock_L1I, &harness.mock_L1D}})
+            op->_operate();
+        }
+
+        THEN("The load retires") {
+          REQUIRE(harness.uut.num_retired == 1);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+
+namespace
+{
+struct in_order_harness {
+  do_nothing_MRC mock_L1I, mock_L1D;
+  O3_CPU uut;
+
+  in_order_harness(champsim::core_model model, unsigned data_latency)
+      : mock_L1I{}, mock_L1D{static_cast<int>(data_latency)}, uut{champsim::core_builder{champsim::defaults::default_core}
+                                                                     .model(model)
+                                                                     .fetch_queues(&mock_L1I.queues)
+                                                                     .data_queues(&mock_L1D.queues)}
+  {
+    uut.warmup = false;
+    uut.begin_phase();
+  }
+
+  long run(std::vector<ooo_model_instr> instrs)
+  {
+    // The window finds instructions by their id
+    uint64_t id = 1;
+    for (auto& instr : instrs)
+      instr.instr_id = id++;
+    uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(instrs), std::end(instrs));
+    long cycles = 0;
+    for (; static_cast<std::size_t>(uut.num_retired) < std::size(instrs) && cycles < 10000; ++cycles) {
+      for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+        op->_operate();
+    }
+    return cycles;
+  }
+};
+
+ooo_model_instr load_to_register(uint64_t addr, PHYSICAL_REGISTER_ID reg)
+{
+  auto instr = champsim::test::instruction_with_ip_and_source_memory(champsim::address{1}, champsim::address{addr});
+  instr.destination_registers.push_back(reg);
+  return instr;
+}
+} // namespace
+
+SCENARIO("The in-order core stalls only when a loaded value is used") {
+  GIVEN("An in-order core with a slow data cache") {
+    const unsigned data_latency = 50;
+    in_order_harness harness{champsim::core_model::in_order, data_latency};
+
+    WHEN("A load is followed by an instruction that uses its value") {
+      auto cycles = harness.run({load_to_register(0x1000, 10), champsim::test::instruction_with_registers(10)});
+
+      THEN("The use waits for the load") {
+        REQUIRE(harness.uut.num_retired == 2);
+        REQUIRE(harness.uut.sim_stats.in_order_use_stall_cycles > 0);
+        REQUIRE(cycles >= data_latency);
+      }
+    }
+
+    WHEN("A load is followed by an independent instruction") {
+      harness.run({load_to_register(0x1000, 10), champsim::test::instruction_with_registers(20)});
+
+      THEN("The independent instruction issues without stalling") {
+        REQUIRE(harness.uut.num_retired == 2);
+        REQUIRE(harness.uut.sim_stats.in_order_issue_cycles > 0);
+        REQUIRE(harness.uut.sim_stats.in_order_use_stall_cycles == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A stalled instruction in the in-order core blocks younger instructions") {
+  GIVEN("An in-order core and an interval core with slow data caches") {
+    const unsigned data_latency = 50;
+    in_order_harness in_order{champsim::core_model::in_order, data_latency};
+    in_order_harness interval{champsim::core_model::interval, data_latency};
+
+    WHEN("A load and its use are followed by independent loads") {
+      std::vector<ooo_model_instr> instrs{load_to_register(0x1000, 10), champsim::test::instruction_with_registers(10)};
+      for (uint64_t i = 1; i < 4; ++i)
+        instrs.push_back(load_to_register(0x1000 + 0x100 * i, static_cast<PHYSICAL_REGISTER_ID>(20 + i)));
+
+      auto in_order_cycles = in_order.run(instrs);
+      auto interval_cycles = interval.run(instrs);
+
+      THEN("Only the interval core overlaps the loads") {
+        REQUIRE(in_order.uut.num_retired == 5);
+        REQUIRE(interval.uut.num_retired == 5);
+        REQUIRE(interval_cycles < 2 * data_latency);
+        REQUIRE(in_order_cycles >= 2 * data_latency);
+      }
+    }
+  }
+}
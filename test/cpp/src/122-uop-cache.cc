@@ -0,0 +1,198 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "ooo_cpu.h"
+#include "instr.h"
+#include "uop_cache.h"
+
+SCENARIO("The micro-op cache limits the micro-ops in a window") {
+  GIVEN("A micro-op cache with two micro-ops per line and two ways per window") {
+    champsim::uop_cache uut{1, 4, 32, 2, 2};
+
+    WHEN("A window is filled to its capacity") {
+      bool success = true;
+      for (uint64_t i = 0; i < 4; ++i)
+        success = uut.fill(champsim::address{0x1000 + 4 * i}) && success;
+
+      THEN("The window hits") {
+        REQUIRE(success);
+        REQUIRE(uut.check_hit(champsim::address{0x1000}));
+      }
+
+      AND_WHEN("Another micro-op is placed in the window") {
+        auto overflow = uut.fill(champsim::address{0x1010});
+
+        THEN("The window is removed") {
+          REQUIRE_FALSE(overflow);
+          REQUIRE_FALSE(uut.check_hit(champsim::address{0x1000}));
+        }
+      }
+    }
+  }
+
+  GIVEN("A micro-op cache with no limit on micro-ops") {
+    champsim::uop_cache uut{1, 4, 32};
+
+    WHEN("Many micro-ops are placed in one window") {
+      bool success = true;
+      for (uint64_t i = 0; i < 32; ++i)
+        success = uut.fill(champsim::address{0x1000 + i}) && success;
+
+      THEN("The window is kept") {
+        REQUIRE(success);
+        REQUIRE(uut.check_hit(champsim::address{0x1000}));
+      }
+    }
+  }
+}
+
+SCENARIO("The micro-op cache counts each instruction of a window once") {
+  GIVEN("A micro-op cache with two micro-ops per line and one way per window") {
+    champsim::uop_cache uut{1, 4, 32, 2, 1};
+
+    WHEN("The same two instructions are placed many times") {
+      bool success = true;
+      for (auto i = 0; i < 10; ++i) {
+        success = uut.fill(champsim::address{0x1000}) && success;
+        success = uut.fill(champsim::address{0x1004}) && success;
+      }
+
+      THEN("The window still fits in its line") {
+        REQUIRE(success);
+        REQUIRE(uut.check_hit(champsim::address{0x1000}));
+      }
+
+      AND_WHEN("A third instruction is placed in the window") {
+        auto overflow = uut.fill(champsim::address{0x1008});
+
+        THEN("The window is removed") {
+          REQUIRE_FALSE(overflow);
+          REQUIRE_FALSE(uut.check_hit(champsim::address{0x1000}));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The micro-op cache removes the windows of a block") {
+  GIVEN("A micro-op cache with windows from two blocks") {
+    champsim::uop_cache uut{8, 4, 16, 6, 3};
+    uut.fill(champsim::address{0x1000});
+    uut.fill(champsim::address{0x1010});
+    uut.fill(champsim::address{0x2000});
+
+    WHEN("The first block is invalidated") {
+      auto removed = uut.invalidate(champsim::block_number{champsim::address{0x1000}});
+
+      THEN("Only the windows in that block are removed") {
+        REQUIRE(removed == 2);
+        REQUIRE_FALSE(uut.check_hit(champsim::address{0x1000}));
+        REQUIRE_FALSE(uut.check_hit(champsim::address{0x1010}));
+        REQUIRE(uut.check_hit(champsim::address{0x2000}));
+      }
+    }
+  }
+}
+
+SCENARIO("A cache reports the blocks that leave it") {
+  GIVEN("A cache with an eviction listener and a resident block") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1i}
+      .name("122-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+    std::deque<champsim::address> evictions{};
+    uut.eviction_listeners.push_back(&evictions);
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    champsim::address addr{0xcafebabe};
+    decltype(mock_ul)::request_type load;
+    load.address = addr;
+    load.v_address = addr;
+    load.cpu = 0;
+    mock_ul.issue(load);
+
+    for (auto i = 0; i < 100; ++i)
+      for (auto elem : elements)
+        elem->_operate();
+
+    WHEN("The block is invalidated") {
+      uut.invalidate_entry(addr);
+
+      THEN("The listener receives its virtual address") {
+        REQUIRE(std::size(evictions) == 1);
+        REQUIRE(champsim::block_number{evictions.front()} == champsim::block_number{addr});
+      }
+    }
+  }
+}
+
+SCENARIO("Switching between the decoders and the DIB costs a penalty") {
+  GIVEN("A core that has decoded an instruction") {
+    const unsigned int penalty = GENERATE(0u, 3u);
+    const unsigned int decode_latency = 4;
+    const unsigned int fetch_latency = 3;
+    do_nothing_MRC mock_L1I{fetch_latency}, mock_L1D;
+
+    O3_CPU uut{champsim::core_builder{champsim::defaults::default_core}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .decode_latency(decode_latency)
+      .dib_switch_penalty(penalty)
+      .fetch_width(champsim::bandwidth::maximum_type{1})
+    };
+    uut.warmup = false;
+    uut.begin_phase();
+    std::vector test_instructions(1, champsim::test::instruction_with_ip(1));
+
+    auto run = [&](long long target) {
+      for (std::size_t i = 0; uut.num_retired < target && i < 200; i++) {
+        for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+          op->_operate();
+      }
+    };
+
+    uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(test_instructions), std::end(test_instructions));
+    run(1);
+    auto first_time = uut.current_time - uut.begin_phase_time;
+
+    WHEN("The instruction passes through the core a second time") {
+      auto begin_second_time = uut.current_time;
+      uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(test_instructions), std::end(test_instructions));
+      run(2);
+      auto second_time = uut.current_time - begin_second_time;
+
+      THEN("The delivery is counted and the penalty is paid") {
+        REQUIRE(uut.num_retired == 2);
+        REQUIRE(uut.sim_stats.dib_lookups == 2);
+        REQUIRE(uut.sim_stats.dib_hits == 1);
+        REQUIRE(uut.sim_stats.decoder_uops_delivered == 1);
+        REQUIRE(uut.sim_stats.dib_uops_delivered == 1);
+        REQUIRE(uut.sim_stats.dib_switches == 1);
+        // A hit in the DIB skips the fetch and decode latencies
+        REQUIRE((second_time - (first_time - (fetch_latency + decode_latency) * uut.clock_period)) / uut.clock_period == penalty);
+      }
+    }
+
+    WHEN("The L1I reports that the block was evicted") {
+      uut.l1i_evictions.push_back(champsim::address{1});
+      uut.IFETCH_BUFFER.insert(std::end(uut.IFETCH_BUFFER), std::begin(test_instructions), std::end(test_instructions));
+      run(2);
+
+      THEN("The instruction misses in the DIB") {
+        REQUIRE(uut.num_retired == 2);
+        REQUIRE(uut.sim_stats.dib_inclusion_invalidations == 1);
+        REQUIRE(uut.sim_stats.dib_hits == 0);
+      }
+    }
+  }
+}
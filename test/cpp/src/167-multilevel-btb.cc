@@ -0,0 +1,139 @@
+#include <catch.hpp>
+
+#include "../../../btb/basic_btb/basic_btb.h"
+#include "instruction.h"
+#include "ooo_cpu.h"
+
+SCENARIO("A multi-level BTB finds entries evicted from its first level") {
+  GIVEN("A two-level BTB with a small first level") {
+    direct_predictor uut{{{1, 2, 0}, {64, 4, 3}}};
+    const champsim::address target{0x66b5f0};
+    const champsim::address first_ip{0x110000};
+    const champsim::address same_block_ip{0x110010};
+    const champsim::address other_ip{0x220000};
+
+    WHEN("More branches are seen than fit in the first level") {
+      uut.update(first_ip, target, BRANCH_DIRECT_JUMP);
+      uut.update(other_ip, target, BRANCH_DIRECT_JUMP);
+      uut.update(same_block_ip, target, BRANCH_DIRECT_JUMP);
+
+      THEN("The evicted branch is found in the second level with its latency") {
+        auto result = uut.check_hit(first_ip);
+        REQUIRE(result.has_value());
+        CHECK(result->level == 1);
+        CHECK(result->latency == 3);
+        CHECK(result->entry.target == target);
+
+        AND_THEN("The branch is promoted into the first level") {
+          auto promoted = uut.check_hit(first_ip);
+          REQUIRE(promoted.has_value());
+          CHECK(promoted->level == 0);
+          CHECK(promoted->latency == 0);
+        }
+      }
+
+      AND_WHEN("The block holding the evicted branch is prefetched") {
+        auto prefetched = uut.prefetch(champsim::block_number{first_ip});
+
+        THEN("Only the missing branch is placed in the first level") {
+          CHECK(prefetched == 1);
+          auto result = uut.check_hit(first_ip);
+          REQUIRE(result.has_value());
+          CHECK(result->level == 0);
+        }
+      }
+    }
+
+    WHEN("A block with no known branches is prefetched") {
+      THEN("Nothing is placed in the BTB") {
+        CHECK(uut.prefetch(champsim::block_number{first_ip}) == 0);
+        CHECK_FALSE(uut.check_hit(first_ip).has_value());
+      }
+    }
+  }
+}
+
+SCENARIO("The basic_btb counts fetch bubbles from its slower levels") {
+  GIVEN("A basic_btb with a two-level hierarchy") {
+    basic_btb uut{{{1, 1, 0}, {64, 4, 2}}};
+    const champsim::address target{0x66b5f0};
+    const champsim::address first_ip{0x110000};
+    const champsim::address second_ip{0x220000};
+
+    uut.update_btb(first_ip, target, true, BRANCH_DIRECT_JUMP);
+    uut.update_btb(second_ip, target, true, BRANCH_DIRECT_JUMP);
+
+    WHEN("The evicted branch is predicted") {
+      auto [predicted_target, always_taken] = uut.btb_prediction(first_ip);
+
+      THEN("The prediction is correct and the bubble is counted") {
+        CHECK(predicted_target == target);
+        CHECK(always_taken);
+        CHECK(uut.stats.level_hits.at(1) == 1);
+        CHECK(uut.stats.bubble_cycles == 2);
+      }
+
+      AND_WHEN("The branch is predicted again") {
+        uut.btb_prediction(first_ip);
+
+        THEN("It hits in the first level without a bubble") {
+          CHECK(uut.stats.level_hits.at(0) == 1);
+          CHECK(uut.stats.bubble_cycles == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The basic_btb takes its organization from the core") {
+  GIVEN("A core configured with a five-level BTB that prefetches from the L1I") {
+    const std::vector<champsim::btb_level> levels{{1, 1, 0}, {1, 1, 1}, {1, 1, 2}, {1, 1, 3}, {64, 4, 4}};
+    O3_CPU cpu{champsim::core_builder{}.btb_levels(levels).set_btb_prefetch_from_l1i()};
+    basic_btb uut{&cpu};
+
+    THEN("The BTB has every level, and counts hits in each") {
+      CHECK(std::size(uut.stats.level_hits) == std::size(levels));
+    }
+
+    WHEN("A branch is evicted into the last level, and its block is then fetched") {
+      const champsim::address target{0x66b5f0};
+      const champsim::address ip{0x110000};
+      uut.update_btb(ip, target, true, BRANCH_DIRECT_JUMP);
+      for (uint64_t i = 1; i <= 4; ++i)
+        uut.update_btb(champsim::address{0x110000 + i * 0x10000}, target, true, BRANCH_DIRECT_JUMP);
+      uut.prefetch_btb(ip);
+
+      THEN("The branch is placed in the first level") {
+        CHECK(uut.stats.prefetched == 1);
+        uut.btb_prediction(ip);
+        CHECK(uut.stats.level_hits.at(0) == 1);
+      }
+    }
+  }
+
+  GIVEN("A core with no BTB organization") {
+    O3_CPU cpu{champsim::core_builder{}};
+    basic_btb uut{&cpu};
+
+    THEN("The BTB has its default single level, and does not prefetch") {
+      CHECK(std::size(uut.stats.level_hits) == 1);
+      uut.prefetch_btb(champsim::address{0x110000});
+      CHECK(uut.stats.prefetched == 0);
+    }
+  }
+}
+
+SCENARIO("A slower BTB level stalls fetch in warmup as well") {
+  GIVEN("A core in warmup") {
+    O3_CPU cpu{champsim::core_builder{}};
+    cpu.warmup = true;
+
+    WHEN("A fetch bubble is inserted") {
+      cpu.insert_fetch_bubble(3);
+
+      THEN("Fetch resumes after the bubble") {
+        CHECK(cpu.fetch_resume_time == cpu.current_time + 3 * cpu.clock_period);
+      }
+    }
+  }
+}
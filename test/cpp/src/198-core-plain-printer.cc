@@ -108,3 +108,48 @@ TEST_CASE("The ROB occupancy modifies the flush penalty") {
 
   REQUIRE_THAT(champsim::plain_printer::format(given), Catch::Matchers::RangeEquals(expected));
 }
+
+TEST_CASE("A core that has spent energy prints its energy and power") {
+  cpu_stats given{};
+  given.name = "test_cpu";
+  given.energy.dynamic = 3000;
+  given.energy.leakage = 1000;
+  given.energy.elapsed = champsim::chrono::picoseconds{2000};
+
+  std::vector<std::string> expected{
+    "test_cpu cumulative IPC: - instructions: 0 cycles: 0",
+    "test_cpu Branch Prediction Accuracy: -% MPKI: - Average ROB Occupancy at Mispredict: -",
+    "Branch type MPKI",
+    "BRANCH_DIRECT_JUMP: -",
+    "BRANCH_INDIRECT: -",
+    "BRANCH_CONDITIONAL: -",
+    "BRANCH_DIRECT_CALL: -",
+    "BRANCH_INDIRECT_CALL: -",
+    "BRANCH_RETURN: -",
+    "test_cpu ENERGY DYNAMIC: 3 nJ LEAKAGE: 1 nJ POWER: 2 W"
+  };
+
+  REQUIRE_THAT(champsim::plain_printer::format(given), Catch::Matchers::RangeEquals(expected));
+}
+
+TEST_CASE("A core that read its trace through a decode cache prints the decode cache hit rate") {
+  cpu_stats given{};
+  given.name = "test_cpu";
+  given.decode_cache_hits = 3;
+  given.decode_cache_misses = 1;
+
+  std::vector<std::string> expected{
+    "test_cpu cumulative IPC: - instructions: 0 cycles: 0",
+    "test_cpu Branch Prediction Accuracy: -% MPKI: - Average ROB Occupancy at Mispredict: -",
+    "Branch type MPKI",
+    "BRANCH_DIRECT_JUMP: -",
+    "BRANCH_INDIRECT: -",
+    "BRANCH_CONDITIONAL: -",
+    "BRANCH_DIRECT_CALL: -",
+    "BRANCH_INDIRECT_CALL: -",
+    "BRANCH_RETURN: -",
+    "test_cpu Decode cache hit rate: 75% hits: 3 misses: 1"
+  };
+
+  REQUIRE_THAT(champsim::plain_printer::format(given), Catch::Matchers::RangeEquals(expected));
+}
@@ -64,3 +64,36 @@ SCENARIO("The core issues loads only after its registers are finished") {
 }
 
 
+
+SCENARIO("The core retires an instruction with more loads than its load queue holds") {
+  GIVEN("A core with a small load queue") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .lq_size(2)
+      .sq_size(2)
+    };
+    uut.warmup = false;
+
+    WHEN("An instruction with more memory operands than the queues is added to the core") {
+      auto gather = champsim::test::instruction_with_ip_and_source_memory(champsim::address{2004}, champsim::address{0xcafe0000});
+      for (uint64_t i = 1; i < 4; ++i) {
+        gather.source_memory.push_back(champsim::address{0xcafe0000 + 0x1000 * i});
+        gather.destination_memory.push_back(champsim::address{0xbeef0000 + 0x1000 * i});
+      }
+      gather.instr_id = 1;
+      uut.input_queue.push_back(gather);
+
+      for (int i = 0; i < 10000 && uut.num_retired < 1; ++i) {
+        for (auto op : std::array<champsim::operable*,3>{{&uut, &mock_L1I, &mock_L1D}})
+          op->_operate();
+      }
+
+      THEN("The operands beyond the size of the queues are dropped, and the instruction retires") {
+        REQUIRE(uut.num_retired == 1);
+        REQUIRE(mock_L1D.packet_count() <= 4);
+      }
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A sectored cache fetches only the sector that missed") {
+  GIVEN("A cache with 128-byte blocks in two sectors") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409a-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .offset_bits(champsim::data::bits{7})
+      .sectors(2)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul.issue(make_packet(0x1000));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The other sector of the block is read") {
+      mock_ul.issue(make_packet(0x1040));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Only that sector is fetched") {
+        REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x1000}, champsim::address{0x1040}}));
+        REQUIRE(uut.sim_stats.sector_misses == 1);
+      }
+
+      AND_WHEN("Both sectors are read again") {
+        mock_ul.issue(make_packet(0x1000));
+        mock_ul.issue(make_packet(0x1040));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("Both sectors hit") {
+          REQUIRE(mock_ll.packet_count() == 2);
+          REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0u}, 0) == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A sectored cache writes back only its dirty sectors") {
+  GIVEN("A single-block cache with 128-byte blocks in two sectors") {
+    do_nothing_MRC mock_ll;
+    to_wq_MRP mock_ul_seed;
+    to_rq_MRP mock_ul_test;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409b-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({{&mock_ul_seed.queues, &mock_ul_test.queues}})
+      .lower_level(&mock_ll.queues)
+      .offset_bits(champsim::data::bits{7})
+      .sectors(2)
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul_seed, &mock_ul_test}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul_seed.issue(make_packet(0x1040, access_type::WRITE));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The block is evicted") {
+      mock_ul_test.issue(make_packet(0x2000));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Only the written sector is sent to the lower level") {
+        REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}), Catch::Matchers::UnorderedEquals(std::vector{champsim::address{0x2000}, champsim::address{0x1040}}));
+      }
+    }
+  }
+}
+
+SCENARIO("A cache splits its misses into the blocks of the lower level") {
+  GIVEN("A cache with 128-byte blocks above a level with 64-byte blocks") {
+    do_nothing_MRC mock_ll;
+    mock_ll.queues = champsim::channel{32, 32, 32, champsim::data::bits{6}, false};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409c-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .offset_bits(champsim::data::bits{7})
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A block misses") {
+      mock_ul.issue(make_packet(0x1048));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Both halves of the block are fetched, and the miss is returned once") {
+        REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}), Catch::Matchers::UnorderedEquals(std::vector{champsim::address{0x1000}, champsim::address{0x1048}}));
+        REQUIRE(std::size(mock_ul.packets) == 1);
+        REQUIRE(mock_ul.packets.front().return_time > 0);
+        REQUIRE(uut.sim_stats.mshr_return.total() == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A response from a lower level with larger blocks completes every miss within it") {
+  GIVEN("A cache with 64-byte blocks above a level with 128-byte blocks") {
+    do_nothing_MRC mock_ll{10};
+    mock_ll.queues = champsim::channel{32, 32, 32, champsim::data::bits{7}, false};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409d-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Both halves of the lower block miss") {
+      mock_ul.issue(make_packet(0x1000));
+      mock_ul.issue(make_packet(0x1040));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Both misses are returned") {
+        REQUIRE(std::size(mock_ul.packets) == 2);
+        REQUIRE(mock_ul.packets.at(0).return_time > 0);
+        REQUIRE(mock_ul.packets.at(1).return_time > 0);
+        REQUIRE(std::empty(uut.MSHR));
+      }
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A victim cache holds the blocks evicted from the main array") {
+  GIVEN("A single-block cache with a victim cache") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("416a-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .victim_cache(2)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul.issue(make_packet(0x1000));
+    run(std::begin(elements), std::end(elements), 100);
+    mock_ul.issue(make_packet(0x2000));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The evicted block is read again") {
+      mock_ul.issue(make_packet(0x1000));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("It hits in the victim cache and is moved back into the main array") {
+        REQUIRE(mock_ll.packet_count() == 2);
+        REQUIRE(uut.sim_stats.victim_hits == 1);
+        REQUIRE(uut.sim_stats.victim_promotions == 1);
+        REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0u}, 0) == 1);
+      }
+
+      AND_WHEN("The block it displaced is read again") {
+        mock_ul.issue(make_packet(0x2000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("The two blocks have swapped places") {
+          REQUIRE(mock_ll.packet_count() == 2);
+          REQUIRE(uut.sim_stats.victim_hits == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A victim cache writes back the dirty blocks that leave it") {
+  GIVEN("A single-block cache with a one-block victim cache, holding a written block") {
+    do_nothing_MRC mock_ll;
+    to_wq_MRP mock_ul_seed;
+    to_rq_MRP mock_ul_test;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("416b-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({{&mock_ul_seed.queues, &mock_ul_test.queues}})
+      .lower_level(&mock_ll.queues)
+      .victim_cache(1)
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul_seed, &mock_ul_test}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul_seed.issue(make_packet(0x1000, access_type::WRITE));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The block is evicted from the main array") {
+      mock_ul_test.issue(make_packet(0x2000));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("It is not yet written back") {
+        REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x2000}}));
+      }
+
+      AND_WHEN("It is evicted from the victim cache") {
+        mock_ul_test.issue(make_packet(0x3000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("It is written back") {
+          REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}),
+                       Catch::Matchers::UnorderedEquals(std::vector{champsim::address{0x2000}, champsim::address{0x3000}, champsim::address{0x1000}}));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("Prefetches may not take the MSHRs reserved for demand misses") {
+  GIVEN("A cache with four MSHRs, two of which are reserved for demand misses") {
+    release_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("417a-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .mshr_size(4)
+      .mshr_demand_reserve(2)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Four blocks are prefetched") {
+      for (uint64_t i = 0; i < 4; ++i)
+        REQUIRE(uut.prefetch_line(champsim::address{0x10000 + i * BLOCK_SIZE}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Only two MSHRs are allocated, and the others wait") {
+        REQUIRE(uut.get_mshr_occupancy() == 2);
+        REQUIRE(mock_ll.packet_count() == 2);
+        REQUIRE(uut.sim_stats.mshr_full.value_or(std::pair{access_type::PREFETCH, 0u}, 0) > 0);
+      }
+
+      AND_WHEN("Demand misses arrive") {
+        mock_ul.issue(make_packet(0x20000, access_type::LOAD));
+        mock_ul.issue(make_packet(0x30000, access_type::LOAD));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("They take the reserved MSHRs") {
+          REQUIRE(uut.get_mshr_occupancy() == 4);
+          REQUIRE(uut.sim_stats.mshr_full.value_or(std::pair{access_type::LOAD, 0u}, 0) == 0);
+        }
+      }
+    }
+  }
+
+  GIVEN("A cache with four MSHRs, of which prefetches may hold one") {
+    release_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("417b-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .mshr_size(4)
+      .mshr_prefetch_limit(1)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two blocks are prefetched") {
+      REQUIRE(uut.prefetch_line(champsim::address{0x10000}, true, 0));
+      REQUIRE(uut.prefetch_line(champsim::address{0x20000}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("Only one MSHR is allocated") {
+        REQUIRE(uut.get_mshr_occupancy() == 1);
+      }
+
+      AND_WHEN("The first prefetch returns") {
+        mock_ll.release_all();
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("The second prefetch is issued") {
+          REQUIRE(mock_ll.packet_count() == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Demand requests may begin their tag checks ahead of prefetches") {
+  auto demand_priority = GENERATE(true, false);
+  GIVEN("A cache that checks one tag each cycle, " + std::string{demand_priority ? "with" : "without"} + " demand priority") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul_load;
+    to_pq_MRP mock_ul_prefetch;
+    champsim::cache_builder builder{champsim::defaults::default_l2c};
+    builder.name("417c-uut")
+        .upper_levels({{&mock_ul_load.queues, &mock_ul_prefetch.queues}})
+        .lower_level(&mock_ll.queues)
+        .tag_bandwidth(champsim::bandwidth::maximum_type{1})
+        .hit_latency(1);
+    if (demand_priority)
+      builder.set_demand_priority();
+    CACHE uut{builder};
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul_load, &mock_ul_prefetch}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A load and a prefetch arrive from different upper levels in the same cycle") {
+      mock_ul_load.issue(make_packet(0x10000, access_type::LOAD));
+      mock_ul_prefetch.issue(make_packet(0x20000, access_type::PREFETCH));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The load is sent to the lower level first only if demands have priority") {
+        REQUIRE(std::size(mock_ll.addresses) == 2);
+        REQUIRE((mock_ll.addresses.front() == champsim::address{0x10000}) == demand_priority);
+      }
+    }
+  }
+}
@@ -0,0 +1,215 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A write-through cache sends every write to the lower level") {
+  GIVEN("A write-through cache holding a block") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul_read;
+    to_wq_MRP mock_ul_write;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("418a-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({{&mock_ul_read.queues, &mock_ul_write.queues}})
+      .lower_level(&mock_ll.queues)
+      .set_write_through()
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul_read, &mock_ul_write}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul_read.issue(make_packet(0x1000));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The block is written") {
+      mock_ul_write.issue(make_packet(0x1000, access_type::WRITE));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The write is sent on, and the block stays clean") {
+        REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::WRITE, 0u}, 0) == 1);
+        REQUIRE(mock_ll.packet_count() == 2);
+        REQUIRE(uut.sim_stats.wb_write_through == 1);
+        REQUIRE(uut.block.front().valid);
+        REQUIRE_FALSE(uut.block.front().dirty);
+      }
+
+      AND_WHEN("The block is evicted") {
+        mock_ul_read.issue(make_packet(0x2000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("It is not written back again") {
+          REQUIRE(mock_ll.packet_count() == 3);
+          REQUIRE(uut.sim_stats.wb_eviction == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A write-through cache does not write back a block that a write miss allocated") {
+  GIVEN("An empty write-through cache") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul_read;
+    to_wq_MRP mock_ul_write;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("418e-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({{&mock_ul_read.queues, &mock_ul_write.queues}})
+      .lower_level(&mock_ll.queues)
+      .set_write_through()
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul_read, &mock_ul_write}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A block is written") {
+      mock_ul_write.issue(make_packet(0x1000, access_type::WRITE));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The write misses and is sent on, and the block is filled clean") {
+        REQUIRE(uut.sim_stats.misses.value_or(std::pair{access_type::WRITE, 0u}, 0) == 1);
+        REQUIRE(uut.sim_stats.wb_write_through == 1);
+        REQUIRE(uut.block.front().valid);
+        REQUIRE_FALSE(uut.block.front().dirty);
+      }
+
+      AND_WHEN("The block is evicted") {
+        auto packets_before = mock_ll.packet_count();
+        mock_ul_read.issue(make_packet(0x2000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("It is not written back again") {
+          REQUIRE(mock_ll.packet_count() == packets_before + 1);
+          REQUIRE(uut.sim_stats.wb_eviction == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A write-through cache merges writes to a block that is waiting in its write buffer") {
+  GIVEN("A write-through cache above a lower level that accepts one write") {
+    do_nothing_MRC mock_ll;
+    mock_ll.queues = champsim::channel{32, 32, 1, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+    to_wq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("418b-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .set_write_through()
+    };
+
+    // The lower level does not operate, so its write queue stays full
+    std::array<champsim::operable*, 2> elements{{&uut, &mock_ul}};
+    for (auto elem : std::array<champsim::operable*, 3>{{&uut, &mock_ll, &mock_ul}}) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul.issue(make_packet(0x1000, access_type::WRITE));
+    run(std::begin(elements), std::end(elements), 100);
+    mock_ul.issue(make_packet(0x2000, access_type::WRITE));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("The waiting block is written again") {
+      mock_ul.issue(make_packet(0x2008, access_type::WRITE));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The writes are merged") {
+        REQUIRE(uut.sim_stats.write_buffer_merges == 1);
+        REQUIRE(std::size(mock_ll.queues.WQ) == 1);
+      }
+
+      AND_WHEN("The lower level drains its queue") {
+        for (long i = 0; i < 100; ++i) {
+          mock_ll._operate();
+          uut._operate();
+        }
+
+        THEN("One write is sent for each block") {
+          REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}), Catch::Matchers::UnorderedEquals(std::vector{champsim::address{0x1000}, champsim::address{0x2000}}));
+          REQUIRE(uut.sim_stats.wb_write_through == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A no-write-allocate cache sends write misses on without filling them") {
+  GIVEN("An empty no-write-allocate cache") {
+    do_nothing_MRC mock_ll;
+    to_wq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("418c-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .reset_write_allocate()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A block is written") {
+      mock_ul.issue(make_packet(0x1000, access_type::WRITE));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The write is sent to the lower level and no block is allocated") {
+        REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}), Catch::Matchers::RangeEquals(std::vector{champsim::address{0x1000}}));
+        REQUIRE(uut.sim_stats.wb_write_around == 1);
+        REQUIRE(uut.sim_stats.misses.value_or(std::pair{access_type::WRITE, 0u}, 0) == 1);
+        REQUIRE(std::none_of(std::begin(uut.block), std::end(uut.block), [](const auto& x) { return x.valid; }));
+        REQUIRE(std::empty(uut.MSHR));
+      }
+    }
+  }
+}
+
+SCENARIO("A cache with eager writeback cleans its next victim while the lower level is idle") {
+  GIVEN("A single-block cache with eager writeback") {
+    do_nothing_MRC mock_ll;
+    to_wq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("418d-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .set_eager_writeback()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("The block is written") {
+      mock_ul.issue(make_packet(0x1000, access_type::WRITE));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("It is written back before it is evicted, and stays in the cache") {
+        REQUIRE_THAT((std::vector<champsim::address>{std::begin(mock_ll.addresses), std::end(mock_ll.addresses)}), Catch::Matchers::RangeEquals(std::vector{champsim::address{0x1000}}));
+        REQUIRE(uut.sim_stats.wb_eager == 1);
+        REQUIRE(uut.block.front().valid);
+        REQUIRE_FALSE(uut.block.front().dirty);
+      }
+    }
+  }
+}
@@ -0,0 +1,62 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+namespace
+{
+void fill_rq(champsim::channel& ul, uint64_t base)
+{
+  for (uint64_t i = 0; i < 4; ++i) {
+    champsim::channel::request_type packet;
+    packet.address = champsim::address{base + i * BLOCK_SIZE};
+    packet.v_address = packet.address;
+    packet.cpu = 0;
+    ul.add_rq(packet);
+  }
+}
+} // namespace
+
+SCENARIO("A cache shares its tag bandwidth among its upper levels") {
+  GIVEN("A cache with two upper levels and a tag bandwidth of 2") {
+    do_nothing_MRC mock_ll;
+    champsim::channel ul0{}, ul1{};
+    auto builder = champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("419-uut")
+      .upper_levels({&ul0, &ul1})
+      .lower_level(&mock_ll.queues)
+      .tag_bandwidth(champsim::bandwidth::maximum_type{2});
+
+    WHEN("Both upper levels have waiting reads, and the upper levels take turns") {
+      CACHE uut{builder};
+      uut.initialize();
+      uut.warmup = false;
+      uut.begin_phase();
+
+      fill_rq(ul0, 0x10000);
+      fill_rq(ul1, 0x20000);
+      uut._operate();
+
+      THEN("Each upper level is served once") {
+        REQUIRE(std::size(ul0.RQ) == 3);
+        REQUIRE(std::size(ul1.RQ) == 3);
+      }
+    }
+
+    WHEN("Both upper levels have waiting reads, and the upper levels are served in a fixed order") {
+      CACHE uut{builder.set_fixed_priority()};
+      uut.initialize();
+      uut.warmup = false;
+      uut.begin_phase();
+
+      fill_rq(ul0, 0x10000);
+      fill_rq(ul1, 0x20000);
+      uut._operate();
+
+      THEN("The first upper level takes all of the bandwidth") {
+        REQUIRE(std::size(ul0.RQ) == 2);
+        REQUIRE(std::size(ul1.RQ) == 4);
+      }
+    }
+  }
+}
@@ -0,0 +1,227 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "prefetch_filter.h"
+
+SCENARIO("The prefetch filter tracks present blocks and recent issues") {
+  GIVEN("An empty prefetch filter") {
+    champsim::prefetch_filter uut{64};
+
+    THEN("No block is present or recently issued") {
+      REQUIRE_FALSE(uut.may_contain(0xdead));
+      REQUIRE_FALSE(uut.recently_issued(0xdead));
+    }
+
+    WHEN("A block is inserted") {
+      uut.insert(0xdead);
+
+      THEN("The block may be present") {
+        REQUIRE(uut.may_contain(0xdead));
+      }
+
+      AND_WHEN("The block is erased") {
+        uut.erase(0xdead);
+
+        THEN("The block is no longer present") {
+          REQUIRE_FALSE(uut.may_contain(0xdead));
+        }
+      }
+
+      AND_WHEN("The block is inserted again and erased once") {
+        uut.insert(0xdead);
+        uut.erase(0xdead);
+
+        THEN("The block is still present") {
+          REQUIRE(uut.may_contain(0xdead));
+        }
+      }
+    }
+
+    WHEN("An issue is recorded") {
+      uut.record_issue(0xbeef);
+
+      THEN("The block was recently issued") {
+        REQUIRE(uut.recently_issued(0xbeef));
+        REQUIRE_FALSE(uut.recently_issued(0xbee0));
+      }
+    }
+  }
+}
+
+SCENARIO("A cache with a prefetch filter drops redundant prefetches") {
+  GIVEN("An empty cache with a prefetch filter") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("427-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .hit_latency(2)
+      .fill_latency(2)
+      .set_prefetch_filter()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("The same prefetch is issued twice") {
+      champsim::address addr{0xdeadbeef};
+      auto first = uut.prefetch_line(addr, true, 0);
+      auto second = uut.prefetch_line(addr, true, 0);
+
+      THEN("Only the first is placed in the queue") {
+        REQUIRE(first);
+        REQUIRE_FALSE(second);
+        REQUIRE(uut.sim_stats.pf_requested == 2);
+        REQUIRE(uut.sim_stats.pf_issued == 1);
+        REQUIRE(uut.sim_stats.pf_filtered == 1);
+      }
+    }
+
+    WHEN("A block is filled by a demand load") {
+      champsim::address addr{0xcafebabe};
+      decltype(mock_ul)::request_type load;
+      load.address = addr;
+      load.v_address = addr;
+      load.cpu = 0;
+      mock_ul.issue(load);
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("A prefetch to that block is dropped") {
+        REQUIRE_FALSE(uut.prefetch_line(addr, true, 0));
+        REQUIRE(uut.sim_stats.pf_filtered == 1);
+      }
+
+      AND_WHEN("The block is invalidated") {
+        uut.invalidate_entry(addr);
+
+        THEN("A prefetch to that block is accepted") {
+          REQUIRE(uut.prefetch_line(addr, true, 0));
+          REQUIRE(uut.sim_stats.pf_filtered == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A cache without a prefetch filter accepts redundant prefetches") {
+  GIVEN("An empty cache") {
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("427-uut-nofilter")
+      .lower_level(&mock_ll.queues)
+    };
+
+    WHEN("The same prefetch is issued twice") {
+      champsim::address addr{0xdeadbeef};
+      uut.prefetch_line(addr, true, 0);
+      auto second = uut.prefetch_line(addr, true, 0);
+
+      THEN("Both are placed in the queue") {
+        REQUIRE(second);
+        REQUIRE(uut.sim_stats.pf_filtered == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A sectored cache with a prefetch filter forgets a block once it is invalidated") {
+  GIVEN("A cache with a prefetch filter and 128-byte blocks in two sectors") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("427b-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .offset_bits(champsim::data::bits{7})
+      .sectors(2)
+      .set_prefetch_filter()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Both sectors of a block are filled, and the block is invalidated") {
+      for (auto addr : {champsim::address{0x1000}, champsim::address{0x1040}}) {
+        decltype(mock_ul)::request_type load;
+        load.address = addr;
+        load.v_address = addr;
+        load.cpu = 0;
+        mock_ul.issue(load);
+
+        for (auto i = 0; i < 100; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+      }
+      REQUIRE(uut.sim_stats.sector_misses == 1);
+
+      uut.invalidate_entry(champsim::address{0x1000});
+
+      THEN("A prefetch to that block is accepted") {
+        REQUIRE(uut.prefetch_line(champsim::address{0x1000}, true, 0));
+        REQUIRE(uut.sim_stats.pf_filtered == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache with a victim cache and a prefetch filter counts only the blocks in its main array") {
+  GIVEN("A single-block cache with a victim cache and a prefetch filter") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("427c-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .victim_cache(2)
+      .set_prefetch_filter()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A block is evicted to the victim cache and promoted back") {
+      for (auto addr : {0x1000, 0x2000, 0x1000}) {
+        mock_ul.issue(make_packet(addr));
+        run(std::begin(elements), std::end(elements), 100);
+      }
+      REQUIRE(uut.sim_stats.victim_promotions == 1);
+
+      THEN("Only the promoted block is counted") {
+        REQUIRE_FALSE(uut.prefetch_line(champsim::address{0x1000}, true, 0));
+        REQUIRE(uut.prefetch_line(champsim::address{0x2000}, true, 0));
+        REQUIRE(uut.sim_stats.pf_filtered == 1);
+      }
+
+      AND_WHEN("The promoted block is invalidated") {
+        uut.invalidate_entry(champsim::address{0x1000});
+
+        THEN("A prefetch to that block is accepted") {
+          REQUIRE(uut.prefetch_line(champsim::address{0x1000}, true, 0));
+          REQUIRE(uut.sim_stats.pf_filtered == 0);
+        }
+      }
+    }
+  }
+}
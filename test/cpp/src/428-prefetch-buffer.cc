@@ -0,0 +1,163 @@
+#include <catch.hpp>
+#include <vector>
+
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A prefetch buffer keeps prefetches out of the main array until they are used") {
+  GIVEN("A single-block cache with a prefetch buffer, holding a demanded block") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("428a-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetch_buffer(4)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    mock_ul.issue(make_packet(0x1000));
+    run(std::begin(elements), std::end(elements), 100);
+
+    WHEN("A block is prefetched") {
+      REQUIRE(uut.prefetch_line(champsim::address{0x2000}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The demanded block is not displaced") {
+        mock_ul.issue(make_packet(0x1000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        REQUIRE(mock_ll.packet_count() == 2);
+        REQUIRE(uut.sim_stats.pf_fill == 1);
+        REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0u}, 0) == 1);
+      }
+
+      AND_WHEN("The prefetched block is demanded") {
+        mock_ul.issue(make_packet(0x2000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("It hits in the prefetch buffer and is moved into the main array") {
+          REQUIRE(mock_ll.packet_count() == 2);
+          REQUIRE(uut.sim_stats.pf_buffer_hits == 1);
+          REQUIRE(uut.sim_stats.pf_buffer_promotions == 1);
+          REQUIRE(uut.sim_stats.pf_useful == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A prefetch pushed out of the prefetch buffer is useless") {
+  GIVEN("A cache with a one-block prefetch buffer") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("428b-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetch_buffer(1)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two blocks are prefetched") {
+      REQUIRE(uut.prefetch_line(champsim::address{0x1000}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+      REQUIRE(uut.prefetch_line(champsim::address{0x2000}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The first is counted as useless") {
+        REQUIRE(uut.sim_stats.pf_fill == 2);
+        REQUIRE(uut.sim_stats.pf_useless == 1);
+      }
+
+      AND_WHEN("The second is prefetched again") {
+        REQUIRE(uut.prefetch_line(champsim::address{0x2000}, true, 0));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("A prefetch of a block in the buffer hits without moving it") {
+          REQUIRE(mock_ll.packet_count() == 2);
+          REQUIRE(uut.sim_stats.pf_buffer_hits == 1);
+          REQUIRE(uut.sim_stats.pf_buffer_promotions == 0);
+        }
+      }
+    }
+  }
+}
+
+namespace
+{
+struct fill_recorder : champsim::modules::prefetcher
+{
+  static inline std::vector<long> fill_ways;
+
+  using prefetcher::prefetcher;
+
+  uint32_t prefetcher_cache_operate(champsim::address, champsim::address, uint8_t, bool, access_type, uint32_t metadata_in) { return metadata_in; }
+
+  uint32_t prefetcher_cache_fill(champsim::address, long, long way, uint8_t, champsim::address, uint32_t metadata_in)
+  {
+    fill_ways.push_back(way);
+    return metadata_in;
+  }
+};
+} // namespace
+
+SCENARIO("The prefetcher sees a buffered prefetch fill when it is moved into the main array") {
+  GIVEN("A single-block cache with a prefetch buffer and a prefetcher that records its fills") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("428c-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetch_buffer(4)
+      .prefetcher<::fill_recorder>()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    ::fill_recorder::fill_ways.clear();
+
+    WHEN("A block is prefetched into the buffer") {
+      REQUIRE(uut.prefetch_line(champsim::address{0x2000}, true, 0));
+      run(std::begin(elements), std::end(elements), 100);
+
+      THEN("The prefetcher has not seen a fill") {
+        REQUIRE(uut.sim_stats.pf_fill == 1);
+        REQUIRE(::fill_recorder::fill_ways.empty());
+      }
+
+      AND_WHEN("The prefetched block is demanded") {
+        mock_ul.issue(make_packet(0x2000));
+        run(std::begin(elements), std::end(elements), 100);
+
+        THEN("The prefetcher sees one fill, into a way of the main array") {
+          REQUIRE(uut.sim_stats.pf_buffer_promotions == 1);
+          REQUIRE(::fill_recorder::fill_ways == std::vector<long>{0});
+        }
+      }
+    }
+  }
+}
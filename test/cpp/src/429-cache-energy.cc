@@ -0,0 +1,85 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A cache charges the energy of each access to its tag and data arrays") {
+  GIVEN("An empty cache with known access energies") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("429-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .tag_energy(champsim::access_energy{1, 10, 0.25})
+      .data_energy(champsim::access_energy{100, 1000, 0.75})
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    champsim::channel::request_type seed;
+    seed.address = champsim::address{0xdeadbeef};
+    seed.is_translated = true;
+    seed.cpu = 0;
+    seed.type = access_type::LOAD;
+
+    WHEN("A load misses and is filled") {
+      mock_ul.issue(seed);
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The tag is read, and the tag and data are written") {
+        REQUIRE(uut.sim_stats.energy.dynamic == Approx(1 + 10 + 1000));
+      }
+
+      THEN("Leakage is charged for every cycle") {
+        REQUIRE(uut.sim_stats.energy.elapsed > champsim::chrono::picoseconds{});
+        REQUIRE(uut.sim_stats.energy.leakage == Approx(static_cast<double>(uut.sim_stats.energy.elapsed / uut.clock_period)));
+        REQUIRE(uut.sim_stats.energy.power() > 0);
+      }
+
+      AND_WHEN("The block is loaded again") {
+        mock_ul.issue(seed);
+        for (auto i = 0; i < 100; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+
+        THEN("The hit reads the tag and the data") {
+          REQUIRE(uut.sim_stats.energy.dynamic == Approx(1 + 10 + 1000 + 1 + 100));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("A cache estimates its access energy from its size when none is given") {
+  do_nothing_MRC mock_ll;
+  CACHE small{champsim::cache_builder{champsim::defaults::default_l1d}.name("429-small").sets(64).lower_level(&mock_ll.queues)};
+  CACHE large{champsim::cache_builder{champsim::defaults::default_l1d}.name("429-large").sets(1024).lower_level(&mock_ll.queues)};
+
+  REQUIRE(small.data_energy.read > 0);
+  REQUIRE(small.data_energy.read < large.data_energy.read);
+  REQUIRE(small.data_energy.leakage < large.data_energy.leakage);
+  REQUIRE(small.tag_energy.read < small.data_energy.read);
+}
+
+TEST_CASE("A cache estimates the parts of its access energy that are not given") {
+  do_nothing_MRC mock_ll;
+  CACHE estimated{champsim::cache_builder{champsim::defaults::default_l1d}.name("429-estimated").lower_level(&mock_ll.queues)};
+  CACHE partial{champsim::cache_builder{champsim::defaults::default_l1d}
+    .name("429-partial")
+    .lower_level(&mock_ll.queues)
+    .tag_energy(champsim::partial_access_energy{1.2, std::nullopt, std::nullopt})
+  };
+
+  REQUIRE(partial.tag_energy.read == Approx(1.2));
+  REQUIRE(partial.tag_energy.write == Approx(estimated.tag_energy.write));
+  REQUIRE(partial.tag_energy.leakage == Approx(estimated.tag_energy.leakage));
+  REQUIRE(partial.data_energy.write == Approx(estimated.data_energy.write));
+}
@@ -0,0 +1,101 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+namespace
+{
+champsim::channel::request_type make_packet(uint64_t addr, uint64_t ip, access_type type = access_type::LOAD)
+{
+  champsim::channel::request_type packet;
+  packet.address = champsim::address{addr};
+  packet.v_address = packet.address;
+  packet.ip = champsim::address{ip};
+  packet.is_translated = true;
+  packet.cpu = 0;
+  packet.type = type;
+  return packet;
+}
+} // namespace
+
+SCENARIO("A cache attributes its demand misses to the instructions that caused them") {
+  GIVEN("A cache that reports the top instruction address") {
+    release_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("433-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .ip_attribution(1)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("One instruction misses more often than another") {
+      for (uint64_t i = 0; i < 3; ++i)
+        mock_ul.issue(make_packet(0x10000 + i * BLOCK_SIZE, 0xcafe));
+      mock_ul.issue(make_packet(0x20000, 0xbeef));
+      mock_ul.issue(make_packet(0x30000, 0xf00d, access_type::PREFETCH));
+
+      for (auto i = 0; i < 100; ++i) {
+        for (auto elem : elements)
+          elem->_operate();
+        mock_ll.release_all();
+      }
+
+      THEN("It is reported, with its misses and their latency") {
+        auto top = uut.sim_stats.ip_misses.top();
+        REQUIRE(std::size(top) == 1);
+        REQUIRE(top.front().key == champsim::address{0xcafe});
+        REQUIRE(top.front().count == 3);
+        REQUIRE(top.front().weight > 0);
+      }
+
+      THEN("Prefetches are not attributed") {
+        REQUIRE(uut.sim_stats.ip_misses.count_or(champsim::address{0xf00d}, 0) == 0);
+        REQUIRE(uut.sim_stats.ip_misses.count_or(champsim::address{0xbeef}, 0) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache does not attribute write misses to instructions") {
+  GIVEN("A cache that reports instruction addresses") {
+    release_MRC mock_ll;
+    to_wq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("433-uut-write")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .ip_attribution(4)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A writeback and a store miss") {
+      mock_ul.issue(make_packet(0x10000, 0, access_type::WRITE));
+      mock_ul.issue(make_packet(0x20000, 0xcafe, access_type::WRITE));
+
+      for (auto i = 0; i < 100; ++i) {
+        for (auto elem : elements)
+          elem->_operate();
+        mock_ll.release_all();
+      }
+
+      THEN("The misses are counted, but not attributed") {
+        REQUIRE(uut.sim_stats.misses.value_or(std::pair{access_type::WRITE, 0u}, 0) == 2);
+        REQUIRE(std::empty(uut.sim_stats.ip_misses.top()));
+      }
+    }
+  }
+}
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+namespace
+{
+struct timeliness_testbed
+{
+  release_MRC mock_ll;
+  to_rq_MRP mock_ul;
+  CACHE uut;
+
+  std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+  explicit timeliness_testbed(uint32_t ways)
+      : uut{champsim::cache_builder{champsim::defaults::default_l2c}
+                .name("434-uut")
+                .sets(1)
+                .ways(ways)
+                .upper_levels({&mock_ul.queues})
+                .lower_level(&mock_ll.queues)}
+  {
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+  }
+
+  void run(int cycles, bool release = true)
+  {
+    for (auto i = 0; i < cycles; ++i) {
+      for (auto elem : elements)
+        elem->_operate();
+      if (release)
+        mock_ll.release_all();
+    }
+  }
+
+  void load(uint64_t addr)
+  {
+    champsim::channel::request_type packet;
+    packet.address = champsim::address{addr};
+    packet.v_address = packet.address;
+    packet.is_translated = true;
+    packet.cpu = 0;
+    packet.type = access_type::LOAD;
+    mock_ul.issue(packet);
+  }
+};
+} // namespace
+
+SCENARIO("A demand that merges with an in-flight prefetch counts the prefetch as late") {
+  GIVEN("A cache with a prefetch in flight") {
+    timeliness_testbed testbed{8};
+    REQUIRE(testbed.uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+    testbed.run(20, false);
+
+    WHEN("A load to the same block arrives") {
+      testbed.load(0xdeadbeef);
+      testbed.run(20, false);
+
+      THEN("The prefetch is late, and its lateness is recorded") {
+        REQUIRE(testbed.uut.sim_stats.pf_late == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_late_distance.total() == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_late_distance.used_buckets() > 1);
+        REQUIRE(testbed.uut.sim_stats.pf_use_distance.total() == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache records the time from the fill of a prefetch to its first use") {
+  GIVEN("A cache with a filled prefetch") {
+    timeliness_testbed testbed{8};
+    REQUIRE(testbed.uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+    testbed.run(20);
+
+    WHEN("A load hits the prefetched block") {
+      testbed.run(100);
+      testbed.load(0xdeadbeef);
+      testbed.run(20);
+
+      THEN("The prefetch is timely, and its use distance is recorded") {
+        REQUIRE(testbed.uut.sim_stats.pf_useful == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_late == 0);
+        REQUIRE(testbed.uut.sim_stats.pf_use_distance.total() == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_use_distance.used_buckets() > 7); // at least 64 cycles
+      }
+    }
+  }
+}
+
+SCENARIO("A demand miss on a prefetched block that was evicted unused counts the prefetch as early") {
+  GIVEN("A single-block cache holding an unused prefetch") {
+    timeliness_testbed testbed{1};
+    REQUIRE(testbed.uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+    testbed.run(20);
+
+    WHEN("Another block evicts the prefetch, and the prefetched block is then loaded") {
+      testbed.load(0xcafebabe);
+      testbed.run(20);
+      testbed.load(0xdeadbeef);
+      testbed.run(20);
+
+      THEN("The prefetch is early") {
+        REQUIRE(testbed.uut.sim_stats.pf_useless == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_early == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_polluting == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A demand miss on a block that a prefetch evicted counts the prefetch as polluting") {
+  GIVEN("A single-block cache holding a demand block") {
+    timeliness_testbed testbed{1};
+    testbed.load(0xcafebabe);
+    testbed.run(20);
+
+    WHEN("A prefetch evicts the block, and the block is then loaded again") {
+      REQUIRE(testbed.uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+      testbed.run(20);
+      testbed.load(0xcafebabe);
+      testbed.run(20);
+
+      THEN("The prefetch is polluting") {
+        REQUIRE(testbed.uut.sim_stats.pf_polluting == 1);
+        REQUIRE(testbed.uut.sim_stats.pf_early == 0);
+      }
+    }
+  }
+}
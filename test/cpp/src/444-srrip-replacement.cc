@@ -20,3 +20,19 @@ TEST_CASE("SRRIP matches the performance in the published work") {
   REQUIRE(victim_b3 == 2);
   uut.update(victim_b3,false); // b3
 }
+
+TEST_CASE("SRRIP reports its next victim without ageing the set") {
+  srrip_set_helper uut{4};
+
+  uut.update(0,true);
+  uut.update(1,false);
+  uut.update(2,true);
+  uut.update(3,false);
+
+  auto before = uut.rrpv_values;
+  REQUIRE(uut.peek_victim() == 1);
+  REQUIRE(uut.peek_victim() == 1);
+  REQUIRE(uut.rrpv_values == before);
+
+  REQUIRE(uut.victim() == 1);
+}
@@ -0,0 +1,172 @@
+#include <catch.hpp>
+#include <algorithm>
+#include "address.h"
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+#include "../../../prefetcher/bop/bop.h"
+
+SCENARIO("The bop prefetcher prefetches the next block before it has learned an offset") {
+  GIVEN("An empty cache") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("454-uut-initial")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetcher<bop>()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A demand miss is sent") {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xffff'0040};
+      seed.ip = champsim::address{0xcafecafe};
+      seed.instr_id = 1;
+      seed.cpu = 0;
+
+      auto seed_result = mock_ul.issue(seed);
+      THEN("The issue is accepted") {
+        REQUIRE(seed_result);
+      }
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The demand and the next block are requested") {
+        REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::SizeIs(2) && champsim::test::StrideMatcher<champsim::block_number>{1});
+      }
+    }
+
+    WHEN("A demand miss is sent to the last block of a page") {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xffff'0fc0};
+      seed.ip = champsim::address{0xcafecafe};
+      seed.instr_id = 1;
+      seed.cpu = 0;
+
+      auto seed_result = mock_ul.issue(seed);
+      THEN("The issue is accepted") {
+        REQUIRE(seed_result);
+      }
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("No prefetch crosses into the next page") {
+        REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::SizeIs(1));
+      }
+    }
+  }
+}
+
+SCENARIO("The bop prefetcher does not cross page boundaries while learning") {
+  GIVEN("A cache that sees a sequential stream through one page") {
+    do_nothing_MRC mock_ll{10};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("454-uut-stream")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetcher<bop>()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    const champsim::page_number page{champsim::address{0xffff'0000}};
+    uint64_t id = 1;
+    for (auto block = champsim::block_number{page}; champsim::page_number{block} == page; block++) {
+      decltype(mock_ul)::request_type pkt;
+      pkt.address = champsim::address{block};
+      pkt.ip = champsim::address{0xcafecafe};
+      pkt.instr_id = id++;
+      pkt.cpu = 0;
+
+      while (!mock_ul.issue(pkt)) {
+        for (auto elem : elements)
+          elem->_operate();
+      }
+
+      for (auto i = 0; i < 5; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+    }
+
+    for (auto i = 0; i < 100; ++i)
+      for (auto elem : elements)
+        elem->_operate();
+
+    THEN("Every request to the lower level is within the page") {
+      REQUIRE(std::all_of(std::begin(mock_ll.addresses), std::end(mock_ll.addresses), [page](auto addr) { return champsim::page_number{addr} == page; }));
+    }
+  }
+}
+
+SCENARIO("The bop prefetcher prefetches with the offset that it learned from a strided stream") {
+  GIVEN("A cache that has seen a strided stream through many pages") {
+    const champsim::block_number::difference_type stride = 3;
+    do_nothing_MRC mock_ll{10};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("454-uut-learned")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetcher<bop>()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    uint64_t id = 1;
+    auto issue = [&](champsim::block_number block) {
+      decltype(mock_ul)::request_type pkt;
+      pkt.address = champsim::address{block};
+      pkt.ip = champsim::address{0xcafecafe};
+      pkt.instr_id = id++;
+      pkt.cpu = 0;
+
+      while (!mock_ul.issue(pkt)) {
+        for (auto elem : elements)
+          elem->_operate();
+      }
+
+      for (auto i = 0; i < 20; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+    };
+
+    auto block = champsim::block_number{champsim::address{0x1000'0000}};
+    for (int i = 0; i < 4096; ++i, block += stride)
+      issue(block);
+
+    WHEN("A demand misses in a page that the stream has not reached") {
+      mock_ll.addresses.clear();
+      issue(champsim::block_number{champsim::address{0x2000'0000}} + 8);
+
+      THEN("The demand is followed by prefetches at the learned offset rather than the next block") {
+        REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::SizeIs(1 + bop::MAX_DEGREE) && champsim::test::StrideMatcher<champsim::block_number>{stride});
+      }
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#include <catch.hpp>
+#include "address.h"
+
+#include "../../../prefetcher/spp_dev/spp_dev.h"
+
+SCENARIO("The SPP perceptron filter learns from useless prefetches") {
+  GIVEN("An untrained perceptron filter") {
+    spp_dev::PERCEPTRON_FILTER uut{};
+    champsim::address ip{0xcafecafe};
+    champsim::address pf_addr{0xffff'0040};
+    auto index = spp_dev::PERCEPTRON_FILTER::get_index(ip, pf_addr, 0x123, 1, 50);
+
+    THEN("Candidates are filled into the L2C") {
+      REQUIRE(uut.predict(uut.get_sum(index)) == spp_dev::PPF_L2C);
+    }
+
+    WHEN("The same prefetch is repeatedly evicted without being used") {
+      for (int i = 0; i < 5; ++i) {
+        uut.record(pf_addr, index, uut.get_sum(index), true);
+        uut.evict(pf_addr);
+      }
+
+      THEN("The candidate is rejected") {
+        REQUIRE(uut.predict(uut.get_sum(index)) == spp_dev::PPF_REJECT);
+        REQUIRE(uut.train_negative == 5);
+      }
+
+      AND_WHEN("A rejected candidate is demanded") {
+        auto old_sum = uut.get_sum(index);
+        uut.record(pf_addr, index, old_sum, false);
+        uut.demand(pf_addr);
+
+        THEN("The weights are reinforced") {
+          REQUIRE(uut.get_sum(index) > old_sum);
+          REQUIRE(uut.train_positive == 1);
+        }
+      }
+    }
+
+    WHEN("A candidate rejected beyond the training margin is demanded") {
+      uut.record(pf_addr, index, spp_dev::PPF_THETA_NEG, false);
+      uut.demand(pf_addr);
+
+      THEN("The weights are not trained") {
+        REQUIRE(uut.get_sum(index) == 0);
+        REQUIRE(uut.train_positive == 0);
+      }
+    }
+
+    WHEN("A prefetch is used before it is evicted") {
+      uut.record(pf_addr, index, uut.get_sum(index), true);
+      uut.demand(pf_addr);
+      uut.evict(pf_addr);
+
+      THEN("The weights are reinforced and not penalized") {
+        REQUIRE(uut.get_sum(index) > 0);
+        REQUIRE(uut.train_positive == 1);
+        REQUIRE(uut.train_negative == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("An untrained SPP perceptron filter keeps the fill levels of the confidence threshold") {
+  GIVEN("An untrained perceptron filter") {
+    spp_dev::PERCEPTRON_FILTER uut{};
+    champsim::address ip{0xcafecafe};
+    champsim::address pf_addr{0xffff'0040};
+
+    THEN("Confident candidates are filled into the L2C, and others into the LLC") {
+      auto confident = spp_dev::PERCEPTRON_FILTER::get_index(ip, pf_addr, 0x123, 1, spp_dev::FILL_THRESHOLD);
+      REQUIRE(uut.predict(uut.get_sum(confident) + spp_dev::PERCEPTRON_FILTER::baseline(spp_dev::FILL_THRESHOLD)) == spp_dev::PPF_L2C);
+
+      auto unconfident = spp_dev::PERCEPTRON_FILTER::get_index(ip, pf_addr, 0x123, 1, spp_dev::PF_THRESHOLD);
+      REQUIRE(uut.predict(uut.get_sum(unconfident) + spp_dev::PERCEPTRON_FILTER::baseline(spp_dev::PF_THRESHOLD)) == spp_dev::PPF_LLC);
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#include <catch.hpp>
+#include "address.h"
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+#include "../../../prefetcher/pythia/pythia.h"
+
+SCENARIO("The pythia prefetcher issues prefetches once it has learned a stride") {
+  GIVEN("A cache that sees a strided stream through many pages") {
+    const champsim::block_number::difference_type stride = 4;
+    do_nothing_MRC mock_ll{10};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("456-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetcher<pythia>()
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    uint64_t id = 1;
+    auto block = champsim::block_number{champsim::address{0x1000'0000}};
+    auto run_stream = [&](int count) {
+      for (int i = 0; i < count; ++i, block += stride) {
+        decltype(mock_ul)::request_type pkt;
+        pkt.address = champsim::address{block};
+        pkt.ip = champsim::address{0xcafecafe};
+        pkt.instr_id = id++;
+        pkt.cpu = 0;
+
+        while (!mock_ul.issue(pkt)) {
+          for (auto elem : elements)
+            elem->_operate();
+        }
+
+        for (auto j = 0; j < 20; ++j)
+          for (auto elem : elements)
+            elem->_operate();
+      }
+    };
+
+    WHEN("The stream runs long enough for the agent to be rewarded for the stride") {
+      run_stream(4096);
+      auto useful_before = uut.sim_stats.pf_useful;
+      auto issued_before = uut.sim_stats.pf_issued;
+
+      const int window = 512;
+      run_stream(window);
+
+      THEN("Most of the demands find a block that was prefetched at the stride") {
+        REQUIRE(uut.sim_stats.pf_issued > issued_before);
+        REQUIRE(uut.sim_stats.pf_useful - useful_before > window / 2);
+      }
+    }
+  }
+}
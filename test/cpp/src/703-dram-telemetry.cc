@@ -0,0 +1,91 @@
+#include <catch.hpp>
+#include "cache.h"
+#include "defaults.hpp"
+#include "dram_controller.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_controller(champsim::channel& ul)
+{
+  const auto clock_period = champsim::chrono::picoseconds{3200};
+  return MEMORY_CONTROLLER{clock_period, clock_period * 2, 2, 2, 4, 4, champsim::chrono::microseconds{64000}, {&ul}, 64, 64, 1,
+                           champsim::data::bytes{8}, 65536, 128, 1, 2, 8, 8192};
+}
+}
+
+SCENARIO("The memory controller reports no data bus activity when idle") {
+  GIVEN("An idle memory controller") {
+    champsim::channel ul{};
+    auto uut = make_controller(ul);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    auto before = uut.telemetry();
+
+    WHEN("It operates without any requests") {
+      for (auto i = 0; i < 1000; ++i)
+        uut._operate();
+
+      auto after = uut.telemetry();
+
+      THEN("The utilization is zero") {
+        REQUIRE(after.utilization_since(before) == 0);
+        REQUIRE(after.congestion_since(before) == 0);
+      }
+
+      THEN("The snapshot reports the queue sizes") {
+        REQUIRE(after.channels == 1);
+        REQUIRE(after.rq_size == 64);
+        REQUIRE(after.wq_size == 64);
+        REQUIRE(after.rq_occupancy == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("The memory controller reports data bus activity while serving reads") {
+  GIVEN("A memory controller") {
+    champsim::channel ul{};
+    auto uut = make_controller(ul);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    auto before = uut.telemetry();
+
+    WHEN("A stream of reads is served") {
+      for (uint64_t i = 0; i < 32; ++i) {
+        champsim::channel::request_type req;
+        req.address = champsim::address{i * BLOCK_SIZE};
+        req.type = access_type::LOAD;
+        req.response_requested = true;
+        ul.add_rq(req);
+      }
+
+      for (auto i = 0; i < 2000; ++i)
+        uut._operate();
+
+      auto after = uut.telemetry();
+
+      THEN("All of the reads returned") {
+        REQUIRE(std::size(ul.returned) == 32);
+      }
+
+      THEN("The utilization is a nonzero fraction") {
+        REQUIRE(after.utilization_since(before) > 0);
+        REQUIRE(after.utilization_since(before) <= 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache can see the memory controller's telemetry") {
+  GIVEN("A cache built with a memory controller") {
+    champsim::channel ul{};
+    auto mc = make_controller(ul);
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_llc}.name("703-uut").memory_controller(&mc)};
+
+    THEN("The cache holds a pointer to the memory controller") {
+      REQUIRE(uut.memory_controller == &mc);
+    }
+  }
+}
@@ -0,0 +1,217 @@
+#include <catch.hpp>
+#include "dram_controller.h"
+
+#include "../../../dram_prefetcher/dram_next_line/dram_next_line.h"
+#include "../../../dram_prefetcher/dram_stream/dram_stream.h"
+
+namespace
+{
+template <typename... Ps>
+MEMORY_CONTROLLER make_controller(champsim::channel& ul, dram_prefetch_parameters params)
+{
+  const auto clock_period = champsim::chrono::picoseconds{3200};
+  return MEMORY_CONTROLLER{champsim::dram_prefetcher_type_holder<Ps...>{}, clock_period, clock_period * 2, 2, 2, 4, 4, champsim::chrono::microseconds{64000},
+                           {&ul}, 64, 64, 1, champsim::data::bytes{8}, 65536, 128, 1, 2, 8, 8192, params};
+}
+
+champsim::channel::request_type make_read(uint64_t block)
+{
+  champsim::channel::request_type req;
+  req.address = champsim::address{block * BLOCK_SIZE};
+  req.type = access_type::LOAD;
+  req.response_requested = true;
+  return req;
+}
+
+void run(MEMORY_CONTROLLER& uut, int cycles)
+{
+  for (auto i = 0; i < cycles; ++i)
+    uut._operate();
+}
+}
+
+SCENARIO("A memory controller without a prefetcher does not prefetch") {
+  GIVEN("A memory controller with the default parameters") {
+    champsim::channel ul{};
+    auto uut = make_controller<>(ul, {});
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("A read is served") {
+      ul.add_rq(make_read(0));
+      run(uut, 1000);
+
+      THEN("No prefetches were issued") {
+        REQUIRE(std::size(ul.returned) == 1);
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ISSUED == 0);
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ROW_OPENED == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A next-line memory-side prefetcher serves reads from its buffer") {
+  GIVEN("A memory controller with a next-line prefetcher") {
+    champsim::channel ul{};
+    auto uut = make_controller<dram_next_line>(ul, {dram_prefetch_parameters::mode_type::buffer, 16, 2});
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("A read is served") {
+      ul.add_rq(make_read(0));
+      run(uut, 1000);
+
+      THEN("The following blocks are prefetched") {
+        REQUIRE(std::size(ul.returned) == 1);
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ISSUED == 2);
+      }
+
+      AND_WHEN("The next block is read") {
+        ul.returned.clear();
+        ul.add_rq(make_read(1));
+        uut._operate();
+
+        THEN("It does not return until its data has crossed the data bus") {
+          REQUIRE(std::empty(ul.returned));
+        }
+
+        run(uut, 10);
+
+        THEN("It returns without accessing DRAM") {
+          REQUIRE(std::size(ul.returned) == 1);
+          REQUIRE(ul.returned.front().address == champsim::address{BLOCK_SIZE});
+          REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_BUFFER_HIT == 1);
+        }
+      }
+
+      AND_WHEN("The next two blocks are read together") {
+        ul.returned.clear();
+        ul.add_rq(make_read(1));
+        ul.add_rq(make_read(2));
+        for (auto i = 0; i < 100 && std::empty(ul.returned); ++i)
+          uut._operate();
+
+        THEN("Their transfers take turns on the data bus") {
+          REQUIRE(std::size(ul.returned) == 1);
+          run(uut, 10);
+          REQUIRE(std::size(ul.returned) == 2);
+          REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_BUFFER_HIT == 2);
+        }
+      }
+
+      AND_WHEN("The next block is written before it is read") {
+        champsim::channel::request_type write = make_read(1);
+        write.type = access_type::WRITE;
+        write.response_requested = false;
+        ul.add_wq(write);
+        uut._operate();
+
+        ul.returned.clear();
+        ul.add_rq(make_read(1));
+        uut._operate();
+
+        THEN("The buffered copy is not used") {
+          REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_BUFFER_HIT == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A memory-side prefetcher fills its buffer during warmup") {
+  GIVEN("A memory controller with a next-line prefetcher in warmup") {
+    champsim::channel ul{};
+    auto uut = make_controller<dram_next_line>(ul, {dram_prefetch_parameters::mode_type::buffer, 16, 2});
+    uut.warmup = true;
+    uut.begin_phase();
+
+    WHEN("A read is served") {
+      ul.add_rq(make_read(0));
+      run(uut, 10);
+
+      THEN("The following blocks are in the buffer") {
+        REQUIRE(std::size(ul.returned) == 1);
+        REQUIRE(uut.channels.at(0).prefetch_buffer.check_hit({champsim::block_number{1}}).has_value());
+        REQUIRE(uut.channels.at(0).prefetch_buffer.check_hit({champsim::block_number{2}}).has_value());
+      }
+    }
+  }
+}
+
+SCENARIO("A stream memory-side prefetcher waits for a confirmed direction") {
+  GIVEN("A memory controller with a stream prefetcher") {
+    champsim::channel ul{};
+    auto uut = make_controller<dram_stream>(ul, {dram_prefetch_parameters::mode_type::buffer, 16, 2});
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("Two blocks are read in ascending order") {
+      ul.add_rq(make_read(10));
+      ul.add_rq(make_read(11));
+      run(uut, 1000);
+
+      THEN("No prefetches are issued") {
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ISSUED == 0);
+      }
+
+      AND_WHEN("A third block continues the stream") {
+        ul.add_rq(make_read(12));
+        run(uut, 1000);
+
+        THEN("The stream is prefetched") {
+          REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ISSUED == 2);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A memory-side prefetcher can open rows early") {
+  GIVEN("A memory controller with a next-line prefetcher that opens rows") {
+    champsim::channel ul{};
+    auto uut = make_controller<dram_next_line>(ul, {dram_prefetch_parameters::mode_type::open_row, 16, 1});
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("A read is served, then the next block is read") {
+      ul.add_rq(make_read(0));
+      run(uut, 1000);
+      ul.add_rq(make_read(1));
+      run(uut, 1000);
+
+      THEN("The second read hits in the row buffer") {
+        REQUIRE(std::size(ul.returned) == 2);
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ISSUED == 0);
+        REQUIRE(uut.channels.at(0).sim_stats.PREFETCH_ROW_OPENED >= 1);
+        REQUIRE(uut.channels.at(0).sim_stats.RQ_ROW_BUFFER_HIT == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Opening a row early occupies the bank") {
+  GIVEN("An idle memory controller with a next-line prefetcher that opens rows") {
+    champsim::channel ul{};
+    auto uut = make_controller<dram_next_line>(ul, {dram_prefetch_parameters::mode_type::open_row, 16, 1});
+    uut.warmup = false;
+    uut.begin_phase();
+    run(uut, 10);
+
+    auto& channel = uut.channels.at(0);
+    const auto addr = champsim::address{0};
+    auto other_row = addr;
+    do {
+      other_row = other_row + BLOCK_SIZE;
+    } while (channel.bank_request_index(other_row) != channel.bank_request_index(addr)
+             || channel.address_mapping.get_row(other_row) == channel.address_mapping.get_row(addr));
+
+    WHEN("A row is opened") {
+      REQUIRE(channel.open_row(addr));
+
+      THEN("The bank is busy for the activation, and another row cannot be opened until it completes") {
+        REQUIRE(channel.bank_request.at(channel.bank_request_index(addr)).ready_time == channel.current_time + channel.tRCD);
+        REQUIRE_FALSE(channel.open_row(other_row));
+      }
+    }
+  }
+}
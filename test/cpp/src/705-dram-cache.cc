@@ -0,0 +1,223 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "dram_cache.h"
+
+namespace
+{
+DRAM_CACHE make_dram_cache(champsim::channel& ul, champsim::channel& ll, dram_cache_parameters params)
+{
+  const auto clock_period = champsim::chrono::picoseconds{3200};
+  return DRAM_CACHE{clock_period, clock_period * 2, 2, 2, 4, 4, champsim::chrono::microseconds{64000}, {&ul}, &ll, 64, 64, 1,
+                    champsim::data::bytes{8}, 128, 1, 2, 8, 8192, params};
+}
+
+void run(DRAM_CACHE& uut, do_nothing_MRC& mock_ll, int cycles)
+{
+  for (auto i = 0; i < cycles; ++i) {
+    uut._operate();
+    mock_ll._operate();
+  }
+}
+
+dram_cache_parameters alloy_params(dram_cache_parameters::predictor_type predictor)
+{
+  dram_cache_parameters params;
+  params.miss_predictor = predictor;
+  params.size = champsim::data::bytes{1 << 16};
+  return params;
+}
+} // namespace
+
+SCENARIO("An alloy DRAM cache serves repeated reads without main memory") {
+  GIVEN("An empty alloy DRAM cache") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{20};
+    auto uut = make_dram_cache(ul, mock_ll.queues, alloy_params(dram_cache_parameters::predictor_type::none));
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("A block is read") {
+      ul.add_rq(make_packet(0x1000));
+      run(uut, mock_ll, 1000);
+
+      THEN("It misses and is read from main memory") {
+        REQUIRE(std::size(ul.returned) == 1);
+        REQUIRE(ul.returned.front().address == champsim::address{0x1000});
+        REQUIRE(uut.sim_stats.read_misses == 1);
+        REQUIRE(uut.sim_stats.memory_reads == 1);
+        REQUIRE(uut.sim_stats.cache_writes == 1);
+      }
+
+      AND_WHEN("The block is read again") {
+        ul.returned.clear();
+        ul.add_rq(make_packet(0x1000));
+        run(uut, mock_ll, 1000);
+
+        THEN("It hits in the DRAM cache") {
+          REQUIRE(std::size(ul.returned) == 1);
+          REQUIRE(uut.sim_stats.read_hits == 1);
+          REQUIRE(mock_ll.packet_count() == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("An alloy DRAM cache writes back dirty blocks that it evicts") {
+  GIVEN("An alloy DRAM cache holding a written block") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{20};
+    auto params = alloy_params(dram_cache_parameters::predictor_type::none);
+    auto uut = make_dram_cache(ul, mock_ll.queues, params);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    ul.add_wq(make_packet(0x1000, access_type::WRITE));
+    run(uut, mock_ll, 1000);
+
+    WHEN("A conflicting block is read") {
+      ul.add_rq(make_packet(0x1000 + static_cast<uint64_t>(params.size.count())));
+      run(uut, mock_ll, 1000);
+
+      THEN("The written block is sent to main memory") {
+        REQUIRE(uut.sim_stats.writes == 1);
+        REQUIRE(uut.sim_stats.writebacks == 1);
+        REQUIRE(std::count(std::begin(mock_ll.addresses), std::end(mock_ll.addresses), champsim::address{0x1000}) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("The miss predictor reads main memory in parallel with the tags") {
+  GIVEN("An alloy DRAM cache with a miss predictor") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{20};
+    auto uut = make_dram_cache(ul, mock_ll.queues, alloy_params(dram_cache_parameters::predictor_type::map_i));
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("An instruction misses repeatedly") {
+      for (uint64_t i = 0; i < 8; ++i) {
+        ul.add_rq(make_packet(0x10000 + i * BLOCK_SIZE));
+        run(uut, mock_ll, 1000);
+      }
+
+      THEN("Its later misses are predicted") {
+        REQUIRE(std::size(ul.returned) == 8);
+        REQUIRE(uut.sim_stats.read_misses == 8);
+        REQUIRE(uut.sim_stats.predicted_misses > 0);
+      }
+
+      AND_WHEN("The instruction then hits") {
+        ul.returned.clear();
+        ul.add_rq(make_packet(0x10000));
+        run(uut, mock_ll, 1000);
+
+        THEN("The read of main memory is wasted, but only one response is returned") {
+          REQUIRE(std::size(ul.returned) == 1);
+          REQUIRE(uut.sim_stats.read_hits == 1);
+          REQUIRE(uut.sim_stats.mispredicted_hits == 1);
+        }
+      }
+    }
+  }
+
+  GIVEN("An alloy DRAM cache without a miss predictor") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{20};
+    auto uut = make_dram_cache(ul, mock_ll.queues, alloy_params(dram_cache_parameters::predictor_type::none));
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("An instruction misses repeatedly") {
+      for (uint64_t i = 0; i < 8; ++i) {
+        ul.add_rq(make_packet(0x10000 + i * BLOCK_SIZE));
+        run(uut, mock_ll, 1000);
+      }
+
+      THEN("No misses are predicted") {
+        REQUIRE(uut.sim_stats.read_misses == 8);
+        REQUIRE(uut.sim_stats.predicted_misses == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A miss takes over a read of main memory that a mispredicted hit left outstanding") {
+  GIVEN("An alloy DRAM cache with a slow main memory and a trained miss predictor") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{500};
+    auto uut = make_dram_cache(ul, mock_ll.queues, alloy_params(dram_cache_parameters::predictor_type::map_i));
+    uut.warmup = false;
+    uut.begin_phase();
+
+    for (uint64_t i = 0; i < 8; ++i) {
+      ul.add_rq(make_packet(0x10000 + i * BLOCK_SIZE));
+      run(uut, mock_ll, 2000);
+    }
+    ul.returned.clear();
+
+    WHEN("A predicted miss hits, and the block is evicted and read again before main memory responds") {
+      ul.add_rq(make_packet(0x10000));
+      run(uut, mock_ll, 100);
+      REQUIRE(uut.sim_stats.mispredicted_hits == 1);
+
+      ul.add_wq(make_packet(0x20000, access_type::WRITE));
+      run(uut, mock_ll, 100);
+      ul.add_rq(make_packet(0x10000));
+      run(uut, mock_ll, 2000);
+
+      THEN("The second read is served by the outstanding read of main memory") {
+        REQUIRE(std::size(ul.returned) == 2);
+        REQUIRE(std::count(std::begin(mock_ll.addresses), std::end(mock_ll.addresses), champsim::address{0x10000}) == 2);
+      }
+    }
+  }
+}
+
+SCENARIO("A unison DRAM cache fetches the footprint of a page") {
+  GIVEN("A unison DRAM cache that has seen a footprint of two blocks") {
+    champsim::channel ul{};
+    do_nothing_MRC mock_ll{20};
+    dram_cache_parameters params;
+    params.organization = dram_cache_parameters::organization_type::unison;
+    params.miss_predictor = dram_cache_parameters::predictor_type::none;
+    params.size = champsim::data::bytes{4096};
+    params.page_size = champsim::data::bytes{1024};
+    params.ways = 1;
+    auto uut = make_dram_cache(ul, mock_ll.queues, params);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    const uint64_t page = 0x100000;
+    const uint64_t conflicting_page = page + static_cast<uint64_t>(params.size.count());
+    ul.add_rq(make_packet(page, access_type::LOAD, 0x400000));
+    run(uut, mock_ll, 1000);
+    ul.add_rq(make_packet(page + BLOCK_SIZE, access_type::LOAD, 0x400004));
+    run(uut, mock_ll, 1000);
+    ul.add_rq(make_packet(conflicting_page, access_type::LOAD, 0x400008));
+    run(uut, mock_ll, 1000);
+
+    WHEN("The page is allocated again by the same access") {
+      ul.returned.clear();
+      ul.add_rq(make_packet(page, access_type::LOAD, 0x400000));
+      run(uut, mock_ll, 1000);
+
+      THEN("The rest of the footprint is fetched with it") {
+        REQUIRE(std::size(ul.returned) == 1);
+        REQUIRE(uut.sim_stats.footprint_fetches == 1);
+      }
+
+      AND_WHEN("The rest of the footprint is read") {
+        ul.returned.clear();
+        ul.add_rq(make_packet(page + BLOCK_SIZE, access_type::LOAD, 0x400004));
+        run(uut, mock_ll, 1000);
+
+        THEN("It hits") {
+          REQUIRE(std::size(ul.returned) == 1);
+          REQUIRE(uut.sim_stats.read_hits == 1);
+        }
+      }
+    }
+  }
+}
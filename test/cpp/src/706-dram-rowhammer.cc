@@ -0,0 +1,158 @@
+#include <catch.hpp>
+#include "dram_controller.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_controller(champsim::channel& ul, dram_rowhammer_parameters params)
+{
+  // A single refresh per period, so that no periodic refresh happens during the test
+  const auto clock_period = champsim::chrono::picoseconds{3200};
+  return MEMORY_CONTROLLER{clock_period, clock_period * 2, 2, 2, 4, 4, champsim::chrono::microseconds{64000}, {&ul}, 64, 64, 1,
+                           champsim::data::bytes{8}, 65536, 128, 1, 2, 8, 1, {}, params};
+}
+
+// Find two rows that map to the same bank
+std::array<champsim::address, 2> aggressors(const MEMORY_CONTROLLER& uut)
+{
+  const auto& channel = uut.channels.at(0);
+  const champsim::address first{uint64_t{1} << 20};
+  for (uint64_t offset = uint64_t{1} << 21;; offset += uint64_t{1} << 20) {
+    champsim::address second{(uint64_t{1} << 20) + offset};
+    if (channel.bank_request_index(first) == channel.bank_request_index(second) && channel.address_mapping.get_row(first) != channel.address_mapping.get_row(second))
+      return {first, second};
+  }
+}
+
+// Find the nth block after the start of the row that lies in the same bank and row
+champsim::address column(const MEMORY_CONTROLLER& uut, champsim::address row_base, uint64_t n)
+{
+  const auto& channel = uut.channels.at(0);
+  auto addr = row_base;
+  for (uint64_t found = 0; found < n;) {
+    addr += BLOCK_SIZE;
+    if (channel.bank_request_index(addr) == channel.bank_request_index(row_base) && channel.address_mapping.get_row(addr) == channel.address_mapping.get_row(row_base))
+      ++found;
+  }
+  return addr;
+}
+
+champsim::channel::request_type make_read(champsim::address addr)
+{
+  champsim::channel::request_type req;
+  req.address = addr;
+  req.type = access_type::LOAD;
+  req.response_requested = true;
+  return req;
+}
+
+void hammer(MEMORY_CONTROLLER& uut, champsim::channel& ul, std::size_t count)
+{
+  auto rows = aggressors(uut);
+  for (std::size_t i = 0; i < count; ++i) {
+    ul.add_rq(make_read(column(uut, rows.at(i % 2), i / 2)));
+    for (auto cycle = 0; cycle < 200; ++cycle)
+      uut._operate();
+  }
+}
+} // namespace
+
+SCENARIO("A memory controller without RowHammer mitigation only counts activations") {
+  GIVEN("A memory controller with no mitigation") {
+    champsim::channel ul{};
+    auto uut = make_controller(ul, {});
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("Two rows in a bank are activated alternately") {
+      hammer(uut, ul, 16);
+
+      THEN("Every read activates a row, and nothing is mitigated") {
+        REQUIRE(std::size(ul.returned) == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.activations == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_mitigations == 0);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_busy_cycles == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("PARA refreshes the neighbors of activated rows") {
+  GIVEN("A memory controller with PARA that always refreshes") {
+    champsim::channel ul{};
+    dram_rowhammer_parameters params;
+    params.mitigation = dram_rowhammer_parameters::mitigation_type::para;
+    params.para_probability = 1;
+    auto uut = make_controller(ul, params);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("Two rows in a bank are activated alternately") {
+      hammer(uut, ul, 16);
+
+      THEN("Every activation is mitigated, and the reads still complete") {
+        REQUIRE(std::size(ul.returned) == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_mitigations == uut.channels.at(0).sim_stats.activations);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_busy_cycles > 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Graphene refreshes the neighbors of a row each time its count reaches the threshold") {
+  GIVEN("A memory controller with Graphene") {
+    champsim::channel ul{};
+    dram_rowhammer_parameters params;
+    params.mitigation = dram_rowhammer_parameters::mitigation_type::graphene;
+    params.threshold = 4;
+    params.table_size = 4;
+    auto uut = make_controller(ul, params);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("Two rows in a bank are each activated 8 times") {
+      hammer(uut, ul, 16);
+
+      THEN("Each row is mitigated twice") {
+        REQUIRE(std::size(ul.returned) == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.activations == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_mitigations == 4);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_busy_cycles > 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Refresh management issues an RFM command when the activations of a bank reach the threshold") {
+  GIVEN("A memory controller with refresh management") {
+    champsim::channel ul{};
+    dram_rowhammer_parameters params;
+    params.mitigation = dram_rowhammer_parameters::mitigation_type::rfm;
+    params.threshold = 8;
+    auto uut = make_controller(ul, params);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("A bank is activated 16 times") {
+      hammer(uut, ul, 16);
+
+      THEN("Two RFM commands are issued") {
+        REQUIRE(std::size(ul.returned) == 16);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_mitigations == 2);
+      }
+    }
+
+    WHEN("Many reads to the bank are waiting") {
+      auto rows = aggressors(uut);
+      for (uint64_t i = 0; i < 32; ++i)
+        ul.add_rq(make_read(column(uut, rows.at(i % 2), i / 2)));
+      for (auto cycle = 0; cycle < 10000; ++cycle)
+        uut._operate();
+
+      THEN("The reads are delayed by the RFM commands") {
+        REQUIRE(std::size(ul.returned) == 32);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_mitigations == 4);
+        REQUIRE(uut.channels.at(0).sim_stats.rowhammer_stall_cycles > 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dram_controller.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_controller(champsim::channel& ul, std::string file, long epoch_length)
+{
+  const auto clock_period = champsim::chrono::picoseconds{3200};
+  return MEMORY_CONTROLLER{clock_period, clock_period * 2, 2, 2, 4, 4, champsim::chrono::microseconds{64000}, {&ul}, 64, 64, 1,
+                           champsim::data::bytes{8}, 65536, 128, 1, 2, 8, 8192, {}, {}, page_profile_parameters{file, epoch_length}};
+}
+
+champsim::channel::request_type make_packet(uint64_t addr, access_type type)
+{
+  champsim::channel::request_type req;
+  req.address = champsim::address{addr};
+  req.type = type;
+  req.response_requested = (type != access_type::WRITE);
+  return req;
+}
+
+std::vector<std::string> read_lines(const std::string& file)
+{
+  std::ifstream in{file};
+  std::vector<std::string> result;
+  for (std::string line; std::getline(in, line);)
+    result.push_back(line);
+  return result;
+}
+
+long count_prefix(const std::vector<std::string>& lines, const std::string& prefix)
+{
+  return std::count_if(std::begin(lines), std::end(lines), [&](const auto& line) { return line.rfind(prefix, 0) == 0; });
+}
+} // namespace
+
+SCENARIO("The memory controller profiles the accesses to each page") {
+  GIVEN("A memory controller with a page profile") {
+    const auto file = (std::filesystem::temp_directory_path() / "707-page-profile.csv").string();
+    champsim::channel ul{};
+    auto uut = make_controller(ul, file, 0);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("Two blocks of one page are read, and a block of another page is written") {
+      ul.add_rq(make_packet(0x1000, access_type::LOAD));
+      ul.add_rq(make_packet(0x1040, access_type::LOAD));
+      ul.add_wq(make_packet(0x5000, access_type::WRITE));
+      for (auto i = 0; i < 2000; ++i)
+        uut._operate();
+      uut.end_phase(0);
+
+      auto lines = read_lines(file);
+
+      THEN("Each page is reported with its reads and writes") {
+        REQUIRE(lines.at(0) == "epoch,kind,id,reads,writes,row_hits");
+        REQUIRE(lines.at(1).rfind("0,page,1,2,0,", 0) == 0);
+        REQUIRE(lines.at(2) == "0,page,5,0,1,0");
+      }
+
+      THEN("Every bank is reported, and the banks account for every access") {
+        REQUIRE(count_prefix(lines, "0,bank,") == 8 * 2);
+        REQUIRE(count_prefix(lines, "0,") == 2 + 8 * 2);
+      }
+    }
+
+    std::filesystem::remove(file);
+  }
+}
+
+SCENARIO("The memory controller ends an epoch after the given number of cycles") {
+  GIVEN("A memory controller with a page profile and an epoch of 100 cycles") {
+    const auto file = (std::filesystem::temp_directory_path() / "707-page-profile-epoch.csv").string();
+    champsim::channel ul{};
+    auto uut = make_controller(ul, file, 100);
+    uut.warmup = false;
+    uut.begin_phase();
+
+    WHEN("It operates for 250 cycles, and then the phase ends") {
+      ul.add_rq(make_packet(0x1000, access_type::LOAD));
+      for (auto i = 0; i < 250; ++i)
+        uut._operate();
+      uut.end_phase(0);
+
+      auto lines = read_lines(file);
+
+      THEN("Three epochs are written, and the read falls in the first") {
+        REQUIRE(count_prefix(lines, "0,page,1,1,0,") == 1);
+        REQUIRE(count_prefix(lines, "1,bank,") == 16);
+        REQUIRE(count_prefix(lines, "2,bank,") == 16);
+        REQUIRE(count_prefix(lines, "3,") == 0);
+      }
+    }
+
+    std::filesystem::remove(file);
+  }
+}
+
+TEST_CASE("A memory controller without a page profile does not count page accesses") {
+  champsim::channel ul{};
+  auto uut = make_controller(ul, "", 0);
+  uut.warmup = false;
+  uut.begin_phase();
+
+  ul.add_rq(make_packet(0x1000, access_type::LOAD));
+  for (auto i = 0; i < 1000; ++i)
+    uut._operate();
+
+  REQUIRE(uut.channels.at(0).page_accesses.size() == 0);
+}
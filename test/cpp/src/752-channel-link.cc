@@ -0,0 +1,134 @@
+#include <catch.hpp>
+
+#include "channel.h"
+
+namespace
+{
+champsim::channel make_link(long request_latency, long response_latency, long flits_per_cycle, champsim::data::bytes flit_size = champsim::data::bytes{BLOCK_SIZE})
+{
+  champsim::link_parameters params{champsim::chrono::picoseconds{1000}, request_latency, response_latency, flits_per_cycle, flit_size};
+  champsim::channel uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false, "uut", params};
+  uut.warmup = false;
+  uut.begin_phase();
+  return uut;
+}
+
+champsim::channel::request_type make_packet(uint64_t addr)
+{
+  champsim::channel::request_type packet{};
+  packet.address = champsim::address{addr};
+  packet.v_address = champsim::address{addr};
+  return packet;
+}
+} // namespace
+
+TEST_CASE("A channel without a link is not timed") {
+  champsim::channel uut{};
+
+  REQUIRE_FALSE(uut.timed());
+  REQUIRE(uut.response_target() == &uut.returned);
+}
+
+SCENARIO("A timed channel delays requests by the latency of its link") {
+  GIVEN("A channel with a request latency of 5 cycles") {
+    auto uut = make_link(5, 0, 0);
+
+    WHEN("A request is sent") {
+      REQUIRE(uut.add_rq(make_packet(0x1000)));
+
+      THEN("It is counted in the occupancy, but does not arrive until it has crossed the link") {
+        REQUIRE(uut.rq_occupancy() == 1);
+        for (int i = 0; i < 5; ++i) {
+          uut._operate();
+          REQUIRE(std::empty(uut.RQ));
+        }
+        uut._operate();
+        REQUIRE(std::size(uut.RQ) == 1);
+        REQUIRE(uut.rq_occupancy() == 1);
+      }
+    }
+  }
+
+  GIVEN("A channel with a request latency of 5 cycles during warmup") {
+    auto uut = make_link(5, 0, 0);
+    uut.warmup = true;
+
+    WHEN("A request is sent") {
+      uut.add_rq(make_packet(0x1000));
+
+      THEN("It arrives immediately") {
+        REQUIRE(std::size(uut.RQ) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A timed channel delays responses by the latency of its link") {
+  GIVEN("A channel with a response latency of 3 cycles") {
+    auto uut = make_link(0, 3, 0);
+
+    WHEN("A response is returned") {
+      uut.response_target()->emplace_back(champsim::address{0x1000}, champsim::address{0x1000}, champsim::address{}, 0, std::vector<uint64_t>{});
+
+      THEN("It arrives after it has crossed the link") {
+        for (int i = 0; i < 3; ++i) {
+          uut._operate();
+          REQUIRE(std::empty(uut.returned));
+        }
+        uut._operate();
+        REQUIRE(std::size(uut.returned) == 1);
+        REQUIRE(uut.sim_link_stats.response_packets == 1);
+        REQUIRE(uut.sim_link_stats.response_flits == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A timed channel limits the flits sent in each cycle") {
+  GIVEN("A channel that sends one flit of a quarter block per cycle") {
+    auto uut = make_link(0, 0, 1, champsim::data::bytes{BLOCK_SIZE / 4});
+
+    WHEN("Two writes are sent together") {
+      uut.add_wq(make_packet(0x1000));
+      uut.add_wq(make_packet(0x2000));
+
+      THEN("Each write takes four cycles, and the second waits for the first") {
+        for (int i = 0; i < 4; ++i)
+          uut._operate();
+        REQUIRE(std::size(uut.WQ) == 1);
+        for (int i = 0; i < 4; ++i)
+          uut._operate();
+        REQUIRE(std::size(uut.WQ) == 2);
+
+        REQUIRE(uut.sim_link_stats.cycles == 8);
+        REQUIRE(uut.sim_link_stats.request_packets == 2);
+        REQUIRE(uut.sim_link_stats.request_flits == 8);
+        REQUIRE(uut.sim_link_stats.request_busy_cycles == 8);
+        REQUIRE(uut.sim_link_stats.request_queue_delay == 4);
+      }
+    }
+
+    WHEN("Two reads are sent together") {
+      uut.add_rq(make_packet(0x1000));
+      uut.add_rq(make_packet(0x2000));
+
+      THEN("Each read takes one cycle") {
+        uut._operate();
+        REQUIRE(std::size(uut.RQ) == 1);
+        uut._operate();
+        REQUIRE(std::size(uut.RQ) == 2);
+        REQUIRE(uut.sim_link_stats.request_flits == 2);
+      }
+    }
+  }
+}
+
+TEST_CASE("A timed channel counts the requests crossing the link against the queue size") {
+  champsim::link_parameters params{champsim::chrono::picoseconds{1000}, 10, 0, 0, champsim::data::bytes{BLOCK_SIZE}};
+  champsim::channel uut{1, 1, 1, champsim::data::bits{LOG2_BLOCK_SIZE}, false, "uut", params};
+  uut.warmup = false;
+
+  REQUIRE(uut.add_rq(make_packet(0x1000)));
+  REQUIRE_FALSE(uut.add_rq(make_packet(0x2000)));
+  REQUIRE(uut.sim_stats.RQ_FULL == 1);
+}
@@ -0,0 +1,102 @@
+#include <catch.hpp>
+#include "vmem.h"
+
+#include "dram_controller.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_dram()
+{
+  return MEMORY_CONTROLLER{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+}
+
+VirtualMemory make_vmem(MEMORY_CONTROLLER& dram, page_allocation_parameters params, std::optional<uint64_t> seed = 200)
+{
+  return VirtualMemory{champsim::data::bytes{1 << 12}, 5, champsim::chrono::nanoseconds{6400}, dram, seed, params};
+}
+
+std::vector<champsim::page_number> translate(VirtualMemory& uut, uint32_t cpu, uint64_t first_vpage, std::size_t count)
+{
+  std::vector<champsim::page_number> result;
+  for (uint64_t vpage = first_vpage; vpage < first_vpage + count; ++vpage)
+    result.push_back(uut.va_to_pa(cpu, champsim::page_number{vpage}).first);
+  return result;
+}
+
+bool contiguous(const std::vector<champsim::page_number>& pages)
+{
+  for (std::size_t i = 1; i < std::size(pages); ++i) {
+    if (pages.at(i) != pages.at(i-1) + 1)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+TEST_CASE("The sequential page allocation policy places pages contiguously") {
+  auto dram = make_dram();
+  page_allocation_parameters params;
+  params.policy = page_allocation_parameters::policy_type::sequential;
+  auto uut = make_vmem(dram, params);
+
+  REQUIRE(contiguous(translate(uut, 0, 0x1000, 16)));
+}
+
+TEST_CASE("The random page allocation policy does not place pages contiguously") {
+  auto dram = make_dram();
+  auto uut = make_vmem(dram, {});
+
+  REQUIRE_FALSE(contiguous(translate(uut, 0, 0x1000, 16)));
+}
+
+TEST_CASE("The coloring page allocation policy gives each virtual page a physical page of the same color") {
+  auto color = GENERATE(page_allocation_parameters::color_type::llc, page_allocation_parameters::color_type::bank);
+
+  auto dram = make_dram();
+  page_allocation_parameters params;
+  params.policy = page_allocation_parameters::policy_type::coloring;
+  params.color = color;
+  params.llc_sets = 4 * PAGE_SIZE / BLOCK_SIZE;
+  auto uut = make_vmem(dram, params);
+
+  REQUIRE(uut.num_colors() > 1);
+  for (uint64_t vpage = 0x1000; vpage < 0x1040; ++vpage) {
+    champsim::page_number vaddr{vpage};
+    REQUIRE(uut.page_color(uut.va_to_pa(0, vaddr).first) == uut.page_color(vaddr));
+  }
+}
+
+TEST_CASE("The buddy page allocation policy places pages contiguously only as far as the fragmentation allows") {
+  auto dram = make_dram();
+  page_allocation_parameters params;
+  params.policy = page_allocation_parameters::policy_type::buddy;
+
+  SECTION("Unfragmented memory") {
+    params.fragmentation = 0;
+    auto uut = make_vmem(dram, params);
+    REQUIRE(contiguous(translate(uut, 0, 0x1000, 16)));
+  }
+
+  SECTION("Fully fragmented memory") {
+    params.fragmentation = 1;
+    auto uut = make_vmem(dram, params);
+    REQUIRE_FALSE(contiguous(translate(uut, 0, 0x1000, 16)));
+  }
+}
+
+TEST_CASE("The NUMA page allocation policy places the pages of each core in its own node") {
+  auto dram = make_dram();
+  page_allocation_parameters params;
+  params.policy = page_allocation_parameters::policy_type::numa;
+  params.nodes = 2;
+  auto uut = make_vmem(dram, params);
+
+  const auto total_pages = uut.available_ppages();
+  const champsim::page_number first_page{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, champsim::data::mebibytes{1}))};
+  const auto node_boundary = first_page + static_cast<long>(total_pages / 2);
+
+  auto cpu0_pages = translate(uut, 0, 0x1000, 16);
+  auto cpu1_pages = translate(uut, 1, 0x1000, 16);
+  REQUIRE(std::all_of(std::begin(cpu0_pages), std::end(cpu0_pages), [node_boundary](auto page) { return page < node_boundary; }));
+  REQUIRE(std::all_of(std::begin(cpu1_pages), std::end(cpu1_pages), [node_boundary](auto page) { return page >= node_boundary; }));
+}
@@ -0,0 +1,67 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "vmem.h"
+
+#include "dram_controller.h"
+
+namespace
+{
+std::vector<std::string> read_lines(const std::string& file)
+{
+  std::ifstream in{file};
+  std::vector<std::string> result;
+  for (std::string line; std::getline(in, line);)
+    result.push_back(line);
+  return result;
+}
+} // namespace
+
+SCENARIO("The virtual memory profiles the translations of each virtual page") {
+  GIVEN("A virtual memory with a page profile") {
+    const auto file = (std::filesystem::temp_directory_path() / "805-page-profile.csv").string();
+    MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, champsim::chrono::nanoseconds{6400}, dram, {}, {}, page_profile_parameters{file, 0}};
+
+    WHEN("One page is translated three times, and another once") {
+      champsim::page_number hot{0x40}, cold{0x10};
+      for (int i = 0; i < 3; ++i)
+        uut.va_to_pa(0, hot);
+      auto [cold_ppage, cold_delay] = uut.va_to_pa(0, cold);
+      auto [hot_ppage, hot_delay] = uut.va_to_pa(0, hot);
+      uut.write_page_profile(0);
+
+      auto lines = read_lines(file);
+
+      THEN("Each virtual page is reported with its physical page and count") {
+        REQUIRE(std::size(lines) == 3);
+        REQUIRE(lines.at(0) == "cpu,vpage,ppage,translations");
+        REQUIRE(lines.at(1) == "0,16," + std::to_string(cold_ppage.to<uint64_t>()) + ",1");
+        REQUIRE(lines.at(2) == "0,64," + std::to_string(hot_ppage.to<uint64_t>()) + ",4");
+      }
+
+      AND_WHEN("The profile is written again") {
+        uut.write_page_profile(0);
+
+        THEN("The counts were discarded") {
+          REQUIRE(std::size(read_lines(file)) == 3);
+        }
+      }
+    }
+
+    WHEN("The profile is cleared") {
+      uut.va_to_pa(0, champsim::page_number{0x40});
+      uut.clear_page_profile();
+      uut.write_page_profile(0);
+
+      THEN("Nothing is written") {
+        REQUIRE(std::size(read_lines(file)) == 1);
+      }
+    }
+
+    std::filesystem::remove(file);
+  }
+}
@@ -276,3 +276,29 @@ struct to_pq_MRP final : public queue_issue_MRP
   }
 };
 
+
+/*
+ * Operate each element in [begin, end) once per cycle, in order
+ */
+template <typename It>
+void run(It begin, It end, long cycles)
+{
+  for (long i = 0; i < cycles; ++i)
+    for (auto it = begin; it != end; ++it)
+      (*it)->_operate();
+}
+
+/*
+ * A translated request from cpu 0. Writes do not ask for a response.
+ */
+inline champsim::channel::request_type make_packet(uint64_t addr, access_type type = access_type::LOAD, uint64_t ip = 0)
+{
+  champsim::channel::request_type packet;
+  packet.address = champsim::address{addr};
+  packet.v_address = champsim::address{addr};
+  packet.ip = champsim::address{ip};
+  packet.cpu = 0;
+  packet.type = type;
+  packet.response_requested = (type != access_type::WRITE);
+  return packet;
+}
@@ -76,3 +76,21 @@ class FragmentTests(unittest.TestCase):
         a_frag = config.filewrite.Fragment(a_parts)
         b_frag = config.filewrite.Fragment(b_parts)
         self.assertEqual(list(iter(config.filewrite.Fragment.join(a_frag, b_frag))), expected)
+
+    def test_joined_fragments_share_constants(self):
+        a_parts = [('champsim_constants.h', (*config.filewrite.cxx_generated_warning(), 'aaa'))]
+        b_parts = [('champsim_constants.h', (*config.filewrite.cxx_generated_warning(), 'aaa'))]
+        expected = [('champsim_constants.h', (*config.filewrite.cxx_generated_warning(), 'aaa'))]
+
+        a_frag = config.filewrite.Fragment(a_parts)
+        b_frag = config.filewrite.Fragment(b_parts)
+        self.assertEqual(list(iter(config.filewrite.Fragment.join(a_frag, b_frag))), expected)
+
+    def test_joined_fragments_reject_different_constants(self):
+        a_parts = [('champsim_constants.h', (*config.filewrite.cxx_generated_warning(), 'aaa'))]
+        b_parts = [('champsim_constants.h', (*config.filewrite.cxx_generated_warning(), 'bbb'))]
+
+        a_frag = config.filewrite.Fragment(a_parts)
+        b_frag = config.filewrite.Fragment(b_parts)
+        with self.assertRaises(ValueError):
+            config.filewrite.Fragment.join(a_frag, b_frag)
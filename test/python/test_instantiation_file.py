@@ -86,6 +86,13 @@ class CpuBuilderTest(unittest.TestCase):
     def test_execute_latency(self):
         self.get_element_diff(['.execute_latency(1)'], execute_latency=1)
 
+    def test_class_execute_latency(self):
+        self.get_element_diff(['.class_execute_latency({1, 3, 20})'], class_execute_latency=[1, 3, 20])
+
+    def test_model(self):
+        self.get_element_diff(['.model(champsim::core_model::interval)'], model='interval')
+        self.get_element_diff(['.model(champsim::core_model::in_order)'], model='in_order')
+
     def test_dib_set(self):
         self.get_element_diff(['.dib_set(1)'], dib_set=1)
 
@@ -104,6 +111,19 @@ class CpuBuilderTest(unittest.TestCase):
     def test_dib_window_dict(self):
         self.get_element_diff(['.dib_window(1)'], DIB={ 'window_size': 1 })
 
+    def test_dib_uops_per_line_dict(self):
+        self.get_element_diff(['.dib_uops_per_line(6)'], DIB={ 'uops_per_line': 6 })
+
+    def test_dib_ways_per_window_dict(self):
+        self.get_element_diff(['.dib_ways_per_window(3)'], DIB={ 'ways_per_window': 3 })
+
+    def test_dib_switch_penalty_dict(self):
+        self.get_element_diff(['.dib_switch_penalty(1)'], DIB={ 'switch_penalty': 1 })
+
+    def test_dib_inclusive_dict(self):
+        self.get_element_diff(['.set_dib_inclusive()'], DIB={ 'inclusive': True })
+        self.get_element_diff(['.reset_dib_inclusive()'], DIB={ 'inclusive': False })
+
     def test_branch_predictor(self):
         self.get_element_diff(['.branch_predictor<class a_class>()'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.branch_predictor<class a_class, class b_class>()'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
@@ -112,6 +132,22 @@ class CpuBuilderTest(unittest.TestCase):
         self.get_element_diff(['.btb<class a_class>()'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.btb<class a_class, class b_class>()'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
+    def test_ip_attribution(self):
+        self.get_element_diff(['.ip_attribution(20)'], ip_attribution=20)
+
+    def test_btb_levels(self):
+        self.get_element_diff(['.btb_levels({{256, 4, 0}, {4096, 8, 2}})'], btb_levels=[{ 'sets': 256, 'ways': 4 }, { 'sets': 4096, 'ways': 8, 'latency': 2 }])
+
+    def test_btb_prefetch_from_l1i(self):
+        self.get_element_diff(['.set_btb_prefetch_from_l1i()'], btb_prefetch_from_l1i=True)
+        self.get_element_diff(['.reset_btb_prefetch_from_l1i()'], btb_prefetch_from_l1i=False)
+
+    def test_energy(self):
+        self.get_element_diff(['.rob_energy(champsim::partial_access_energy{1.0, 2.0, 0.5})'], energy={ 'rob': { 'read': 1, 'write': 2, 'leakage': 0.5 } })
+        self.get_element_diff(['.lq_energy(champsim::partial_access_energy{1.0, std::nullopt, std::nullopt})'], energy={ 'lq': { 'read': 1 } })
+        self.get_element_diff(['.sq_energy(champsim::partial_access_energy{std::nullopt, 1.0, std::nullopt})'], energy={ 'sq': { 'write': 1 } })
+        self.get_element_diff(['.branch_predictor_energy(champsim::partial_access_energy{std::nullopt, std::nullopt, 1.0})'], energy={ 'branch_predictor': { 'leakage': 1 } })
+
 class CacheBuilderTests(unittest.TestCase):
 
     def get_element_diff(self, added_lines, **kwargs):
@@ -154,6 +190,15 @@ class CacheBuilderTests(unittest.TestCase):
     def test_fill_latency(self):
         self.get_element_diff(['.fill_latency(1)'], fill_latency=1)
 
+    def test_sectors(self):
+        self.get_element_diff(['.sectors(4)'], sectors=4)
+
+    def test_victim_cache(self):
+        self.get_element_diff(['.victim_cache(8)'], victim_cache=8)
+
+    def test_prefetch_buffer(self):
+        self.get_element_diff(['.prefetch_buffer(16)'], prefetch_buffer=16)
+
     def test_max_tag_check(self):
         self.get_element_diff(['.tag_bandwidth(champsim::bandwidth::maximum_type{1})'], max_tag_check=1)
 
@@ -168,6 +213,38 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.set_wq_checks_full_addr()'], wq_check_full_addr=True)
         self.get_element_diff(['.reset_wq_checks_full_addr()'], wq_check_full_addr=False)
 
+    def test_mshr_demand_reserve(self):
+        self.get_element_diff(['.mshr_demand_reserve(4)'], mshr_demand_reserve=4)
+
+    def test_mshr_prefetch_limit(self):
+        self.get_element_diff(['.mshr_prefetch_limit(8)'], mshr_prefetch_limit=8)
+
+    def test_demand_priority(self):
+        self.get_element_diff(['.set_demand_priority()'], demand_priority=True)
+        self.get_element_diff(['.reset_demand_priority()'], demand_priority=False)
+
+    def test_fixed_priority(self):
+        self.get_element_diff(['.set_fixed_priority()'], fixed_priority=True)
+        self.get_element_diff(['.reset_fixed_priority()'], fixed_priority=False)
+
+    def test_write_through(self):
+        self.get_element_diff(['.set_write_through()'], write_through=True)
+        self.get_element_diff(['.reset_write_through()'], write_through=False)
+
+    def test_write_buffer(self):
+        self.get_element_diff(['.write_buffer_size(16)'], write_buffer=16)
+
+    def test_ip_attribution(self):
+        self.get_element_diff(['.ip_attribution(20)'], ip_attribution=20)
+
+    def test_write_allocate(self):
+        self.get_element_diff(['.set_write_allocate()'], write_allocate=True)
+        self.get_element_diff(['.reset_write_allocate()'], write_allocate=False)
+
+    def test_eager_writeback(self):
+        self.get_element_diff(['.set_eager_writeback()'], eager_writeback=True)
+        self.get_element_diff(['.reset_eager_writeback()'], eager_writeback=False)
+
     def test_virtual_prefetch(self):
         self.get_element_diff(['.set_virtual_prefetch()'], virtual_prefetch=True)
         self.get_element_diff(['.reset_virtual_prefetch()'], virtual_prefetch=False)
@@ -188,6 +265,11 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.replacement<class a_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.replacement<class a_class, class b_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
+    def test_energy(self):
+        self.get_element_diff(['.tag_energy(champsim::partial_access_energy{1.0, 2.0, 0.5})'], energy={ 'tag': { 'read': 1, 'write': 2, 'leakage': 0.5 } })
+        self.get_element_diff(['.data_energy(champsim::partial_access_energy{3.0, std::nullopt, std::nullopt})'], energy={ 'data': { 'read': 3 } })
+        self.get_element_diff([], energy={})
+
 class PageTableWalkerBuilderTests(unittest.TestCase):
 
     def get_element_diff(self, added_lines, **kwargs):
@@ -206,6 +288,9 @@ class PageTableWalkerBuilderTests(unittest.TestCase):
     def test_max_write(self):
         self.get_element_diff(['.fill_bandwidth(champsim::bandwidth::maximum_type{1})'], max_write=1)
 
+    def test_energy(self):
+        self.get_element_diff(['.pscl_energy(champsim::partial_access_energy{1.0, 2.0, 0.5})'], energy={ 'pscl': { 'read': 1, 'write': 2, 'leakage': 0.5 } })
+
     def test_pscl5(self):
         self.get_element_diff(['.add_pscl(5, 1, 2)'], pscl5_set=1, pscl5_way=2)
 
@@ -218,6 +303,84 @@ class PageTableWalkerBuilderTests(unittest.TestCase):
     def test_pscl2(self):
         self.get_element_diff(['.add_pscl(2, 1, 2)'], pscl2_set=1, pscl2_way=2)
 
+class PageAllocationTests(unittest.TestCase):
+
+    def test_default_is_random(self):
+        result = config.instantiation_file.get_page_allocation_params({}, 2048)
+        self.assertIn('policy_type::random', result)
+        self.assertIn('color_type::llc', result)
+        self.assertIn(', 2048,', result)
+
+    def test_policy_is_forwarded(self):
+        for policy in ('sequential', 'coloring', 'buddy', 'numa'):
+            with self.subTest(policy=policy):
+                result = config.instantiation_file.get_page_allocation_params({ 'page_allocation': policy }, 2048)
+                self.assertIn(f'policy_type::{policy}', result)
+
+    def test_numa_nodes(self):
+        result = config.instantiation_file.get_page_allocation_params({ 'page_allocation': 'numa', 'numa_nodes': 4 }, 2048)
+        self.assertTrue(result.endswith(', 4}'))
+
+    def test_unknown_policy_raises(self):
+        with self.assertRaises(ValueError):
+            config.instantiation_file.get_page_allocation_params({ 'page_allocation': 'first_fit' }, 2048)
+
+    def test_unknown_color_raises(self):
+        with self.assertRaises(ValueError):
+            config.instantiation_file.get_page_allocation_params({ 'page_allocation': 'coloring', 'page_color': 'l2c' }, 2048)
+
+class DramRowhammerTests(unittest.TestCase):
+
+    def test_default_is_none(self):
+        result = config.instantiation_file.get_dram_rowhammer_params({})
+        self.assertIn('mitigation_type::none', result)
+
+    def test_mitigation_is_forwarded(self):
+        for mitigation in ('para', 'graphene', 'rfm'):
+            with self.subTest(mitigation=mitigation):
+                result = config.instantiation_file.get_dram_rowhammer_params({ 'rowhammer_mitigation': mitigation })
+                self.assertIn(f'mitigation_type::{mitigation}', result)
+
+    def test_threshold(self):
+        result = config.instantiation_file.get_dram_rowhammer_params({ 'rowhammer_mitigation': 'graphene', 'rowhammer_threshold': 512 })
+        self.assertIn(', 512,', result)
+
+class PageProfileTests(unittest.TestCase):
+
+    def test_default_is_disabled(self):
+        result = config.instantiation_file.get_page_profile_params({})
+        self.assertEqual(result, 'page_profile_parameters{"", 0}')
+
+    def test_file_and_epoch_are_forwarded(self):
+        result = config.instantiation_file.get_page_profile_params({ 'page_profile': 'pages.csv', 'page_profile_epoch': 100000 })
+        self.assertEqual(result, 'page_profile_parameters{"pages.csv", 100000}')
+
+class LinkParamsTests(unittest.TestCase):
+
+    def test_no_link_is_untimed(self):
+        self.assertIsNone(config.instantiation_file.get_link_params({ 'name': 'test', 'frequency': 1000 }))
+
+    def test_link_uses_the_frequency_of_the_element(self):
+        result = config.instantiation_file.get_link_params({ 'name': 'test', 'frequency': 2000, 'link': {} })
+        self.assertIn('champsim::chrono::picoseconds{500}', result)
+
+    def test_link_frequency(self):
+        result = config.instantiation_file.get_link_params({ 'name': 'test', 'frequency': 2000, 'link': { 'frequency': 1000 } })
+        self.assertIn('champsim::chrono::picoseconds{1000}', result)
+
+    def test_link_latency_and_bandwidth(self):
+        link = { 'request_latency': 3, 'response_latency': 5, 'flits_per_cycle': 2, 'flit_size': 16 }
+        result = config.instantiation_file.get_link_params({ 'name': 'test', 'frequency': 1000, 'link': link })
+        self.assertIn('}, 3, 5, 2, champsim::data::bytes{16}}', result)
+
+    def test_only_the_lower_level_is_timed(self):
+        uppers = { 'test_cache': { 'name': 'test_cache', 'frequency': 1000, 'lower_level': 'test_ll', 'lower_translate': 'test_lt', 'link': {} } }
+        queues = [{ 'rq_size': 1, 'pq_size': 1, 'wq_size': 1, '_offset_bits': 6, '_queue_check_full_addr': False }] * 2
+        ul_pairs = [('test_ll', 'test_cache'), ('test_lt', 'test_cache')]
+        result = list(config.instantiation_file.get_channel_instantiation(ul_pairs, queues, uppers))
+        self.assertIn('"test_cache->test_ll", champsim::link_parameters{', result[0])
+        self.assertNotIn('link_parameters', result[1])
+
 class GetUpperLevelsTests(unittest.TestCase):
 
     def test_empty(self):
@@ -275,6 +438,15 @@ class DecorateQueuesTests(unittest.TestCase):
         self.assertEqual(evaluated.get('test_l3').get('wq_size'), 3)
         self.assertEqual(evaluated.get('test_l3').get('pq_size'), 3)
 
+    def test_sectored_caches_merge_by_sector(self):
+        caches = [
+            {'name': 'test_l1', 'lower_level': 'DRAM', 'rq_size': 1, 'wq_size': 1, 'pq_size': 1, '_offset_bits': 8, '_queue_offset_bits': 6, '_queue_check_full_addr': False, '_queue_factor': None}
+        ]
+
+        evaluated = config.instantiation_file.decorate_queues(caches, [], {'name': 'DRAM'})
+
+        self.assertEqual(evaluated.get('test_l1').get('_offset_bits'), 6)
+
 class GetQueueInfoTests(unittest.TestCase):
     def test_single(self):
         given_uppers = [('dog', 'cat')]
@@ -304,3 +476,15 @@ class GetQueueInfoTests(unittest.TestCase):
             { 'is_good_boy': False }
         ]
         self.assertEqual(expected, evaluated)
+
+class ConstantsHeaderTests(unittest.TestCase):
+    def test_constants_have_logarithms(self):
+        lines = list(config.instantiation_file.get_constants_header({'block_size': 128, 'page_size': 8192}))
+        self.assertIn('constexpr unsigned BLOCK_SIZE = 128;', lines)
+        self.assertIn('constexpr unsigned PAGE_SIZE = 8192;', lines)
+        self.assertIn('constexpr unsigned LOG2_BLOCK_SIZE = 7;', lines)
+        self.assertIn('constexpr unsigned LOG2_PAGE_SIZE = 13;', lines)
+
+    def test_sizes_must_be_powers_of_two(self):
+        with self.assertRaises(ValueError):
+            list(config.instantiation_file.get_constants_header({'block_size': 96, 'page_size': 4096}))
@@ -321,6 +321,76 @@ class ParseNormalizedTests(unittest.TestCase):
                 module_names = [c.get(module_key) for c in caches]
                 self.assertNotIn(None, module_names)
 
+    def test_caches_may_have_their_own_block_size(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'caches': [{ 'name': 'LLC', 'block_size': '128B' }] })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        llc = next(filter(lambda c: c['name'] == 'LLC', result[0]['caches']))
+        l1d = next(filter(lambda c: c['name'] == result[0]['cores'][0]['L1D'], result[0]['caches']))
+
+        self.assertEqual(llc['_offset_bits'], 'champsim::lg2(128)')
+        self.assertEqual(llc['_queue_offset_bits'], 'champsim::lg2(128)')
+        self.assertEqual(l1d['_offset_bits'], 'champsim::lg2(64)')
+
+    def test_sectored_caches_merge_requests_by_sector(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'caches': [{ 'name': 'LLC', 'block_size': 256, 'sectors': 4 }] })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        llc = next(filter(lambda c: c['name'] == 'LLC', result[0]['caches']))
+
+        self.assertEqual(llc['_offset_bits'], 'champsim::lg2(256)')
+        self.assertEqual(llc['_queue_offset_bits'], 'champsim::lg2(64)')
+
+    def test_first_level_caches_must_fill_system_blocks(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu', 'L1D': { 'name': 'test_L1D', 'block_size': 128 } }] })
+
+        with self.assertRaises(ValueError):
+            test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+
+    def test_there_is_no_dram_cache_by_default(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }] })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        self.assertIsNone(result[0]['dram_cache'])
+
+    def test_there_is_no_memory_side_prefetcher_by_default(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }] })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        self.assertEqual(result[0]['pmem']['_dram_prefetcher_data'], [])
+
+    def test_memory_side_prefetchers_are_modules(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'physical_memory': { 'prefetcher': 'dram_stream' } })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        self.assertEqual([m['name'] for m in result[0]['pmem']['_dram_prefetcher_data']], ['dram_stream'])
+
+    def test_the_dram_cache_sits_above_dram(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'dram_cache': { 'size': '64MiB' } })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        dram_cache = result[0]['dram_cache']
+        llc = next(filter(lambda c: c['name'] == 'LLC', result[0]['caches']))
+
+        self.assertEqual(llc['lower_level'], dram_cache['name'])
+        self.assertEqual(dram_cache['lower_level'], 'DRAM')
+        self.assertEqual(dram_cache['size'], 64*1024*1024)
+
+    def test_dram_cache_organizations_have_their_own_geometry(self):
+        for organization, page_size, ways in (('alloy', 64, 1), ('unison', 1024, 4)):
+            with self.subTest(organization=organization):
+                test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'dram_cache': { 'organization': organization } })
+
+                result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+                self.assertEqual(result[0]['dram_cache']['page_size'], page_size)
+                self.assertEqual(result[0]['dram_cache']['ways'], ways)
+
+    def test_dram_cache_pages_must_fit_a_block_mask(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }], 'dram_cache': { 'organization': 'unison', 'page_size': '8kB' } })
+
+        with self.assertRaises(ValueError):
+            test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+
 class NormalizeConfigTest(unittest.TestCase):
 
     def test_empty_config_creates_defaults(self):
@@ -19,6 +19,7 @@
  *  and could serve as the starting point for developing your first PIN tool
  */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdlib.h>
@@ -39,6 +40,7 @@ UINT64 instrCount = 0;
 std::ofstream outfile;
 
 trace_instr_format_t curr_instr;
+extended_instr curr_extended_instr;
 
 /* ===================================================================== */
 // Command line switches
@@ -49,6 +51,8 @@ KNOB<UINT64> KnobSkipInstructions(KNOB_MODE_WRITEONCE, "pintool", "s", "0", "How
 
 KNOB<UINT64> KnobTraceInstructions(KNOB_MODE_WRITEONCE, "pintool", "t", "1000000", "How many instructions to trace");
 
+KNOB<BOOL> KnobExtended(KNOB_MODE_WRITEONCE, "pintool", "x", "0", "Write the trace in the extended format");
+
 /* ===================================================================== */
 // Utilities
 /* ===================================================================== */
@@ -62,6 +66,7 @@ INT32 Usage()
             << "Specify the output trace file with -o" << std::endl
             << "Specify the number of instructions to skip before tracing with -s" << std::endl
             << "Specify the number of instructions to trace with -t" << std::endl
+            << "Write the extended trace format with -x" << std::endl
             << std::endl;
 
   std::cerr << KNOB_BASE::StringKnobSummary() << std::endl;
@@ -79,23 +84,32 @@ void ResetCurrentInstruction(VOID* ip)
   curr_instr.ip = (unsigned long long int)ip;
 }
 
+void ResetCurrentExtendedInstruction(VOID* ip)
+{
+  curr_extended_instr = {};
+  curr_extended_instr.ip = (unsigned long long int)ip;
+  curr_extended_instr.version = EXTENDED_TRACE_VERSION;
+}
+
 BOOL ShouldWrite()
 {
   ++instrCount;
   return (instrCount > KnobSkipInstructions.Value()) && (instrCount <= (KnobTraceInstructions.Value() + KnobSkipInstructions.Value()));
 }
 
-void WriteCurrentInstruction()
+template <typename T>
+void WriteCurrentInstruction(T* instr)
 {
-  typename decltype(outfile)::char_type buf[sizeof(trace_instr_format_t)];
-  std::memcpy(buf, &curr_instr, sizeof(trace_instr_format_t));
-  outfile.write(buf, sizeof(trace_instr_format_t));
+  typename decltype(outfile)::char_type buf[sizeof(T)];
+  std::memcpy(buf, instr, sizeof(T));
+  outfile.write(buf, sizeof(T));
 }
 
-void BranchOrNot(UINT32 taken)
+template <typename T>
+void BranchOrNot(T* instr, UINT32 taken)
 {
-  curr_instr.is_branch = 1;
-  curr_instr.branch_taken = taken;
+  instr->is_branch = 1;
+  instr->branch_taken = taken;
 }
 
 template <typename T>
@@ -103,7 +117,37 @@ void WriteToSet(T* begin, T* end, UINT32 r)
 {
   auto set_end = std::find(begin, end, 0);
   auto found_reg = std::find(begin, set_end, r); // check to see if this register is already in the list
-  *found_reg = r;
+  if (found_reg != end) // operands beyond the capacity of the format are dropped
+    *found_reg = r;
+}
+
+// Record a memory operand with its size. An operand that is accessed twice keeps the larger size.
+void WriteSizedToSet(unsigned long long* begin, unsigned long long* end, unsigned char* sizes, ADDRINT addr, UINT32 size)
+{
+  auto set_end = std::find(begin, end, 0);
+  auto found = std::find(begin, set_end, addr);
+  if (found != end) {
+    *found = addr;
+    auto& found_size = sizes[found - begin];
+    found_size = std::max<unsigned char>(found_size, (unsigned char)std::min<UINT32>(size, 255));
+  }
+}
+
+// Record each active element of a gather or scatter, which has a separate address and size for every element
+void WriteVectorMemory(PIN_MULTI_MEM_ACCESS_INFO* info)
+{
+  for (UINT32 i = 0; i < info->numberOfMemops; i++) {
+    const auto& element = info->memop[i];
+    if (!element.maskOn)
+      continue;
+
+    if (element.memopType == PIN_MEMOP_LOAD)
+      WriteSizedToSet(curr_extended_instr.source_memory, curr_extended_instr.source_memory + NUM_EXTENDED_MEMORY_OPERANDS,
+                      curr_extended_instr.source_memory_size, element.memoryAddress, (UINT32)element.bytesAccessed);
+    else
+      WriteSizedToSet(curr_extended_instr.destination_memory, curr_extended_instr.destination_memory + NUM_EXTENDED_MEMORY_OPERANDS,
+                      curr_extended_instr.destination_memory_size, element.memoryAddress, (UINT32)element.bytesAccessed);
+  }
 }
 
 /* ===================================================================== */
@@ -118,7 +162,7 @@ VOID Instruction(INS ins, VOID* v)
 
   // instrument branch instructions
   if (INS_IsBranch(ins))
-    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)BranchOrNot, IARG_BRANCH_TAKEN, IARG_END);
+    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)BranchOrNot<trace_instr_format_t>, IARG_PTR, &curr_instr, IARG_BRANCH_TAKEN, IARG_END);
 
   // instrument register reads
   UINT32 readRegCount = INS_MaxNumRRegs(ins);
@@ -151,7 +195,51 @@ VOID Instruction(INS ins, VOID* v)
 
   // finalize each instruction with this function
   INS_InsertIfCall(ins, IPOINT_BEFORE, (AFUNPTR)ShouldWrite, IARG_END);
-  INS_InsertThenCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteCurrentInstruction, IARG_END);
+  INS_InsertThenCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteCurrentInstruction<trace_instr_format_t>, IARG_PTR, &curr_instr, IARG_END);
+}
+
+// Is called for every instruction when the extended format is selected. The extended format holds more register and memory operands, and
+// the size of each memory operand.
+VOID ExtendedInstruction(INS ins, VOID* v)
+{
+  INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)ResetCurrentExtendedInstruction, IARG_INST_PTR, IARG_END);
+
+  if (INS_IsBranch(ins))
+    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)BranchOrNot<extended_instr>, IARG_PTR, &curr_extended_instr, IARG_BRANCH_TAKEN, IARG_END);
+
+  UINT32 readRegCount = INS_MaxNumRRegs(ins);
+  for (UINT32 i = 0; i < readRegCount; i++) {
+    UINT32 regNum = INS_RegR(ins, i);
+    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteToSet<unsigned short>, IARG_PTR, curr_extended_instr.source_registers, IARG_PTR,
+                   curr_extended_instr.source_registers + NUM_EXTENDED_SOURCE_REGISTERS, IARG_UINT32, regNum, IARG_END);
+  }
+
+  UINT32 writeRegCount = INS_MaxNumWRegs(ins);
+  for (UINT32 i = 0; i < writeRegCount; i++) {
+    UINT32 regNum = INS_RegW(ins, i);
+    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteToSet<unsigned short>, IARG_PTR, curr_extended_instr.destination_registers, IARG_PTR,
+                   curr_extended_instr.destination_registers + NUM_EXTENDED_DESTINATION_REGISTERS, IARG_UINT32, regNum, IARG_END);
+  }
+
+  // The memory operand of a gather or scatter stands for all of its elements, so the elements are recorded individually
+  UINT32 memOperands = INS_HasMemoryVector(ins) ? 0 : INS_MemoryOperandCount(ins);
+  if (INS_HasMemoryVector(ins))
+    INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteVectorMemory, IARG_MULTI_MEMORYACCESS_EA, IARG_END);
+
+  for (UINT32 memOp = 0; memOp < memOperands; memOp++) {
+    UINT32 size = INS_MemoryOperandSize(ins, memOp);
+    if (INS_MemoryOperandIsRead(ins, memOp))
+      INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteSizedToSet, IARG_PTR, curr_extended_instr.source_memory, IARG_PTR,
+                     curr_extended_instr.source_memory + NUM_EXTENDED_MEMORY_OPERANDS, IARG_PTR, curr_extended_instr.source_memory_size,
+                     IARG_MEMORYOP_EA, memOp, IARG_UINT32, size, IARG_END);
+    if (INS_MemoryOperandIsWritten(ins, memOp))
+      INS_InsertCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteSizedToSet, IARG_PTR, curr_extended_instr.destination_memory, IARG_PTR,
+                     curr_extended_instr.destination_memory + NUM_EXTENDED_MEMORY_OPERANDS, IARG_PTR, curr_extended_instr.destination_memory_size,
+                     IARG_MEMORYOP_EA, memOp, IARG_UINT32, size, IARG_END);
+  }
+
+  INS_InsertIfCall(ins, IPOINT_BEFORE, (AFUNPTR)ShouldWrite, IARG_END);
+  INS_InsertThenCall(ins, IPOINT_BEFORE, (AFUNPTR)WriteCurrentInstruction<extended_instr>, IARG_PTR, &curr_extended_instr, IARG_END);
 }
 
 /*!
@@ -184,7 +272,10 @@ int main(int argc, char* argv[])
   }
 
   // Register function to be called to instrument instructions
-  INS_AddInstrumentFunction(Instruction, 0);
+  if (KnobExtended.Value())
+    INS_AddInstrumentFunction(ExtendedInstruction, 0);
+  else
+    INS_AddInstrumentFunction(Instruction, 0);
 
   // Register function to be called when the application exits
   PIN_AddFiniFunction(Fini, 0);